@@ -0,0 +1,273 @@
+/*
+ * checkpoint.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "checkpoint.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "driverlib/sysctl.h"
+#include "driverlib/eeprom.h"
+
+#define CHKPT_HDRWORDS		3		/* sequence number, CRC, state */
+#define CHKPT_DATAWORDS		(CHKPT_SLOTWORDS-CHKPT_HDRWORDS)
+#define CHKPT_EMPTY			0xFFFFFFFF	/* sequence number of an erased slot */
+#define CHKPT_VALID			0x5452			/* state of a slot holding a checkpoint */
+#define CHKPT_CLEARED		0				/* state of a slot written by chkpt_clear() */
+
+/* fails to compile, if the checkpoint content does not fit into a slot */
+typedef char chkpt_size_check[(sizeof(chkpt_data_t) <= CHKPT_DATAWORDS*4) ? 1 : -1];
+
+typedef union {
+	uint32_t		w[CHKPT_SLOTWORDS];
+	struct {
+		uint32_t	seq;
+		uint32_t	crc;
+		uint32_t	state;
+		chkpt_data_t data;
+	} s;
+} chkpt_slot_t;
+
+/* ################### internal variables ################### */
+
+static chkpt_slot_t		slot;				/* image of the slot being written */
+static uint32_t			seq = 0;			/* sequence number of the most recent checkpoint */
+static uint8_t			slotIdx = CHKPT_SLOTS-1;	/* slot of the most recent checkpoint */
+static int8_t			wordIdx = -1;		/* next word to be written, -1 if idle */
+static bool				eepromOk = false;
+static const chkpt_ops_t *	ops;
+static void *			opsArg;
+
+/* ################### private function prototypes ################### */
+
+/* Calculates the CRC-32 of a slot (sequence number and data). */
+uint32_t chkpt_crc(const chkpt_slot_t * sl);
+void chkpt_write(const chkpt_data_t * data, uint32_t state);
+
+/* EEPROM operations (private) */
+bool chkpt_eepromInit(void *arg);
+void chkpt_eepromRead(void *arg, uint32_t *data, uint32_t addr, uint32_t len);
+void chkpt_eepromProgram(void *arg, uint32_t data, uint32_t addr);
+bool chkpt_eepromReady(void *arg);
+
+static const chkpt_ops_t eepromOps = {
+	chkpt_eepromInit, chkpt_eepromRead, chkpt_eepromProgram, chkpt_eepromReady
+};
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Initialises the EEPROM.
+ */
+void chkpt_init(void)
+{
+	chkpt_initOps(&eepromOps, NULL);
+}
+
+/*
+ * Initialises the checkpoints on the given storage. A write in progress is dropped.
+ * o		storage operations
+ * arg		passed to the operations
+ */
+void chkpt_initOps(const chkpt_ops_t *o, void *arg)
+{
+	ops = o;
+	opsArg = arg;
+	seq = 0;
+	slotIdx = CHKPT_SLOTS-1;
+	wordIdx = -1;
+
+	eepromOk = ops->init(opsArg);
+}
+
+/*
+ * Loads the most recent valid checkpoint.
+ * The slot with the highest sequence number and a valid CRC is used, the next checkpoint is
+ * written to the following slot. If that slot has been cleared, there is no checkpoint.
+ * data		returns the checkpoint content
+ * Returns	true, if a valid checkpoint was found
+ */
+bool chkpt_load(chkpt_data_t * data)
+{
+	uint8_t i;
+	bool found = false;
+	bool valid = false;
+
+	if(!eepromOk) return false;
+
+	for(i=0; i<CHKPT_SLOTS; i++)
+	{
+		ops->read(opsArg, slot.w, CHKPT_BASE + i*CHKPT_SLOTWORDS*4, CHKPT_SLOTWORDS*4);
+		if(slot.s.seq==CHKPT_EMPTY || slot.s.crc!=chkpt_crc(&slot)) continue;
+		if(!found || slot.s.seq>seq)
+		{
+			found = true;
+			seq = slot.s.seq;
+			slotIdx = i;
+			valid = (slot.s.state==CHKPT_VALID);
+			if(valid) *data = slot.s.data;
+		}
+	}
+
+	return valid;
+}
+
+/*
+ * Starts writing a checkpoint to the next slot.
+ * The data words are written first, the sequence number last.
+ * data		the checkpoint content
+ */
+void chkpt_save(const chkpt_data_t * data)
+{
+	chkpt_write(data, CHKPT_VALID);
+}
+
+/*
+ * Starts writing an empty slot with the next sequence number, so the previous checkpoints are
+ * no longer loaded. An interrupted write leaves the previous checkpoint valid.
+ */
+void chkpt_clear(void)
+{
+	chkpt_data_t empty;
+
+	memset(&empty, 0, sizeof(empty));
+	chkpt_write(&empty, CHKPT_CLEARED);
+}
+
+/*
+ * Returns the GPS date and time in seconds since 1.1.2000, valid until 2099.
+ * date, time	GPS date and time
+ */
+uint32_t chkpt_timestamp(gps_date_t date, gps_time_t time)
+{
+	static const uint16_t mdays[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+	uint32_t days;
+
+	if(date.m<1 || date.m>12 || date.d<1) return 0;
+
+	days = date.y*365UL + (date.y+3)/4 + mdays[date.m-1] + date.d-1;
+	if(date.m>2 && (date.y%4)==0) days++;
+
+	return ((days*24 + time.h)*60 + time.m)*60 + time.s;
+}
+
+/*
+ * Returns true, if a checkpoint must not be resumed, because it was saved more than CHKPT_MAXAGE
+ * before now or after now (clock not comparable).
+ * data		the checkpoint content
+ * now		current time, see chkpt_timestamp()
+ */
+bool chkpt_expired(const chkpt_data_t * data, uint32_t now)
+{
+	return now<data->saveTime || now-data->saveTime>CHKPT_MAXAGE;
+}
+
+/*
+ * Writes the next word of a pending checkpoint, if the EEPROM is ready.
+ * Each call costs only a few register accesses, the EEPROM programs in the background.
+ * Returns true, if a word was written.
+ */
+bool chkpt_poll(void)
+{
+	if(wordIdx<0) return false;
+	if(!ops->ready(opsArg)) return false;
+
+	ops->program(opsArg, slot.w[wordIdx], CHKPT_BASE + (slotIdx*CHKPT_SLOTWORDS + wordIdx)*4);
+
+	if(wordIdx==0) wordIdx = -1;						/* sequence number written, done */
+	else if(++wordIdx==CHKPT_SLOTWORDS) wordIdx = 0;	/* data done, write sequence number */
+
+	return true;
+}
+
+/*
+ * Returns true, while a checkpoint is being written.
+ */
+bool chkpt_busy(void)
+{
+	return wordIdx>=0;
+}
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Prepares the slot image and starts writing it to the next slot.
+ * The data words are written first, the sequence number last.
+ * data		the checkpoint content
+ * state	CHKPT_VALID or CHKPT_CLEARED
+ */
+void chkpt_write(const chkpt_data_t * data, uint32_t state)
+{
+	if(!eepromOk) return;
+
+	if(wordIdx<0)		/* otherwise restart the pending slot with the new data */
+	{
+		slotIdx = (slotIdx+1) % CHKPT_SLOTS;
+		seq++;
+		if(seq==CHKPT_EMPTY) seq = 0;
+	}
+
+	memset(&slot, 0, sizeof(slot));
+	slot.s.seq = seq;
+	slot.s.state = state;
+	slot.s.data = *data;
+	slot.s.crc = chkpt_crc(&slot);
+
+	wordIdx = 1;
+}
+
+/*
+ * Calculates the CRC-32 (reflected, polynomial 0xEDB88320) of a slot, except the CRC word.
+ */
+uint32_t chkpt_crc(const chkpt_slot_t * sl)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	uint32_t w;
+	uint8_t i, b;
+
+	for(i=0; i<CHKPT_SLOTWORDS; i++)
+	{
+		if(i==1) continue;		/* CRC word */
+		w = sl->w[i];
+		for(b=0; b<32; b++)
+		{
+			if((crc ^ w) & 1) crc = (crc >> 1) ^ 0xEDB88320;
+			else crc >>= 1;
+			w >>= 1;
+		}
+	}
+
+	return ~crc;
+}
+
+/* EEPROM operations ---------------------------------------------------------------------- */
+
+bool chkpt_eepromInit(void *arg)
+{
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+	while(!SysCtlPeripheralReady(SYSCTL_PERIPH_EEPROM0));
+
+	return EEPROMInit()==EEPROM_INIT_OK;
+}
+
+void chkpt_eepromRead(void *arg, uint32_t *data, uint32_t addr, uint32_t len)
+{
+	EEPROMRead(data, addr, len);
+}
+
+void chkpt_eepromProgram(void *arg, uint32_t data, uint32_t addr)
+{
+	EEPROMProgramNonBlocking(data, addr);
+}
+
+bool chkpt_eepromReady(void *arg)
+{
+	return !(EEPROMStatusGet() & EEPROM_RC_WORKING);
+}
@@ -0,0 +1,87 @@
+/*
+ * checkpoint.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: checkpoint.h provides a trip checkpoint in the on-chip EEPROM, so computed values, the
+ *       		stopwatch and the open log can be resumed after a power loss. CHKPT_SLOTS slots are
+ *       		written round robin for wear levelling. Each slot holds a sequence number and a CRC,
+ *       		the sequence number is written last, so an interrupted write never replaces the
+ *       		previous valid checkpoint. Writing is non-blocking, one word per chkpt_poll() call.
+ *       		A checkpoint is cleared by writing an empty slot, e.g. when the log is stopped, and one
+ *       		older than CHKPT_MAXAGE is not resumed. The EEPROM is accessed through a small set of
+ *       		operations only, so interrupted writes can also be run against a simulated storage.
+ */
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gps.h"
+
+#define CHKPT_BASE			0x0000	/* EEPROM address of the first slot */
+#define CHKPT_SLOTS			16		/* number of slots used for wear levelling */
+#define CHKPT_SLOTWORDS		32		/* words per slot (128 bytes) */
+#define CHKPT_INTERVAL		10		/* s, interval between checkpoints */
+#define CHKPT_NAMELEN		28		/* max. length of the stored log file names */
+#define CHKPT_MAXAGE		7200	/* s, a checkpoint saved longer ago is not resumed */
+
+/* checkpoint content */
+typedef struct {
+	uint32_t	dist;		/* distance made good */
+	uint32_t	altUp;		/* altitude made good upwards */
+	uint32_t	altDwn;		/* altitude made good downwards */
+	gps_time_t	resetTime;	/* GPS time of the last reset, reference of the time since reset */
+	uint32_t	stpw;		/* ms, stopwatch value */
+	uint32_t	logDist;	/* distance at the last log record */
+	uint16_t	spdMax;		/* maximum speed */
+	uint8_t		stpwRun;	/* 1, if the stopwatch is running */
+	uint8_t		rec;		/* 1, if recording */
+	uint32_t	saveTime;	/* s since 1.1.2000, GPS time of saving, see chkpt_timestamp() */
+	uint32_t	logSize;	/* bytes of the track log on the card, see log_SyncedSize() */
+	uint32_t	eventSize;	/* bytes of the event log on the card */
+	char		logName[CHKPT_NAMELEN];		/* track log file name */
+	char		eventName[CHKPT_NAMELEN];	/* event log file name */
+} chkpt_data_t;
+
+/* storage operations */
+typedef struct {
+	bool (*init)(void *arg);												/* true, if the storage can be used */
+	void (*read)(void *arg, uint32_t *data, uint32_t addr, uint32_t len);	/* reads len bytes */
+	void (*program)(void *arg, uint32_t data, uint32_t addr);				/* starts programming a word */
+	bool (*ready)(void *arg);												/* true, if no word is being programmed */
+} chkpt_ops_t;
+
+/* Initialises the EEPROM. */
+void chkpt_init(void);
+
+/* Initialises the checkpoints on the given storage. */
+void chkpt_initOps(const chkpt_ops_t *ops, void *arg);
+
+/* Loads the most recent valid checkpoint. Returns true, if a valid checkpoint was found. */
+bool chkpt_load(chkpt_data_t * data);
+
+/* Starts writing a checkpoint to the next slot. A write in progress is restarted with the new data. */
+void chkpt_save(const chkpt_data_t * data);
+
+/* Starts writing an empty slot, so no checkpoint is loaded afterwards. */
+void chkpt_clear(void);
+
+/* Returns the GPS date and time in seconds since 1.1.2000. */
+uint32_t chkpt_timestamp(gps_date_t date, gps_time_t time);
+
+/* Returns true, if a checkpoint was saved more than CHKPT_MAXAGE before now or after now. */
+bool chkpt_expired(const chkpt_data_t * data, uint32_t now);
+
+/* Writes the next word of a pending checkpoint, if the EEPROM is ready. Must be called periodically.
+ * Returns true, if a word was written. */
+bool chkpt_poll(void);
+
+/* Returns true, while a checkpoint is being written. */
+bool chkpt_busy(void);
+
+#endif /* CHECKPOINT_H_ */
@@ -19,6 +19,9 @@
 
 config_t conf;
 
+/* Inserts a decimal point before the last digit of str (private) */
+void shiftDecLeft (char * str, uint8_t Len);
+
 /* array of pointers to strings */
 const char * confstrs[] = {
 	"demo",
@@ -129,46 +132,7 @@ void conf_processLine(char * str)
 		val[chrptrEOL-chrptrEQ] = 0;
 		
 		/* evaluate config string values */
-		switch(valId)
-		{
-		case CFG_DEMO:
-			conf.demo = aToBool(val, DEF_DEMO);
-			break;
-		case CFG_LOGDBG:
-			conf.logDebug = aToBool(val, DEF_LOGDBG);
-			break;
-		case CFG_LOGINTVL:
-			conf.logIntvl = (uint8_t)(axp1ToUi32(val, DEF_LOGINTVL*10) / 1U);
-			if(conf.logIntvl>255 || conf.logIntvl<5) conf.logIntvl = DEF_LOGINTVL;
-			break;
-		case CFG_LOGASTART:
-			conf.logAutoStart = aToBool(val, DEF_LOGASTART);
-			break;
-		case CFG_GPSBAUD:
-			conf.gpsUartBaud = (axp1ToUi32(val, DEF_GPSBAUD*10) / 10U);
-			if(conf.gpsUartBaud>921600U || conf.gpsUartBaud<2400U) conf.gpsUartBaud = DEF_GPSBAUD;
-			break;
-		case CFG_GPSALTTH:
-			conf.gpsAltThreshold = (int32_t)(axp1ToUi32(val, DEF_GPSALTTH));
-			if(conf.gpsAltThreshold>500U || conf.gpsAltThreshold<1U) conf.gpsAltThreshold = DEF_GPSALTTH;
-			break;
-		case CFG_GPSDOPTH:
-			conf.gpsDopThreshold = (uint8_t)(axp1ToUi32(val, DEF_GPSDOPTH));
-			if(conf.gpsDopThreshold>300U || conf.gpsDopThreshold<1U) conf.gpsDopThreshold = DEF_GPSDOPTH;
-			break;
-		case CFG_GPSDISTTH:
-			conf.gpsDistThreshold = (uint32_t)(axp1ToUi32(val, DEF_GPSDISTTH));
-			if(conf.gpsDistThreshold>5000U || conf.gpsDistThreshold<1U) conf.gpsDistThreshold = DEF_GPSDISTTH;
-			break;
-		case CFG_DISPDIMT:
-			conf.dispDimTime = (uint32_t)(axp1ToUi32(val, DEF_DISPDIMT));
-			if(conf.dispDimTime>(12*60*60*10)) conf.dispDimTime = DEF_DISPDIMT;
-			break;
-		case CFG_DISPOFFT:
-			conf.dispOffTime = (uint32_t)(axp1ToUi32(val, DEF_DISPOFFT));
-			if(conf.dispOffTime>(12*60*60*10)) conf.dispOffTime = DEF_DISPOFFT;
-			break;
-		}
+		conf_setValue(valId, val);
 
 		/* delete evaluated parts of buffer */
 		chrptrEOL++;
@@ -178,6 +142,116 @@ void conf_processLine(char * str)
 	}
 }
 
+/*
+ * Sets a configuration value from its string representation as used in the configuration file.
+ * Invalid or out of range values are replaced by the default value.
+ * valId	configuration key, CFG_DEMO..CFG_DISPOFFT
+ * val		zero terminated value string
+ * Returns	false, if valId is not a configuration key
+ */
+bool conf_setValue(uint8_t valId, char * val)
+{
+	switch(valId)
+	{
+	case CFG_DEMO:
+		conf.demo = aToBool(val, DEF_DEMO);
+		break;
+	case CFG_LOGDBG:
+		conf.logDebug = aToBool(val, DEF_LOGDBG);
+		break;
+	case CFG_LOGINTVL:
+		conf.logIntvl = (uint8_t)(axp1ToUi32(val, DEF_LOGINTVL*10) / 1U);
+		if(conf.logIntvl>255 || conf.logIntvl<5) conf.logIntvl = DEF_LOGINTVL;
+		break;
+	case CFG_LOGASTART:
+		conf.logAutoStart = aToBool(val, DEF_LOGASTART);
+		break;
+	case CFG_GPSBAUD:
+		conf.gpsUartBaud = (axp1ToUi32(val, DEF_GPSBAUD*10) / 10U);
+		if(conf.gpsUartBaud>921600U || conf.gpsUartBaud<2400U) conf.gpsUartBaud = DEF_GPSBAUD;
+		break;
+	case CFG_GPSALTTH:
+		conf.gpsAltThreshold = (int32_t)(axp1ToUi32(val, DEF_GPSALTTH));
+		if(conf.gpsAltThreshold>500U || conf.gpsAltThreshold<1U) conf.gpsAltThreshold = DEF_GPSALTTH;
+		break;
+	case CFG_GPSDOPTH:
+		conf.gpsDopThreshold = (uint8_t)(axp1ToUi32(val, DEF_GPSDOPTH));
+		if(conf.gpsDopThreshold>300U || conf.gpsDopThreshold<1U) conf.gpsDopThreshold = DEF_GPSDOPTH;
+		break;
+	case CFG_GPSDISTTH:
+		conf.gpsDistThreshold = (uint32_t)(axp1ToUi32(val, DEF_GPSDISTTH));
+		if(conf.gpsDistThreshold>5000U || conf.gpsDistThreshold<1U) conf.gpsDistThreshold = DEF_GPSDISTTH;
+		break;
+	case CFG_DISPDIMT:
+		conf.dispDimTime = (uint32_t)(axp1ToUi32(val, DEF_DISPDIMT));
+		if(conf.dispDimTime>(12*60*60*10)) conf.dispDimTime = DEF_DISPDIMT;
+		break;
+	case CFG_DISPOFFT:
+		conf.dispOffTime = (uint32_t)(axp1ToUi32(val, DEF_DISPOFFT));
+		if(conf.dispOffTime>(12*60*60*10)) conf.dispOffTime = DEF_DISPOFFT;
+		break;
+	default:
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Returns the configuration key of a key name, or -1 if the name is unknown.
+ */
+int8_t conf_findKey(const char * name)
+{
+	uint8_t i;
+
+	for(i=0; i<CFG_CNT; i++)
+		if(strcmp(name, confstrs[i])==0) return i;
+
+	return -1;
+}
+
+/*
+ * Returns the name of a configuration key, or NULL if valId is not a configuration key.
+ */
+const char * conf_getKeyName(uint8_t valId)
+{
+	if(valId>=CFG_CNT) return NULL;
+	return confstrs[valId];
+}
+
+/*
+ * Writes a configuration value to buffer in the format of the configuration file, i.e. 1/10 units
+ * with one decimal place.
+ * valId	configuration key, CFG_DEMO..CFG_DISPOFFT
+ * buffer	at least 11 chars
+ * Returns	buffer, or NULL if valId is not a configuration key
+ */
+char * conf_getValue(uint8_t valId, char * buffer)
+{
+	uint32_t val;
+
+	switch(valId)
+	{
+	case CFG_DEMO:		buffer[0] = conf.demo ? '1' : '0'; buffer[1] = 0; return buffer;
+	case CFG_LOGDBG:	buffer[0] = conf.logDebug ? '1' : '0'; buffer[1] = 0; return buffer;
+	case CFG_LOGASTART:	buffer[0] = conf.logAutoStart ? '1' : '0'; buffer[1] = 0; return buffer;
+	case CFG_GPSBAUD:	val = conf.gpsUartBaud*10; break;
+	case CFG_LOGINTVL:	val = conf.logIntvl; break;
+	case CFG_GPSALTTH:	val = conf.gpsAltThreshold; break;
+	case CFG_GPSDOPTH:	val = conf.gpsDopThreshold; break;
+	case CFG_GPSDISTTH:	val = conf.gpsDistThreshold; break;
+	case CFG_DISPDIMT:	val = conf.dispDimTime; break;
+	case CFG_DISPOFFT:	val = conf.dispOffTime; break;
+	default:			return NULL;
+	}
+
+	ui32ToA(val, buffer, 9);
+	shiftDecLeft(&buffer[7], 2);		/* e.g. "00000001.5" */
+	while(buffer[0]=='0' && buffer[1]!='.') buffer++;
+
+	return buffer;
+}
+
 /* Increases the selected configuration value */
 bool conf_inc(int8_t selection)
 {
@@ -83,6 +83,18 @@ uint8_t conf_read(void);
 /* write a sample config file to SD card. */
 uint8_t conf_write(void);
 
+/* Sets a configuration value from its string representation as used in the configuration file. */
+bool conf_setValue(uint8_t valId, char * val);
+
+/* Returns the configuration key of a key name, or -1 if the name is unknown. */
+int8_t conf_findKey(const char * name);
+
+/* Returns the name of a configuration key, or NULL if valId is not a configuration key. */
+const char * conf_getKeyName(uint8_t valId);
+
+/* Writes a configuration value to buffer (at least 11 chars) in the format of the configuration file. */
+char * conf_getValue(uint8_t valId, char * buffer);
+
 /* Increases the selected configuration value */
 bool conf_inc(int8_t selection);
 /* Decreases the selected configuration value */
@@ -0,0 +1,224 @@
+/*
+ * console.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "console.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "debug.h"
+
+/* ################### internal variables ################### */
+
+static const console_cmd_t * cmdTable = NULL;
+static uint8_t cmdCount = 0;
+
+static char line[CONSOLE_LINELEN+1];	/* line being assembled */
+static uint8_t lineLen = 0;
+static bool lineOverflow = false;
+
+/* ################### private function prototypes ################### */
+
+/* Prints the command table. */
+void console_help(void);
+
+/* Prints a line "name=value" of a magnitude and sign. */
+void console_printNum(const char * name, uint32_t value, bool negative);
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Sets the command table. "help" is handled by the console itself.
+ * table	array of commands, must remain valid
+ * count	number of commands
+ */
+void console_init(const console_cmd_t * table, uint8_t count)
+{
+	cmdTable = table;
+	cmdCount = count;
+	lineLen = 0;
+	lineOverflow = false;
+}
+
+/*
+ * Processes a received character: echoes it, handles backspace and executes the line on CR or LF.
+ * Lines longer than CONSOLE_LINELEN are discarded.
+ * c		the received character
+ */
+void console_input(char c)
+{
+	char echo[2];
+
+	if(c=='\r' || c=='\n')
+	{
+		if(lineLen==0 && !lineOverflow) return;		/* empty line or second char of CR LF */
+
+		console_print("\r\n");
+		line[lineLen] = 0;
+		if(lineOverflow)
+			console_print("line too long\r\n");
+		else if(!console_execute(line))
+			console_print("unknown command, type help\r\n");
+
+		lineLen = 0;
+		lineOverflow = false;
+		console_print(CONSOLE_PROMPT);
+		return;
+	}
+
+	if(c=='\b' || c==0x7F)			/* backspace or delete */
+	{
+		if(lineLen>0)
+		{
+			lineLen--;
+			console_print("\b \b");
+		}
+		return;
+	}
+
+	if(c=='\t') c = ' ';
+	if(c<' ') return;				/* ignore other control characters */
+
+	if(lineLen>=CONSOLE_LINELEN)
+	{
+		lineOverflow = true;
+		return;
+	}
+
+	line[lineLen++] = c;
+	echo[0] = c;
+	echo[1] = 0;
+	console_print(echo);
+}
+
+/*
+ * Splits a line into whitespace separated arguments in place.
+ * Arguments exceeding maxArgs are ignored.
+ * line		zero terminated line, whitespaces are replaced by zeros
+ * argv		returns pointers to the arguments
+ * Returns	the number of arguments
+ */
+uint8_t console_parse(char * line, char * argv[], uint8_t maxArgs)
+{
+	uint8_t argc = 0;
+
+	while(*line && argc<maxArgs)
+	{
+		while(*line==' ' || *line=='\t') *line++ = 0;
+		if(*line==0) break;
+
+		argv[argc++] = line;
+		while(*line && *line!=' ' && *line!='\t') line++;
+		if(*line) *line++ = 0;
+	}
+	if(argc<maxArgs) argv[argc] = NULL;
+
+	return argc;
+}
+
+/*
+ * Parses and executes a command line.
+ * line		zero terminated line, modified by parsing
+ * Returns	false, if the command is unknown
+ */
+bool console_execute(char * line)
+{
+	char * argv[CONSOLE_MAXARGS+1];
+	uint8_t argc;
+	uint8_t i;
+
+	argc = console_parse(line, argv, CONSOLE_MAXARGS);
+	if(argc==0) return true;
+
+	if(strcmp(argv[0], "help")==0)
+	{
+		console_help();
+		return true;
+	}
+
+	for(i=0; i<cmdCount; i++)
+	{
+		if(strcmp(argv[0], cmdTable[i].name)==0)
+		{
+			cmdTable[i].fn(argc, argv);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Prints a string to the console.
+ */
+void console_print(const char * str)
+{
+	debug_print((char *)str);
+}
+
+/*
+ * Prints a line "name=value" of a signed value.
+ */
+void console_printValue(const char * name, int32_t value)
+{
+	console_printNum(name, value<0 ? 0U-(uint32_t)value : (uint32_t)value, value<0);
+}
+
+/*
+ * Prints a line "name=value" of an unsigned value, e.g. a counter.
+ */
+void console_printUValue(const char * name, uint32_t value)
+{
+	console_printNum(name, value, false);
+}
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Prints the command table.
+ */
+void console_help(void)
+{
+	uint8_t i;
+
+	for(i=0; i<cmdCount; i++)
+	{
+		console_print(cmdTable[i].name);
+		console_print("\t");
+		console_print(cmdTable[i].help);
+		console_print("\r\n");
+	}
+}
+
+/*
+ * Prints a line "name=value".
+ * name			the name
+ * value		magnitude of the value
+ * negative		true: a minus sign is printed
+ */
+void console_printNum(const char * name, uint32_t value, bool negative)
+{
+	char buffer[15];				/* sign, 10 digits, CR LF and terminating zero */
+	int16_t i = sizeof(buffer)-1;
+
+	buffer[i--] = 0;
+	buffer[i--] = '\n';
+	buffer[i--] = '\r';
+	do
+	{
+		buffer[i--] = (value % 10) + '0';
+		value /= 10;
+	} while(value);
+	if(negative) buffer[i--] = '-';
+
+	console_print(name);
+	console_print("=");
+	console_print(&buffer[i+1]);
+}
@@ -0,0 +1,55 @@
+/*
+ * console.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: console.h provides a line oriented command interpreter on the debug interface. Received
+ *       		characters are assembled to a line, which is split into arguments in place and dispatched
+ *       		to a command of a compile-time command table. Nothing is allocated and no function blocks,
+ *       		the commands are executed from debug_checkRX() in the main loop.
+ */
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CONSOLE_LINELEN		48		/* max. length of a command line */
+#define CONSOLE_MAXARGS		4		/* max. number of arguments including the command name */
+#define CONSOLE_PROMPT		"> "
+
+/* command function, argv[0] is the command name */
+typedef void (*console_fn_t)(uint8_t argc, char * argv[]);
+
+typedef struct {
+	const char *	name;		/* command name */
+	const char *	help;		/* one line description */
+	console_fn_t	fn;
+} console_cmd_t;
+
+
+/* Sets the command table. The table must remain valid. */
+void console_init(const console_cmd_t * table, uint8_t count);
+
+/* Processes a received character. To be set as RX hook of the debug interface. */
+void console_input(char c);
+
+/* Splits a line into whitespace separated arguments in place. Returns the number of arguments. */
+uint8_t console_parse(char * line, char * argv[], uint8_t maxArgs);
+
+/* Parses and executes a command line. Returns false, if the command is unknown. */
+bool console_execute(char * line);
+
+/* Prints a string to the console. */
+void console_print(const char * str);
+
+/* Prints a line "name=value" of a signed value. */
+void console_printValue(const char * name, int32_t value);
+
+/* Prints a line "name=value" of an unsigned value. */
+void console_printUValue(const char * name, uint32_t value);
+
+#endif /* CONSOLE_H_ */
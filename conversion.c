@@ -109,6 +109,30 @@ char * ui32ToA(uint32_t number, char * buffer, uint8_t digits)
 	return buffer;
 }
 
+/*
+ * Appends a 32 bit unsigned as decimal ascii without leading zeros and a delimiter to buffer.
+ * The buffer is not terminated.
+ * buffer	destination, at least i+11 chars
+ * i		current length of the text in buffer
+ * Returns the new length.
+ */
+uint16_t ui32AppendA(char * buffer, uint16_t i, uint32_t number, char delim)
+{
+	char tmp[10];
+	uint8_t n = 0;
+
+	do
+	{
+		tmp[n++] = (number % 10) + '0';
+		number /= 10;
+	} while(number);
+
+	while(n) buffer[i++] = tmp[--n];
+	buffer[i++] = delim;
+
+	return i;
+}
+
 /* Convert 32 bit unsigned to hex ascii. */
 char * ui32ToX(uint32_t value, char * buffer, uint8_t digits)
 {
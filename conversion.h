@@ -29,6 +29,9 @@ char * ui16ToA(uint16_t number, char * buffer, uint8_t digits, bool zero2white);
 /* Convert 32 bit unsigned to ascii. */
 char * ui32ToA(uint32_t number, char * buffer, uint8_t digits);
 
+/* Appends a 32 bit unsigned as decimal ascii and a delimiter to buffer. Returns the new length. */
+uint16_t ui32AppendA(char * buffer, uint16_t i, uint32_t number, char delim);
+
 /* Convert 32 bit unsigned to hex ascii. */
 char * ui32ToX(uint32_t value, char * buffer, uint8_t digits);
 
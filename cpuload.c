@@ -0,0 +1,160 @@
+/*
+ * cpuload.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "cpuload.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "debug.h"
+#include "conversion.h"
+
+/* ################### internal variables ################### */
+
+static uint32_t cyclesPerUs = 120;
+static uint32_t windowLen = 120000000;	/* cycles per window */
+
+static uint32_t last;					/* debug_timestamp() at the beginning of the last pass */
+static bool lastBusy = false;			/* true, if the last pass was busy */
+static uint32_t total = 0;				/* cycles in the current window */
+static uint32_t busyCycles = 0;			/* busy cycles in the current window */
+static uint32_t passes = 0;				/* passes in the current window */
+static uint32_t passMax = 0;			/* cycles of the longest busy pass in the current window */
+
+static uint16_t history[CPULOAD_WINDOWS];	/* load of the last windows in 0.1 % */
+static uint8_t histIdx = 0;
+static cpuload_t stats;
+
+/* ################### private function prototypes ################### */
+
+void cpuload_closeWindow(void);
+
+/* ################### function definitions ################### */
+
+/*
+ * Initialises the load measurement.
+ * clock	frequency of the debug timer in Hz
+ */
+void cpuload_init(uint32_t clock)
+{
+	cyclesPerUs = clock / 1000000;
+	windowLen = clock;
+	last = debug_timestamp();
+	cpuload_reset();
+}
+
+/*
+ * Accounts the duration of the previous loop pass as busy or idle time and closes the window
+ * after 1 s. The duration must be shorter than the timer period (2^32 cycles).
+ * busy		true, if a flag is pending at the beginning of this pass
+ */
+void cpuload_loop(bool busy)
+{
+	uint32_t now = debug_timestamp();
+	uint32_t dt = now - last;
+
+	last = now;
+	total += dt;
+	passes++;
+	if(lastBusy)
+	{
+		busyCycles += dt;
+		if(dt > passMax) passMax = dt;
+	}
+	lastBusy = busy;
+
+	if(total >= windowLen) cpuload_closeWindow();
+}
+
+/*
+ * Accounts the current loop pass as busy, e.g. if a poller found work during the pass.
+ * busy		true, if work was done
+ */
+void cpuload_work(bool busy)
+{
+	if(busy) lastBusy = true;
+}
+
+/*
+ * Returns the load statistics.
+ */
+cpuload_t cpuload_get(void)
+{
+	return stats;
+}
+
+/*
+ * Resets the worst-case pass duration and the load history, the current window is kept.
+ */
+void cpuload_reset(void)
+{
+	uint8_t i;
+
+	for(i=0; i<CPULOAD_WINDOWS; i++) history[i] = 0;
+	histIdx = 0;
+	stats.load1 = 0;
+	stats.load10 = 0;
+	stats.passMax = 0;
+	stats.passMaxAll = 0;
+	stats.passes = 0;
+	stats.windows = 0;
+}
+
+/*
+ * Writes the statistics as a text line.
+ * buffer	the destination, at least CPULOAD_TEXTLEN chars
+ * Returns buffer or NULL, if no window has been completed yet.
+ */
+char * cpuload_toText(char * buffer)
+{
+	uint16_t i = 0;
+
+	if(stats.windows==0) return NULL;
+
+	buffer[i++] = 'C'; buffer[i++] = 'P'; buffer[i++] = 'U'; buffer[i++] = ',';
+	i = ui32AppendA(buffer, i, stats.load1, ',');
+	i = ui32AppendA(buffer, i, stats.load10, ',');
+	i = ui32AppendA(buffer, i, stats.passMax, ',');
+	i = ui32AppendA(buffer, i, stats.passMaxAll, ',');
+	i = ui32AppendA(buffer, i, stats.passes, '\r');
+	buffer[i++] = '\n';
+	buffer[i] = 0;
+
+	return buffer;
+}
+
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Computes the load of the finished window and starts the next one.
+ */
+void cpuload_closeWindow(void)
+{
+	uint32_t sum = 0;
+	uint8_t n, i;
+
+	stats.load1 = (uint16_t)(((uint64_t)busyCycles * 1000) / total);
+	history[histIdx] = stats.load1;
+	if(++histIdx >= CPULOAD_WINDOWS) histIdx = 0;
+	stats.windows++;
+
+	n = (stats.windows < CPULOAD_WINDOWS) ? stats.windows : CPULOAD_WINDOWS;
+	for(i=0; i<CPULOAD_WINDOWS; i++) sum += history[i];
+	stats.load10 = sum / n;
+
+	stats.passMax = passMax / cyclesPerUs;
+	if(stats.passMax > stats.passMaxAll) stats.passMaxAll = stats.passMax;
+	stats.passes = passes;
+
+	total = 0;
+	busyCycles = 0;
+	passes = 0;
+	passMax = 0;
+}
+
@@ -0,0 +1,55 @@
+/*
+ * cpuload.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: cpuload.h measures the load of the main loop. Every loop pass is timed with the debug timer
+ *       		(debug_timestamp()); a pass that starts without a pending flag and in which no poller
+ *       		finds work is idle time, all other passes are busy time. The load is computed over 1 s
+ *       		windows and averaged over the last 10 windows. The longest busy pass is the worst-case
+ *       		tick duration.
+ */
+
+#ifndef CPULOAD_H_
+#define CPULOAD_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CPULOAD_WINDOWS		10		/* number of 1 s windows of the long term load */
+#define CPULOAD_TEXTLEN		(4+6*11+2+1)	/* max. length of cpuload_toText() */
+
+/* load statistics */
+typedef struct {
+	uint16_t	load1;			/* load of the last 1 s window in 0.1 % */
+	uint16_t	load10;			/* load of the last 10 s in 0.1 % */
+	uint32_t	passMax;		/* longest busy loop pass of the last 1 s window in us */
+	uint32_t	passMaxAll;		/* longest busy loop pass since reset in us */
+	uint32_t	passes;			/* loop passes of the last 1 s window */
+	uint32_t	windows;		/* number of completed 1 s windows since reset */
+} cpuload_t;
+
+/* Initialises the load measurement, clock is the frequency of the debug timer. */
+void cpuload_init(uint32_t clock);
+
+/* Accounts the previous loop pass. Call at the beginning of every main loop pass,
+ * busy=true if a flag is pending, i.e. the pass will do work. */
+void cpuload_loop(bool busy);
+
+/* Accounts the current loop pass as busy, if busy is true. For work found by polling during the pass. */
+void cpuload_work(bool busy);
+
+/* Returns the load statistics. */
+cpuload_t cpuload_get(void);
+
+/* Resets the worst-case pass duration and the load history. */
+void cpuload_reset(void);
+
+/* Writes the statistics as a text line to buffer (at least CPULOAD_TEXTLEN chars):
+ * CPU,load1,load10,passMax,passMaxAll,passes\r\n (load in 0.1 %, pass durations in us).
+ * Returns buffer or NULL, if no window has been completed yet. */
+char * cpuload_toText(char * buffer);
+
+#endif /* CPULOAD_H_ */
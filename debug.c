@@ -40,7 +40,7 @@ void debug_init(uint32_t debug_g_ui32SysClock)
 	pfnRX = debug_handleRX;
 
     /* Initialise UART for Debugging: 115200, 8N1*/
-	uart_debug = UART_init(0, debug_g_ui32SysClock, 115200, (UART_CONFIG_WLEN_8|UART_CONFIG_STOP_ONE|UART_CONFIG_PAR_NONE));
+	uart_debug = UART_init(0, debug_g_ui32SysClock, DEBUG_BAUD, (UART_CONFIG_WLEN_8|UART_CONFIG_STOP_ONE|UART_CONFIG_PAR_NONE));
 
 	debug_timer_init(debug_g_ui32SysClock);
 #endif
@@ -62,22 +62,59 @@ void debug_print(char * str)
 #endif
 }
 
-/* Checks the debug RX buffer for received data. Must be called periodically. */
-void debug_checkRX(void)
+/* Writes len bytes to the debug interface, if they fit completely into the transmit buffer.
+ * Returns false, if the data was dropped. */
+bool debug_write(const char * data, uint16_t len)
 {
 #ifndef DEBUG_OFF
-	char buffer[2];
-	if(UARTDataAvailable(uart_debug))
+	if(UARTSpace(uart_debug) < len) return false;
+	UARTWrite(uart_debug, data, len);
+	return true;
+#else
+	return false;
+#endif
+}
+
+/* Returns the free space in the debug transmit buffer. */
+uint16_t debug_space(void)
+{
+#ifndef DEBUG_OFF
+	return UARTSpace(uart_debug);
+#else
+	return 0;
+#endif
+}
+
+/* Changes the baud rate of the debug UART once all pending output is sent. Returns false if still sending. */
+bool debug_setBaud(uint32_t baud)
+{
+#ifndef DEBUG_OFF
+	return UART_setBaud(uart_debug, baud);
+#else
+	return true;
+#endif
+}
+
+/* Checks the debug RX buffer for received data and passes all received chars to the RX hook.
+ * Must be called periodically. Returns true, if data was received. */
+bool debug_checkRX(void)
+{
+#ifndef DEBUG_OFF
+	char buffer[16];
+	uint16_t getCnt, i;
+	bool received = false;
+
+	do
 	{
-		uint8_t getCnt;
-
-		getCnt = UARTGet(uart_debug, buffer, 1);
-		buffer[1] = 0;
-		if(getCnt==1)
-		{
-			pfnRX(buffer[0]);
-		}
-	}
+		getCnt = UARTRead(uart_debug, buffer, sizeof(buffer));
+		for(i=0; i<getCnt; i++)
+			pfnRX(buffer[i]);
+		if(getCnt) received = true;
+	} while(getCnt==sizeof(buffer));
+
+	return received;
+#else
+	return false;
 #endif
 }
 
@@ -127,6 +164,20 @@ void debug_printMeas(uint32_t cnt)
 #endif
 }
 
+/* Returns a free-running timestamp in clock cycles, wraps after 2^32 cycles. */
+uint32_t debug_timestamp(void)
+{
+#ifndef DEBUG_OFF
+ #ifndef DEBUG_TIMEROFF
+	return ~HWREG(TMRBASE + TIMER_O_TAR);	/* the timer counts down from 0xFFFFFFFF */
+ #else
+	return 0;
+ #endif
+#else
+	return 0;
+#endif
+}
+
 /* ---=== PRIVAT ===--- */
 
 /* Initialises timer functionality for measuring runtime. */
@@ -22,6 +22,8 @@
 #define TMRBASE		TIMER1_BASE
 #define TMRPERIPH	SYSCTL_PERIPH_TIMER1
 
+#define DEBUG_BAUD	115200		/* baud rate of the debug UART, 8N1 */
+
 /* Initialises the debug unit. */
 void debug_init(uint32_t debug_g_ui32SysClock);
 
@@ -31,8 +33,17 @@ void debug_RXHook(void (* pfnRXHook)(char c));
 /* Prints data to the debug interface. */
 void debug_print(char * str);
 
-/* Checks the debug RX buffer for received data. Must be called periodically. */
-void debug_checkRX(void);
+/* Writes len bytes to the debug interface, if they fit completely into the transmit buffer. */
+bool debug_write(const char * data, uint16_t len);
+
+/* Returns the free space in the debug transmit buffer. */
+uint16_t debug_space(void);
+
+/* Changes the baud rate of the debug UART once all pending output is sent. Returns false if still sending. */
+bool debug_setBaud(uint32_t baud);
+
+/* Checks the debug RX buffer for received data. Must be called periodically. Returns true, if data was received. */
+bool debug_checkRX(void);
 
 /* Starts the measurement of execution runtime. */
 void debug_startMeas(void);
@@ -43,5 +54,8 @@ uint32_t debug_getMeas(void);
 /* Prints the measured execution runtime (cnt) or, if cnt==0, calls debug_getMeas() internally. */
 void debug_printMeas(uint32_t cnt);
 
+/* Returns a free-running timestamp in clock cycles, wraps after 2^32 cycles. */
+uint32_t debug_timestamp(void);
+
 
 #endif /* DEBUG_H_ */
@@ -91,6 +91,15 @@ const uint32_t icon_rec[] = {	/* Record icon (Circle) */
 /* Draw the static (non-changing) text and grahpics for the selected page. */
 void display_drawStaticText(void);
 
+/* Converts a time in 1/10 s to "h:mm:ss". */
+char * display_timeToA(uint32_t t, char * buf);
+
+/* Converts a time in ms to "mm:ss.sss". */
+char * display_msToA(uint32_t t, char * buf);
+
+/* Converts a value in tenths to "ddd.d". */
+char * display_tenthsToA(uint32_t t, uint8_t digits, char * buf);
+
 /* Draws the battery icon. */
 void draw_Battery(bool forceshow);
 /* Hides the battery icon. */
@@ -133,7 +142,7 @@ void display_init(uint32_t g_ui32SysClock)
  */
 void display_initContent(void)
 {
-	oled_fillScreen(syscolors[back]);
+	oled_fillRectAsync(0, 0, SSD1351WIDTH, SSD1351HEIGHT, syscolors[back]);
 	display_GPS(0, 0, 99);
 	display_SDMissing();
 	display_Battery(0);
@@ -167,93 +176,154 @@ void display_Time(uint8_t hr, uint8_t min, uint8_t sec)
 }
 
 /*
- * Draw the static (non-changing) text and grahpics for the selected page.
+ * Draw the static (non-changing) text and grahpics for the selected page. They are queued as SPI
+ * transactions, so the main loop continues while the page is sent.
  */
 void display_drawStaticText(void)
 {
-	oled_fillRect(0, 13, SSD1351WIDTH, SSD1351HEIGHT-13, syscolors[back]);
+	oled_fillRectAsync(0, 13, SSD1351WIDTH, SSD1351HEIGHT-13, syscolors[back]);
 
 	if(page==0)
 	{
 		/* Stopwatch */
-		oled_drawtext("Stopwatch", syscolors[textstat], syscolors[back], GP_STPWX, GP_STPWY);
-		oled_drawtext_big(":", syscolors[text], syscolors[back], GP_STPWX+22, GP_STPWY+9);
-		oled_drawtext_big(":", syscolors[text], syscolors[back], GP_STPWX+55, GP_STPWY+9);
-		oled_drawtext_big(".", syscolors[text], syscolors[back], GP_STPWX+88, GP_STPWY+9);
+		oled_drawtextAsync("Stopwatch", syscolors[textstat], syscolors[back], GP_STPWX, GP_STPWY);
+		oled_drawtextAsync_big(":", syscolors[text], syscolors[back], GP_STPWX+22, GP_STPWY+9);
+		oled_drawtextAsync_big(":", syscolors[text], syscolors[back], GP_STPWX+55, GP_STPWY+9);
+		oled_drawtextAsync_big(".", syscolors[text], syscolors[back], GP_STPWX+88, GP_STPWY+9);
 		/* Altitude */
-		oled_drawtext("Altitude", syscolors[textstat], syscolors[back], GP_ALTX, GP_ALTY);
-		oled_drawtext("m", syscolors[textstat], syscolors[back], GP_ALTX+45, GP_ALTY+15);
-		oled_drawtext("Up", syscolors[textstat], syscolors[back], GP_ALTX+55, GP_ALTY+6);
-		oled_drawtext("Dwn", syscolors[textstat], syscolors[back], GP_ALTX+55, GP_ALTY+15);
-		oled_drawtext("m", syscolors[textstat], syscolors[back], GP_ALTX+104, GP_ALTY+6);
-		oled_drawtext("m", syscolors[textstat], syscolors[back], GP_ALTX+104, GP_ALTY+15);
+		oled_drawtextAsync("Altitude", syscolors[textstat], syscolors[back], GP_ALTX, GP_ALTY);
+		oled_drawtextAsync("m", syscolors[textstat], syscolors[back], GP_ALTX+45, GP_ALTY+15);
+		oled_drawtextAsync("Up", syscolors[textstat], syscolors[back], GP_ALTX+55, GP_ALTY+6);
+		oled_drawtextAsync("Dwn", syscolors[textstat], syscolors[back], GP_ALTX+55, GP_ALTY+15);
+		oled_drawtextAsync("m", syscolors[textstat], syscolors[back], GP_ALTX+104, GP_ALTY+6);
+		oled_drawtextAsync("m", syscolors[textstat], syscolors[back], GP_ALTX+104, GP_ALTY+15);
 		/* Speed */
-		oled_drawtext("Speed", syscolors[textstat], syscolors[back], GP_SPDX, GP_SPDY);
-		oled_drawtext("km", syscolors[textstat], syscolors[back], GP_SPDX+34, GP_SPDY+6);
-		oled_drawHLine(GP_SPDX+34, GP_SPDY+14, 11, syscolors[textstat]);
-		oled_drawtext("h", syscolors[textstat], syscolors[back], GP_SPDX+36, GP_SPDY+15);
-		oled_drawtext("Avg", syscolors[textstat], syscolors[back], GP_SPDX+55, GP_SPDY+6);
-		oled_drawtext("Max", syscolors[textstat], syscolors[back], GP_SPDX+55, GP_SPDY+15);
-		oled_drawtext("km/h", syscolors[textstat], syscolors[back], GP_SPDX+98, GP_SPDY+6);
-		oled_drawtext("km/h", syscolors[textstat], syscolors[back], GP_SPDX+98, GP_SPDY+15);
+		oled_drawtextAsync("Speed", syscolors[textstat], syscolors[back], GP_SPDX, GP_SPDY);
+		oled_drawtextAsync("km", syscolors[textstat], syscolors[back], GP_SPDX+34, GP_SPDY+6);
+		oled_fillRectAsync(GP_SPDX+34, GP_SPDY+14, 11, 1, syscolors[textstat]);
+		oled_drawtextAsync("h", syscolors[textstat], syscolors[back], GP_SPDX+36, GP_SPDY+15);
+		oled_drawtextAsync("Avg", syscolors[textstat], syscolors[back], GP_SPDX+55, GP_SPDY+6);
+		oled_drawtextAsync("Max", syscolors[textstat], syscolors[back], GP_SPDX+55, GP_SPDY+15);
+		oled_drawtextAsync("km/h", syscolors[textstat], syscolors[back], GP_SPDX+98, GP_SPDY+6);
+		oled_drawtextAsync("km/h", syscolors[textstat], syscolors[back], GP_SPDX+98, GP_SPDY+15);
 		/* Distance */
-		oled_drawtext("Distance", syscolors[textstat], syscolors[back], GP_DISTX, GP_DISTY);
-		oled_drawtext("km", syscolors[textstat], syscolors[back], GP_DISTX+34, GP_DISTY+15);
-		oled_drawtext("m", syscolors[textstat], syscolors[back], GP_DISTX+81, GP_DISTY+15);
+		oled_drawtextAsync("Distance", syscolors[textstat], syscolors[back], GP_DISTX, GP_DISTY);
+		oled_drawtextAsync("km", syscolors[textstat], syscolors[back], GP_DISTX+34, GP_DISTY+15);
+		oled_drawtextAsync("m", syscolors[textstat], syscolors[back], GP_DISTX+81, GP_DISTY+15);
 	}
 	else if(page==1)
 	{
 		/* Time to first fix */
-		oled_drawtext("Time To First Fix", syscolors[textstat], syscolors[back], GP_TTFFX, GP_TTFFY);
-		oled_drawtext("m", syscolors[textstat], syscolors[back], GP_TTFFX+18, GP_TTFFY+9);
-		oled_drawtext("s", syscolors[textstat], syscolors[back], GP_TTFFX+42, GP_TTFFY+9);
+		oled_drawtextAsync("Time To First Fix", syscolors[textstat], syscolors[back], GP_TTFFX, GP_TTFFY);
+		oled_drawtextAsync("m", syscolors[textstat], syscolors[back], GP_TTFFX+18, GP_TTFFY+9);
+		oled_drawtextAsync("s", syscolors[textstat], syscolors[back], GP_TTFFX+42, GP_TTFFY+9);
 		
 		/* Time Since Reset */
-		oled_drawtext("Time Since Reset", syscolors[textstat], syscolors[back], GP_TSRX, GP_TSRY);
-		oled_drawtext("d", syscolors[text], syscolors[back], GP_TSRX+24, GP_TSRY+9);
-		oled_drawtext(":", syscolors[text], syscolors[back], GP_TSRX+48, GP_TSRY+9);
-		oled_drawtext(":", syscolors[text], syscolors[back], GP_TSRX+66, GP_TSRY+9);
+		oled_drawtextAsync("Time Since Reset", syscolors[textstat], syscolors[back], GP_TSRX, GP_TSRY);
+		oled_drawtextAsync("d", syscolors[text], syscolors[back], GP_TSRX+24, GP_TSRY+9);
+		oled_drawtextAsync(":", syscolors[text], syscolors[back], GP_TSRX+48, GP_TSRY+9);
+		oled_drawtextAsync(":", syscolors[text], syscolors[back], GP_TSRX+66, GP_TSRY+9);
 
 		/* Satellite Info */
-		oled_drawtext("Vw/Fx PDOP/HDOP/VDOP", syscolors[textstat], syscolors[back], GP_SATX, GP_SATY);
-		oled_drawtext("/", syscolors[textstat], syscolors[back], GP_SATX+12, GP_SATY+9);
-		oled_drawtext("/", syscolors[textstat], syscolors[back], GP_SATX+60, GP_SATY+9);
-		oled_drawtext("/", syscolors[textstat], syscolors[back], GP_SATX+90, GP_SATY+9);
+		oled_drawtextAsync("Vw/Fx PDOP/HDOP/VDOP", syscolors[textstat], syscolors[back], GP_SATX, GP_SATY);
+		oled_drawtextAsync("/", syscolors[textstat], syscolors[back], GP_SATX+12, GP_SATY+9);
+		oled_drawtextAsync("/", syscolors[textstat], syscolors[back], GP_SATX+60, GP_SATY+9);
+		oled_drawtextAsync("/", syscolors[textstat], syscolors[back], GP_SATX+90, GP_SATY+9);
 
 		/* Fix Info */
-		oled_drawtext("Fix Type/Quality", syscolors[textstat], syscolors[back], GP_FIXX, GP_FIXY);
-		oled_drawtext("fix", syscolors[text], syscolors[back], GP_FIXX+18, GP_FIXY+9);
+		oled_drawtextAsync("Fix Type/Quality", syscolors[textstat], syscolors[back], GP_FIXX, GP_FIXY);
+		oled_drawtextAsync("fix", syscolors[text], syscolors[back], GP_FIXX+18, GP_FIXY+9);
 
 
 		/* Lat/Lon Position */
-		oled_drawtext("Latitude", syscolors[textstat], syscolors[back], GP_LLX, GP_LLY);
-		oled_drawtext("Longitude", syscolors[textstat], syscolors[back], GP_LLX, GP_LLY+18);
-		oled_drawtext(".", syscolors[text], syscolors[back], GP_LLX+18, GP_LLY+9);
-		oled_drawtext(".", syscolors[text], syscolors[back], GP_LLX+18, GP_LLY+27);
-		oled_drawtext("`", syscolors[text], syscolors[back], GP_LLX+54, GP_LLY+9);	/* '`' is substitude symbol for '°' */
-		oled_drawtext("`", syscolors[text], syscolors[back], GP_LLX+54, GP_LLY+27);
+		oled_drawtextAsync("Latitude", syscolors[textstat], syscolors[back], GP_LLX, GP_LLY);
+		oled_drawtextAsync("Longitude", syscolors[textstat], syscolors[back], GP_LLX, GP_LLY+18);
+		oled_drawtextAsync(".", syscolors[text], syscolors[back], GP_LLX+18, GP_LLY+9);
+		oled_drawtextAsync(".", syscolors[text], syscolors[back], GP_LLX+18, GP_LLY+27);
+		oled_drawtextAsync("`", syscolors[text], syscolors[back], GP_LLX+54, GP_LLY+9);	/* '`' is substitude symbol for '°' */
+		oled_drawtextAsync("`", syscolors[text], syscolors[back], GP_LLX+54, GP_LLY+27);
 	}
 	else if(page==2)
 	{
 		/* Satellites Overview */
-		oled_drawtext("Satellites Overview", syscolors[textstat], syscolors[back], GP_SATOVX, GP_SATOVY);
-		oled_drawHLine(GP_SATOVX, GP_SATOVY+9, 126, syscolors[textstat]);		/* draw grid */
-		oled_drawHLine(GP_SATOVX, GP_SATOVY+29, 126, syscolors[textstat]);
-		oled_drawHLine(GP_SATOVX, GP_SATOVY+49, 126, syscolors[textstat]);
-		oled_drawHLine(GP_SATOVX, GP_SATOVY+69, 126, syscolors[textstat]);
-		oled_drawHLine(GP_SATOVX, GP_SATOVY+89, 126, syscolors[textstat]);
-		oled_drawVLine(GP_SATOVX+0, GP_SATOVY+9, 80, syscolors[textstat]);
-		oled_drawVLine(GP_SATOVX+14, GP_SATOVY+9, 80, syscolors[textstat]);
-		oled_drawVLine(GP_SATOVX+28, GP_SATOVY+9, 80, syscolors[textstat]);
-		oled_drawVLine(GP_SATOVX+42, GP_SATOVY+9, 80, syscolors[textstat]);
-		oled_drawVLine(GP_SATOVX+56, GP_SATOVY+9, 80, syscolors[textstat]);
-		oled_drawVLine(GP_SATOVX+70, GP_SATOVY+9, 80, syscolors[textstat]);
-		oled_drawVLine(GP_SATOVX+84, GP_SATOVY+9, 80, syscolors[textstat]);
-		oled_drawVLine(GP_SATOVX+98, GP_SATOVY+9, 80, syscolors[textstat]);
-		oled_drawVLine(GP_SATOVX+112, GP_SATOVY+9, 80, syscolors[textstat]);
-		oled_drawVLine(GP_SATOVX+126, GP_SATOVY+9, 80, syscolors[textstat]);
+		oled_drawtextAsync("Satellites Overview", syscolors[textstat], syscolors[back], GP_SATOVX, GP_SATOVY);
+		oled_fillRectAsync(GP_SATOVX, GP_SATOVY+9, 126, 1, syscolors[textstat]);		/* draw grid */
+		oled_fillRectAsync(GP_SATOVX, GP_SATOVY+29, 126, 1, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX, GP_SATOVY+49, 126, 1, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX, GP_SATOVY+69, 126, 1, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX, GP_SATOVY+89, 126, 1, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX+0, GP_SATOVY+9, 1, 80, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX+14, GP_SATOVY+9, 1, 80, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX+28, GP_SATOVY+9, 1, 80, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX+42, GP_SATOVY+9, 1, 80, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX+56, GP_SATOVY+9, 1, 80, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX+70, GP_SATOVY+9, 1, 80, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX+84, GP_SATOVY+9, 1, 80, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX+98, GP_SATOVY+9, 1, 80, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX+112, GP_SATOVY+9, 1, 80, syscolors[textstat]);
+		oled_fillRectAsync(GP_SATOVX+126, GP_SATOVY+9, 1, 80, syscolors[textstat]);
 	}
 	else if(page==3)
+	{
+		/* Distance To Go */
+		oled_drawtextAsync("Distance To Go", syscolors[textstat], syscolors[back], GP_RTEDTGX, GP_RTEDTGY);
+		oled_drawtextAsync("km", syscolors[textstat], syscolors[back], GP_RTEDTGX+34, GP_RTEDTGY+15);
+		oled_drawtextAsync("m", syscolors[textstat], syscolors[back], GP_RTEDTGX+81, GP_RTEDTGY+15);
+		/* Cross Track Error */
+		oled_drawtextAsync("Cross Track", syscolors[textstat], syscolors[back], GP_RTEXTEX, GP_RTEXTEY);
+		oled_drawtextAsync("m", syscolors[textstat], syscolors[back], GP_RTEXTEX+56, GP_RTEXTEY+15);
+		/* Next Turn */
+		oled_drawtextAsync("Next Turn", syscolors[textstat], syscolors[back], GP_RTETRNX, GP_RTETRNY);
+		oled_drawtextAsync("`", syscolors[textstat], syscolors[back], GP_RTETRNX+34, GP_RTETRNY+9);
+		oled_drawtextAsync("in", syscolors[textstat], syscolors[back], GP_RTETRNX+55, GP_RTETRNY+15);
+		oled_drawtextAsync("m", syscolors[textstat], syscolors[back], GP_RTETRNX+104, GP_RTETRNY+15);
+		/* Route State */
+		oled_drawtextAsync("Route", syscolors[textstat], syscolors[back], GP_RTESTX, GP_RTESTY);
+	}
+	else if(page==4)
+	{
+		/* Best Splits, labels are drawn by display_Split */
+	}
+	else if(page==5)
+	{
+		/* Segment */
+		oled_drawtextAsync("Segment", syscolors[textstat], syscolors[back], GP_SEGX, GP_SEGY);
+		oled_drawtextAsync("Time", syscolors[textstat], syscolors[back], GP_SEGTIMEX, GP_SEGTIMEY);
+		oled_drawtextAsync("Delta To Best", syscolors[textstat], syscolors[back], GP_SEGDELTAX, GP_SEGDELTAY);
+		oled_drawtextAsync("Best", syscolors[textstat], syscolors[back], GP_SEGBESTX, GP_SEGBESTY);
+		oled_drawtextAsync("Progress", syscolors[textstat], syscolors[back], GP_SEGBESTX+64, GP_SEGBESTY);
+		oled_drawtextAsync("%", syscolors[textstat], syscolors[back], GP_SEGBESTX+88, GP_SEGBESTY+9);
+	}
+	else if(page==6)
+	{
+		/* Lap Timer */
+		oled_drawtextAsync("Lap", syscolors[textstat], syscolors[back], GP_LAPX, GP_LAPY);
+		oled_drawtextAsync("Last", syscolors[textstat], syscolors[back], GP_LAPSTATX, GP_LAPSTATY);
+		oled_drawtextAsync("Best", syscolors[textstat], syscolors[back], GP_LAPSTATX, GP_LAPSTATY+9);
+		oled_drawtextAsync("Worst", syscolors[textstat], syscolors[back], GP_LAPSTATX, GP_LAPSTATY+18);
+		oled_drawtextAsync("Delta", syscolors[textstat], syscolors[back], GP_LAPSTATX, GP_LAPSTATY+27);
+	}
+	else if(page==7)
+	{
+		/* Main Loop Load */
+		oled_drawtextAsync("CPU Load", syscolors[textstat], syscolors[back], GP_DIAGLOADX, GP_DIAGLOADY);
+		oled_drawtextAsync("%", syscolors[textstat], syscolors[back], GP_DIAGLOADX+46, GP_DIAGLOADY+15);
+		oled_drawtextAsync("10s", syscolors[textstat], syscolors[back], GP_DIAGLOADX+82, GP_DIAGLOADY+6);
+		oled_drawtextAsync("%", syscolors[textstat], syscolors[back], GP_DIAGLOADX+112, GP_DIAGLOADY+15);
+		/* Worst Loop Pass */
+		oled_drawtextAsync("Worst Loop Pass", syscolors[textstat], syscolors[back], GP_DIAGPASSX, GP_DIAGPASSY);
+		oled_drawtextAsync("ms", syscolors[textstat], syscolors[back], GP_DIAGPASSX+40, GP_DIAGPASSY+9);
+		oled_drawtextAsync("Max", syscolors[textstat], syscolors[back], GP_DIAGPASSX+54, GP_DIAGPASSY+9);
+		oled_drawtextAsync("ms", syscolors[textstat], syscolors[back], GP_DIAGPASSX+112, GP_DIAGPASSY+9);
+		/* Stack Usage */
+		oled_drawtextAsync("Stack Max/Size", syscolors[textstat], syscolors[back], GP_DIAGSTACKX, GP_DIAGSTACKY);
+		oled_drawtextAsync("/", syscolors[textstat], syscolors[back], GP_DIAGSTACKX+30, GP_DIAGSTACKY+9);
+		oled_drawtextAsync("bytes", syscolors[textstat], syscolors[back], GP_DIAGSTACKX+72, GP_DIAGSTACKY+9);
+		/* Loop Passes */
+		oled_drawtextAsync("Loop Passes/s", syscolors[textstat], syscolors[back], GP_DIAGLOOPX, GP_DIAGLOOPY);
+		oled_drawtextAsync("k", syscolors[textstat], syscolors[back], GP_DIAGLOOPX+118, GP_DIAGLOOPY);
+	}
+	else if(page==GP_CONFPAGE)
 	{
 		display_conf(-1, sSelection);
 	}
@@ -324,6 +394,35 @@ void display_Dist(int32_t Dist)
 	oled_drawtext_big(ui16ToA(m, buffer, 3, true), syscolors[text], syscolors[back], GP_DISTX+47, GP_DISTY+9);
 }
 
+/*
+ * Draws the time gap to the ghost next to the distance label.
+ * valid	true, if a ghost is loaded and the gap is known
+ * gap		the time gap in 1/10 s, positive if behind the ghost
+ */
+void display_Ghost(bool valid, int32_t gap)
+{
+	uint16_t col;
+
+	if(!((1<<page) & GP_GHOSTPAGE)) return;
+
+	if(!valid)
+	{
+		oled_fillRect(GP_GHOSTX, GP_GHOSTY, SSD1351WIDTH-GP_GHOSTX, 8, syscolors[back]);
+		return;
+	}
+
+	if(gap<0) { gap = -gap; col = colors[green]; buffer[0] = '-'; }
+	else { col = (gap>0) ? colors[red] : syscolors[text]; buffer[0] = '+'; }
+	gap /= 10;
+	if(gap>5999) gap = 5999;
+
+	ui8ToA(gap/60, &buffer[1], 2);
+	buffer[3] = ':';
+	ui8ToA(gap%60, &buffer[4], 2);
+	oled_drawtext("Ghost", syscolors[textstat], syscolors[back], GP_GHOSTX, GP_GHOSTY);
+	oled_drawtext(buffer, col, syscolors[back], GP_GHOSTX+34, GP_GHOSTY);
+}
+
 /* 
  * Draws the Time since reset on the display. 
  * d, h, m, s		days, hours, minutes and seconds since reset.
@@ -520,6 +619,107 @@ void display_Satov(uint8_t satViewNum, uint8_t satFixNum, uint8_t * satsView, ui
 	
 }
 
+/*
+ * Draws the route following data.
+ * state		the route state (0=no route, 1=acquiring, 2=on route, 3=off route)
+ * distToGo		remaining distance along the route in m
+ * xte			cross track error in m, positive if right of the route
+ * turnBrg		bearing after the next turn in degree
+ * turnDist		distance to the next turn in m
+ */
+void display_Route(uint8_t state, uint32_t distToGo, int32_t xte, uint16_t turnBrg, uint32_t turnDist)
+{
+	uint16_t col;
+
+	if(!((1<<page) & GP_RTEPAGE)) return;
+
+	switch(state)
+	{
+	case 1: oled_drawtext("acquiring", syscolors[text], syscolors[back], GP_RTESTX, GP_RTESTY+9); break;
+	case 2: oled_drawtext("on route ", colors[green], syscolors[back], GP_RTESTX, GP_RTESTY+9); break;
+	case 3: oled_drawtext("off route", colors[red], syscolors[back], GP_RTESTX, GP_RTESTY+9); break;
+	default:oled_drawtext("no route ", syscolors[textstat], syscolors[back], GP_RTESTX, GP_RTESTY+9); break;
+	}
+	if(state!=2) col = syscolors[textstat]; else col = syscolors[text];
+
+	if(distToGo>999999) distToGo = 999999;
+	oled_drawtext_big(ui16ToA(distToGo/1000, buffer, 3, true), col, syscolors[back], GP_RTEDTGX, GP_RTEDTGY+9);
+	oled_drawtext_big(ui16ToA(distToGo%1000, buffer, 3, true), col, syscolors[back], GP_RTEDTGX+47, GP_RTEDTGY+9);
+
+	if(xte<0) { xte = -xte; buffer[0] = 'L'; } else buffer[0] = 'R';
+	if(xte>9999) xte = 9999;
+	buffer[1] = 0;
+	oled_drawtext_big(buffer, col, syscolors[back], GP_RTEXTEX, GP_RTEXTEY+9);
+	oled_drawtext_big(ui16ToA(xte, buffer, 4, true), col, syscolors[back], GP_RTEXTEX+11, GP_RTEXTEY+9);
+
+	if(turnDist>9999) turnDist = 9999;
+	oled_drawtext_big(ui16ToA(turnBrg, buffer, 3, true), col, syscolors[back], GP_RTETRNX, GP_RTETRNY+9);
+	oled_drawtext(ui16ToA(turnDist, buffer, 4, true), col, syscolors[back], GP_RTETRNX+79, GP_RTETRNY+15);
+}
+
+/*
+ * Draws the best and the most recent time of a split.
+ * idx		the split index, selects the row on the page
+ * dist		the split distance in km
+ * best		fastest time in 1/10 s, 0 if not yet covered
+ * last		time of the most recent window in 1/10 s, 0 if not yet covered
+ */
+void display_Split(uint8_t idx, uint16_t dist, uint32_t best, uint32_t last)
+{
+	uint8_t y;
+
+	if(!((1<<page) & GP_SPLITPAGE)) return;
+	if(idx>2) return;
+	y = GP_SPLITY + idx*GP_SPLITDY;
+
+	oled_drawtext("Best", syscolors[textstat], syscolors[back], GP_SPLITX, y);
+	oled_drawtext(ui16ToA(dist, buffer, 3, true), syscolors[textstat], syscolors[back], GP_SPLITX+24, y);
+	oled_drawtext("km", syscolors[textstat], syscolors[back], GP_SPLITX+42, y);
+	oled_drawtext("Last", syscolors[textstat], syscolors[back], GP_SPLITX+82, y+6);
+
+	oled_drawtext_big(display_timeToA(best, buffer), syscolors[text], syscolors[back], GP_SPLITX, y+9);
+
+	oled_drawtext(display_timeToA(last, buffer), syscolors[textstat], syscolors[back], GP_SPLITX+82, y+15);
+}
+
+/*
+ * Draws the current or last segment effort.
+ * state		0=none, 1=effort active, 2=effort finished
+ * name			the segment name
+ * elapsed		elapsed or final time in 1/10 s
+ * delta		difference to the best effort in 1/10 s, positive if slower
+ * best			best effort in 1/10 s, 0 if none
+ * progress		progress in percent
+ */
+void display_Segment(uint8_t state, char * name, uint32_t elapsed, int32_t delta, uint32_t best, uint8_t progress)
+{
+	uint16_t col;
+
+	if(!((1<<page) & GP_SEGPAGE)) return;
+
+	if(state==0)
+	{
+		oled_drawtext("none        ", syscolors[textstat], syscolors[back], GP_SEGX+48, GP_SEGY);
+		elapsed = 0; delta = 0; best = 0; progress = 0;
+	}
+	else
+	{
+		oled_drawtext("            ", syscolors[text], syscolors[back], GP_SEGX+48, GP_SEGY);
+		oled_drawtext(name, (state==2) ? colors[green] : syscolors[text], syscolors[back], GP_SEGX+48, GP_SEGY);
+	}
+
+	oled_drawtext_big(display_timeToA(elapsed, buffer), syscolors[text], syscolors[back], GP_SEGTIMEX, GP_SEGTIMEY+9);
+
+	if(delta<0) { delta = -delta; col = colors[green]; buffer[0] = '-'; }
+	else { col = (delta>0) ? colors[red] : syscolors[text]; buffer[0] = '+'; }
+	buffer[1] = 0;
+	oled_drawtext_big(buffer, col, syscolors[back], GP_SEGDELTAX, GP_SEGDELTAY+9);
+	oled_drawtext_big(display_timeToA(delta, buffer), col, syscolors[back], GP_SEGDELTAX+11, GP_SEGDELTAY+9);
+
+	oled_drawtext(display_timeToA(best, buffer), syscolors[text], syscolors[back], GP_SEGBESTX, GP_SEGBESTY+9);
+	oled_drawtext(ui8ToA(progress, buffer, 3), syscolors[text], syscolors[back], GP_SEGBESTX+64, GP_SEGBESTY+9);
+}
+
 /* ================================================= */
 
 /* 
@@ -721,6 +921,119 @@ void display_blink_fast(void)
 	}
 }
 
+/*
+ * Draws the lap timer.
+ * lap			number of the running lap
+ * current		running time of the current lap in ms
+ * last			time of the last finished lap in ms
+ * best			time of the best lap in ms
+ * worst		time of the worst lap in ms
+ * delta		last lap compared to the best lap in ms
+ */
+void display_Laps(uint16_t lap, uint32_t current, uint32_t last, uint32_t best, uint32_t worst, int32_t delta)
+{
+	uint16_t col;
+
+	if(!((1<<page) & GP_LAPPAGE)) return;
+
+	oled_drawtext(ui16ToA(lap, buffer, 4, false), syscolors[text], syscolors[back], GP_LAPX+24, GP_LAPY);
+	oled_drawtext_big(display_msToA(current, buffer), syscolors[text], syscolors[back], GP_LAPX, GP_LAPY+9);
+
+	oled_drawtext(display_msToA(last, buffer), syscolors[text], syscolors[back], GP_LAPSTATX+36, GP_LAPSTATY);
+	oled_drawtext(display_msToA(best, buffer), colors[green], syscolors[back], GP_LAPSTATX+36, GP_LAPSTATY+9);
+	oled_drawtext(display_msToA(worst, buffer), colors[red], syscolors[back], GP_LAPSTATX+36, GP_LAPSTATY+18);
+
+	if(delta<0) { delta = -delta; buffer[0] = '-'; } else buffer[0] = '+';
+	col = (delta>0) ? colors[red] : syscolors[text];
+	buffer[1] = 0;
+	oled_drawtext(buffer, col, syscolors[back], GP_LAPSTATX+30, GP_LAPSTATY+27);
+	oled_drawtext(display_msToA(delta, buffer), col, syscolors[back], GP_LAPSTATX+36, GP_LAPSTATY+27);
+}
+
+/*
+ * Draws the diagnostics page.
+ * load1		main loop load of the last second in 0.1 %
+ * load10		main loop load of the last 10 seconds in 0.1 %
+ * passMax		longest loop pass of the last second in us
+ * passMaxAll	longest loop pass since reset in us
+ * passes		loop passes in the last second, shown in thousands
+ * stackUsed	maximum stack usage since startup in bytes
+ * stackSize	stack size in bytes
+ */
+void display_Diag(uint16_t load1, uint16_t load10, uint32_t passMax, uint32_t passMaxAll, uint32_t passes,
+		uint32_t stackUsed, uint32_t stackSize)
+{
+	if(!((1<<page) & GP_DIAGPAGE)) return;
+
+	if(load1>999) load1 = 999;
+	oled_drawtext_big(ui16ToA(load1/10, buffer, 2, true), syscolors[text], syscolors[back], GP_DIAGLOADX, GP_DIAGLOADY+9);
+	oled_drawtext_big(".", syscolors[text], syscolors[back], GP_DIAGLOADX+22, GP_DIAGLOADY+9);
+	oled_drawtext_big(ui8ToA(load1%10, buffer, 1), syscolors[text], syscolors[back], GP_DIAGLOADX+33, GP_DIAGLOADY+9);
+	oled_drawtext(display_tenthsToA(load10, 3, buffer), syscolors[text], syscolors[back], GP_DIAGLOADX+82, GP_DIAGLOADY+15);
+
+	oled_drawtext(display_tenthsToA(passMax/100, 4, buffer), syscolors[text], syscolors[back], GP_DIAGPASSX, GP_DIAGPASSY+9);
+	oled_drawtext(display_tenthsToA(passMaxAll/100, 4, buffer), syscolors[text], syscolors[back], GP_DIAGPASSX+74, GP_DIAGPASSY+9);
+
+	oled_drawtext(ui16ToA(stackUsed, buffer, 5, true), syscolors[text], syscolors[back], GP_DIAGSTACKX, GP_DIAGSTACKY+9);
+	oled_drawtext(ui16ToA(stackSize, buffer, 5, true), syscolors[text], syscolors[back], GP_DIAGSTACKX+36, GP_DIAGSTACKY+9);
+
+	oled_drawtext(display_tenthsToA(passes/100, 4, buffer), syscolors[text], syscolors[back], GP_DIAGLOOPX+82, GP_DIAGLOOPY);
+}
+
+/*
+ * Converts a time in 1/10 s to "h:mm:ss", times above 9:59:59 are limited.
+ * t		the time in 1/10 s
+ * buf		the destination, min. 8 chars
+ */
+char * display_timeToA(uint32_t t, char * buf)
+{
+	if(t>359999) t = 359999;
+
+	ui8ToA(t/36000, buf, 1);
+	buf[1] = ':';
+	ui8ToA((t/600)%60, &buf[2], 2);
+	buf[4] = ':';
+	ui8ToA((t/10)%60, &buf[5], 2);
+	return buf;
+}
+
+/*
+ * Converts a time in ms to "mm:ss.sss", times above 99:59.999 are limited.
+ * t		the time in ms
+ * buf		the destination, min. 10 chars
+ */
+char * display_msToA(uint32_t t, char * buf)
+{
+	if(t>5999999) t = 5999999;
+
+	ui8ToA(t/60000, buf, 2);
+	buf[2] = ':';
+	ui8ToA((t/1000)%60, &buf[3], 2);
+	buf[5] = '.';
+	ui16ToA(t%1000, &buf[6], 3, false);
+	return buf;
+}
+
+/*
+ * Converts a value in tenths to "ddd.d" with leading blanks, larger values are limited.
+ * t		the value in tenths
+ * digits	the number of integer digits (1-4)
+ * buf		the destination, min. digits+3 chars
+ */
+char * display_tenthsToA(uint32_t t, uint8_t digits, char * buf)
+{
+	uint32_t max = 10;
+	uint8_t i;
+
+	for(i=0; i<digits; i++) max *= 10;
+	if(t>=max) t = max-1;
+
+	ui16ToA(t/10, buf, digits, true);
+	buf[digits] = '.';
+	ui8ToA(t%10, &buf[digits+1], 1);
+	return buf;
+}
+
 /* ================================================= */
 /* Configuration */
 
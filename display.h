@@ -16,30 +16,35 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-/* Bitmasks for Page 1 - Page 3 */
+/* Bitmasks for Page 1 - Page 8 */
 #define GP_P1_bm		(1<<0)
 #define GP_P2_bm		(1<<1)
 #define GP_P3_bm		(1<<2)
 #define GP_P4_bm		(1<<3)
+#define GP_P5_bm		(1<<4)
+#define GP_P6_bm		(1<<5)
+#define GP_P7_bm		(1<<6)
+#define GP_P8_bm		(1<<7)
+#define GP_P9_bm		(1<<8)
 
 /* Status Line */
 #define GP_SDX			106
 #define GP_SDY			0
-#define GP_SDPAGE		GP_P1_bm|GP_P2_bm|GP_P3_bm|GP_P4_bm
+#define GP_SDPAGE		GP_P1_bm|GP_P2_bm|GP_P3_bm|GP_P4_bm|GP_P5_bm|GP_P6_bm|GP_P7_bm|GP_P8_bm|GP_P9_bm
 
 #define GP_GPSX			78
 #define GP_GPSY			0
-#define GP_GPSPAGE		GP_P1_bm|GP_P2_bm|GP_P3_bm|GP_P4_bm
+#define GP_GPSPAGE		GP_P1_bm|GP_P2_bm|GP_P3_bm|GP_P4_bm|GP_P5_bm|GP_P6_bm|GP_P7_bm|GP_P8_bm|GP_P9_bm
 #define GP_DOPTHRESHR	60
 #define GP_DOPTHRESHY	25
 
 #define GP_BATTX		56
 #define GP_BATTY		0
-#define GP_BATTPAGE		GP_P1_bm|GP_P2_bm|GP_P3_bm|GP_P4_bm
+#define GP_BATTPAGE		GP_P1_bm|GP_P2_bm|GP_P3_bm|GP_P4_bm|GP_P5_bm|GP_P6_bm|GP_P7_bm|GP_P8_bm|GP_P9_bm
 
 #define GP_TIMEX		0
 #define GP_TIMEY		1
-#define GP_TIMEPAGE		GP_P1_bm|GP_P2_bm|GP_P3_bm|GP_P4_bm
+#define GP_TIMEPAGE		GP_P1_bm|GP_P2_bm|GP_P3_bm|GP_P4_bm|GP_P5_bm|GP_P6_bm|GP_P7_bm|GP_P8_bm|GP_P9_bm
 
 /* PAGE 0 */
 #define GP_STPWX		2
@@ -58,6 +63,10 @@
 #define GP_DISTY		(GP_SPDY+27)
 #define GP_DISTPAGE		GP_P1_bm
 
+#define GP_GHOSTX		56				/* ghost gap, next to the distance label */
+#define GP_GHOSTY		GP_DISTY
+#define GP_GHOSTPAGE	GP_P1_bm
+
 /* PAGE 1 */
 #define GP_TTFFX		2				/* Time to first fix */
 #define GP_TTFFY		13
@@ -85,7 +94,52 @@
 #define GP_SATOVPAGE	GP_P3_bm
 
 /* PAGE 3 */
-
+#define GP_RTEDTGX		2				/* route distance to go */
+#define GP_RTEDTGY		13
+#define GP_RTEXTEX		2				/* route cross track error */
+#define GP_RTEXTEY		(GP_RTEDTGY+27)
+#define GP_RTETRNX		2				/* route next turn */
+#define GP_RTETRNY		(GP_RTEXTEY+27)
+#define GP_RTESTX		2				/* route state */
+#define GP_RTESTY		(GP_RTETRNY+27)
+#define GP_RTEPAGE		GP_P4_bm
+
+/* PAGE 4 */
+#define GP_SPLITX		2				/* best splits */
+#define GP_SPLITY		13
+#define GP_SPLITDY		27				/* vertical distance between splits */
+#define GP_SPLITPAGE	GP_P5_bm
+
+/* PAGE 5 */
+#define GP_SEGX			2				/* segment effort */
+#define GP_SEGY			13
+#define GP_SEGTIMEX		2
+#define GP_SEGTIMEY		(GP_SEGY+18)
+#define GP_SEGDELTAX	2
+#define GP_SEGDELTAY	(GP_SEGTIMEY+27)
+#define GP_SEGBESTX		2
+#define GP_SEGBESTY		(GP_SEGDELTAY+27)
+#define GP_SEGPAGE		GP_P6_bm
+
+/* PAGE 6 */
+#define GP_LAPX			2				/* lap timer */
+#define GP_LAPY			13
+#define GP_LAPSTATX		2				/* last, best, worst lap and delta */
+#define GP_LAPSTATY		(GP_LAPY+27)
+#define GP_LAPPAGE		GP_P7_bm
+
+/* PAGE 7 */
+#define GP_DIAGLOADX	2				/* main loop load */
+#define GP_DIAGLOADY	13
+#define GP_DIAGPASSX	2				/* worst-case loop pass */
+#define GP_DIAGPASSY	(GP_DIAGLOADY+27)
+#define GP_DIAGSTACKX	2				/* stack usage */
+#define GP_DIAGSTACKY	(GP_DIAGPASSY+27)
+#define GP_DIAGLOOPX	2				/* loop passes per second */
+#define GP_DIAGLOOPY	(GP_DIAGSTACKY+18)
+#define GP_DIAGPAGE		GP_P8_bm
+
+/* PAGE 8 (configuration) */
 #define GP_LOGSETX		2				/* log settings */
 #define GP_LOGSETY		13
 #define GP_GPSSETX		2				/* uart settings */
@@ -95,8 +149,9 @@
 #define GP_DISPCONFX	2
 #define GP_DISPCONFY	(GP_DISPSETY+18)
 
-#define GP_LASTLOOPPAGE	2
-#define GP_LASTPAGE		3
+#define GP_LASTLOOPPAGE	7
+#define GP_LASTPAGE		8
+#define GP_CONFPAGE		GP_LASTPAGE
 
 typedef enum {sBack, sSelection, sRed, sGreen} eselcolor;	/* names of the predefined selection colors */
 
@@ -126,6 +181,8 @@ void display_Alt(int32_t Alt, uint32_t AltUp, uint32_t AltDwn);
 void display_Speed(uint16_t Speed, uint16_t Avg, uint16_t Max);
 /* Draws the distance made good on the display. */
 void display_Dist(int32_t Dist);
+/* Draws the time gap to the ghost in 1/10 s (positive if behind), hidden if not valid. */
+void display_Ghost(bool valid, int32_t gap);
 
 /* ---=== PAGE 1 ===--- */
 /* Draws the Time since reset on the display. */
@@ -143,6 +200,27 @@ void display_TTFF(uint32_t seconds);
 /* Draws a table with an overview of satellite IDs, IDs used in fix and SNR data. */
 void display_Satov(uint8_t satViewNum, uint8_t satFixNum, uint8_t * satsView, uint8_t * satsViewSNR, uint8_t * satsFix);
 
+/* ---=== PAGE 3 ===--- */
+/* Draws the route following data (distances and cross track error in m, state see route_state_e). */
+void display_Route(uint8_t state, uint32_t distToGo, int32_t xte, uint16_t turnBrg, uint32_t turnDist);
+
+/* ---=== PAGE 4 ===--- */
+/* Draws the best and the most recent time of split idx (dist in km, times in 1/10 s, 0 if not covered). */
+void display_Split(uint8_t idx, uint16_t dist, uint32_t best, uint32_t last);
+
+/* ---=== PAGE 5 ===--- */
+/* Draws the current or last segment effort (state see seg_state_e, times in 1/10 s). */
+void display_Segment(uint8_t state, char * name, uint32_t elapsed, int32_t delta, uint32_t best, uint8_t progress);
+
+/* ---=== PAGE 6 ===--- */
+/* Draws the lap timer (times in ms, lap=0 if no lap finished). */
+void display_Laps(uint16_t lap, uint32_t current, uint32_t last, uint32_t best, uint32_t worst, int32_t delta);
+
+/* ---=== PAGE 7 ===--- */
+/* Draws the diagnostics: main loop load (0.1 %), loop pass durations (us) and stack usage (bytes). */
+void display_Diag(uint16_t load1, uint16_t load10, uint32_t passMax, uint32_t passMaxAll, uint32_t passes,
+		uint32_t stackUsed, uint32_t stackSize);
+
 /* ---=== Status Line information ===--- */
 /* Prints the time on the display. */ 
 void display_Time(uint8_t hr, uint8_t min, uint8_t sec);
@@ -0,0 +1,72 @@
+/*
+ * dlog.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "dlog.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "debug.h"
+#include "export.h"
+
+/* ################### internal variables ################### */
+
+static bool dlogEnabled = false;
+static uint32_t dlogDropped = 0;
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Enables or disables the output of records at runtime.
+ */
+void dlog_enable(bool enable)
+{
+	dlogEnabled = enable;
+}
+
+/*
+ * Returns true, if the output of records is enabled.
+ */
+bool dlog_enabled(void)
+{
+	return dlogEnabled;
+}
+
+/*
+ * Writes a record: DLOG_SYNC, ID, number of arguments, arguments (32 bit, little endian).
+ * A record is written completely or dropped, if it does not fit into the transmit ring.
+ * No records are written while the log export owns the debug UART, they would corrupt its frames.
+ * id			message ID
+ * nargs		number of arguments, max. DLOG_MAXARGS
+ * a, b, c		arguments
+ */
+void dlog_write(dlog_id_e id, uint8_t nargs, uint32_t a, uint32_t b, uint32_t c)
+{
+	uint8_t rec[3 + 4*DLOG_MAXARGS];
+
+	if(!dlogEnabled || export_active()) return;
+
+	rec[0] = DLOG_SYNC;
+	rec[1] = (uint8_t)id;
+	rec[2] = nargs;
+	memcpy(&rec[3], &a, 4);		/* Cortex-M is little endian */
+	memcpy(&rec[7], &b, 4);
+	memcpy(&rec[11], &c, 4);
+
+	if(!debug_write((const char *)rec, 3 + 4*nargs)) dlogDropped++;
+}
+
+/*
+ * Returns the number of records dropped because the transmit ring was full.
+ */
+uint32_t dlog_getDropped(void)
+{
+	return dlogDropped;
+}
@@ -0,0 +1,58 @@
+/*
+ * dlog.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: dlog.h provides deferred binary debug logging. A call site emits a compact record consisting
+ *       		of a message ID and up to DLOG_MAXARGS raw 32 bit arguments, no formatting is done on the
+ *       		device. The records are written to the debug UART transmit ring; tools/dlog_decode.py
+ *       		expands them into text using the ID table in dlog_ids.h. Records may only be emitted from
+ *       		the main loop, which is the single producer of the transmit ring.
+ */
+
+#ifndef DLOG_H_
+#define DLOG_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+//#define DLOG_OFF				/* uncomment to remove all deferred log records at compile time */
+
+#define DLOG_SYNC			0xA5	/* first byte of a record, not used by text output */
+#define DLOG_MAXARGS		3		/* max. number of arguments per record */
+
+/* message IDs, generated from dlog_ids.h */
+typedef enum {
+#define DLOG_ID(id, fmt)	id,
+#include "dlog_ids.h"
+#undef DLOG_ID
+	DLOG_IDCOUNT
+} dlog_id_e;
+
+#ifndef DLOG_OFF
+#define dlog0(id)			dlog_write((id), 0, 0, 0, 0)
+#define dlog1(id, a)		dlog_write((id), 1, (uint32_t)(a), 0, 0)
+#define dlog2(id, a, b)		dlog_write((id), 2, (uint32_t)(a), (uint32_t)(b), 0)
+#define dlog3(id, a, b, c)	dlog_write((id), 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c))
+#else
+#define dlog0(id)
+#define dlog1(id, a)
+#define dlog2(id, a, b)
+#define dlog3(id, a, b, c)
+#endif
+
+/* Enables or disables the output of records at runtime. */
+void dlog_enable(bool enable);
+
+/* Returns true, if the output of records is enabled. */
+bool dlog_enabled(void);
+
+/* Writes a record. Use the dlog0..dlog3 macros instead of calling this function directly. */
+void dlog_write(dlog_id_e id, uint8_t nargs, uint32_t a, uint32_t b, uint32_t c);
+
+/* Returns the number of records dropped because the transmit ring was full. */
+uint32_t dlog_getDropped(void);
+
+#endif /* DLOG_H_ */
@@ -0,0 +1,21 @@
+/*
+ * dlog_ids.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: dlog_ids.h is the table of deferred log messages. Each entry defines an ID and the printf
+ *       		style format string the host expands the record with. Arguments are sent as 32 bit values,
+ *       		supported conversions are %d, %i, %u, %x, %X and %c. tools/dlog_decode.py reads this file,
+ *       		so IDs are numbered by their position: append new entries, do not reorder or remove them
+ *       		while old captures need to be decoded. No include guard, the file is included repeatedly.
+ */
+
+DLOG_ID(DLOG_MEAS_DISP,		"D: %u cycles")
+DLOG_ID(DLOG_MEAS_GPS,		"G: %u cycles")
+DLOG_ID(DLOG_MEAS_SD,		"S: %u cycles")
+DLOG_ID(DLOG_FIRSTFIX,		"first fix after %u x 100 ms")
+DLOG_ID(DLOG_LOGSTART,		"log start, result %u")
+DLOG_ID(DLOG_LOGSTOP,		"log stop, result %u")
+DLOG_ID(DLOG_LOGWRITE,		"log write failed, result %u")
+DLOG_ID(DLOG_LOGSYNC,		"log sync failed, result %u")
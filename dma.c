@@ -0,0 +1,77 @@
+/*
+ * dma.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "dma.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "inc/hw_memmap.h"
+#include "inc/tm4c1294ncpdt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/udma.h"
+
+/* ################### internal variables ################### */
+
+/* channel control table, primary and alternate structures of all 32 channels */
+#pragma DATA_ALIGN(dmaControlTable, 1024)
+static uint8_t dmaControlTable[1024];
+
+static bool dmaInitialised = false;
+static volatile uint32_t dmaErrors = 0;
+
+/* ################### private function prototypes ################### */
+
+/* ISR for uDMA bus errors */
+void dma_errorIntHandler(void);
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Enables the uDMA controller and sets the channel control table.
+ * Further calls have no effect.
+ */
+void dma_init(void)
+{
+	if(dmaInitialised) return;
+
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+	while(!SysCtlPeripheralReady(SYSCTL_PERIPH_UDMA));
+
+	uDMAIntRegister(UDMA_INT_ERR, dma_errorIntHandler);
+	IntEnable(INT_UDMAERR);
+
+	uDMAEnable();
+	uDMAControlBaseSet(dmaControlTable);
+
+	dmaInitialised = true;
+}
+
+/*
+ * Returns the number of uDMA bus errors since dma_init().
+ */
+uint32_t dma_getErrors(void)
+{
+	return dmaErrors;
+}
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * ISR for uDMA bus errors.
+ */
+void dma_errorIntHandler(void)
+{
+	if(uDMAErrorStatusGet())
+	{
+		uDMAErrorStatusClear();
+		dmaErrors++;
+	}
+}
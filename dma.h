@@ -0,0 +1,24 @@
+/*
+ * dma.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: dma.h provides the shared uDMA controller set-up. The channel control table is allocated
+ *       		once here and used by all drivers that run uDMA transfers.
+ */
+
+#ifndef DMA_H_
+#define DMA_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Enables the uDMA controller and sets the channel control table. May be called by several drivers. */
+void dma_init(void);
+
+/* Returns the number of uDMA bus errors since dma_init(). */
+uint32_t dma_getErrors(void);
+
+#endif /* DMA_H_ */
@@ -0,0 +1,426 @@
+/*
+ * export.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "export.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fatfs/ff.h"
+#include "sdcard.h"
+#include "debug.h"
+#include "framing.h"
+
+#define XFER_TXLEN			(1+4+XFER_BLOCK+4)	/* longest frame payload to the host */
+#define XFER_CTRLLEN		(1+1+4+XFER_NAMELEN+4)	/* longest control frame payload */
+
+/* transfer state */
+typedef enum {
+	xsOff = 0,		/* not in transfer mode */
+	xsSwitch,		/* waiting for the pending output to switch the baud rate */
+	xsIdle,			/* waiting for a request */
+	xsList,			/* sending the file list */
+	xsRead,			/* sending file data */
+	xsLeave			/* waiting for the last frame to switch back to DEBUG_BAUD */
+} xfer_state_e;
+
+/* ################### internal variables ################### */
+
+static xfer_state_e xferState = xsOff;
+static uint32_t xferBaud;
+static uint32_t lastRx;						/* tick of the last valid frame */
+static uint32_t lastAck;					/* tick of the last acknowledgement progress */
+static uint32_t now;						/* tick of the current poll */
+static uint32_t resent = 0;
+
+static uint8_t rxFrame[FRAMING_MAXENC(XFER_RXLEN)];
+static uint16_t rxLen = 0;
+static bool rxOverflow = false;
+
+static uint8_t txPayload[XFER_TXLEN];
+static uint8_t txFrame[FRAMING_MAXENC(XFER_TXLEN)];
+static uint8_t ctrlFrame[FRAMING_MAXENC(XFER_CTRLLEN)];	/* pending control frame, sent before data */
+static uint16_t ctrlLen = 0;
+
+static FIL xferFile;
+static DIR xferDir;
+static char lfn[XFER_NAMELEN];
+static uint32_t sendOff, ackOff, endOff;	/* next offset to send, acknowledged offset, end of the range */
+static uint32_t rewindOff;					/* ackOff at the last go-back, avoids repeated rewinds */
+
+
+/* ################### private function prototypes ################### */
+
+/* Handles a decoded frame from the host */
+void export_handleFrame(uint8_t * payload, uint16_t len);
+
+/* Starts reading a file range */
+void export_openRead(const char * name, uint32_t offset, uint32_t length);
+
+/* Sends the next directory entry, returns false if the TX ring is full */
+bool export_sendEntry(void);
+
+/* Sends the next data block, returns false if nothing could be sent */
+bool export_sendBlock(void);
+
+/* Finishes a list or read with an 'E' frame */
+void export_finish(uint8_t status);
+
+/* Appends the CRC, encodes the payload to dst and returns the frame length */
+uint16_t export_encode(uint8_t * payload, uint16_t len, uint8_t * dst);
+
+/* Queues a control frame */
+void export_queueCtrl(uint8_t * payload, uint16_t len);
+
+/* Stores a 32 bit value little endian */
+void export_put32(uint8_t * dst, uint32_t val);
+
+/* Loads a 32 bit little endian value */
+uint32_t export_get32(const uint8_t * src);
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Enters transfer mode. The console stays silent until the host quits or the idle timeout expires.
+ * baud		baud rate during the transfer, 0 for XFER_BAUD
+ */
+void export_start(uint32_t baud)
+{
+	xferBaud = baud ? baud : XFER_BAUD;
+	rxLen = 0;
+	rxOverflow = false;
+	ctrlLen = 0;
+	lastRx = now;
+	xferState = xsSwitch;
+}
+
+/*
+ * Returns true while in transfer mode.
+ */
+bool export_active(void)
+{
+	return xferState!=xsOff;
+}
+
+/*
+ * Processes a char received in transfer mode. Frames are collected up to the delimiter, frames that
+ * are too long or fail to decode are discarded.
+ * c		received char
+ */
+void export_input(char c)
+{
+	uint16_t len;
+
+	if(xferState==xsOff || xferState==xsSwitch) return;
+
+	if((uint8_t)c!=FRAMING_DELIM)
+	{
+		if(rxLen<sizeof(rxFrame)) rxFrame[rxLen++] = (uint8_t)c;
+		else rxOverflow = true;
+		return;
+	}
+
+	len = rxOverflow ? 0 : framing_decode(rxFrame, rxLen, rxFrame);
+	rxLen = 0;
+	rxOverflow = false;
+
+	if(len<5 || framing_crc32(0, rxFrame, len-4)!=export_get32(&rxFrame[len-4])) return;
+
+	lastRx = now;
+	export_handleFrame(rxFrame, len-4);
+}
+
+/*
+ * Sends pending frames as long as the TX ring has space and handles timeouts.
+ * ticks	100ms ticks since system start
+ */
+void export_poll(uint32_t ticks)
+{
+	now = ticks;
+
+	switch(xferState)
+	{
+	case xsOff:
+		return;
+	case xsSwitch:
+		if(debug_setBaud(xferBaud))
+		{
+			lastRx = now;
+			xferState = xsIdle;
+		}
+		return;
+	case xsLeave:
+		if(ctrlLen==0 && debug_setBaud(DEBUG_BAUD)) xferState = xsOff;
+		break;
+	default:
+		if(now - lastRx > XFER_IDLETIMEOUT)
+		{
+			/* host gone, give the console back */
+			if(xferState==xsRead) f_close(&xferFile);
+			ctrlLen = 0;
+			xferState = xsLeave;
+		}
+		break;
+	}
+
+	if(ctrlLen)
+	{
+		if(!debug_write((const char *)ctrlFrame, ctrlLen)) return;
+		ctrlLen = 0;
+	}
+
+	if(xferState==xsList)
+	{
+		while(export_sendEntry());
+	}
+	else if(xferState==xsRead)
+	{
+		if(ackOff>=endOff)
+		{
+			f_close(&xferFile);
+			export_finish(FR_OK);
+			return;
+		}
+		if(sendOff>ackOff && now - lastAck > XFER_TIMEOUT)
+		{
+			/* no progress, resend everything not acknowledged */
+			resent += (sendOff - ackOff + XFER_BLOCK - 1) / XFER_BLOCK;
+			sendOff = ackOff;
+			lastAck = now;
+		}
+		while(export_sendBlock());
+	}
+}
+
+/*
+ * Returns the number of blocks resent since start.
+ */
+uint32_t export_getResent(void)
+{
+	return resent;
+}
+
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Handles a decoded frame from the host.
+ * payload	frame type and body without CRC
+ * len		length of type and body
+ */
+void export_handleFrame(uint8_t * payload, uint16_t len)
+{
+	uint8_t reply[1];
+	uint32_t ack;
+	const uint8_t * term;
+	uint16_t nameLen;
+
+	switch(payload[0])
+	{
+	case 'L':
+		if(xferState==xsRead) f_close(&xferFile);
+		xferState = xsIdle;
+		if(sd_mount(LOG_DIR)!=FR_OK || f_opendir(&xferDir, "")!=FR_OK)
+			export_finish(FR_NOT_READY);
+		else
+			xferState = xsList;
+		break;
+	case 'R':
+		term = memchr(&payload[1], 0, len-1);
+		if(term==NULL) return;
+		nameLen = term - &payload[1];
+		if(nameLen==0 || nameLen>=XFER_NAMELEN || 1+nameLen+1+8!=len) return;
+		if(xferState==xsRead) f_close(&xferFile);
+		xferState = xsIdle;
+		export_openRead((const char *)&payload[1], export_get32(&payload[nameLen+2]), export_get32(&payload[nameLen+6]));
+		break;
+	case 'A':
+		if(len!=5 || xferState!=xsRead) return;
+		ack = export_get32(&payload[1]);
+		if(ack>ackOff && ack<=endOff)
+		{
+			ackOff = ack;
+			if(sendOff<ackOff) sendOff = ackOff;	/* data sent before a go-back arrived after all */
+			lastAck = now;
+		}
+		else if(ack==ackOff && sendOff>ackOff && rewindOff!=ackOff)
+		{
+			/* repeated acknowledgement: the host misses the block at ackOff, go back once */
+			resent += (sendOff - ackOff + XFER_BLOCK - 1) / XFER_BLOCK;
+			sendOff = ackOff;
+			rewindOff = ackOff;
+			lastAck = now;
+		}
+		break;
+	case 'Q':
+		if(xferState==xsRead) f_close(&xferFile);
+		reply[0] = 'q';
+		export_queueCtrl(reply, 1);
+		xferState = xsLeave;
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Opens a file in LOG_DIR and starts sending the range offset..offset+length.
+ * Names containing a path are refused, so only the logs directory can be read.
+ * name		file name
+ * offset	first byte to send
+ * length	number of bytes, 0 to send up to the end of the file
+ */
+void export_openRead(const char * name, uint32_t offset, uint32_t length)
+{
+	uint8_t reply[1+1+4+XFER_NAMELEN];
+	uint16_t nameLen = strlen(name);
+	FRESULT b1;
+
+	if(strchr(name, '/') || strchr(name, '\\') || strchr(name, ':'))
+		b1 = FR_INVALID_NAME;
+	else
+		b1 = (FRESULT)sd_mount(LOG_DIR);
+	if(b1==FR_OK) b1 = f_open(&xferFile, name, FA_OPEN_EXISTING | FA_READ);
+
+	reply[0] = 'r';
+	reply[1] = (uint8_t)b1;
+	export_put32(&reply[2], b1==FR_OK ? f_size(&xferFile) : 0);
+	memcpy(&reply[6], name, nameLen);			/* lets the host tell the reply from one to a repeated request */
+	export_queueCtrl(reply, 6+nameLen);
+	if(b1!=FR_OK) return;
+
+	endOff = f_size(&xferFile);
+	if(offset>endOff) offset = endOff;
+	if(length!=0 && length < endOff - offset) endOff = offset + length;
+	sendOff = offset;
+	ackOff = offset;
+	rewindOff = 0xFFFFFFFF;
+	lastAck = now;
+	xferState = xsRead;
+}
+
+/*
+ * Sends the next directory entry as 'l' frame, or the 'E' frame after the last one.
+ * Returns false, if the TX ring is full or the list is complete.
+ */
+bool export_sendEntry(void)
+{
+	FILINFO fno;
+	uint16_t nameLen, len;
+	const char * name;
+
+	if(debug_space() < FRAMING_MAXENC(1+4+XFER_NAMELEN+4)) return false;
+
+	fno.lfname = lfn;
+	fno.lfsize = sizeof(lfn);
+	do
+	{
+		if(f_readdir(&xferDir, &fno)!=FR_OK || fno.fname[0]==0)
+		{
+			f_closedir(&xferDir);
+			export_finish(FR_OK);
+			return false;
+		}
+	} while(fno.fattrib & (AM_DIR | AM_HID | AM_SYS));
+
+	name = *fno.lfname ? fno.lfname : fno.fname;
+	nameLen = strlen(name);
+	txPayload[0] = 'l';
+	export_put32(&txPayload[1], fno.fsize);
+	memcpy(&txPayload[5], name, nameLen);
+
+	len = export_encode(txPayload, 5+nameLen, txFrame);
+	debug_write((const char *)txFrame, len);
+	return true;
+}
+
+/*
+ * Reads and sends the next data block as 'D' frame, if the window and the TX ring allow.
+ * Returns false, if nothing was sent.
+ */
+bool export_sendBlock(void)
+{
+	UINT cnt;
+	uint16_t len;
+
+	if(sendOff>=endOff || sendOff - ackOff >= XFER_WINDOW*XFER_BLOCK) return false;
+	if(debug_space() < FRAMING_MAXENC(XFER_TXLEN)) return false;
+
+	len = endOff - sendOff > XFER_BLOCK ? XFER_BLOCK : endOff - sendOff;
+	if((f_tell(&xferFile)!=sendOff && f_lseek(&xferFile, sendOff)!=FR_OK) ||
+			f_read(&xferFile, &txPayload[5], len, &cnt)!=FR_OK || cnt!=len)
+	{
+		f_close(&xferFile);
+		export_finish(FR_DISK_ERR);
+		return false;
+	}
+
+	txPayload[0] = 'D';
+	export_put32(&txPayload[1], sendOff);
+	len = export_encode(txPayload, 5+cnt, txFrame);
+	debug_write((const char *)txFrame, len);
+	sendOff += cnt;
+	return true;
+}
+
+/*
+ * Finishes a list or read with an 'E' frame and waits for the next request.
+ * status	FatFs result
+ */
+void export_finish(uint8_t status)
+{
+	uint8_t reply[2];
+
+	reply[0] = 'E';
+	reply[1] = status;
+	export_queueCtrl(reply, 2);
+	xferState = xsIdle;
+}
+
+/*
+ * Appends the CRC to the payload and encodes it.
+ * payload	type and body, must have 4 bytes of space behind len for the CRC
+ * len		length of type and body
+ * dst		destination, must hold FRAMING_MAXENC(len+4) bytes
+ * Returns the frame length incl. delimiter.
+ */
+uint16_t export_encode(uint8_t * payload, uint16_t len, uint8_t * dst)
+{
+	export_put32(&payload[len], framing_crc32(0, payload, len));
+	return framing_encode(payload, len+4, dst);
+}
+
+/*
+ * Queues a control frame, it is sent by the next export_poll() before any data.
+ * payload	type and body
+ * len		length of type and body, max. XFER_CTRLLEN-4
+ */
+void export_queueCtrl(uint8_t * payload, uint16_t len)
+{
+	uint8_t buf[XFER_CTRLLEN];
+
+	memcpy(buf, payload, len);
+	ctrlLen = export_encode(buf, len, ctrlFrame);
+}
+
+/* Stores a 32 bit value little endian */
+void export_put32(uint8_t * dst, uint32_t val)
+{
+	dst[0] = val;
+	dst[1] = val >> 8;
+	dst[2] = val >> 16;
+	dst[3] = val >> 24;
+}
+
+/* Loads a 32 bit little endian value */
+uint32_t export_get32(const uint8_t * src)
+{
+	return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
@@ -0,0 +1,61 @@
+/*
+ * export.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: export.h provides a resumable file transfer of the files in LOG_DIR over the debug UART,
+ *       		so logs can be fetched without removing the SD card. Frames are COBS encoded (framing.h)
+ *       		and carry a CRC-32. File data is sent in blocks of XFER_BLOCK bytes tagged with their file
+ *       		offset; up to XFER_WINDOW blocks are in flight before the host has to acknowledge them.
+ *       		Lost blocks are resent from the last acknowledged offset (go-back-N), and a transfer can
+ *       		be resumed at any offset. The transfer runs from the main loop beside all other tasks.
+ *       		tools/logxfer.py is the host side.
+ *
+ *       		Frame payload: type (1 byte), body, CRC-32 of type and body (4 bytes, little endian).
+ *       		Host to device:
+ *       			'L'									list the files
+ *       			'R' name, 0, offset u32, length u32	read a file range, length 0 reads to the end
+ *       			'A' offset u32						all data before offset received
+ *       			'Q'									quit, the device returns to DEBUG_BAUD
+ *       		Device to host:
+ *       			'l' size u32, name					one per file
+ *       			'r' status u8, size u32, name		reply to 'R', status is a FatFs result
+ *       			'D' offset u32, data				file data
+ *       			'E' status u8						list complete, read complete (all data acknowledged) or failed
+ *       			'q'									reply to 'Q'
+ */
+
+#ifndef EXPORT_H_
+#define EXPORT_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define XFER_BAUD			921600	/* default baud rate during a transfer */
+#define XFER_MINBAUD		9600	/* range of baud rates accepted by the xfer command */
+#define XFER_MAXBAUD		3000000
+#define XFER_BLOCK			256		/* file data bytes per frame */
+#define XFER_WINDOW			6		/* unacknowledged blocks in flight */
+#define XFER_TIMEOUT		3		/* 100ms ticks without acknowledgement progress until data is resent */
+#define XFER_IDLETIMEOUT	300		/* 100ms ticks without a valid frame until transfer mode is left */
+#define XFER_NAMELEN		65		/* max. file name length incl. termination (_MAX_LFN+1) */
+#define XFER_RXLEN			(1+XFER_NAMELEN+8+4)	/* longest frame payload from the host */
+
+/* Enters transfer mode: the debug UART is switched to baud once the pending output is sent. */
+void export_start(uint32_t baud);
+
+/* Returns true while in transfer mode, received chars must then be passed to export_input(). */
+bool export_active(void);
+
+/* Processes a char received over the debug UART in transfer mode. */
+void export_input(char c);
+
+/* Sends pending frames and handles timeouts. Must be called periodically from the main loop. */
+void export_poll(uint32_t ticks);
+
+/* Returns the number of blocks resent since start. */
+uint32_t export_getResent(void);
+
+#endif /* EXPORT_H_ */
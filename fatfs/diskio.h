@@ -71,6 +71,7 @@ void disk_timerproc (void);
 #define MMC_GET_CID			52	/* Get CID */
 #define MMC_GET_OCR			53	/* Get OCR */
 #define MMC_GET_SDSTAT		54	/* Get SD status */
+#define MMC_GET_LINK		55	/* Get SPI link clock and errors */
 
 /* ATA/CF specific ioctl command */
 #define ATA_GET_REV			60	/* Get F/W revision */
@@ -16,6 +16,7 @@
 
 #include "./../spi_wrapper.h"
 #include "./../sdcard.h"
+#include "./../sdlink.h"
 
 #include "driverlib/gpio.h"
 #include "driverlib/pin_map.h"
@@ -59,6 +60,7 @@
 #define CMD38	(38)		/* ERASE */
 #define CMD55	(55)		/* APP_CMD */
 #define CMD58	(58)		/* READ_OCR */
+#define CMD59	(59)		/* CRC_ON_OFF */
 
 
 static volatile
@@ -70,6 +72,12 @@ BYTE Timer1, Timer2;	/* 100Hz decrement timer */
 static
 BYTE CardType;			/* Card type flags */
 
+static
+sdlink_t Link;			/* Clock and error counters of the SPI link */
+
+static
+BYTE CrcOn;				/* The card checks CRCs, received blocks are checked */
+
 
 /*-----------------------------------------------------------------------*/
 /* Power Control  (Platform dependent)                                   */
@@ -128,7 +136,7 @@ BYTE xchg_spi (		/* Returns received data */
 #endif
 }
 
-/* Send a data block fast */
+/* Send a data block fast, blocks of at least SPI_DMAMIN bytes are sent by uDMA */
 static
 void xmit_spi_multi (
 	const BYTE *p,	/* Data block to be sent */
@@ -145,7 +153,7 @@ void xmit_spi_multi (
 #endif
 }
 
-/* Receive a data block fast */
+/* Receive a data block fast, blocks of at least SPI_DMAMIN bytes are received by uDMA */
 static
 void rcvr_spi_multi (
 	BYTE *p,	/* Data buffer */
@@ -226,6 +234,20 @@ int select (void)						/* 1:Successful, 0:Timeout */
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Reduce the clock after a CRC or response error                        */
+/*-----------------------------------------------------------------------*/
+
+static
+void link_error (void)
+{
+	if (Stat & STA_NOINIT) return;		/* Not during initialization, the clock is slow anyway */
+
+	Link.clock = SPI_setClock(getSDSPIProcess(), sdlink_error(&Link));
+}
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Receive a data packet from MMC                                        */
 /*-----------------------------------------------------------------------*/
@@ -237,17 +259,26 @@ int rcvr_datablock (
 )
 {
 	BYTE token;
+	WORD crc;
 
 
 	Timer1 = 20;
 	do {							/* Wait for data packet in timeout of 200ms */
 		token = xchg_spi(0xFF);
 	} while ((token == 0xFF) && Timer1);
-	if (token != 0xFE) return 0;	/* If not valid data token, retutn with error */
+	if (token != 0xFE) {			/* If not valid data token, retutn with error */
+		if (token != 0xFF && (token & 0xE0)) link_error();	/* Neither timeout nor error token (000xxxxx) */
+		return 0;
+	}
 
 	rcvr_spi_multi(buff, btr);		/* Receive the data block into buffer */
-	xchg_spi(0xFF);					/* Discard CRC */
-	xchg_spi(0xFF);
+	crc = (WORD)xchg_spi(0xFF) << 8;	/* CRC16 */
+	crc |= xchg_spi(0xFF);
+
+	if (CrcOn && crc != sdlink_crc16(buff, btr)) {
+		link_error();
+		return 0;
+	}
 
 	return 1;						/* Return with success */
 }
@@ -266,18 +297,23 @@ int xmit_datablock (
 )
 {
 	BYTE resp;
+	WORD crc;
 
 
 	if (!wait_ready(500)) return 0;
 
 	xchg_spi(token);					/* Xmit data token */
 	if (token != 0xFD) {	/* Is data token */
+		crc = sdlink_crc16(buff, 512);
 		xmit_spi_multi(buff, 512);		/* Xmit the data block to the MMC */
-		xchg_spi(0xFF);					/* CRC (Dummy) */
-		xchg_spi(0xFF);
+		xchg_spi((BYTE)(crc >> 8));		/* CRC16 */
+		xchg_spi((BYTE)crc);
 		resp = xchg_spi(0xFF);			/* Reveive data response */
-		if ((resp & 0x1F) != 0x05)		/* If not accepted, return with error */
+		if ((resp & 0x1F) != 0x05) {	/* If not accepted, return with error */
+			if ((resp & 0x1F) == 0x0B || (resp & 0x11) != 0x01)	/* CRC error or no valid response */
+				link_error();
 			return 0;
+		}
 	}
 
 	return 1;
@@ -296,7 +332,7 @@ BYTE send_cmd (		/* Returns R1 resp (bit7==1:Send failed) */
 	DWORD arg		/* Argument */
 )
 {
-	BYTE n, res;
+	BYTE n, res, pkt[6];
 
 
 	if (cmd & 0x80) {	/* ACMD<n> is the command sequense of CMD55-CMD<n> */
@@ -312,15 +348,13 @@ BYTE send_cmd (		/* Returns R1 resp (bit7==1:Send failed) */
 	}
 
 	/* Send command packet */
-	xchg_spi(0x40 | cmd);				/* Start + Command index */
-	xchg_spi((BYTE)(arg >> 24));		/* Argument[31..24] */
-	xchg_spi((BYTE)(arg >> 16));		/* Argument[23..16] */
-	xchg_spi((BYTE)(arg >> 8));			/* Argument[15..8] */
-	xchg_spi((BYTE)arg);				/* Argument[7..0] */
-	n = 0x01;							/* Dummy CRC + Stop */
-	if (cmd == CMD0) n = 0x95;			/* Valid CRC for CMD0(0) + Stop */
-	if (cmd == CMD8) n = 0x87;			/* Valid CRC for CMD8(0x1AA) Stop */
-	xchg_spi(n);
+	pkt[0] = 0x40 | cmd;				/* Start + Command index */
+	pkt[1] = (BYTE)(arg >> 24);			/* Argument[31..24] */
+	pkt[2] = (BYTE)(arg >> 16);			/* Argument[23..16] */
+	pkt[3] = (BYTE)(arg >> 8);			/* Argument[15..8] */
+	pkt[4] = (BYTE)arg;					/* Argument[7..0] */
+	pkt[5] = (sdlink_crc7(pkt, 5) << 1) | 0x01;	/* CRC + Stop */
+	for (n = 0; n < 6; n++) xchg_spi(pkt[n]);
 
 	/* Receive command response */
 	if (cmd == CMD12) xchg_spi(0xFF);		/* Skip a stuff byte when stop reading */
@@ -329,6 +363,8 @@ BYTE send_cmd (		/* Returns R1 resp (bit7==1:Send failed) */
 		res = xchg_spi(0xFF);
 	while ((res & 0x80) && --n);
 
+	if (!(res & 0x80) && (res & 0x08)) link_error();	/* Command CRC error */
+
 	return res;			/* Return with the response value */
 }
 
@@ -349,14 +385,17 @@ DSTATUS disk_initialize (
 	BYTE pdrv		/* Physical drive nmuber (0) */
 )
 {
-	BYTE n, cmd, ty, ocr[4];
+	BYTE n, cmd, ty, ocr[4], csd[16];
+	DWORD hz;
 
 
 	if (pdrv) return STA_NOINIT;		/* Supports only single drive */
 	power_off();						/* Turn off the socket power to reset the card */
 	if (Stat & STA_NODISK) return Stat;	/* No card in the socket */
 	power_on();							/* Turn on the socket power */
-	SPI_setSlow();
+	Stat |= STA_NOINIT;
+	CrcOn = 0;
+	SPI_setClock(getSDSPIProcess(), SPI_CLKSLOW);
 	for (n = 10; n; n--) xchg_spi(0xFF);	/* 80 dummy clocks */
 
 	ty = 0;
@@ -386,14 +425,18 @@ DSTATUS disk_initialize (
 	//deselect();
 
 	if (ty) {			/* Initialization succeded */
+#ifdef SD_CRC
+		CrcOn = (send_cmd(CMD59, 1) == 0);	/* CRC on for commands and data */
+#endif
+		hz = 0;						/* Fastest clock of the card from the CSD */
+		if (send_cmd(CMD9, 0) == 0 && rcvr_datablock(csd, 16)) hz = sdlink_tranSpeed(csd);
+		Link.clock = SPI_setClock(getSDSPIProcess(), sdlink_init(&Link, hz, SPI_CLKMAX));
 		Stat &= ~STA_NOINIT;		/* Clear STA_NOINIT */
-		//SPI_setFast();
 	} else {			/* Initialization failed */
 		power_off();
 	}
 
 	deselect();
-	SPI_setFast();
 
 	return Stat;
 }
@@ -425,7 +468,10 @@ DRESULT disk_read (
 	UINT count			/* Sector count (1..128) */
 )
 {
-	BYTE cmd;
+	BYTE cmd, retry = SD_RETRIES;
+	BYTE *p;
+	UINT n;
+	DWORD errors;
 
 
 	if (pdrv || !count) return RES_PARERR;
@@ -434,16 +480,21 @@ DRESULT disk_read (
 	if (!(CardType & CT_BLOCK)) sector *= 512;	/* Convert to byte address if needed */
 
 	cmd = count > 1 ? CMD18 : CMD17;			/*  READ_MULTIPLE_BLOCK : READ_SINGLE_BLOCK */
-	if (send_cmd(cmd, sector) == 0) {
-		do {
-			if (!rcvr_datablock(buff, 512)) break;
-			buff += 512;
-		} while (--count);
-		if (cmd == CMD18) send_cmd(CMD12, 0);	/* STOP_TRANSMISSION */
-	}
-	deselect();
+	do {							/* Repeat at the reduced clock after a link error */
+		errors = Link.errors;
+		p = buff;
+		n = count;
+		if (send_cmd(cmd, sector) == 0) {
+			do {
+				if (!rcvr_datablock(p, 512)) break;
+				p += 512;
+			} while (--n);
+			if (cmd == CMD18) send_cmd(CMD12, 0);	/* STOP_TRANSMISSION */
+		}
+		deselect();
+	} while (n && Link.errors != errors && retry--);
 
-	return count ? RES_ERROR : RES_OK;
+	return n ? RES_ERROR : RES_OK;
 }
 
 
@@ -460,31 +511,42 @@ DRESULT disk_write (
 	UINT count			/* Sector count (1..128) */
 )
 {
+	BYTE retry = SD_RETRIES;
+	const BYTE *p;
+	UINT n;
+	DWORD errors;
+
+
 	if (pdrv || !count) return RES_PARERR;
 	if (Stat & STA_NOINIT) return RES_NOTRDY;
 	if (Stat & STA_PROTECT) return RES_WRPRT;
 
 	if (!(CardType & CT_BLOCK)) sector *= 512;	/* Convert to byte address if needed */
 
-	if (count == 1) {	/* Single block write */
-		if ((send_cmd(CMD24, sector) == 0)	/* WRITE_BLOCK */
-			&& xmit_datablock(buff, 0xFE))
-			count = 0;
-	}
-	else {				/* Multiple block write */
-		if (CardType & CT_SDC) send_cmd(ACMD23, count);
-		if (send_cmd(CMD25, sector) == 0) {	/* WRITE_MULTIPLE_BLOCK */
-			do {
-				if (!xmit_datablock(buff, 0xFC)) break;
-				buff += 512;
-			} while (--count);
-			if (!xmit_datablock(0, 0xFD))	/* STOP_TRAN token */
-				count = 1;
+	do {							/* Repeat at the reduced clock after a link error */
+		errors = Link.errors;
+		p = buff;
+		n = count;
+		if (n == 1) {		/* Single block write */
+			if ((send_cmd(CMD24, sector) == 0)	/* WRITE_BLOCK */
+				&& xmit_datablock(p, 0xFE))
+				n = 0;
 		}
-	}
-	deselect();
+		else {				/* Multiple block write */
+			if (CardType & CT_SDC) send_cmd(ACMD23, n);
+			if (send_cmd(CMD25, sector) == 0) {	/* WRITE_MULTIPLE_BLOCK */
+				do {
+					if (!xmit_datablock(p, 0xFC)) break;
+					p += 512;
+				} while (--n);
+				if (!xmit_datablock(0, 0xFD))	/* STOP_TRAN token */
+					n = 1;
+			}
+		}
+		deselect();
+	} while (n && Link.errors != errors && retry--);
 
-	return count ? RES_ERROR : RES_OK;
+	return n ? RES_ERROR : RES_OK;
 }
 #endif
 
@@ -578,6 +640,11 @@ DRESULT disk_ioctl (
 		}
 		break;
 
+	case MMC_GET_LINK :		/* Get clock and error counters of the SPI link (sdlink_t) */
+		*(sdlink_t*)buff = Link;
+		res = RES_OK;
+		break;
+
 	case MMC_GET_SDSTAT :	/* Receive SD statsu as a data block (64 bytes) */
 		if (send_cmd(ACMD13, 0) == 0) {	/* SD_STATUS */
 			xchg_spi(0xFF);
@@ -0,0 +1,110 @@
+/*
+ * framing.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "framing.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ################### internal variables ################### */
+
+/* CRC-32 table for 4 bits per step, keeps the table in 64 bytes of flash */
+static const uint32_t crcTable[16] = {
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Encodes len bytes with COBS and appends the delimiter.
+ * Every zero byte is replaced by the distance to the next zero byte, a code byte of 0xFF marks
+ * a run of 254 non-zero bytes without a following zero.
+ * src			data to encode
+ * len			number of bytes
+ * dst			destination, must hold FRAMING_MAXENC(len) bytes and must not overlap src
+ * Returns the encoded length incl. the delimiter.
+ */
+uint16_t framing_encode(const uint8_t * src, uint16_t len, uint8_t * dst)
+{
+	uint16_t codeIdx = 0;		/* position of the current code byte */
+	uint16_t o = 1;
+	uint8_t code = 1;
+	uint16_t i;
+
+	for(i=0; i<len; i++)
+	{
+		if(src[i]==0)
+		{
+			dst[codeIdx] = code;
+			codeIdx = o++;
+			code = 1;
+		}
+		else
+		{
+			dst[o++] = src[i];
+			code++;
+			if(code==0xFF)
+			{
+				dst[codeIdx] = code;
+				codeIdx = o++;
+				code = 1;
+			}
+		}
+	}
+	dst[codeIdx] = code;
+	dst[o++] = FRAMING_DELIM;
+
+	return o;
+}
+
+/*
+ * Decodes a COBS frame.
+ * src			encoded frame without the delimiter
+ * len			length of the encoded frame
+ * dst			destination, must hold len bytes, may equal src (decoding in place)
+ * Returns the decoded length or 0 if the frame is invalid.
+ */
+uint16_t framing_decode(const uint8_t * src, uint16_t len, uint8_t * dst)
+{
+	uint16_t i = 0, o = 0;
+	uint8_t code, j;
+
+	while(i<len)
+	{
+		code = src[i++];
+		if(code==0 || i+code-1>len) return 0;
+
+		for(j=1; j<code; j++)
+			dst[o++] = src[i++];
+
+		if(code!=0xFF && i<len) dst[o++] = 0;
+	}
+
+	return o;
+}
+
+/*
+ * Continues a CRC-32 (zlib compatible).
+ * crc			CRC of the preceding data, 0 to start
+ * data			data
+ * len			number of bytes
+ * Returns the CRC-32 including data.
+ */
+uint32_t framing_crc32(uint32_t crc, const uint8_t * data, uint16_t len)
+{
+	crc = ~crc;
+	while(len--)
+	{
+		crc ^= *data++;
+		crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+		crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+	}
+	return ~crc;
+}
@@ -0,0 +1,33 @@
+/*
+ * framing.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: framing.h provides COBS framing and CRC-32 for binary transfers over a byte stream.
+ *       		A COBS encoded frame contains no zero bytes, so a single zero byte delimits frames and
+ *       		the receiver resynchronises after corrupted or foreign data (e.g. text output) at the
+ *       		next delimiter. The CRC-32 is the one of zlib/Ethernet (polynomial 0xEDB88320).
+ */
+
+#ifndef FRAMING_H_
+#define FRAMING_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FRAMING_DELIM			0x00						/* frame delimiter */
+#define FRAMING_MAXENC(len)		((len) + (len)/254 + 2)		/* encoded length of len bytes incl. delimiter */
+
+/* Encodes len bytes with COBS and appends the delimiter. dst must hold FRAMING_MAXENC(len) bytes.
+ * Returns the encoded length incl. the delimiter. */
+uint16_t framing_encode(const uint8_t * src, uint16_t len, uint8_t * dst);
+
+/* Decodes a COBS frame (without delimiter), dst may equal src. Returns the decoded length or 0 if the frame is invalid. */
+uint16_t framing_decode(const uint8_t * src, uint16_t len, uint8_t * dst);
+
+/* Continues a CRC-32 over len bytes, start with crc = 0. */
+uint32_t framing_crc32(uint32_t crc, const uint8_t * data, uint16_t len);
+
+#endif /* FRAMING_H_ */
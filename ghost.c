@@ -0,0 +1,246 @@
+/*
+ * ghost.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "ghost.h"
+#include "sdcard.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "fatfs/ff.h"
+#include "fatfs/integer.h"
+
+
+#if (GHOST_RINGLEN & (GHOST_RINGLEN-1)) != 0
+#error "GHOST_RINGLEN must be a power of 2"
+#endif
+
+#define GHOST_FIELD_TIME	1		/* CSV column of the time of day (hh:mm:ss.c) */
+#define GHOST_FIELD_DIST	9		/* CSV column of the distance increment (dddd.d m) */
+#define GHOST_DAY			864000	/* 1/10 s per day */
+
+typedef struct {
+	uint32_t	dist;		/* 1/10 m, cumulative distance */
+	uint32_t	time;		/* 1/10 s, time since the first sample */
+} ghost_sample_t;
+
+/* ################### internal variables ################### */
+
+static FIL				ghostFile;
+static bool				ghostOpen = false;
+static bool				ghostEof;
+
+static ghost_sample_t	ring[GHOST_RINGLEN];
+static uint16_t			head;				/* next sample to be written */
+static uint16_t			tail;				/* cursor, sample at or before the current distance */
+
+/* line parser */
+static bool				header;				/* true, while skipping the header line */
+static bool				first;				/* true, until the first sample has been added */
+static uint8_t			field;				/* current CSV column */
+static char				fieldBuf[GHOST_FIELDLEN+1];
+static uint8_t			fieldLen;
+static uint32_t			lineTime;			/* 1/10 s, time of day of the current line */
+static uint32_t			lineDist;			/* 1/10 m, distance increment of the current line */
+static bool				lineValid;
+
+static uint32_t			cumDist;			/* 1/10 m, cumulative distance of the parsed lines */
+static uint32_t			startTime;			/* 1/10 s, time of day of the first sample */
+static uint32_t			lastTime;			/* 1/10 s, time of day of the previous sample */
+static uint32_t			dayOffset;			/* 1/10 s, added after midnight */
+
+/* ################### private function prototypes ################### */
+
+/* Feeds a character to the CSV line parser. */
+void ghost_parse(char c);
+
+/* Converts a decimal field with one fractional digit to 1/10 units, ':' separated fields as time. */
+uint32_t ghost_fieldToInt(const char * str, bool time);
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Opens the ghost track log. The SD card must be mounted and LOG_DIR must be the current directory.
+ * filename		the CSV track log
+ * Returns		FR_OK or a FatFs error code
+ */
+uint8_t ghost_open(const char * filename)
+{
+#ifndef SDCARD_OFF
+	BYTE b1;
+
+	if(ghostOpen) f_close(&ghostFile);
+	ghostOpen = false;
+
+	b1 = f_open(&ghostFile, filename, FA_OPEN_EXISTING | FA_READ);
+	if ( !(b1==FR_OK) ) return b1;
+
+	ghostOpen = true;
+	return ghost_rewind();
+#else
+	return FR_OK;
+#endif
+}
+
+/*
+ * Restarts the ghost from the beginning of the track.
+ */
+uint8_t ghost_rewind(void)
+{
+#ifndef SDCARD_OFF
+	BYTE b1;
+
+	if(!ghostOpen) return FR_NO_FILE;
+
+	b1 = f_lseek(&ghostFile, 0);
+	if ( !(b1==FR_OK) ) return b1;
+
+	head = 0;
+	tail = 0;
+	ghostEof = false;
+	header = true;
+	first = true;
+	field = 0;
+	fieldLen = 0;
+	lineValid = false;
+	cumDist = 0;
+	dayOffset = 0;
+#endif
+	return FR_OK;
+}
+
+/*
+ * Reads ahead a chunk of the ghost track, if there is space in the ring.
+ * At most GHOST_CHUNK bytes are read per call, so the main loop is never blocked for long.
+ * Returns true, if a chunk was read.
+ */
+bool ghost_poll(void)
+{
+#ifndef SDCARD_OFF
+	static char chunk[GHOST_CHUNK];
+	UINT cnt, i;
+
+	if(!ghostOpen || ghostEof) return false;
+
+	/* a valid line has at least 10 chars, keep space for all lines of one chunk */
+	if((uint16_t)(head - tail) > GHOST_RINGLEN - GHOST_CHUNK/8) return false;
+
+	if(f_read(&ghostFile, chunk, GHOST_CHUNK, &cnt)!=FR_OK) cnt = 0;
+	if(cnt<GHOST_CHUNK) ghostEof = true;
+
+	for(i=0; i<cnt; i++) ghost_parse(chunk[i]);
+	if(ghostEof) ghost_parse('\n');		/* last line without line ending */
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+/*
+ * Determines the time gap to the ghost at the same distance.
+ * The cursor only moves forward, samples behind the cursor are released for read-ahead.
+ * dist		the current distance in 1/10 m
+ * time		the current time in 1/10 s (same reference as the ghost: time since reset)
+ * gap		returns the gap in 1/10 s, positive if behind the ghost
+ * Returns	true, if the gap is valid
+ */
+bool ghost_getGap(uint32_t dist, uint32_t time, int32_t * gap)
+{
+	ghost_sample_t * a;
+	ghost_sample_t * b;
+	uint32_t t;
+
+	if(!ghostOpen) return false;
+
+	/* advance cursor while the next sample is not beyond the current distance */
+	while((uint16_t)(head - tail) > 1 && ring[(tail+1) & (GHOST_RINGLEN-1)].dist <= dist) tail++;
+
+	if((uint16_t)(head - tail) < 2) return false;	/* not read ahead yet or ghost finished */
+
+	a = &ring[tail & (GHOST_RINGLEN-1)];
+	b = &ring[(tail+1) & (GHOST_RINGLEN-1)];
+	if(dist<a->dist) return false;					/* before the first sample */
+
+	t = a->time;
+	if(b->dist>a->dist)
+		t += (uint32_t)((uint64_t)(b->time - a->time) * (dist - a->dist) / (b->dist - a->dist));
+
+	*gap = (int32_t)time - (int32_t)t;
+	return true;
+}
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Feeds a character to the CSV line parser, complete lines are added to the ring.
+ */
+void ghost_parse(char c)
+{
+	ghost_sample_t * s;
+
+	if(c=='\r') return;
+
+	if(c==',' || c=='\n')
+	{
+		fieldBuf[fieldLen] = 0;
+		if(!header && fieldLen>0)
+		{
+			if(field==GHOST_FIELD_TIME) { lineTime = ghost_fieldToInt(fieldBuf, true); lineValid = true; }
+			else if(field==GHOST_FIELD_DIST) lineDist = ghost_fieldToInt(fieldBuf, false);
+		}
+		fieldLen = 0;
+		field++;
+	}
+	else if(fieldLen<GHOST_FIELDLEN) fieldBuf[fieldLen++] = c;
+
+	if(c!='\n') return;
+
+	/* end of line */
+	if(!header && lineValid && field>GHOST_FIELD_DIST)
+	{
+		if(first) { startTime = lineTime; lastTime = lineTime; first = false; }
+		if(lineTime<lastTime) dayOffset += GHOST_DAY;	/* midnight */
+		lastTime = lineTime;
+
+		cumDist += lineDist;
+		s = &ring[head & (GHOST_RINGLEN-1)];
+		s->dist = cumDist;
+		s->time = lineTime + dayOffset - startTime;
+		head++;
+	}
+	header = false;
+	field = 0;
+	lineDist = 0;
+	lineValid = false;
+}
+
+/*
+ * Converts a decimal field with one fractional digit to 1/10 units.
+ * str		the field, e.g. "0012.3" or "hh:mm:ss.c"
+ * time		true, if the field is a time (':' separated)
+ */
+uint32_t ghost_fieldToInt(const char * str, bool time)
+{
+	uint32_t val = 0, part = 0;
+	bool frac = false;
+
+	for( ; *str; str++)
+	{
+		if(*str>='0' && *str<='9')
+		{
+			if(!frac) part = part*10 + (*str-'0');
+			else { val = (val + part)*10 + (*str-'0'); part = 0; break; }
+		}
+		else if(*str==':' && time) { val = (val + part)*60; part = 0; }
+		else if(*str=='.') frac = true;
+	}
+	if(!frac) val = (val + part)*10;
+	return val;
+}
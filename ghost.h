@@ -0,0 +1,40 @@
+/*
+ * ghost.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: ghost.h provides racing against a previously recorded track log (ghost). The CSV log
+ *       		GHOST_FILENAME is streamed from the SD card into a small ring of distance/time samples,
+ *       		a bounded chunk is read ahead per main loop pass. The ghost time at the current distance
+ *       		is looked up with a monotonically advancing cursor and interpolation, so memory does
+ *       		not depend on the length of the ghost track.
+ */
+
+#ifndef GHOST_H_
+#define GHOST_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GHOST_FILENAME		"ghost.csv"		/* track log (CSV, see LOG_LEADINCSV) to race against, located in LOG_DIR */
+#define GHOST_RINGLEN		64				/* samples read ahead, power of 2 */
+#define GHOST_CHUNK			64				/* bytes read from the file per ghost_poll() call */
+#define GHOST_FIELDLEN		12				/* max. length of a parsed CSV field */
+
+/* Opens the ghost track log. The SD card must be mounted and LOG_DIR must be the current directory. */
+uint8_t ghost_open(const char * filename);
+
+/* Restarts the ghost from the beginning of the track, e.g. after resetting the distance. */
+uint8_t ghost_rewind(void);
+
+/* Reads ahead a chunk of the ghost track, if there is space in the ring. Must be called periodically.
+ * Returns true, if a chunk was read. */
+bool ghost_poll(void);
+
+/* Determines the time gap to the ghost at the same distance. dist in 1/10 m, time in 1/10 s.
+ * Returns true, if the gap is valid. gap is positive if behind the ghost. */
+bool ghost_getGap(uint32_t dist, uint32_t time, int32_t * gap);
+
+#endif /* GHOST_H_ */
@@ -151,6 +151,32 @@ void gps_resetComputedValues(void)
 	setTsr();
 }
 
+/*
+ * Restores computed values from a checkpoint, must be called on a valid fix.
+ * The previous position and altitude are taken from the current fix.
+ * dist, altUp, altDwn	distance and altitude made good
+ * spdMax				maximum speed
+ * resetTime			GPS time of the last reset, reference of the time since reset
+ */
+void gps_restoreComputedValues(uint32_t dist, uint32_t altUp, uint32_t altDwn, uint16_t spdMax, gps_time_t resetTime)
+{
+	gps_resetComputedValues();
+	avgStartTime = resetTime;
+	gps_data.dist = dist;
+	gps_data.altUp = altUp;
+	gps_data.altDwn = altDwn;
+	gps_data.spdMax = spdMax;
+	setTsr();
+}
+
+/*
+ * Returns the GPS time of the last reset of the computed values.
+ */
+gps_time_t gps_getResetTime(void)
+{
+	return avgStartTime;
+}
+
 /* 
  * Set Time Since Reset (TSR)
  */
@@ -799,3 +825,17 @@ uint32_t gps_calcDist(gps_coordinate_t p1Lat, gps_coordinate_t p1Lon,
 
 	return dist;
 }
+
+/*
+ * Converts a coordinate to a signed integer in 1e-5 degree (negative for S and W).
+ * coo		the coordinate to be converted
+ */
+int32_t gps_coordToInt(gps_coordinate_t coo)
+{
+	int32_t val;
+
+	val = (int32_t)coo.coord_int * 100000 + (int32_t)coo.coord_fract;
+	if(coo.NSEW=='S' || coo.NSEW=='W') val = -val;
+
+	return val;
+}
@@ -127,6 +127,13 @@ void gps_resetValues(void);
 /* Reset variables that are computed and are intended to be reset by the user. */
 void gps_resetComputedValues(void);
 
+/* Restores computed values from a checkpoint, must be called on a valid fix.
+ * resetTime is the GPS time of the last reset (reference of the time since reset). */
+void gps_restoreComputedValues(uint32_t dist, uint32_t altUp, uint32_t altDwn, uint16_t spdMax, gps_time_t resetTime);
+
+/* Returns the GPS time of the last reset of the computed values. */
+gps_time_t gps_getResetTime(void);
+
 /* Calculates all data in the gps_data struct. Must be called prior to reading gps_data struct.
  * Distance must be the latest value by calling gps_computeDist(). */
 uint8_t gps_computeData(void);
@@ -163,5 +170,8 @@ inline gps_data_t gps_getData(void);
 uint32_t gps_calcDist(gps_coordinate_t p1Lat, gps_coordinate_t p1Lon,
 						gps_coordinate_t p2Lat, gps_coordinate_t p2Lon);
 
+/* Converts a coordinate to a signed integer in 1e-5 degree (negative for S and W). */
+int32_t gps_coordToInt(gps_coordinate_t coo);
+
 
 #endif /* GPS_H_ */
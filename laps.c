@@ -0,0 +1,166 @@
+/*
+ * laps.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "laps.h"
+#include "conversion.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#if (LAP_MAX & (LAP_MAX-1)) != 0
+#error "LAP_MAX must be a power of 2"
+#endif
+
+/* ################### internal variables ################### */
+
+static lap_t		laps[LAP_MAX];		/* ring of the most recent laps, indexed by (num-1) & (LAP_MAX-1) */
+static uint16_t		lapCnt;				/* finished laps since reset */
+static lap_t		best, worst;
+static uint32_t		markTime;			/* ms, stopwatch time of the last lap mark */
+static uint32_t		markDist;			/* 1/10 m, distance of the last lap mark */
+
+/* ################### function definitions ################### */
+
+/*
+ * Resets all laps.
+ * dist		the distance at the start of the first lap in 1/10 m
+ */
+void laps_reset(uint32_t dist)
+{
+	lapCnt = 0;
+	best.num = 0;
+	worst.num = 0;
+	markTime = 0;
+	markDist = dist;
+}
+
+/*
+ * Marks the end of the current lap and starts the next one.
+ * time		the stopwatch value in ms
+ * dist		the current distance in 1/10 m
+ * Returns	the finished lap
+ */
+lap_t laps_mark(uint32_t time, uint32_t dist)
+{
+	lap_t * l = &laps[lapCnt & (LAP_MAX-1)];
+
+	lapCnt++;
+	l->num = lapCnt;
+	l->time = time - markTime;
+	l->dist = (dist>markDist) ? dist - markDist : 0;
+	l->spdAvg = (l->time>0) ? (uint16_t)((uint64_t)l->dist * 3600 / l->time) : 0;
+
+	if(best.num==0 || l->time<best.time) best = *l;
+	if(worst.num==0 || l->time>worst.time) worst = *l;
+
+	markTime = time;
+	markDist = dist;
+	return *l;
+}
+
+/*
+ * Returns the number of finished laps since reset.
+ */
+uint16_t laps_getCount(void)
+{
+	return lapCnt;
+}
+
+/*
+ * Returns a finished lap.
+ * back		0 for the most recent lap, 1 for the lap before, ...
+ */
+lap_t laps_get(uint16_t back)
+{
+	lap_t none = {0, 0, 0, 0};
+
+	if(back>=lapCnt || back>=LAP_MAX) return none;
+	return laps[(lapCnt-1-back) & (LAP_MAX-1)];
+}
+
+/*
+ * Returns the best (fastest) lap since reset.
+ */
+lap_t laps_getBest(void)
+{
+	return best;
+}
+
+/*
+ * Returns the worst (slowest) lap since reset.
+ */
+lap_t laps_getWorst(void)
+{
+	return worst;
+}
+
+/*
+ * Returns the running time of the current lap in ms.
+ * time		the stopwatch value in ms
+ */
+uint32_t laps_getCurrent(uint32_t time)
+{
+	return (time>markTime) ? time - markTime : 0;
+}
+
+/*
+ * Returns the delta of the most recent lap to the best lap in ms.
+ */
+int32_t laps_getDelta(void)
+{
+	if(lapCnt==0) return 0;
+	return (int32_t)laps[(lapCnt-1) & (LAP_MAX-1)].time - (int32_t)best.time;
+}
+
+/*
+ * Writes an event line "LAP,<num>,<hh:mm:ss.mmm>,<dist m>,<avg km/h>" of a lap.
+ * lap		the lap
+ * buffer	the destination, min. 40 chars
+ */
+char * laps_toText(lap_t lap, char * buffer)
+{
+	uint8_t i = 0;
+
+	buffer[i++] = 'L'; buffer[i++] = 'A'; buffer[i++] = 'P';
+	buffer[i++] = ',';
+	ui16ToA(lap.num, &buffer[i], 4, false);
+	i+=4;
+	buffer[i++] = ',';
+
+	ui8ToA(lap.time/3600000UL, &buffer[i], 2);
+	i+=2;
+	buffer[i++] = ':';
+	ui8ToA((lap.time/60000UL)%60, &buffer[i], 2);
+	i+=2;
+	buffer[i++] = ':';
+	ui8ToA((lap.time/1000UL)%60, &buffer[i], 2);
+	i+=2;
+	buffer[i++] = '.';
+	ui16ToA(lap.time%1000, &buffer[i], 3, false);
+	i+=3;
+	buffer[i++] = ',';
+
+	//	Distance: ddddd.d
+	ui32ToA(lap.dist, &buffer[i], 6);
+	buffer[i+6] = buffer[i+5];
+	buffer[i+5] = '.';
+	i+=7;
+	buffer[i++] = ',';
+
+	//	Speed: sss.s
+	ui16ToA(lap.spdAvg, &buffer[i], 4, false);
+	buffer[i+4] = buffer[i+3];
+	buffer[i+3] = '.';
+	i+=5;
+
+	buffer[i++] = '\r';
+	buffer[i++] = '\n';
+	buffer[i] = 0;
+
+	return buffer;
+}
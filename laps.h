@@ -0,0 +1,56 @@
+/*
+ * laps.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: laps.h provides a lap timer based on the stopwatch. The most recent LAP_MAX laps are
+ *       		stored in a ring with lap time, distance and average speed. Best and worst lap and the
+ *       		delta to the best lap are maintained over all laps, each lap mark costs O(1).
+ */
+
+#ifndef LAPS_H_
+#define LAPS_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LAP_MAX				32		/* laps stored in the ring, power of 2 */
+
+typedef struct {
+	uint16_t	num;		/* lap number, starting at 1 */
+	uint32_t	time;		/* ms, lap time */
+	uint32_t	dist;		/* 1/10 m, lap distance */
+	uint16_t	spdAvg;		/* 1/10 km/h, average lap speed */
+} lap_t;
+
+
+/* Resets all laps. The first lap starts at stopwatch time 0 and distance dist (1/10 m). */
+void laps_reset(uint32_t dist);
+
+/* Marks the end of the current lap. time is the stopwatch value in ms, dist in 1/10 m. Returns the finished lap. */
+lap_t laps_mark(uint32_t time, uint32_t dist);
+
+/* Returns the number of finished laps since reset. */
+uint16_t laps_getCount(void);
+
+/* Returns a finished lap, back=0 is the most recent lap. Returns a lap with num=0 if not stored. */
+lap_t laps_get(uint16_t back);
+
+/* Returns the best (fastest) lap, num=0 if no lap finished. */
+lap_t laps_getBest(void);
+
+/* Returns the worst (slowest) lap, num=0 if no lap finished. */
+lap_t laps_getWorst(void);
+
+/* Returns the running time of the current lap in ms. */
+uint32_t laps_getCurrent(uint32_t time);
+
+/* Returns the delta of the most recent lap to the best lap in ms (0 if it is the best lap). */
+int32_t laps_getDelta(void);
+
+/* Writes an event line "LAP,<num>,<hh:mm:ss.mmm>,<dist m>,<avg km/h>" of lap to buffer (min. 40 chars). */
+char * laps_toText(lap_t lap, char * buffer);
+
+#endif /* LAPS_H_ */
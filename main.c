@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 #include "inc/tm4c1294ncpdt.h"
 #include "driverlib/gpio.h"
@@ -45,6 +46,22 @@
 #include "time.h"
 #include "conversion.h"
 #include "config.h"
+#include "route.h"
+#include "splits.h"
+#include "segments.h"
+#include "ghost.h"
+#include "laps.h"
+#include "checkpoint.h"
+#include "uart.h"
+#include "dlog.h"
+#include "console.h"
+#include "export.h"
+#include "telem.h"
+#include "trace.h"
+#include "spi_trace.h"
+#include "prof.h"
+#include "memstat.h"
+#include "cpuload.h"
 
 
 #define SPISPEED	(10e6)
@@ -69,8 +86,10 @@ uint32_t lastGPStick = 99999;
 uint32_t ticksToFF = 0; 			/* 500 ms ticks to first fix */
 
 bool rec = false;					/* true, if currently recording */
+bool recset = false;				/* true, if recording is requested */
+int8_t reqPage = -1;				/* display page requested by the console, -1 if none */
 
-char mainbuffer[40];
+char mainbuffer[PROF_TEXTLEN > UART_STATSTEXTLEN ? PROF_TEXTLEN : UART_STATSTEXTLEN];
 
 
 /* ------------------------------
@@ -81,7 +100,52 @@ char mainbuffer[40];
 void GPIO_init(void);
 void Timer_init(void);
 
-void handleUARTData(char data);
+void debugRX(char c);
+
+/* debug console commands */
+void cmd_get(uint8_t argc, char * argv[]);
+void cmd_set(uint8_t argc, char * argv[]);
+void cmd_save(uint8_t argc, char * argv[]);
+void cmd_gps(uint8_t argc, char * argv[]);
+void cmd_uart(uint8_t argc, char * argv[]);
+void cmd_sd(uint8_t argc, char * argv[]);
+void cmd_prof(uint8_t argc, char * argv[]);
+void cmd_log(uint8_t argc, char * argv[]);
+void cmd_page(uint8_t argc, char * argv[]);
+void cmd_stpw(uint8_t argc, char * argv[]);
+void cmd_reset(uint8_t argc, char * argv[]);
+void cmd_dlog(uint8_t argc, char * argv[]);
+void cmd_xfer(uint8_t argc, char * argv[]);
+void cmd_telem(uint8_t argc, char * argv[]);
+void cmd_trace(uint8_t argc, char * argv[]);
+void cmd_mem(uint8_t argc, char * argv[]);
+void cmd_cpu(uint8_t argc, char * argv[]);
+void cmd_spi(uint8_t argc, char * argv[]);
+void cmd_spitrace(uint8_t argc, char * argv[]);
+void cmd_ghost(uint8_t argc, char * argv[]);
+
+const console_cmd_t commands[] = {
+	{ "get",	"get [key] - shows a config value or all",	cmd_get },
+	{ "set",	"set key value - sets a config value",		cmd_set },
+	{ "save",	"writes the config file",					cmd_save },
+	{ "gps",	"shows GPS data",							cmd_gps },
+	{ "uart",	"shows UART statistics",					cmd_uart },
+	{ "sd",		"shows SD card, log and segment statistics",	cmd_sd },
+	{ "prof",	"prof [reset] - runtime statistics (cycles)",	cmd_prof },
+	{ "log",	"log start|stop",							cmd_log },
+	{ "page",	"page n - shows display page n",			cmd_page },
+	{ "stpw",	"stpw start|stop|reset",					cmd_stpw },
+	{ "reset",	"resets distance, altitude, splits",		cmd_reset },
+	{ "dlog",	"dlog on|off - binary log records",			cmd_dlog },
+	{ "xfer",	"xfer [baud] - log export (tools/logxfer.py)",	cmd_xfer },
+	{ "telem",	"telem on|off - binary telemetry per GPS epoch",	cmd_telem },
+	{ "trace",	"trace on|off|clear|dump - event trace",	cmd_trace },
+	{ "mem",	"shows stack usage (bytes)",				cmd_mem },
+	{ "cpu",	"cpu [reset] - main loop load (0.1 %, us)",	cmd_cpu },
+	{ "spi",	"SPI bus arbitration per process (us)",		cmd_spi },
+	{ "spitrace",	"spitrace on|off|clear|dump - SPI bus recorder (tools/spidecode.py)",	cmd_spitrace },
+	{ "ghost",	"ghost file - races against a track log in " LOG_DIR,	cmd_ghost }
+};
 
 void Timer0AIntHandler(void);
 
@@ -128,6 +192,10 @@ void Timer0AIntHandler(void)
 	// Interrupt Flag lschen
 	TimerIntClear(TIMER0_BASE, TIMER_TIMA_TIMEOUT);
 
+	//------------------------------------------------
+	// 1 ms ticks
+	time_tick1Ms();		/* stopwatch */
+
 	//------------------------------------------------
 	// 100 ms ticks
 	static int cnt=55;
@@ -188,23 +256,42 @@ void Timer0AIntHandler(void)
  */
 
 int main(void) {
-	bool stpwRun = false;			/* true, if stopwatch is running */
+	/* The larger structures are static, main() never returns. This keeps them off the system stack,
+	 * which is shared with the deepest call chains (config file, log writes, log export). */
+	static gps_nmea_data_t tmpNmea;		/* temporary raw nmea data */
+	static gps_data_t tmpGps;			/* temporary processed gps data */
+	static uint32_t meas[TELEM_MEASCNT];	/* runtimes sent with the telemetry */
+	static route_data_t tmpRoute;		/* temporary route following data */
+	static split_t tmpSplit;			/* temporary split data */
+	static cpuload_t tmpLoad;			/* temporary main loop load */
+	static seg_status_t tmpSeg;			/* temporary segment effort data */
+	static lap_t tmpLap;				/* temporary lap data */
+	static char fnmlog[CHKPT_NAMELEN];	/* current log file names */
+	static char fnmevent[CHKPT_NAMELEN];
+	static chkpt_data_t chk;			/* trip checkpoint */
 	time_t tmpTime, tmpStpw;		/* current time and stopwatch */
 	date_t tmpDate;
-	gps_nmea_data_t tmpNmea;		/* temporary raw nmea data */
-	gps_data_t tmpGps;				/* temporary processed gps data */
 	uint8_t selPage = 0;			/* selected display page */
 	uint32_t debugCnt;
 	uint8_t retval;
 	uint8_t sdintvl = 0;
 	uint8_t sdcalc = 0;
-	bool recset = rec;
+	uint8_t calc;
+	int32_t ghostGap;				/* time gap to the ghost */
+	uint8_t i;
 	uint32_t tmplogdist;
+	bool resume = false;			/* true, until values of a checkpoint have been restored */
+	bool resumeLog = false;			/* true, until a log file of a checkpoint has been reopened */
+	uint8_t chkptcnt = 0;
+	uint8_t profcnt = 0;
 	uint8_t displaystate = 1;		/* 0=off, 1=on, 2=dim */
 	uint32_t displaytimer = 0;
 	bool config_menu = false;
 	int8_t config_selected;
 
+	/* Paint the unused stack for the high-water mark */
+	memstat_paint();
+
 	/* Interrupts global on */
     IntMasterDisable();
 
@@ -221,7 +308,9 @@ int main(void) {
 
     /* Initialise Debugging interface */
     debug_init(g_ui32SysClock);
-    debug_RXHook(handleUARTData);
+    trace_init(g_ui32SysClock);
+    console_init(commands, sizeof(commands)/sizeof(commands[0]));
+    debug_RXHook(debugRX);
 
     /* Initialise Key/Button/switch debouncing functions */
     Key_init();
@@ -241,6 +330,22 @@ int main(void) {
     /* Read config file */
     conf_read();
 
+    /* Initialise best split detection and lap timer */
+    splits_reset();
+    laps_reset(0);
+
+    /* Resume trip after power loss. The checkpoint is restored on the first fix, if it is not too old. */
+    chkpt_init();
+    resume = chkpt_load(&chk);
+
+    /* Load route and segments from SD card */
+    if(!sd_mount(LOG_DIR))
+    {
+    	route_load(ROUTE_GPXFILE);
+    	segments_load();
+    	ghost_open(GHOST_FILENAME);
+    }
+
 	/* Interrupts global on */
     IntMasterEnable();
 
@@ -266,12 +371,19 @@ int main(void) {
 	if(conf.logAutoStart) recset = true;
 	if(conf.demo) Demo();
 
+    /* Start the main loop load measurement */
+    cpuload_init(g_ui32SysClock);
+
     /* ---===### Infinite Loop ###===--- */
     while(1)
     {	
+    	/* Account the last loop pass as busy or idle time */
+    	cpuload_loop(_100msFlag || _500msFlag || _5sFlag || export_active());
+
 		/* Check if keys are pressed short or long */
     	if(Key_getState(0x0F))
     	{
+    		cpuload_work(true);		/* the key actions below redraw pages and write log entries */
     		displaytimer = 0;
     		if(displaystate==0)
     			{
@@ -283,6 +395,16 @@ int main(void) {
     		displaystate = 1;
     	}
 
+    	/* Show the page requested by the console, this leaves the configuration menu */
+    	if(reqPage>=0)
+    	{
+    		cpuload_work(true);
+    		config_menu = false;
+    		selPage = (uint8_t)reqPage;
+    		reqPage = -1;
+    		display_setPage(selPage);
+    	}
+
     	if(config_menu)	/* currently within configuration menu, configuration button actions */
     	{
     		if(Key_getShort(1<<0))
@@ -322,17 +444,22 @@ int main(void) {
     	{
 			if(Key_getShort(1<<0))
 			{
-				if(stpwRun)	stpw_stop(); else stpw_start();
-				stpwRun = !stpwRun;
+				if(stpw_running())	stpw_stop();
+				else
+				{
+					if(stpw_ms()==0) laps_reset(tmpGps.dist);	/* first lap starts with the stopwatch */
+					stpw_start();
+				}
 			}
 			if(Key_getLong(1<<0))
 			{
 				stpw_reset();
+				laps_reset(tmpGps.dist);
 			}
 			if(Key_getLong(1<<1))
 			{
 				config_menu = true;
-				display_setPage(3);
+				display_setPage(GP_CONFPAGE);
 				config_selected = CFG_FIRSTEDIT;
 				display_conf(config_selected, sSelection);
 			}
@@ -342,6 +469,12 @@ int main(void) {
 					retval = logDataSet(tmpDate, tmpTime, tmpGps.lat, tmpGps.lon, tmpGps.alt, tmpNmea.Height,
 							tmpGps.spd, tmpGps.dist - tmplogdist, tmpNmea.NumSatFix, tmpNmea.PDOP,
 							((uint8_t)(tmpNmea.GPSFixType)<<4)|tmpNmea.GPSFixQuality, 0, true);
+				if(stpw_running())		/* lap mark */
+				{
+					tmpLap = laps_mark(stpw_ms(), tmpGps.dist);
+					if(sd_initialised() && rec)
+						retval = log_Text(laps_toText(tmpLap, mainbuffer));
+				}
 			}
 			if(Key_getLong(1<<2))
 			{
@@ -355,6 +488,8 @@ int main(void) {
 			if(Key_getLong(1<<3))
 			{
 				gps_resetComputedValues();
+				splits_reset();
+				ghost_rewind();
 				tmplogdist = 0;
 			}
     	}
@@ -371,7 +506,7 @@ int main(void) {
     			display_GPS(0, 0, 99);
     		}
 
-    		debug_startMeas();
+    		PROF_BEGIN(PR_DISPLAY);
 			
 			display_Time(tmpTime.hr, tmpTime.min, tmpTime.sec);
 			display_GPS(tmpNmea.NumSatFix, tmpNmea.GPSFixType, tmpNmea.HDOP);
@@ -383,13 +518,35 @@ int main(void) {
 			if(ticksToFF==0 && (tmpNmea.GPSFixType==3) && (tmpNmea.GPSFixQuality!=0))
 			{ 
 				ticksToFF = ticks;
-				gps_resetComputedValues();
+				dlog1(DLOG_FIRSTFIX, ticksToFF);
+				if(resume && !chkpt_expired(&chk, chkpt_timestamp(tmpNmea.Date, tmpNmea.Time)))
+				{
+					gps_restoreComputedValues(chk.dist, chk.altUp, chk.altDwn, chk.spdMax, chk.resetTime);
+					tmplogdist = chk.logDist;
+					stpw_set(chk.stpw);
+					if(chk.stpwRun) stpw_start();
+					if(chk.rec)
+					{
+						recset = true;
+						resumeLog = true;
+						strncpy(fnmlog, chk.logName, CHKPT_NAMELEN);
+						strncpy(fnmevent, chk.eventName, CHKPT_NAMELEN);
+					}
+				}
+				else
+					gps_resetComputedValues();
+				resume = false;
+				splits_reset();
+				ghost_rewind();
 				sdintvl=0;
 			}
 			
     		display_Alt((tmpGps.alt+5)/10, (tmpGps.altUp+5)/10, (tmpGps.altDwn+5)/10); /* 5s */
     		display_Speed((tmpGps.spd+5)/10, (tmpGps.spdAvg+5)/10, (tmpGps.spdMax+5)/10);
 			display_Dist(tmpGps.dist/10); /* 5s */
+			retval = ghost_getGap(tmpGps.dist,
+					(((tmpGps.tsr.day*24U + tmpGps.tsr.h)*60U + tmpGps.tsr.m)*60U + tmpGps.tsr.s)*10U, &ghostGap);
+			display_Ghost(retval, ghostGap);
     		
     		display_Tsr(tmpGps.tsr.day, tmpGps.tsr.h, tmpGps.tsr.m, tmpGps.tsr.s);
     		display_Satinfo(tmpNmea.NumSatView,tmpNmea.NumSatFix, tmpNmea.PDOP, tmpNmea.HDOP, tmpNmea.VDOP);
@@ -400,9 +557,26 @@ int main(void) {
 			display_Satov(tmpNmea.NumSatView, tmpNmea.NumSatFix, tmpNmea.SatsInView->ID, tmpNmea.SatsInView->SNR, 
 					tmpNmea.SatsInFix);
 
-    		debugCnt = debug_getMeas();
-    		//debug_print("\r\nD: ");
-    		//debug_printMeas(debugCnt);
+			tmpRoute = route_getData();
+			display_Route(tmpRoute.state, tmpRoute.distToGo/10, tmpRoute.xte/10, tmpRoute.turnBrg, tmpRoute.turnDist/10);
+
+			for(i=0; i<SPLIT_NUM; i++)
+			{
+				tmpSplit = splits_get(i);
+				display_Split(i, tmpSplit.dist/10000, tmpSplit.best, tmpSplit.last);
+			}
+
+			tmpSeg = segments_getStatus(ticks);
+			display_Segment(tmpSeg.state, tmpSeg.name, tmpSeg.elapsed, tmpSeg.delta, tmpSeg.best, tmpSeg.progress);
+
+			tmpLoad = cpuload_get();
+			display_Diag(tmpLoad.load1, tmpLoad.load10, tmpLoad.passMax, tmpLoad.passMaxAll, tmpLoad.passes,
+					memstat_stackUsed(), memstat_stackSize());
+
+    		debugCnt = PROF_END(PR_DISPLAY);
+    		if(!config_menu && selPage <= PR_DISPLAY_P7-PR_DISPLAY_P0)
+    			prof_add((prof_id_e)(PR_DISPLAY_P0 + selPage), debugCnt);
+    		dlog1(DLOG_MEAS_DISP, debugCnt);
 
     		if(sd_inserted())
     		{
@@ -430,19 +604,60 @@ int main(void) {
     		display_Battery(100);
 
     		display_TTFF(ticksToFF/10);
+
+    		/* save trip checkpoint while recording, not before the first fix to keep the checkpoint of a
+    		 * previous run. The checkpoint refers to the log sizes of the last completed sync, which are
+    		 * on the card; then the next sync is started, it runs one file per pass in log_SyncPoll(). */
+    		if(++chkptcnt >= CHKPT_INTERVAL/5 && ticksToFF!=0 && rec)
+    		{
+    			chkptcnt = 0;
+    			chk.dist = tmpGps.dist;
+    			chk.altUp = tmpGps.altUp;
+    			chk.altDwn = tmpGps.altDwn;
+    			chk.spdMax = tmpGps.spdMax;
+    			chk.resetTime = gps_getResetTime();
+    			chk.stpw = stpw_ms();
+    			chk.stpwRun = stpw_running();
+    			chk.logDist = tmplogdist;
+    			chk.rec = rec;
+    			chk.saveTime = chkpt_timestamp(tmpNmea.Date, tmpNmea.Time);
+    			chk.logSize = log_SyncedSize(0);
+    			chk.eventSize = log_SyncedSize(1);
+    			strncpy(chk.logName, fnmlog, CHKPT_NAMELEN);
+    			strncpy(chk.eventName, fnmevent, CHKPT_NAMELEN);
+    			chkpt_save(&chk);
+    			log_SyncStart();
+    		}
+
+    		/* write the runtime statistics and the main loop load to the event log */
+    		if(++profcnt >= PROF_LOGINTVL/5)
+    		{
+    			profcnt = 0;
+    			if(rec)
+    			{
+    				for(i=0; i<PROF_IDCOUNT; i++)
+    					if(prof_toText((prof_id_e)i, mainbuffer)) log_Text(mainbuffer);
+    				if(cpuload_toText(mainbuffer)) log_Text(mainbuffer);
+    			}
+    		}
     	}
 		
 		/* Perform some actions every 100 milliseconds */
     	if(_100msFlag)
     	{
     		_100msFlag = 0;
+    		TRACE_INSTANT(TR_TICK, ticks);
     		tmpStpw = stpw();
 
     		sdintvl++;
 
     		display_Stpw(tmpStpw.hr, tmpStpw.min, tmpStpw.sec, tmpStpw.ms);
+    		display_Laps(laps_getCount()+1, laps_getCurrent(stpw_ms()), laps_get(0).time,
+    				laps_getBest().time, laps_getWorst().time, laps_getDelta());
 
+    		PROF_BEGIN(PR_GPS_PARSE);
     		retval = gps_checkUart();
+    		PROF_END(PR_GPS_PARSE);
     		if(retval)
     		{
     			lastGPStick = ticks;
@@ -450,16 +665,32 @@ int main(void) {
 				if(retval==1)
 					time_sync(tmpNmea.Date.y, tmpNmea.Date.m, tmpNmea.Date.d, tmpNmea.Time.h, tmpNmea.Time.m, tmpNmea.Time.s);
 
-    		debug_startMeas();
-
+    			PROF_BEGIN(PR_GPS_COMPUTE);
     			sdcalc = gps_computeData();
+    			PROF_END(PR_GPS_COMPUTE);
+    			calc = sdcalc;				/* gates the route, split and segment updates */
     			if(!conf.logDebug) sdcalc = 0;
 
-    		debugCnt = debug_getMeas();
-    		//debug_print("\r\nG: ");
-    		//debug_printMeas(debugCnt);
-
     			tmpGps = gps_getData();
+    			if(calc & GPS_CALC_C)
+    			{
+    				PROF_BEGIN(PR_GPS_MATCH);
+    				route_update(tmpGps.lat, tmpGps.lon);
+    				splits_update(tmpGps.dist, ticks);
+    				segments_update(tmpGps.lat, tmpGps.lon, ticks, tmpDate, tmpTime);
+    				PROF_END(PR_GPS_MATCH);
+    			}
+
+    			dlog1(DLOG_MEAS_GPS, prof_getLast(PR_GPS_COMPUTE));
+
+    			/* stream the epoch (decode with tools/telem_rx.py), not while the log export uses the UART */
+    			if(!export_active())
+    			{
+    				meas[0] = prof_getLast(PR_DISPLAY);
+    				meas[1] = prof_getLast(PR_GPS_COMPUTE);
+    				meas[2] = prof_getLast(PR_SD);
+    				telem_send(&tmpNmea, &tmpGps, ticks, meas);
+    			}
     		}
 	
 			tmpTime = time();
@@ -480,94 +711,343 @@ int main(void) {
 		}
 
     	/* Check if data has been received on debug interface (USB-UART) */
-    	debug_checkRX();
+    	cpuload_work(debug_checkRX());
+
+    	/* Send log export frames */
+    	PROF_BEGIN(PR_EXPORT);
+    	export_poll(ticks);
+    	PROF_END(PR_EXPORT);
+
+    	/* Write pending trace dump lines, not while the log export uses the UART */
+    	if(!export_active())
+    	{
+    		cpuload_work(trace_poll());
+    		cpuload_work(spitrace_poll());
+    	}
+
+    	/* Read ahead ghost track */
+    	PROF_BEGIN(PR_GHOST);
+    	cpuload_work(ghost_poll());
+    	PROF_END(PR_GHOST);
+
+    	/* Write pending checkpoint to EEPROM */
+    	cpuload_work(chkpt_poll());
+    	cpuload_work(log_SyncPoll());
 
     	if((sdintvl>=conf.logIntvl) || sdcalc)
     	{
     		sdintvl = 0;
 
-    		debug_startMeas();
+    		PROF_BEGIN(PR_SD);
 
     		if(sd_inserted())
     		{
     			if (recset && !rec && ticksToFF!=0)	/* record can be started after first fix */
     			{
     				rec=recset;
+    				/* continue the log files of a checkpoint, otherwise start new ones */
+    				if(!resumeLog || log_Resume(fnmlog, fnmevent, chk.logSize, chk.eventSize))
 					{
-						char fnmlog[50];
-						char fnmevent[50];
 						log_getNextID(fnmlog, tmpTime, tmpDate, false);
 						log_getNextID(fnmevent, tmpTime, tmpDate, true);
+						PROF_BEGIN(PR_LOG_START);
 						retval = log_Start(fnmlog, fnmevent);
+						PROF_END(PR_LOG_START);
+						dlog1(DLOG_LOGSTART, retval);
+						tmplogdist = tmpGps.dist;
 					}
-					
-    				tmplogdist = tmpGps.dist;
+    				resumeLog = false;
     			}
     			if(rec)
     			{
+    				PROF_BEGIN(PR_LOG_WRITE);
     				retval = logDataSet(tmpDate, tmpTime, tmpGps.lat, tmpGps.lon, tmpGps.alt, tmpNmea.Height,
     						tmpGps.spd, tmpGps.dist - tmplogdist, tmpNmea.NumSatFix, tmpNmea.PDOP,
     						((uint8_t)(tmpNmea.GPSFixType)<<4)|tmpNmea.GPSFixQuality, sdcalc, false);
+    				PROF_END(PR_LOG_WRITE);
+    				if(retval) dlog1(DLOG_LOGWRITE, retval);
         			tmplogdist = tmpGps.dist;
         			sdcalc = 0;
     			}
     			if(!recset && rec)
     			{
     				rec=recset;
+    				for(i=0; i<SPLIT_NUM; i++)
+    					log_Text(splits_toText(i, mainbuffer));
+    				for(i=0; i<=UART_MAX; i++)
+    					if(UART_statsToText(i, mainbuffer)) log_Text(mainbuffer);
+    				for(i=0; i<PROF_IDCOUNT; i++)
+    					if(prof_toText((prof_id_e)i, mainbuffer)) log_Text(mainbuffer);
+    				if(cpuload_toText(mainbuffer)) log_Text(mainbuffer);
+    				for(i=1; i<=SPI_MAXPROC; i++)
+    					if(SPI_statsToText(i, mainbuffer)) log_Text(mainbuffer);
     				retval = log_Stop();
+    				dlog1(DLOG_LOGSTOP, retval);
+    				resumeLog = false;
+    				chkpt_clear();		/* the log has been closed intentionally, do not resume it */
     			}
     		}
 
-    		debugCnt = debug_getMeas();
-    		//debug_print("\r\nS: ");
-    		//debug_printMeas(debugCnt);
+    		debugCnt = PROF_END(PR_SD);
+    		dlog1(DLOG_MEAS_SD, debugCnt);
     	}
     }
 }
 
-/* Handle data received on debug interface (USB-UART) */
-void handleUARTData(char data)
+/* Passes a char received over the debug interface to the log export while active, else to the console */
+void debugRX(char c)
 {
-	//static uint8_t pin = 0;
+	if(export_active()) export_input(c);
+	else console_input(c);
+}
 
-	if (data=='s')			/* 's' starts stopwatch */
-	{
-		stpw_start();
-	}
-	else if (data=='p')		/* 'p' stops stopwatch */
+/* ------------------------------
+ * C O N S O L E   C O M M A N D S
+ * ------------------------------
+ */
+
+/* get [key]: shows a config value or all config values */
+void cmd_get(uint8_t argc, char * argv[])
+{
+	char buffer[12];
+	int8_t key;
+	uint8_t i;
+
+	for(i=0; i<CFG_CNT; i++)
 	{
-		stpw_stop();
+		if(argc>1)
+		{
+			key = conf_findKey(argv[1]);
+			if(key<0) { console_print("unknown key\r\n"); return; }
+			i = key;
+		}
+		console_print(conf_getKeyName(i));
+		console_print("=");
+		console_print(conf_getValue(i, buffer));
+		console_print("\r\n");
+		if(argc>1) return;
 	}
-	else if (data=='r')		/* 'r' resets stopwatch */
+}
+
+/* set key value: sets a config value, as written in the config file */
+void cmd_set(uint8_t argc, char * argv[])
+{
+	int8_t key;
+
+	if(argc<3) { console_print("usage: set key value\r\n"); return; }
+	key = conf_findKey(argv[1]);
+	if(key<0) { console_print("unknown key\r\n"); return; }
+
+	conf_setValue(key, argv[2]);
+	cmd_get(2, argv);
+}
+
+/* save: writes the config file */
+void cmd_save(uint8_t argc, char * argv[])
+{
+	if(log_active()) { console_print("stop the log first\r\n"); return; }	/* file object is shared with the log */
+	console_printValue("result", conf_write());
+}
+
+/* gps: shows GPS data */
+void cmd_gps(uint8_t argc, char * argv[])
+{
+	gps_nmea_data_t nmea = gps_getRawData();
+	gps_data_t gps = gps_getData();
+
+	console_printValue("fix", nmea.GPSFixType);
+	console_printValue("quality", nmea.GPSFixQuality);
+	console_printValue("satsFix", nmea.NumSatFix);
+	console_printValue("satsView", nmea.NumSatView);
+	console_printValue("hdop", nmea.HDOP);
+	console_printValue("pdop", nmea.PDOP);
+	console_printValue("lat", gps_coordToInt(gps.lat));
+	console_printValue("lon", gps_coordToInt(gps.lon));
+	console_printValue("alt", gps.alt);
+	console_printValue("spd", gps.spd);
+	console_printUValue("dist", gps.dist);
+	console_printUValue("ttff", ticksToFF);
+	console_printUValue("lastFix", ticks - lastGPStick);
+}
+
+/* uart: shows UART statistics */
+void cmd_uart(uint8_t argc, char * argv[])
+{
+	uint8_t i;
+
+	for(i=0; i<=UART_MAX; i++)
+		if(UART_statsToText(i, mainbuffer)) console_print(mainbuffer);
+	console_printUValue("dlogDropped", dlog_getDropped());
+	console_printUValue("xferResent", export_getResent());
+	console_printUValue("telemDropped", telem_getDropped());
+}
+
+/* sd: shows SD card and log statistics */
+void cmd_sd(uint8_t argc, char * argv[])
+{
+	sd_stats_t sd = sd_getStats();
+
+	console_printValue("inserted", sd_inserted());
+	console_printValue("initialised", sd_initialised());
+	console_printValue("logging", log_active());
+	console_printUValue("records", sd.records);
+	console_printUValue("bytes", sd.bytes);
+	console_printUValue("errors", sd.errors);
+	console_printValue("lastError", sd.lastError);
+	console_printUValue("clock", sd.clock);
+	console_printUValue("linkErrors", sd.linkErrors);
+	console_printUValue("backoffs", sd.backoffs);
+	console_printUValue("segments", segments_getCount());
+	console_printUValue("segDropped", segments_getDropped());
+}
+
+/* prof [reset]: shows the runtime statistics of the profiling regions: count, min, mean, max, log2 histogram */
+void cmd_prof(uint8_t argc, char * argv[])
+{
+	uint8_t i;
+
+	if(argc>1 && strcmp(argv[1], "reset")==0) { prof_reset(); return; }
+	for(i=0; i<PROF_IDCOUNT; i++)
+		if(prof_toText((prof_id_e)i, mainbuffer)) console_print(mainbuffer);
+}
+
+/* mem: shows the stack size, the maximum usage since startup and the current usage */
+void cmd_mem(uint8_t argc, char * argv[])
+{
+	console_printUValue("stackSize", memstat_stackSize());
+	console_printUValue("stackMax", memstat_stackUsed());
+	console_printUValue("stackNow", memstat_stackNow());
+}
+
+/* cpu [reset]: shows the main loop load of the last 1 s and 10 s and the longest loop pass */
+void cmd_cpu(uint8_t argc, char * argv[])
+{
+	cpuload_t load;
+
+	if(argc>1 && strcmp(argv[1], "reset")==0) cpuload_reset();
+	load = cpuload_get();
+	console_printValue("load1", load.load1);
+	console_printValue("load10", load.load10);
+	console_printUValue("passMax", load.passMax);
+	console_printUValue("passMaxAll", load.passMaxAll);
+	console_printUValue("passes", load.passes);
+}
+
+/* spi: shows priority, bus grants, waits for the bus and yields of each SPI process */
+void cmd_spi(uint8_t argc, char * argv[])
+{
+	uint8_t i;
+
+	for(i=1; i<=SPI_MAXPROC; i++)
+		if(SPI_statsToText(i, mainbuffer)) console_print(mainbuffer);
+}
+
+/* log start|stop: requests to start or stop recording, recording starts after the first fix */
+void cmd_log(uint8_t argc, char * argv[])
+{
+	if(argc>1 && strcmp(argv[1], "start")==0) recset = true;
+	else if(argc>1 && strcmp(argv[1], "stop")==0) recset = false;
+	console_printValue("recset", recset);
+}
+
+/* page n: shows display page n */
+void cmd_page(uint8_t argc, char * argv[])
+{
+	uint8_t page;
+
+	if(argc<2) { console_print("usage: page n\r\n"); return; }
+	page = (uint8_t)atoi(argv[1]);
+	if(page>GP_LASTLOOPPAGE) { console_print("no such page\r\n"); return; }
+	reqPage = page;				/* applied by the main loop, which owns selPage */
+}
+
+/* stpw start|stop|reset: controls the stopwatch */
+void cmd_stpw(uint8_t argc, char * argv[])
+{
+	if(argc>1 && strcmp(argv[1], "start")==0) stpw_start();
+	else if(argc>1 && strcmp(argv[1], "stop")==0) stpw_stop();
+	else if(argc>1 && strcmp(argv[1], "reset")==0)
 	{
 		stpw_reset();
+		laps_reset(gps_getData().dist);
 	}
-	else if (data=='R')		/* 'R' resets computed values (Distance, Alt made good, ...) */
-	{
-		gps_resetComputedValues();
-	}
-	else if (data=='1')		/* '1' shows page 1 */
-	{
-		display_setPage(0);
-	}
-	else if (data=='2')		/* '2' shows page 2 */
+	console_printUValue("ms", stpw_ms());
+}
+
+/* reset: resets computed values (Distance, Alt made good, ...) */
+void cmd_reset(uint8_t argc, char * argv[])
+{
+	gps_resetComputedValues();
+	splits_reset();
+	ghost_rewind();
+}
+
+/* dlog on|off: enables deferred binary log records (decode with tools/dlog_decode.py) */
+void cmd_dlog(uint8_t argc, char * argv[])
+{
+	if(argc>1) dlog_enable(strcmp(argv[1], "on")==0);
+	console_printValue("dlog", dlog_enabled());
+}
+
+/* xfer [baud]: enters the log export mode, the console returns when the host quits */
+void cmd_xfer(uint8_t argc, char * argv[])
+{
+	uint32_t baud = XFER_BAUD;
+	char * end;
+
+	if(argc>1)
 	{
-		display_setPage(1);
+		baud = strtoul(argv[1], &end, 10);
+		if(*end!='\0' || baud<XFER_MINBAUD || baud>XFER_MAXBAUD)
+		{
+			console_print("usage: xfer [baud], 9600..3000000\r\n");
+			return;
+		}
 	}
-	else if (data=='3')		/* '3' shows page 3 */
+	console_printUValue("xfer", baud);
+	export_start(baud);
+}
+
+/* telem on|off: enables the binary telemetry stream (decode with tools/telem_rx.py) */
+void cmd_telem(uint8_t argc, char * argv[])
+{
+	if(argc>1) telem_enable(strcmp(argv[1], "on")==0);
+	console_printValue("telem", telem_enabled());
+}
+
+/* trace on|off|clear|dump: controls the event trace (convert a dump with tools/trace2json.py) */
+void cmd_trace(uint8_t argc, char * argv[])
+{
+	if(argc>1)
 	{
-		display_setPage(2);
+		if(strcmp(argv[1], "dump")==0) { trace_dump(); return; }
+		if(strcmp(argv[1], "clear")==0) trace_clear();
+		else trace_enable(strcmp(argv[1], "on")==0);
 	}
-	else if (data=='+')		/* '+' starts recording */
+	console_printValue("trace", trace_enabled());
+}
+
+/* spitrace on|off|clear|dump: SPI bus recorder, only records if compiled with SPI_TRACE (spi_trace.h) */
+void cmd_spitrace(uint8_t argc, char * argv[])
+{
+	if(argc>1)
 	{
-		if(sd_inserted()) rec = true;
+		if(strcmp(argv[1], "dump")==0) { spitrace_dump(); return; }
+		if(strcmp(argv[1], "clear")==0) spitrace_clear();
+		else spitrace_enable(strcmp(argv[1], "on")==0);
 	}
-	else if (data=='-')		/* '-' pauses recording */
-	{
-		rec = false;
-	}	
-	
-	
+	console_printValue("spitrace", spitrace_enabled());
+}
+
+/* ghost file: races against a previous track log from LOG_DIR, compared by the distance since the last reset */
+void cmd_ghost(uint8_t argc, char * argv[])
+{
+	uint8_t res;
+
+	if(argc<2) { console_print("usage: ghost file\r\n"); return; }
+	res = sd_mount(LOG_DIR);
+	if(!res) res = ghost_open(argv[1]);
+	console_printValue("ghost", res);
 }
 
 
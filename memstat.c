@@ -0,0 +1,65 @@
+/*
+ * memstat.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "memstat.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* stack bounds, defined by the linker (--stack_size) */
+extern uint32_t __stack;
+extern uint32_t __STACK_END;
+
+/* ################### function definitions ################### */
+
+/*
+ * Paints the stack from its bottom up to MEMSTAT_GUARD words below the current stack pointer.
+ * The stack grows downwards, so the painted words are overwritten once the stack grows into them.
+ */
+void memstat_paint(void)
+{
+	volatile uint32_t marker;			/* its address is close to the stack pointer */
+	uint32_t * p = &__stack;
+	uint32_t * end = (uint32_t *)&marker - MEMSTAT_GUARD;
+
+	while(p < end)
+		*p++ = MEMSTAT_PATTERN;
+}
+
+/*
+ * Returns the stack size in bytes.
+ */
+uint32_t memstat_stackSize(void)
+{
+	return (uint32_t)&__STACK_END - (uint32_t)&__stack;
+}
+
+/*
+ * Returns the maximum stack usage since startup in bytes: the stack above the lowest word that
+ * does not hold the pattern anymore. A function that reserves stack without writing to it is not
+ * seen, so allow some margin.
+ */
+uint32_t memstat_stackUsed(void)
+{
+	uint32_t * p = &__stack;
+
+	while(p < &__STACK_END && *p==MEMSTAT_PATTERN)
+		p++;
+
+	return (uint32_t)&__STACK_END - (uint32_t)p;
+}
+
+/*
+ * Returns the current stack usage in bytes.
+ */
+uint32_t memstat_stackNow(void)
+{
+	volatile uint32_t marker;
+
+	return (uint32_t)&__STACK_END - (uint32_t)&marker;
+}
@@ -0,0 +1,35 @@
+/*
+ * memstat.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: memstat.h provides run time stack usage instrumentation. The unused part of the stack is
+ *       		painted with MEMSTAT_PATTERN at startup; the high-water mark is the lowest address that no
+ *       		longer holds the pattern. The static RAM footprint per module (.bss, .data) is reported at
+ *       		build time from the linker map file by tools/memreport.py.
+ */
+
+#ifndef MEMSTAT_H_
+#define MEMSTAT_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MEMSTAT_PATTERN		0xA5A5A5A5	/* fill word of the unused stack */
+#define MEMSTAT_GUARD		16			/* words below the current stack pointer left unpainted */
+
+/* Paints the unused stack. Must be called at the beginning of main(). */
+void memstat_paint(void);
+
+/* Returns the stack size in bytes. */
+uint32_t memstat_stackSize(void);
+
+/* Returns the maximum stack usage since startup in bytes (high-water mark). */
+uint32_t memstat_stackUsed(void);
+
+/* Returns the current stack usage in bytes. */
+uint32_t memstat_stackNow(void);
+
+#endif /* MEMSTAT_H_ */
@@ -10,6 +10,7 @@
 #include "spi_wrapper.h"
 #include "oled_fontTables.h"
 
+#include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -25,6 +26,26 @@
 uint32_t oled_g_ui32SysClock;
 uint8_t oledSPIProcess;
 
+/* asynchronous fills, sent by the SPI transaction queue */
+typedef struct {
+	uint8_t		cmd[7];			/* set column, x1, x2, set row, y1, y2, write RAM */
+	uint8_t		color[2];
+	spi_buf_t	bufs[6];
+	spi_trans_t	trans;
+} oled_fill_t;
+oled_fill_t fills[OLED_FILLSLOTS];
+uint8_t fillIdx = 0;
+
+/* asynchronous texts, rendered into a pixel buffer and sent by the SPI transaction queue */
+typedef struct {
+	uint8_t		cmd[7];
+	uint8_t		pix[OLED_TEXTMAXPIX*2];
+	spi_buf_t	bufs[5+16];		/* window commands, one buffer per pixel row */
+	spi_trans_t	trans;
+} oled_text_t;
+oled_text_t texts[OLED_TEXTSLOTS];
+uint8_t textIdx = 0;
+
 
 /* Initialisation sequence for OLED */
 void oled_initSequence(void);
@@ -45,6 +66,20 @@ void writeCommand8(uint8_t command, uint8_t data1);
 void writeCommand16(uint8_t command, uint8_t data1, uint8_t data2);
 void writeCommand24(uint8_t command, uint8_t data1, uint8_t data2, uint8_t data3);
 
+/* functions for streaming pixel data into the RAM window set by oled_setRAM() */
+void writePixelsStart(void);
+void writePixel(uint16_t color);
+void writePixels(uint16_t color, uint32_t cnt);
+void writePixelsStop(void);
+
+/* D/C line switching before a buffer of an asynchronous transaction */
+void oledDC_command(void);
+void oledDC_data(void);
+
+/* asynchronous transactions */
+void oled_queueWindow(spi_buf_t * bufs, uint8_t * cmd, uint8_t x1, uint8_t x2, uint8_t y1, uint8_t y2);
+void oled_textAsync(char * data, uint16_t forecolor, uint16_t backcolor, uint8_t x, uint8_t y, bool big);
+
 
 void oledCS_assert(void)
 {
@@ -56,6 +91,16 @@ void oledCS_deassert(void)
 	setOLEDCS();
 }
 
+void oledDC_command(void)
+{
+	clearOLEDDC();
+}
+
+void oledDC_data(void)
+{
+	setOLEDDC();
+}
+
 /*
  * Initialise OLED and underlaying SPI
  * _g_ui32SysClock is the system clock frequency in Hz.
@@ -78,6 +123,7 @@ void oled_init(uint32_t _g_ui32SysClock)
 	setOLEDDC();
 
 	oledSPIProcess = SPI_registerProc(oledCS_assert, oledCS_deassert);
+	SPI_setPolicy(oledSPIProcess, OLED_SPIPRIO, OLED_MAXHOLD);
 	
 	oled_initSequence();
 #endif
@@ -206,7 +252,6 @@ void oled_drawPixel(uint16_t x, uint16_t y, uint16_t color)
  */
 void oled_fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
 {
-	uint16_t i;
 	/* Bounds check */
 	if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT))
 	return;
@@ -226,9 +271,77 @@ void oled_fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t colo
 	/* set location */
 	oled_setRAM(x, x+w-1, y, y+h-1);
 
-	for (i=0; i < w*h; i++) {
-		writeData16(color);
+	writePixelsStart();
+	writePixels(color, (uint32_t)w*h);
+	writePixelsStop();
+}
+
+/*
+ * Draw a filled rectangle without waiting for the transfer. The commands and the color pattern are
+ * queued as one SPI transaction, so the main loop continues while the pixels are sent.
+ */
+void oled_fillRectAsync(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+	oled_fill_t * f;
+
+	/* Bounds check */
+	if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT) || w==0 || h==0)
+	return;
+
+	/* Y bounds check */
+	if (y+h > SSD1351HEIGHT)
+	{
+		h = SSD1351HEIGHT - y - 1;
+	}
+
+	/* X bounds check */
+	if (x+w > SSD1351WIDTH)
+	{
+		w = SSD1351WIDTH - x - 1;
 	}
+
+#ifndef OLED_OFF
+	f = &fills[fillIdx];
+	if(++fillIdx >= OLED_FILLSLOTS) fillIdx = 0;
+	SPI_wait(&f->trans);
+
+	f->color[0] = color>>8;
+	f->color[1] = color;
+
+	oled_queueWindow(f->bufs, f->cmd, x, x+w-1, y, y+h-1);
+	f->bufs[5].data = f->color;   f->bufs[5].len = 2; f->bufs[5].repeat = w*h-1; f->bufs[5].chunk = w; f->bufs[5].pfnStart = oledDC_data;	/* may pause after each row */
+
+	f->trans.process = oledSPIProcess;
+	f->trans.bufs = f->bufs;
+	f->trans.bufCnt = 6;
+	f->trans.pfnDone = NULL;
+
+	if(!SPI_queue(&f->trans))			/* queue full */
+		oled_fillRect(x, y, w, h, color);
+#endif
+}
+
+/*
+ * Prepares the first 5 buffers of an asynchronous transaction: the commands setting the RAM window
+ * and starting the RAM write. The pixels follow in bufs[5].
+ * bufs		the buffers of the transaction
+ * cmd		7 bytes for the commands and their arguments
+ */
+void oled_queueWindow(spi_buf_t * bufs, uint8_t * cmd, uint8_t x1, uint8_t x2, uint8_t y1, uint8_t y2)
+{
+	cmd[0] = SSD1351_CMD_SETCOLUMN;
+	cmd[1] = x1;
+	cmd[2] = x2;
+	cmd[3] = SSD1351_CMD_SETROW;
+	cmd[4] = y1;
+	cmd[5] = y2;
+	cmd[6] = SSD1351_CMD_WRITERAM;
+
+	bufs[0].data = &cmd[0]; bufs[0].len = 1; bufs[0].repeat = 0; bufs[0].chunk = 0; bufs[0].pfnStart = oledDC_command;
+	bufs[1].data = &cmd[1]; bufs[1].len = 2; bufs[1].repeat = 0; bufs[1].chunk = 0; bufs[1].pfnStart = oledDC_data;
+	bufs[2].data = &cmd[3]; bufs[2].len = 1; bufs[2].repeat = 0; bufs[2].chunk = 0; bufs[2].pfnStart = oledDC_command;
+	bufs[3].data = &cmd[4]; bufs[3].len = 2; bufs[3].repeat = 0; bufs[3].chunk = 0; bufs[3].pfnStart = oledDC_data;
+	bufs[4].data = &cmd[6]; bufs[4].len = 1; bufs[4].repeat = 0; bufs[4].chunk = 0; bufs[4].pfnStart = oledDC_command;
 }
 
 /*
@@ -236,8 +349,6 @@ void oled_fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t colo
  */
 void oled_drawHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t color)
 {
-	uint16_t i;
-
 	/* Bounds check */
 	if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT))
 		return;
@@ -251,9 +362,9 @@ void oled_drawHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t color)
 	/* set location */
 	oled_setRAM(x, x+w-1, y, y);
 
-	for (i=0; i < w; i++) {
-		writeData16(color);
-	}
+	writePixelsStart();
+	writePixels(color, w);
+	writePixelsStop();
 }
 
 /*
@@ -261,7 +372,6 @@ void oled_drawHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t color)
  */
 void oled_drawVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t color)
 {
-	uint16_t i;
 	/* Bounds check */
 	if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT))
 		return;
@@ -275,9 +385,9 @@ void oled_drawVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t color)
 	/* set location */
 	oled_setRAM(x, x, y, y+h-1);
 
-	for (i=0; i < h; i++) {
-		writeData16(color);
-	}
+	writePixelsStart();
+	writePixels(color, h);
+	writePixelsStop();
 }
 
 /*
@@ -322,6 +432,7 @@ void oled_drawtext(char * data, uint16_t forecolor, uint16_t backcolor, uint8_t
     oled_setRAM(x,x+(cnt*6-1), y, y+8-1); /* for left alignment */
     /*oled_setRAM(SSD1351WIDTH-x-(cnt*6-1),SSD1351WIDTH-x, y, y+8-1); */ /* for right alignment */
 
+	writePixelsStart();
 	for(z=0;z<8;z++)						/* row (zeile, z) */
 	{
 		rowmask = (1<<z);
@@ -331,19 +442,20 @@ void oled_drawtext(char * data, uint16_t forecolor, uint16_t backcolor, uint8_t
 			{
 				if (s==5)
 				{
-					writeData16(backcolor);	/* Space between characters */
+					writePixel(backcolor);	/* Space between characters */
 				}
 				else if (font7x5[data[c]-' '][s] & rowmask)
 				{
-					writeData16(forecolor);	/* character */
+					writePixel(forecolor);	/* character */
 				}
 				else
 				{
-					writeData16(backcolor);	/* character background */
+					writePixel(backcolor);	/* character background */
 				}
 			}
 		}
     }
+	writePixelsStop();
 
 }
 
@@ -367,6 +479,7 @@ void oled_drawtext_big(char * data, uint16_t forecolor, uint16_t backcolor, uint
     oled_setRAM(x,x+(cnt*11-1), y, y+16-1); /* for left alignment */
     /*oled_setRAM(SSD1351WIDTH-x-(cnt*11-1),SSD1351WIDTH-x, y, y+16-1); */ /* for right alignment */
 
+	writePixelsStart();
 	for(z=0;z<16;z++)						/* row (zeile, z) */
 	{
 		rowmask = (1<<z);
@@ -376,20 +489,104 @@ void oled_drawtext_big(char * data, uint16_t forecolor, uint16_t backcolor, uint
 			{
 				if (s==10)
 				{
-					writeData16(backcolor);	/* Space between characters */
+					writePixel(backcolor);	/* Space between characters */
 				}
 				else if (font16x10[data[c]-' '][s] & rowmask)
 				{
-					writeData16(forecolor);	/* character */
+					writePixel(forecolor);	/* character */
 				}
 				else
 				{
-					writeData16(backcolor);	/* character background */
+					writePixel(backcolor);	/* character background */
 				}
 			}
 		}
     }
+	writePixelsStop();
+
+}
+
+/*
+ * Write text with small font without waiting for the transfer.
+ */
+void oled_drawtextAsync(char * data, uint16_t forecolor, uint16_t backcolor, uint8_t x, uint8_t y)
+{
+	oled_textAsync(data, forecolor, backcolor, x, y, false);
+}
+
+/*
+ * Write text with big font without waiting for the transfer.
+ */
+void oled_drawtextAsync_big(char * data, uint16_t forecolor, uint16_t backcolor, uint8_t x, uint8_t y)
+{
+	oled_textAsync(data, forecolor, backcolor, x, y, true);
+}
+
+/*
+ * Renders a text into the pixel buffer of the next text slot and queues it as one SPI transaction.
+ * If the queue is full, the text is drawn by the blocking function.
+ * big		true for the big font
+ */
+void oled_textAsync(char * data, uint16_t forecolor, uint16_t backcolor, uint8_t x, uint8_t y, bool big)
+{
+	oled_text_t * t;
+	uint8_t cw = big ? 11 : 6;				/* character width including the space */
+	uint8_t ch = big ? 16 : 8;				/* character height */
+	uint8_t cnt = 0;
+	uint8_t c, z, s;
+	uint16_t bits, color;
+	uint16_t i = 0;
+
+	if (x >= SSD1351WIDTH) return;
+
+	while(data[cnt]!=0 && (cnt+1)*cw <= SSD1351WIDTH-x)
+	{cnt++;}
+	if(cnt==0) return;
+
+#ifndef OLED_OFF
+	t = &texts[textIdx];
+	if(++textIdx >= OLED_TEXTSLOTS) textIdx = 0;
+	SPI_wait(&t->trans);
+
+	for(z=0;z<ch;z++)						/* row (zeile, z) */
+	{
+		for(c=0;c<cnt;c++)					/* character count (c) */
+		{
+			for(s=0;s<cw;s++)				/* column in char (spalte, s) */
+			{
+				if (s==cw-1)
+					bits = 0;				/* Space between characters */
+				else
+					bits = big ? font16x10[data[c]-' '][s] : font7x5[data[c]-' '][s];
+				color = (bits & (1<<z)) ? forecolor : backcolor;
+				t->pix[i++] = color>>8;
+				t->pix[i++] = color;
+			}
+		}
+	}
+
+	/* one buffer per row, the transaction may pause after each row */
+	oled_queueWindow(t->bufs, t->cmd, x, x+cnt*cw-1, y, y+ch-1);
+	for(z=0;z<ch;z++)
+	{
+		t->bufs[5+z].data = &t->pix[z*i/ch];
+		t->bufs[5+z].len = i/ch;
+		t->bufs[5+z].repeat = 0;
+		t->bufs[5+z].chunk = 1;
+		t->bufs[5+z].pfnStart = z==0 ? oledDC_data : NULL;
+	}
 
+	t->trans.process = oledSPIProcess;
+	t->trans.bufs = t->bufs;
+	t->trans.bufCnt = 5+ch;
+	t->trans.pfnDone = NULL;
+
+	if(!SPI_queue(&t->trans))			/* queue full */
+	{
+		if(big) oled_drawtext_big(data, forecolor, backcolor, x, y);
+		else oled_drawtext(data, forecolor, backcolor, x, y);
+	}
+#endif
 }
 
 /* ===============  I C O N  ==================== */
@@ -401,6 +598,7 @@ void oled_drawIcon(const uint32_t * data, uint16_t forecolor, uint16_t backcolor
 
     oled_setRAM(x,x+w-1, y, y+h-1); 	/* for left alignment */
 
+	writePixelsStart();
     for(z=0;z<h;z++)
     {
     	tmp = *(data+z);
@@ -408,14 +606,15 @@ void oled_drawIcon(const uint32_t * data, uint16_t forecolor, uint16_t backcolor
     	{
     		if(tmp & (uint32_t)(1<<s))
     		{
-    			writeData16(forecolor);	/* symbol */
+    			writePixel(forecolor);	/* symbol */
 			}
 			else
 			{
-				writeData16(backcolor);	/* symbol background */
+				writePixel(backcolor);	/* symbol background */
 			}
     	}
     }
+	writePixelsStop();
 
 }
 
@@ -454,6 +653,7 @@ void writeData16(uint16_t d)
 void writeCommand(uint8_t c)
 {
 #ifndef OLED_OFF
+	SPI_flush();			/* D/C must not change during queued transactions */
 	clearOLEDDC();
 	spiWrite(c);
 #endif
@@ -465,6 +665,7 @@ void writeCommand(uint8_t c)
 void writeCommand8(uint8_t command, uint8_t data)
 {
 #ifndef OLED_OFF
+	SPI_flush();
 	clearOLEDDC();
 	spiWrite(command);
 	setOLEDDC();
@@ -478,6 +679,7 @@ void writeCommand8(uint8_t command, uint8_t data)
 void writeCommand16(uint8_t command, uint8_t data1, uint8_t data2)
 {
 #ifndef OLED_OFF
+	SPI_flush();
 	clearOLEDDC();
 	spiWrite(command);
 	setOLEDDC();
@@ -491,6 +693,7 @@ void writeCommand16(uint8_t command, uint8_t data1, uint8_t data2)
 void writeCommand24(uint8_t command, uint8_t data1, uint8_t data2, uint8_t data3)
 {
 #ifndef OLED_OFF
+	SPI_flush();
 	clearOLEDDC();
 	spiWrite(command);
 	setOLEDDC();
@@ -498,6 +701,48 @@ void writeCommand24(uint8_t command, uint8_t data1, uint8_t data2, uint8_t data3
 #endif
 }
 
+/*
+ * Start a stream of pixels into the RAM window set by oled_setRAM(). The Chip Select stays asserted
+ * and SSI3 sends 16 bit frames until writePixelsStop(), other SPI processes wait.
+ */
+void writePixelsStart(void)
+{
+#ifndef OLED_OFF
+	SPI_streamStart(oledSPIProcess);
+	setOLEDDC();
+#endif
+}
+
+/*
+ * Write one pixel to the stream
+ */
+void writePixel(uint16_t color)
+{
+#ifndef OLED_OFF
+	SPI_stream16(oledSPIProcess, color);
+#endif
+}
+
+/*
+ * Write cnt pixels of the same color to the stream
+ */
+void writePixels(uint16_t color, uint32_t cnt)
+{
+#ifndef OLED_OFF
+	SPI_streamFill16(oledSPIProcess, color, cnt);
+#endif
+}
+
+/*
+ * End the pixel stream
+ */
+void writePixelsStop(void)
+{
+#ifndef OLED_OFF
+	SPI_streamStop(oledSPIProcess);
+#endif
+}
+
 /*  SPI wrapper access functions */
 inline void spiWrite(uint8_t data)
 {
@@ -21,6 +21,12 @@
 #define SSD1351WIDTH 					128
 #define SSD1351HEIGHT 					128
 
+#define OLED_FILLSLOTS					4		/* max. number of queued asynchronous fills */
+#define OLED_TEXTSLOTS					4		/* max. number of queued asynchronous texts */
+#define OLED_TEXTMAXPIX					(SSD1351WIDTH*16)	/* pixels of an asynchronous text, one display width in the big font */
+#define OLED_SPIPRIO					0		/* SPI bus priority, see SPI_setPolicy() */
+#define OLED_MAXHOLD					1000	/* us an asynchronous fill or text may delay a process with higher priority */
+
 // Timing Delays
 #define SSD1351_DELAYS_HWFILL	    	(3)
 #define SSD1351_DELAYS_HWLINE       	(1)
@@ -98,6 +104,12 @@ void oled_drawPixel(uint16_t x, uint16_t y, uint16_t color);
  */
 void oled_fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
 
+/*
+ * Draw a filled rectangle without waiting for the transfer, the pixels are sent by the SPI interrupt.
+ * Waits only if OLED_FILLSLOTS fills are pending already.
+ */
+void oled_fillRectAsync(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+
 /*
  * Draw a horizontal line
  */
@@ -131,6 +143,18 @@ void oled_drawtext(char * data, uint16_t forecolor, uint16_t backcolor, uint8_t
  */
 void oled_drawtext_big(char * data, uint16_t forecolor, uint16_t backcolor, uint8_t x, uint8_t y);
 
+/*
+ * Write text with small font without waiting for the transfer, the text is rendered into a buffer
+ * and its pixels are sent by the SPI interrupt. Waits only if OLED_TEXTSLOTS texts are pending.
+ * Characters beyond the display width are dropped.
+ */
+void oled_drawtextAsync(char * data, uint16_t forecolor, uint16_t backcolor, uint8_t x, uint8_t y);
+
+/*
+ * Write text with big font without waiting for the transfer, see oled_drawtextAsync().
+ */
+void oled_drawtextAsync_big(char * data, uint16_t forecolor, uint16_t backcolor, uint8_t x, uint8_t y);
+
 void oled_drawIcon(const uint32_t * data, uint16_t forecolor, uint16_t backcolor, uint8_t x, uint8_t y, uint8_t w, uint8_t h);
 
 /*
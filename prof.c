@@ -0,0 +1,144 @@
+/*
+ * prof.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "prof.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "debug.h"
+#include "conversion.h"
+
+/* ################### internal variables ################### */
+
+static prof_stats_t stats[PROF_IDCOUNT];
+static uint32_t start[PROF_IDCOUNT];		/* debug_timestamp() at begin */
+
+static const char * const names[PROF_IDCOUNT] = {
+#define PROF_ID(id, name, trace)	name,
+#include "prof_ids.h"
+#undef PROF_ID
+};
+
+static const uint8_t traceIds[PROF_IDCOUNT] = {
+#define PROF_ID(id, name, trace)	trace,
+#include "prof_ids.h"
+#undef PROF_ID
+};
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Starts a region.
+ * id		region ID
+ */
+void prof_begin(prof_id_e id)
+{
+#ifndef TRACE_OFF
+	if(traceIds[id]!=TR_NONE) trace_record((trace_id_e)traceIds[id], 'B', 0);
+#endif
+	start[id] = debug_timestamp();
+}
+
+/*
+ * Ends a region.
+ * id		region ID
+ * Returns the runtime in cycles.
+ */
+uint32_t prof_end(prof_id_e id)
+{
+	uint32_t cycles = debug_timestamp() - start[id];	/* wraps correctly */
+
+	prof_add(id, cycles);
+#ifndef TRACE_OFF
+	if(traceIds[id]!=TR_NONE) trace_record((trace_id_e)traceIds[id], 'E', 0);
+#endif
+	return cycles;
+}
+
+/*
+ * Adds a runtime to a region.
+ * id		region ID
+ * cycles	runtime in cycles
+ */
+void prof_add(prof_id_e id, uint32_t cycles)
+{
+	prof_stats_t * s = &stats[id];
+	uint8_t bin = 0;
+
+	while(bin<PROF_HISTBINS-1 && (cycles >> (bin+1))) bin++;	/* floor(log2(cycles)) */
+
+	if(s->count==0 || cycles < s->min) s->min = cycles;
+	if(cycles > s->max) s->max = cycles;
+	s->count++;
+	s->total += cycles;
+	s->last = cycles;
+	s->hist[bin]++;
+}
+
+/*
+ * Returns the last runtime of a region in cycles.
+ */
+uint32_t prof_getLast(prof_id_e id)
+{
+	return stats[id].last;
+}
+
+/*
+ * Returns the statistics of a region.
+ */
+prof_stats_t prof_getStats(prof_id_e id)
+{
+	return stats[id];
+}
+
+/*
+ * Resets the statistics of all regions.
+ */
+void prof_reset(void)
+{
+	memset(stats, 0, sizeof(stats));
+}
+
+/*
+ * Writes the statistics of a region as a text line:
+ * PROF,name,count,min,mean,max,first bin,bin counts separated by '/'
+ * Only the bins from the first to the last non-empty one are written.
+ * id		region ID
+ * buffer	must hold at least PROF_TEXTLEN chars
+ * Returns buffer, or NULL if the region was not run yet.
+ */
+char * prof_toText(prof_id_e id, char * buffer)
+{
+	prof_stats_t * s = &stats[id];
+	uint16_t i = 0;
+	uint8_t first, last, bin;
+
+	if(s->count==0) return NULL;
+
+	buffer[i++] = 'P'; buffer[i++] = 'R'; buffer[i++] = 'O'; buffer[i++] = 'F'; buffer[i++] = ',';
+	strncpy(&buffer[i], names[id], PROF_NAMELEN);
+	while(i < 5+PROF_NAMELEN && buffer[i]) i++;
+	buffer[i++] = ',';
+	i = ui32AppendA(buffer, i, s->count, ',');
+	i = ui32AppendA(buffer, i, s->min, ',');
+	i = ui32AppendA(buffer, i, (uint32_t)(s->total / s->count), ',');
+	i = ui32AppendA(buffer, i, s->max, ',');
+
+	for(first=0; s->hist[first]==0; first++);
+	for(last=PROF_HISTBINS-1; s->hist[last]==0; last--);
+	i = ui32AppendA(buffer, i, first, ',');
+	for(bin=first; bin<=last; bin++)
+		i = ui32AppendA(buffer, i, s->hist[bin], bin==last ? '\r' : '/');
+	buffer[i++] = '\n';
+	buffer[i] = 0;
+
+	return buffer;
+}
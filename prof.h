@@ -0,0 +1,79 @@
+/*
+ * prof.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: prof.h provides always-on profiling of named regions (prof_ids.h). Each region keeps count,
+ *       		total, min, max and last runtime in clock cycles of the debug timer plus a log2 histogram,
+ *       		so tail latencies can be read from long runs in the field. Regions may nest. Begin and end
+ *       		also emit the region's trace event (trace.h). Regions may only be used from the main loop.
+ */
+
+#ifndef PROF_H_
+#define PROF_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "trace.h"
+
+//#define PROF_OFF				/* uncomment to remove all profiling regions at compile time */
+
+#define TR_NONE				TRACE_IDCOUNT	/* region without trace event */
+#define PROF_HISTBINS		32		/* histogram bin n counts runtimes of 2^n..2^(n+1)-1 cycles */
+#define PROF_NAMELEN		16		/* max. region name length */
+#define PROF_TEXTLEN		(5+PROF_NAMELEN+1+4*11+3+PROF_HISTBINS*11+2+1)	/* max. length of prof_toText() */
+#define PROF_LOGINTVL		600		/* seconds between the profiling lines in the event log */
+
+/* region IDs, generated from prof_ids.h */
+typedef enum {
+#define PROF_ID(id, name, trace)	id,
+#include "prof_ids.h"
+#undef PROF_ID
+	PROF_IDCOUNT
+} prof_id_e;
+
+/* region statistics */
+typedef struct {
+	uint32_t	count;
+	uint64_t	total;			/* cycles */
+	uint32_t	min;			/* cycles */
+	uint32_t	max;			/* cycles */
+	uint32_t	last;			/* cycles */
+	uint32_t	hist[PROF_HISTBINS];
+} prof_stats_t;
+
+#ifndef PROF_OFF
+#define PROF_BEGIN(id)		prof_begin(id)
+#define PROF_END(id)		prof_end(id)
+#else
+#define PROF_BEGIN(id)
+#define PROF_END(id)		0
+#endif
+
+/* Starts a region. Use PROF_BEGIN() instead of calling this function directly. */
+void prof_begin(prof_id_e id);
+
+/* Ends a region and returns its runtime in cycles. Use PROF_END() instead of calling this function directly. */
+uint32_t prof_end(prof_id_e id);
+
+/* Adds a runtime measured elsewhere to a region. */
+void prof_add(prof_id_e id, uint32_t cycles);
+
+/* Returns the last runtime of a region in cycles. */
+uint32_t prof_getLast(prof_id_e id);
+
+/* Returns the statistics of a region. */
+prof_stats_t prof_getStats(prof_id_e id);
+
+/* Resets the statistics of all regions. */
+void prof_reset(void);
+
+/* Writes the statistics of a region as a text line to buffer (at least PROF_TEXTLEN chars):
+ * PROF,name,count,min,mean,max,first bin,bin counts separated by '/'
+ * Returns NULL, if the region was not run yet. */
+char * prof_toText(prof_id_e id, char * buffer);
+
+#endif /* PROF_H_ */
@@ -0,0 +1,29 @@
+/*
+ * prof_ids.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: prof_ids.h is the registry of profiling regions. Each entry defines an ID, the name used in
+ *       		reports and the trace event (trace_ids.h) emitted at begin and end, TR_NONE for none.
+ *       		The display page regions must stay contiguous and in page order. No include guard, the file
+ *       		is included repeatedly.
+ */
+
+PROF_ID(PR_GPS_PARSE,		"gps_parse",		TR_GPS_PARSE)
+PROF_ID(PR_GPS_COMPUTE,		"gps_compute",		TR_GPS_COMPUTE)
+PROF_ID(PR_GPS_MATCH,		"gps_match",		TR_GPS_MATCH)
+PROF_ID(PR_DISPLAY,			"display",			TR_DISPLAY)
+PROF_ID(PR_SD,				"sd_block",			TR_SD)
+PROF_ID(PR_LOG_WRITE,		"log_write",		TR_SD_WRITE)
+PROF_ID(PR_LOG_START,		"log_start",		TR_LOG_START)
+PROF_ID(PR_GHOST,			"ghost_poll",		TR_GHOST)
+PROF_ID(PR_EXPORT,			"export_poll",		TR_EXPORT)
+PROF_ID(PR_DISPLAY_P0,		"display_page0",	TR_NONE)
+PROF_ID(PR_DISPLAY_P1,		"display_page1",	TR_NONE)
+PROF_ID(PR_DISPLAY_P2,		"display_page2",	TR_NONE)
+PROF_ID(PR_DISPLAY_P3,		"display_page3",	TR_NONE)
+PROF_ID(PR_DISPLAY_P4,		"display_page4",	TR_NONE)
+PROF_ID(PR_DISPLAY_P5,		"display_page5",	TR_NONE)
+PROF_ID(PR_DISPLAY_P6,		"display_page6",	TR_NONE)
+PROF_ID(PR_DISPLAY_P7,		"display_page7",	TR_NONE)
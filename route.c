@@ -0,0 +1,534 @@
+/*
+ * route.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "route.h"
+#include "sdcard.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+
+#include "fatfs/ff.h"
+#include "fatfs/integer.h"
+
+
+#define ROUTE_DEG2DM		11.1195f						/* 1/10 m per 1e-5 degree of latitude */
+#define ROUTE_RAD			(3.14159265f/180.0f/100000.0f)	/* rad per 1e-5 degree */
+#define ROUTE_MAXVERTEX		(ROUTE_BLOCKLEN*ROUTE_MAXBLOCKS)
+
+/* GPX parser states */
+#define GPX_TEXT			0		/* outside of a tag */
+#define GPX_TAGNAME			1		/* reading a tag name */
+#define GPX_TAG				2		/* inside an ignored tag */
+#define GPX_PT				3		/* inside a rtept/trkpt tag */
+#define GPX_NUM				4		/* reading a lat/lon attribute value */
+
+typedef struct {
+	int32_t		latMin;
+	int32_t		latMax;
+	int32_t		lonMin;
+	int32_t		lonMax;
+} route_bbox_t;
+
+typedef struct {
+	uint8_t		state;		/* GPX_xx parser state */
+	char		win[6];		/* tag name or sliding attribute window */
+	uint8_t		len;		/* number of chars in win */
+	bool		isLon;		/* true, if the current value is the longitude */
+	bool		neg;		/* true, if the current value is negative */
+	int8_t		frac;		/* decimal places read, -1 before the decimal point */
+	int32_t		val;		/* value in 1e-5 degree */
+	bool		hasLat, hasLon;
+	int32_t		lat, lon;
+} gpx_parser_t;
+
+/* ################### internal variables ################### */
+
+static FIL				routeFile;					/* binary vertex file, open while a route is loaded */
+static bool				routeOpen;					/* true while routeFile is open */
+static FIL				gpxFile;					/* GPX file, only open while loading */
+static char				gpxChunk[ROUTE_GPXCHUNK];	/* GPX read buffer */
+
+static route_bbox_t		blocks[ROUTE_MAXBLOCKS];	/* bounding boxes of ROUTE_BLOCKLEN segments each */
+static uint16_t			blockCnt;
+static route_vertex_t	cache[ROUTE_CACHELEN];		/* window of the vertex file, also write buffer while loading */
+static route_vertex_t	lastVertex;					/* previous vertex while loading */
+static uint16_t			cacheStart;
+static uint16_t			cacheCnt;
+static uint16_t			vertexCnt;
+static uint32_t			routeLen;					/* 1/10 m */
+static uint16_t			reacqBlock;					/* next block to be tested while off route */
+
+static route_data_t		route_data;
+
+/* ################### private function prototypes ################### */
+
+/* Feeds a character to the GPX parser. Returns true if a complete point was parsed. */
+bool gpx_parse(gpx_parser_t * p, char c);
+
+/* Appends a vertex to the vertex file and updates the bounding box index. */
+uint8_t addVertex(int32_t lat, int32_t lon);
+
+/* Reads a vertex from the cache, refills the cache from the vertex file if necessary. Returns false on a read error. */
+bool getVertex(uint16_t idx, route_vertex_t * v);
+
+/* Projects the position onto a segment. Returns false on a read error. */
+bool matchSegment(uint16_t seg, int32_t lat, int32_t lon, float kx, float * dist, float * t, float * cross);
+
+/* Calculates the bearing of a segment in degree. Returns false on a read error. */
+bool segBearing(uint16_t seg, float kx, float * brg);
+
+/* Sets the route data for a matched segment. */
+void acceptMatch(uint16_t seg, float t, float cross, float dist, float kx);
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Loads a GPX route from the SD card. The SD card must be mounted and LOG_DIR must be the current directory.
+ * The GPX file is converted to ROUTE_BINFILE, which is read in chunks while following the route.
+ * gpxFilename		the name of the GPX file
+ * Returns			FR_OK or a FatFs error code
+ */
+uint8_t route_load(const char * gpxFilename)
+{
+#ifndef SDCARD_OFF
+	BYTE b1;
+	UINT cnt, i;
+	gpx_parser_t parser;
+
+	route_unload();
+
+	b1 = f_open(&gpxFile, gpxFilename, FA_OPEN_EXISTING | FA_READ);
+	if ( !(b1==FR_OK) ) return b1;
+
+	b1 = f_open(&routeFile, ROUTE_BINFILE, FA_WRITE | FA_CREATE_ALWAYS);
+	if ( !(b1==FR_OK) ) { f_close(&gpxFile); return b1; }
+	routeOpen = true;
+
+	parser.state = GPX_TEXT;
+	parser.len = 0;
+
+	/* stream GPX file and convert points to vertices */
+	do {
+		b1 = f_read(&gpxFile, gpxChunk, ROUTE_GPXCHUNK, &cnt);
+		if(b1!=FR_OK) break;
+
+		for(i=0; i<cnt && b1==FR_OK; i++)
+		{
+			if(gpx_parse(&parser, gpxChunk[i]))
+				b1 = addVertex(parser.lat, parser.lon);
+		}
+	} while (cnt==ROUTE_GPXCHUNK && b1==FR_OK);
+
+	/* write remaining vertices */
+	if(b1==FR_OK && cacheCnt>0)
+		b1 = f_write(&routeFile, cache, cacheCnt*sizeof(route_vertex_t), &cnt);
+
+	f_close(&gpxFile);
+	f_close(&routeFile);
+	routeOpen = false;
+	if(b1==FR_OK && vertexCnt<2) b1 = FR_INVALID_OBJECT;
+
+	/* reopen vertex file for reading */
+	if(b1==FR_OK) b1 = f_open(&routeFile, ROUTE_BINFILE, FA_OPEN_EXISTING | FA_READ);
+	if ( !(b1==FR_OK) )
+	{
+		route_unload();			/* discard the partly converted route */
+		return b1;
+	}
+	routeOpen = true;
+
+	blockCnt = (vertexCnt - 2) / ROUTE_BLOCKLEN + 1;
+	cacheCnt = 0;
+	cacheStart = 0;
+	reacqBlock = 0;
+
+	route_data.state = rsAcquire;
+	route_data.segment = 0;
+	route_data.distToGo = routeLen;
+#endif
+	return FR_OK;
+}
+
+/*
+ * Unloads the route.
+ */
+void route_unload(void)
+{
+#ifndef SDCARD_OFF
+	if(routeOpen) f_close(&routeFile);
+	routeOpen = false;
+#endif
+	route_data.state = rsNone;
+	route_data.segment = 0;
+	route_data.distToGo = 0;
+	route_data.xte = 0;
+	route_data.turnBrg = 0;
+	route_data.turnDist = 0;
+	vertexCnt = 0;
+	blockCnt = 0;
+	cacheCnt = 0;
+	cacheStart = 0;
+	routeLen = 0;
+}
+
+/*
+ * Matches a new position to the route. Must be called on every new fix.
+ * The segments ahead of the last match are searched first. If the position is off route,
+ * ROUTE_REACQBLOCKS blocks of the bounding box index are tested per fix.
+ * lat, lon		the current position
+ */
+void route_update(gps_coordinate_t lat, gps_coordinate_t lon)
+{
+	int32_t plat, plon, mlat, mlon;
+	float kx, t, cross, dist;
+	float bestT = 0, bestCross = 0, bestDist = 1e9f;
+	uint16_t seg, last, bestSeg = 0;
+	uint8_t i;
+	route_bbox_t * bb;
+
+	if(route_data.state==rsNone) return;
+	if(lat.NSEW=='-' || lon.NSEW=='-') return;	/* no valid position */
+
+	plat = gps_coordToInt(lat);
+	plon = gps_coordToInt(lon);
+	kx = ROUTE_DEG2DM * cosf((float)plat * ROUTE_RAD);
+
+	/* windowed search ahead of the last match */
+	last = route_data.segment + ROUTE_WINDOW;
+	if(last > vertexCnt-1) last = vertexCnt-1;
+	for(seg=route_data.segment; seg<last; seg++)
+	{
+		if(!matchSegment(seg, plat, plon, kx, &dist, &t, &cross)) return;	/* route given up */
+		if(dist < bestDist)
+		{
+			bestDist = dist; bestSeg = seg; bestT = t; bestCross = cross;
+		}
+	}
+	if(bestDist <= ROUTE_OFFROUTE)
+	{
+		acceptMatch(bestSeg, bestT, bestCross, bestDist, kx);
+		return;
+	}
+
+	/* off route: test a limited number of blocks of the bounding box index */
+	if(route_data.state==rsOnRoute)
+	{
+		route_data.state = rsOffRoute;
+		reacqBlock = route_data.segment / ROUTE_BLOCKLEN;
+	}
+
+	mlat = (int32_t)(ROUTE_OFFROUTE / ROUTE_DEG2DM);
+	mlon = (int32_t)(ROUTE_OFFROUTE / kx);
+	for(i=0; i<ROUTE_REACQBLOCKS && i<blockCnt; i++)
+	{
+		bb = &blocks[reacqBlock];
+		seg = reacqBlock * ROUTE_BLOCKLEN;
+		if(++reacqBlock>=blockCnt) reacqBlock = 0;
+
+		if(plat < bb->latMin-mlat || plat > bb->latMax+mlat || plon < bb->lonMin-mlon || plon > bb->lonMax+mlon)
+			continue;
+
+		/* position within bounding box, search segments of this block only */
+		last = seg + ROUTE_BLOCKLEN;
+		if(last > vertexCnt-1) last = vertexCnt-1;
+		bestDist = 1e9f;
+		for( ; seg<last; seg++)
+		{
+			if(!matchSegment(seg, plat, plon, kx, &dist, &t, &cross)) return;
+			if(dist < bestDist)
+			{
+				bestDist = dist; bestSeg = seg; bestT = t; bestCross = cross;
+			}
+		}
+		if(bestDist <= ROUTE_OFFROUTE)
+			acceptMatch(bestSeg, bestT, bestCross, bestDist, kx);
+		break;
+	}
+}
+
+/*
+ * Returns the current route following data.
+ */
+route_data_t route_getData(void)
+{
+	return route_data;
+}
+
+/*
+ * Returns the number of vertices of the loaded route.
+ */
+uint16_t route_getVertexCount(void)
+{
+	return vertexCnt;
+}
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Feeds a character to the GPX parser. Returns true if a complete point was parsed.
+ * Only the lat and lon attributes of rtept and trkpt tags are evaluated.
+ */
+bool gpx_parse(gpx_parser_t * p, char c)
+{
+	bool delim = (c==' ' || c=='\t' || c=='\r' || c=='\n' || c=='>' || c=='/');
+
+	switch(p->state)
+	{
+	case GPX_TEXT:
+		if(c=='<') { p->state = GPX_TAGNAME; p->len = 0; }
+		break;
+
+	case GPX_TAGNAME:
+		if(delim)
+		{
+			p->win[p->len] = 0;
+			if(c!='>' && p->len==5 &&
+				(strcmp(p->win, "rtept")==0 || strcmp(p->win, "trkpt")==0))
+			{
+				p->state = GPX_PT;
+				p->len = 0;
+				p->hasLat = false;
+				p->hasLon = false;
+			}
+			else
+			{
+				p->state = (c=='>') ? GPX_TEXT : GPX_TAG;
+			}
+		}
+		else if(p->len<5) p->win[p->len++] = c;
+		else p->state = GPX_TAG;
+		break;
+
+	case GPX_TAG:
+		if(c=='>') p->state = GPX_TEXT;
+		break;
+
+	case GPX_PT:
+		if(c=='>')
+		{
+			p->state = GPX_TEXT;
+			return p->hasLat && p->hasLon;
+		}
+		/* sliding window over the last 5 chars */
+		if(p->len==5)
+		{
+			p->win[0] = p->win[1]; p->win[1] = p->win[2]; p->win[2] = p->win[3]; p->win[3] = p->win[4];
+			p->len = 4;
+		}
+		p->win[p->len++] = c;
+		p->win[p->len] = 0;
+		if(p->len==5 && (strcmp(p->win, "lat=\"")==0 || strcmp(p->win, "lon=\"")==0))
+		{
+			p->state = GPX_NUM;
+			p->isLon = (p->win[1]=='o');
+			p->neg = false;
+			p->frac = -1;
+			p->val = 0;
+		}
+		break;
+
+	case GPX_NUM:
+		if(c=='-') p->neg = true;
+		else if(c=='.') p->frac = 0;
+		else if(c>='0' && c<='9')
+		{
+			if(p->frac<0) p->val = p->val*10 + (c-'0');
+			else if(p->frac<5) { p->val = p->val*10 + (c-'0'); p->frac++; }
+		}
+		else if(c=='"')
+		{
+			if(p->frac<0) p->frac = 0;
+			while(p->frac<5) { p->val *= 10; p->frac++; }
+			if(p->neg) p->val = -p->val;
+			if(p->isLon) { p->lon = p->val; p->hasLon = true; }
+			else { p->lat = p->val; p->hasLat = true; }
+			p->state = GPX_PT;
+			p->len = 0;
+		}
+		break;
+	}
+
+	return false;
+}
+
+/*
+ * Appends a vertex to the vertex file and updates the bounding box index.
+ * The cache is used as write buffer while loading.
+ */
+uint8_t addVertex(int32_t lat, int32_t lon)
+{
+	route_vertex_t * v;
+	route_bbox_t * bb;
+	float dx, dy;
+	UINT cnt;
+	BYTE b1;
+
+	if(vertexCnt>=ROUTE_MAXVERTEX) return FR_OK;	/* route too long, ignore remaining points */
+
+	if(cacheCnt==ROUTE_CACHELEN)
+	{
+		b1 = f_write(&routeFile, cache, ROUTE_CACHELEN*sizeof(route_vertex_t), &cnt);
+		if ( !(b1==FR_OK) ) return b1;
+		cacheCnt = 0;
+	}
+
+	v = &cache[cacheCnt];
+	v->lat = lat;
+	v->lon = lon;
+
+	if(vertexCnt>0)
+	{
+		dy = (float)(lat - lastVertex.lat) * ROUTE_DEG2DM;
+		dx = (float)(lon - lastVertex.lon) * ROUTE_DEG2DM * cosf((float)lastVertex.lat * ROUTE_RAD);
+		routeLen += (uint32_t)(sqrtf(dx*dx + dy*dy) + 0.5f);
+
+		/* segment vertexCnt-1 belongs to block (vertexCnt-1)/ROUTE_BLOCKLEN */
+		bb = &blocks[(vertexCnt-1) / ROUTE_BLOCKLEN];
+		if((vertexCnt-1) % ROUTE_BLOCKLEN == 0)
+		{
+			bb->latMin = bb->latMax = lastVertex.lat;
+			bb->lonMin = bb->lonMax = lastVertex.lon;
+		}
+		if(lat < bb->latMin) bb->latMin = lat;
+		if(lat > bb->latMax) bb->latMax = lat;
+		if(lon < bb->lonMin) bb->lonMin = lon;
+		if(lon > bb->lonMax) bb->lonMax = lon;
+	}
+	v->dist = routeLen;
+	lastVertex = *v;
+
+	cacheCnt++;
+	vertexCnt++;
+	return FR_OK;
+}
+
+/*
+ * Reads a vertex from the cache, refills the cache from the vertex file if necessary.
+ * If the vertex file is not readable, the route is unloaded and the file is closed.
+ * idx		the vertex index
+ * v		returns the vertex
+ * Returns	false on a read error
+ */
+bool getVertex(uint16_t idx, route_vertex_t * v)
+{
+	UINT cnt;
+	uint16_t start;
+
+	if(idx<cacheStart || idx>=cacheStart+cacheCnt)
+	{
+		start = (idx>ROUTE_CACHEBACK) ? idx-ROUTE_CACHEBACK : 0;
+		cacheCnt = 0;
+		if(f_lseek(&routeFile, (DWORD)start*sizeof(route_vertex_t))==FR_OK &&
+			f_read(&routeFile, cache, ROUTE_CACHELEN*sizeof(route_vertex_t), &cnt)==FR_OK)
+		{
+			cacheStart = start;
+			cacheCnt = cnt / sizeof(route_vertex_t);
+		}
+		if(idx<cacheStart || idx>=cacheStart+cacheCnt)
+		{
+			route_unload();		/* vertex file not readable, give up route */
+			return false;
+		}
+	}
+
+	*v = cache[idx-cacheStart];
+	return true;
+}
+
+/*
+ * Projects the position onto a segment.
+ * The position is the origin of the local plane, kx is 1/10 m per 1e-5 degree longitude.
+ * dist		returns the distance in 1/10 m
+ * t		returns the relative position of the projection on the segment (0..1)
+ * cross	returns the cross product of the segment and the position (>0: left of the segment)
+ * Returns	false on a read error, the route is unloaded then
+ */
+bool matchSegment(uint16_t seg, int32_t lat, int32_t lon, float kx, float * dist, float * t, float * cross)
+{
+	route_vertex_t a, b;
+	float ax, ay, dx, dy, len2, u, px, py;
+
+	if(!getVertex(seg, &a) || !getVertex(seg+1, &b)) return false;
+
+	ax = (float)(a.lon - lon) * kx;
+	ay = (float)(a.lat - lat) * ROUTE_DEG2DM;
+	dx = (float)(b.lon - a.lon) * kx;
+	dy = (float)(b.lat - a.lat) * ROUTE_DEG2DM;
+
+	len2 = dx*dx + dy*dy;
+	u = (len2>0.0f) ? -(ax*dx + ay*dy) / len2 : 0.0f;
+	if(u<0.0f) u = 0.0f;
+	if(u>1.0f) u = 1.0f;
+
+	px = ax + u*dx;
+	py = ay + u*dy;
+
+	*t = u;
+	*cross = dy*ax - dx*ay;
+	*dist = sqrtf(px*px + py*py);
+	return true;
+}
+
+/*
+ * Calculates the bearing of a segment in degree (0..360).
+ * brg		returns the bearing
+ * Returns	false on a read error, the route is unloaded then
+ */
+bool segBearing(uint16_t seg, float kx, float * brg)
+{
+	route_vertex_t a, b;
+
+	if(!getVertex(seg, &a) || !getVertex(seg+1, &b)) return false;
+
+	*brg = atan2f((float)(b.lon - a.lon) * kx, (float)(b.lat - a.lat) * ROUTE_DEG2DM) * (180.0f / 3.14159265f);
+	if(*brg<0.0f) *brg += 360.0f;
+	return true;
+}
+
+/*
+ * Sets the route data for a matched segment.
+ * On a read error the route is unloaded and route_data is left at rsNone.
+ */
+void acceptMatch(uint16_t seg, float t, float cross, float dist, float kx)
+{
+	route_vertex_t a, b;
+	uint32_t along;
+	uint16_t i, last;
+	float brg, prevBrg, diff;
+
+	if(!getVertex(seg, &a) || !getVertex(seg+1, &b)) return;
+	along = a.dist + (uint32_t)(t * (float)(b.dist - a.dist));
+
+	route_data.state = rsOnRoute;
+	route_data.segment = seg;
+	route_data.distToGo = (routeLen>along) ? routeLen - along : 0;
+	route_data.xte = (cross>0.0f) ? -(int32_t)dist : (int32_t)dist;
+
+	/* search next turn within the window */
+	last = seg + ROUTE_WINDOW;
+	if(last > vertexCnt-2) last = vertexCnt-2;
+	if(!segBearing(seg, kx, &prevBrg)) return;
+	brg = prevBrg;
+	for(i=seg+1; i<=last; i++)
+	{
+		if(!segBearing(i, kx, &brg)) return;
+		diff = brg - prevBrg;
+		if(diff>180.0f) diff -= 360.0f;
+		if(diff<-180.0f) diff += 360.0f;
+		if(diff>ROUTE_TURNANGLE || diff<-ROUTE_TURNANGLE) break;
+		prevBrg = brg;
+	}
+	if(i>last) i = last+1;		/* no turn within the window, report end of window */
+
+	if(!getVertex(i, &a)) return;
+	route_data.turnBrg = (uint16_t)(brg + 0.5f) % 360;
+	route_data.turnDist = (a.dist>along) ? a.dist - along : 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * route.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: route.h provides route following against a GPX route stored on the SD card. The GPX
+ *       		file is converted once into a compact binary vertex file which is then streamed in
+ *       		chunks, so only a small window of the route is held in RAM. The current segment is
+ *       		tracked with a windowed search ahead of the last match; a bounding box index of segment
+ *       		blocks is used to re-acquire the route after going off route. The cost per fix does
+ *       		not depend on the route length.
+ */
+
+#ifndef ROUTE_H_
+#define ROUTE_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gps.h"
+
+#define ROUTE_GPXFILE		"route.gpx"		/* GPX route file (rtept or trkpt elements), located in LOG_DIR */
+#define ROUTE_BINFILE		"route.bin"		/* converted binary vertex file, located in LOG_DIR */
+
+#define ROUTE_BLOCKLEN		32		/* segments per bounding box block */
+#define ROUTE_MAXBLOCKS		256		/* bounding box blocks, limits the route to ROUTE_BLOCKLEN*ROUTE_MAXBLOCKS vertices */
+#define ROUTE_CACHELEN		48		/* vertices held in RAM, must be larger than ROUTE_BLOCKLEN+1 and ROUTE_WINDOW+1 */
+#define ROUTE_CACHEBACK		4		/* vertices kept behind the current segment when the cache is refilled */
+#define ROUTE_WINDOW		12		/* segments searched ahead of the last match */
+#define ROUTE_REACQBLOCKS	8		/* bounding box blocks tested per fix while off route */
+#define ROUTE_OFFROUTE		500		/* 1/10 m, cross track error that counts as off route */
+#define ROUTE_TURNANGLE		30		/* degree, heading change that counts as a turn */
+#define ROUTE_GPXCHUNK		128		/* bytes read from the GPX file at once */
+
+/* route state */
+typedef enum {
+	rsNone = 0,		/* no route loaded */
+	rsAcquire,		/* route loaded, position not yet matched */
+	rsOnRoute,		/* position matched to a segment */
+	rsOffRoute		/* position too far from the route */
+} route_state_e;
+
+/* vertex as stored in ROUTE_BINFILE */
+typedef struct {
+	int32_t		lat;		/* 1e-5 degree, negative for S */
+	int32_t		lon;		/* 1e-5 degree, negative for W */
+	uint32_t	dist;		/* 1/10 m, cumulative distance from the first vertex */
+} route_vertex_t;
+
+typedef struct {
+	route_state_e	state;
+	uint16_t		segment;	/* index of the current segment (vertex segment -> segment+1) */
+	uint32_t		distToGo;	/* 1/10 m, remaining distance along the route */
+	int32_t			xte;		/* 1/10 m, cross track error, positive if right of the route */
+	uint16_t		turnBrg;	/* degree, bearing of the route after the next turn */
+	uint32_t		turnDist;	/* 1/10 m, distance along the route to the next turn */
+} route_data_t;
+
+
+/* Loads a GPX route from the SD card. The SD card must be mounted and LOG_DIR must be the current directory. */
+uint8_t route_load(const char * gpxFilename);
+
+/* Unloads the route. */
+void route_unload(void);
+
+/* Matches a new position to the route. Must be called on every new fix. */
+void route_update(gps_coordinate_t lat, gps_coordinate_t lon);
+
+/* Returns the current route following data. */
+route_data_t route_getData(void);
+
+/* Returns the number of vertices of the loaded route. */
+uint16_t route_getVertexCount(void);
+
+#endif /* ROUTE_H_ */
@@ -15,6 +15,7 @@
 #include "fatfs/ff.h"
 #include "fatfs/diskio.h"
 #include "fatfs/integer.h"
+#include "sdlink.h"
 
 #include "driverlib/gpio.h"
 #include "driverlib/pin_map.h"
@@ -49,6 +50,12 @@ FIL File[2];				/* File object */
 // ----------------------------------------------------
 
 uint8_t logFlag = 0;
+sd_stats_t sdStats;
+uint8_t syncPending = 0;	/* bit i set: File[i] is synced by log_SyncPoll() */
+uint32_t syncedSize[2];		/* size of the log files on the card after their last sync */
+
+/* Writes a record to a log file and updates the statistics (private) */
+uint8_t log_write(FIL * fp, const void * data, UINT len);
 
 
 /* ---===###  S D   S Y S T E M   F U N C T I O N S  ###===--- */
@@ -73,6 +80,7 @@ void sd_init(uint32_t sd_g_ui32SysClock)
 {
 #ifndef SDCARD_OFF
 	SDSPIProcess = SPI_registerProc(SDCS_assert, SDCS_deassert);
+	SPI_setPolicy(SDSPIProcess, SD_SPIPRIO, 0);
 
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOK);
 
@@ -119,6 +127,44 @@ bool sd_initialised(void)
 	return !(disk_status(0) & (STA_NODISK|STA_NOINIT));
 }
 
+/*
+ * Initialises the card and mounts the file system if necessary and changes to the given directory.
+ * The directory is created if it does not exist.
+ * path		the directory without drive letter and without leading and trailing slashes
+ */
+uint8_t sd_mount(const char * path)
+{
+#ifndef SDCARD_OFF
+	BYTE b1;
+	bool remount = false;
+
+	if(!sd_initialised())
+	{
+		// init SD Card
+		b1 = sd_initCard();
+		if ( !(b1==FR_OK) ) return b1;
+		remount = true;
+	}
+
+	/* mounting again would invalidate files opened by other modules (ghost track, log export) */
+	if(remount || FatFs[0].fs_type==0)
+	{
+		b1 = f_mount(&FatFs[0], "0:", 1);
+		if ( !(b1==FR_OK) ) return b1;
+	}
+
+	b1 = f_chdir(path);
+	if(b1==FR_NO_PATH)
+	{
+		b1 = f_mkdir(path);
+		if ( !(b1==FR_OK) ) return b1;
+		b1 = f_chdir(path);
+	}
+	if ( !(b1==FR_OK) ) return b1;
+#endif
+	return FR_OK;
+}
+
 /* ---===###  L O G   F U N C T I O N S  ###===--- */
 /*
  * Returns the next unused Log File Name.
@@ -161,26 +207,9 @@ uint8_t log_Start(char * logFilename, char * eventFilename)
 	BYTE b1;
 	UINT cnt;
 
-	if(!sd_initialised())
-	{
-		// init SD Card
-		b1 = sd_initCard();
-		if ( !(b1==FR_OK) ) return b1;
-	}
-
-	b1 = f_mount(&FatFs[0], "0:", 1);
+	b1 = sd_mount(LOG_DIR);
 	if ( !(b1==FR_OK) ) return b1;
 
-	b1 = f_chdir(LOG_DIR);
-	if(b1==FR_NO_PATH)
-	{
-		b1 = f_mkdir(LOG_DIR);
-		if ( !(b1==FR_OK) ) return b1;
-		b1 = f_chdir(LOG_DIR);
-	}
-	if ( !(b1==FR_OK) ) return b1;
-
-	
 	strncpy((char *)buff, LOG_LEADIN, LOG_LILENGTH+1);
 	
 	/* open log file for write */
@@ -201,10 +230,99 @@ uint8_t log_Start(char * logFilename, char * eventFilename)
 	if ( !(b1==FR_OK) ) return b1;
 	
 	logFlag = 1;
+	syncedSize[0] = syncedSize[1] = 0;
+	syncPending = 0x03;		/* get the lead-ins onto the card */
 #endif
 	return 0;
 }
 
+/*
+ * Reopens existing log files in append mode and continues logging, e.g. after power loss.
+ * Each file is continued at the given size, clipped to its size on the card, and cut there, so
+ * records not covered by the checkpoint are dropped.
+ * logFilename, eventFilename		the names of the log files to be continued
+ * logSize, eventSize				the sizes of the files when the checkpoint was taken
+ */
+uint8_t log_Resume(char * logFilename, char * eventFilename, uint32_t logSize, uint32_t eventSize)
+{
+#ifndef SDCARD_OFF
+	BYTE b1;
+
+	b1 = sd_mount(LOG_DIR);
+	if ( !(b1==FR_OK) ) return b1;
+
+	/* open log file and move to the resume position */
+	b1 = f_open(&File[0], logFilename, FA_WRITE | FA_OPEN_EXISTING);
+	if ( !(b1==FR_OK) ) return b1;
+	if(logSize > f_size(&File[0])) logSize = f_size(&File[0]);
+	b1 = f_lseek(&File[0], logSize);
+	if(b1==FR_OK) b1 = f_truncate(&File[0]);
+	if ( !(b1==FR_OK) ) { f_close(&File[0]); return b1; }
+
+	/* open event file and move to the resume position */
+	b1 = f_open(&File[1], eventFilename, FA_WRITE | FA_OPEN_EXISTING);
+	if ( !(b1==FR_OK) ) { f_close(&File[0]); return b1; }
+	if(eventSize > f_size(&File[1])) eventSize = f_size(&File[1]);
+	b1 = f_lseek(&File[1], eventSize);
+	if(b1==FR_OK) b1 = f_truncate(&File[1]);
+	if ( !(b1==FR_OK) ) { f_close(&File[0]); f_close(&File[1]); return b1; }
+
+	logFlag = 1;
+	syncedSize[0] = logSize;
+	syncedSize[1] = eventSize;
+	syncPending = 0;
+#endif
+	return FR_OK;
+}
+
+/*
+ * Requests writing the cached data and the directory entries of both log files to the card.
+ * The files are synced by log_SyncPoll(), one per call, so a single main loop pass never waits
+ * for both.
+ */
+void log_SyncStart(void)
+{
+	if(logFlag) syncPending = 0x03;
+}
+
+/*
+ * Syncs the next log file requested by log_SyncStart(). Must be called periodically.
+ * A failed sync is counted as write error.
+ * Returns true, if a file was synced.
+ */
+bool log_SyncPoll(void)
+{
+#ifndef SDCARD_OFF
+	BYTE b1;
+	uint8_t i;
+
+	if(logFlag==0 || syncPending==0) return false;
+
+	i = (syncPending & 0x01) ? 0 : 1;
+	syncPending &= ~(1<<i);
+	b1 = f_sync(&File[i]);
+	if ( !(b1==FR_OK) )
+	{
+		sdStats.errors++;
+		sdStats.lastError = b1;
+	}
+	else
+		syncedSize[i] = f_size(&File[i]);
+	return true;
+#else
+	return false;
+#endif
+}
+
+/*
+ * Returns the size of a log file on the card after its last completed sync.
+ * file		0: track log, 1: event log
+ */
+uint32_t log_SyncedSize(uint8_t file)
+{
+	return syncedSize[file & 1];
+}
+
 /*
  * Stops logging and closes file.
  */
@@ -220,6 +338,8 @@ uint8_t log_Stop(void)
 	b1 = f_write(&File[0], buff, LOG_LOLENGTH, &cnt);
 	if ( !(b1==FR_OK) ) return b1;
 
+	syncPending = 0;
+
 	/* close log file */
 	b1 = f_close(&File[0]);
 	if ( !(b1==FR_OK) ) return b1;
@@ -238,6 +358,22 @@ uint8_t log_Stop(void)
 	return FR_OK;
 }
 
+/*
+ * Writes a text line to the event file, e.g. a trip summary.
+ * text		zero terminated string including line ending
+ */
+uint8_t log_Text(const char * text)
+{
+#ifndef SDCARD_OFF
+	BYTE b1;
+	if(logFlag==0) return 1;
+
+	b1 = log_write(&File[1], text, strlen(text));
+	if ( !(b1==FR_OK) ) return b1;
+#endif
+	return FR_OK;
+}
+
 /*
  * Writes data to the Log file.
  */
@@ -249,7 +385,6 @@ uint8_t logDataSet(	date_t Date, time_t Time, gps_coordinate_t Lat, gps_coordina
 	static char str_buf[100];
 	uint8_t i=0;
 	BYTE b1;
-	UINT cnt;
 	if(logFlag==0) return 1;
 
 	// [hh:mm:ss.cc]	13
@@ -300,7 +435,7 @@ uint8_t logDataSet(	date_t Date, time_t Time, gps_coordinate_t Lat, gps_coordina
 	str_buf[i++] = '\n';
 
 	// write record to file
-	b1 = f_write(&File[0], str_buf, i, &cnt);
+	b1 = log_write(&File[0], str_buf, i);
 	if ( !(b1==FR_OK) ) return b1;
 	
 #elif LOGFILETYPE == 2
@@ -308,7 +443,6 @@ uint8_t logDataSet(	date_t Date, time_t Time, gps_coordinate_t Lat, gps_coordina
 	static char str_buf[100];
 	uint8_t i=0;
 	BYTE b1;
-	UINT cnt;
 	if(logFlag==0) return 1;
 
 	// yyyy/mm/dd;	11
@@ -427,7 +561,7 @@ uint8_t logDataSet(	date_t Date, time_t Time, gps_coordinate_t Lat, gps_coordina
 	str_buf[i++] = '\n';
 
 	// write line to file
-	b1 = f_write(&File[event?1:0], str_buf, i, &cnt);
+	b1 = log_write(&File[event?1:0], str_buf, i);
 	if ( !(b1==FR_OK) ) return b1;
 #endif	/* LOGFILETYPE */
 #endif	/* SDCARD_OFF */
@@ -435,6 +569,54 @@ uint8_t logDataSet(	date_t Date, time_t Time, gps_coordinate_t Lat, gps_coordina
 }
 
 
+/*
+ * Returns the log write statistics.
+ */
+sd_stats_t sd_getStats(void)
+{
+	sdlink_t link;
+
+	if (disk_ioctl(0, MMC_GET_LINK, &link) == RES_OK)
+	{
+		sdStats.clock = link.clock;
+		sdStats.linkErrors = link.errors;
+		sdStats.backoffs = link.backoffs;
+	}
+	else
+		sdStats.clock = 0;
+	return sdStats;
+}
+
+/*
+ * Returns true, if logging is active.
+ */
+bool log_active(void)
+{
+	return logFlag!=0;
+}
+
+/*
+ * Writes a record to a log file and updates the statistics (private).
+ */
+uint8_t log_write(FIL * fp, const void * data, UINT len)
+{
+#ifndef SDCARD_OFF
+	BYTE b1;
+	UINT cnt;
+
+	b1 = f_write(fp, data, len, &cnt);
+	if ( !(b1==FR_OK) )
+	{
+		sdStats.errors++;
+		sdStats.lastError = b1;
+		return b1;
+	}
+	sdStats.records++;
+	sdStats.bytes += cnt;
+#endif
+	return FR_OK;
+}
+
 /* passes the current time to the fatfs library */
 inline uint32_t sd_fattime(void)
 {
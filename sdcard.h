@@ -19,6 +19,10 @@
 
 //#define SDCARD_OFF		/* uncomment to turn SD functionality off */
 
+#define SD_SPIPRIO			1	/* SPI bus priority, above the display so that logging isn't delayed by screen updates */
+#define SD_CRC					/* comment out to run the card without CRC checks */
+#define SD_RETRIES			1	/* block transfers repeated after a CRC or response error (at a reduced clock) */
+
 /* defines chip select and sd card detect pin actions */
 #define getSDCD()			(GPIOPinRead(GPIO_PORTK_BASE, GPIO_PIN_6)==(1<<6))
 #define setSDCS()			GPIOPinWrite(GPIO_PORTK_BASE, GPIO_PIN_5, (1<<5))
@@ -60,6 +64,17 @@
 #define LOG_EXT			LOG_EXTCSV
 #endif
 
+/* log write statistics */
+typedef struct {
+	uint32_t	records;		/* records and text lines written */
+	uint32_t	bytes;			/* bytes written */
+	uint32_t	errors;			/* failed writes */
+	uint8_t		lastError;		/* FatFs result of the last failed write */
+	uint32_t	clock;			/* SPI clock of the card in Hz, 0 if not initialised */
+	uint32_t	linkErrors;		/* CRC and response errors */
+	uint32_t	backoffs;		/* clock reductions after errors */
+} sd_stats_t;
+
 /* Initialises SD card functions. */
 void sd_init(uint32_t sd_g_ui32SysClock);
 
@@ -72,19 +87,43 @@ void sd_tick10Ms(void);
 /* SD Init */
 uint8_t sd_initCard(void);
 
+/* Initialises the card if necessary, mounts the file system and changes to the given directory. */
+uint8_t sd_mount(const char * path);
+
 /* Returns the next unused Log File Name. */
 char * log_getNextID(char * buffer, time_t time, date_t date, bool event);
 
 /* Opens file and starts logging. */
 uint8_t log_Start(char * logFilename, char * eventFilename);
 
+/* Reopens existing log files at the given sizes, clipped to the card, and continues logging, e.g. after power loss. */
+uint8_t log_Resume(char * logFilename, char * eventFilename, uint32_t logSize, uint32_t eventSize);
+
+/* Requests writing the cached data of both log files to the card. */
+void log_SyncStart(void);
+
+/* Syncs the next requested log file. Must be called periodically. Returns true, if a file was synced. */
+bool log_SyncPoll(void);
+
+/* Returns the size of a log file (0: track, 1: event) on the card after its last completed sync. */
+uint32_t log_SyncedSize(uint8_t file);
+
 /* Stops logging and closes file. */
 uint8_t log_Stop(void);
 
+/* Writes a text line (including line ending) to the event file. */
+uint8_t log_Text(const char * text);
+
 /* Writes data to the Log file. */
 uint8_t logDataSet(	date_t Date, time_t Time, gps_coordinate_t Lat, gps_coordinate_t Lon, int32_t alt, int32_t height,
 					uint16_t speed, uint32_t dist, uint8_t satsInFix, uint8_t DOP, uint8_t fix, uint32_t debug, bool event);
 
+/* Returns the log write statistics. */
+sd_stats_t sd_getStats(void);
+
+/* Returns true, if logging is active. */
+bool log_active(void);
+
 /* Returns true, if a SD card is in the socket */
 bool sd_inserted(void);
 
@@ -0,0 +1,113 @@
+/*
+ * sdlink.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "sdlink.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ################### internal variables ################### */
+
+/* TRAN_SPEED time value (bits 6:3) times 10, and rate unit (bits 2:0) in 100 kbit/s / 10 */
+static const uint8_t tranValue[16] = { 0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80 };
+static const uint32_t tranUnit[4] = { 10000, 100000, 1000000, 10000000 };
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Returns the maximum data transfer rate in bit/s decoded from TRAN_SPEED of a CSD, 0 if invalid.
+ * TRAN_SPEED is byte 3 in all CSD versions, e.g. 0x32 = 25 Mbit/s, 0x5A = 50 Mbit/s.
+ * csd		the 16 bytes of the CSD register as read by CMD9
+ */
+uint32_t sdlink_tranSpeed(const uint8_t * csd)
+{
+	uint8_t ts = csd[3];
+
+	if((ts & 0x80) || (ts & 0x07) > 3 || tranValue[(ts >> 3) & 0x0F]==0) return 0;
+
+	return tranValue[(ts >> 3) & 0x0F] * tranUnit[ts & 0x07];
+}
+
+/*
+ * Initialises the link with the clock limit of the card and of the host.
+ * cardHz	the rate from sdlink_tranSpeed(), 0 uses SDLINK_CLKSAFE
+ * hostHz	the fastest clock of the SPI interface
+ * Returns the clock to be used.
+ */
+uint32_t sdlink_init(sdlink_t * link, uint32_t cardHz, uint32_t hostHz)
+{
+	if(cardHz==0) cardHz = SDLINK_CLKSAFE;
+
+	link->limit = cardHz < hostHz ? cardHz : hostHz;
+	link->clock = link->limit;
+	link->errors = 0;
+	link->backoffs = 0;
+
+	return link->clock;
+}
+
+/*
+ * Counts an error and reduces the clock to SDLINK_BACKOFF %, but not below SDLINK_CLKMIN.
+ * The interface may round the clock down further, link->clock should be set to the clock in use.
+ * Returns the new clock.
+ */
+uint32_t sdlink_error(sdlink_t * link)
+{
+	uint32_t clock;
+
+	link->errors++;
+
+	clock = (uint64_t)link->clock * SDLINK_BACKOFF / 100;
+	if(clock < SDLINK_CLKMIN) clock = SDLINK_CLKMIN;
+	if(clock < link->clock)
+	{
+		link->clock = clock;
+		link->backoffs++;
+	}
+
+	return link->clock;
+}
+
+/*
+ * Returns the CRC7 (x^7 + x^3 + 1) of a command packet. The last byte of the packet is (crc7<<1)|1.
+ */
+uint8_t sdlink_crc7(const uint8_t * data, uint16_t len)
+{
+	uint8_t crc = 0;
+	uint8_t i;
+
+	while(len--)
+	{
+		crc ^= *data++;
+		for(i=0; i<8; i++)
+			crc = (crc & 0x80) ? (crc << 1) ^ 0x12 : crc << 1;
+	}
+
+	return crc >> 1;
+}
+
+/*
+ * Returns the CRC16 (x^16 + x^12 + x^5 + 1, initial value 0) of a data block, sent MSB first after
+ * the block. Computed bytewise without table.
+ */
+uint16_t sdlink_crc16(const uint8_t * data, uint16_t len)
+{
+	uint16_t crc = 0;
+
+	while(len--)
+	{
+		crc = (crc >> 8) | (crc << 8);
+		crc ^= *data++;
+		crc ^= (crc & 0xFF) >> 4;
+		crc ^= crc << 12;
+		crc ^= (crc & 0xFF) << 5;
+	}
+
+	return crc;
+}
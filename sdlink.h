@@ -0,0 +1,47 @@
+/*
+ * sdlink.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: sdlink.h provides the SPI link parameters of the SD card: the maximum clock is decoded from
+ *       		TRAN_SPEED of the CSD register, data blocks and commands are protected by CRC16 and CRC7,
+ *       		and the clock is reduced step by step when CRC or response errors occur. The functions do
+ *       		not access the hardware, the MMC driver applies the clock.
+ */
+
+#ifndef SDLINK_H_
+#define SDLINK_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SDLINK_CLKSAFE		(10e6)		/* clock used if the CSD can't be read */
+#define SDLINK_CLKMIN		(1e6)		/* the clock is not reduced below this */
+#define SDLINK_BACKOFF		75			/* % of the clock kept per error */
+
+typedef struct {
+	uint32_t	limit;		/* fastest clock allowed by the card and the host in Hz */
+	uint32_t	clock;		/* current clock in Hz */
+	uint32_t	errors;		/* CRC and response errors */
+	uint32_t	backoffs;	/* clock reductions */
+} sdlink_t;
+
+
+/* Returns the maximum data transfer rate in bit/s decoded from TRAN_SPEED of a CSD, 0 if invalid. */
+uint32_t sdlink_tranSpeed(const uint8_t * csd);
+
+/* Initialises the link with the clock limit of the card (0: unknown) and of the host. Returns the clock. */
+uint32_t sdlink_init(sdlink_t * link, uint32_t cardHz, uint32_t hostHz);
+
+/* Counts an error and reduces the clock. Returns the new clock. */
+uint32_t sdlink_error(sdlink_t * link);
+
+/* Returns the CRC7 of a command packet (without the end bit). */
+uint8_t sdlink_crc7(const uint8_t * data, uint16_t len);
+
+/* Returns the CRC16 (CCITT) of a data block. */
+uint16_t sdlink_crc16(const uint8_t * data, uint16_t len);
+
+#endif /* SDLINK_H_ */
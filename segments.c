@@ -0,0 +1,483 @@
+/*
+ * segments.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "segments.h"
+#include "sdcard.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "fatfs/ff.h"
+#include "fatfs/integer.h"
+
+
+#if (SEG_HASHLEN & (SEG_HASHLEN-1)) != 0 || SEG_HASHLEN > 256
+#error "SEG_HASHLEN must be a power of 2, max. 256"
+#endif
+#if SEG_MAXSEGS >= SEG_NONE
+#error "SEG_MAXSEGS must be less than SEG_NONE"
+#endif
+
+#define SEG_DEG2DM			11.1195f						/* 1/10 m per 1e-5 degree of latitude */
+#define SEG_RAD				(3.14159265f/180.0f/100000.0f)	/* rad per 1e-5 degree */
+#define SEG_SHOWTIME		600								/* 1/10 s, a finished effort is shown for this time */
+
+typedef struct {
+	int32_t		lat;		/* 1e-5 degree */
+	int32_t		lon;		/* 1e-5 degree */
+	uint32_t	dist;		/* 1/10 m, distance from the start gate along the polyline */
+} seg_point_t;
+
+typedef struct {
+	uint16_t	id;
+	char		name[SEG_NAMELEN+1];
+	int32_t		startLat, startLon;
+	int32_t		endLat, endLon;
+	uint16_t	radius;		/* 1/10 m */
+	uint16_t	firstPt;	/* index of the first polyline point in points[] */
+	uint16_t	numPts;		/* number of polyline points */
+	uint32_t	len;		/* 1/10 m, length start gate - polyline - end gate */
+	uint32_t	best;		/* 1/10 s, best effort, 0 if none */
+	uint16_t	next;		/* next segment in the same hash bucket */
+} segment_t;
+
+typedef struct {
+	uint16_t	seg;		/* segment index, SEG_NONE if unused */
+	bool		inStart;	/* true, while within the start gate */
+	uint16_t	nextPt;		/* next polyline point to be passed, relative to firstPt */
+	uint32_t	start;		/* 1/10 s, start time */
+	uint32_t	progress;	/* 1/10 m, distance of the last passed polyline point */
+	date_t		date;		/* date and time of the start */
+	time_t		tod;
+} seg_effort_t;
+
+/* ################### internal variables ################### */
+
+static segment_t		segs[SEG_MAXSEGS];
+static uint16_t			segCnt;
+static uint16_t			segDropped;					/* entries of the segment file that were ignored */
+static bool				segSkip;					/* true, while the P lines of an ignored S line are skipped */
+static seg_point_t		points[SEG_MAXPOINTS];
+static uint16_t			pointCnt;
+static uint16_t			hash[SEG_HASHLEN];			/* first segment per bucket, SEG_NONE if empty */
+static seg_effort_t		efforts[SEG_MAXACTIVE];
+static uint16_t			lastEffort = SEG_NONE;		/* most recently started effort */
+
+static seg_status_t		lastResult;					/* result of the last finished effort */
+static uint32_t			lastResultTime;
+
+static FIL				segFile;
+
+/* ################### private function prototypes ################### */
+
+/* Processes one line of the segment file. */
+void seg_processLine(char * line);
+
+/* Parses a signed decimal degree value to 1e-5 degree. Returns the position after the next ',' or NULL. */
+char * seg_parseCoord(char * str, int32_t * val);
+
+/* Returns the grid hash bucket of a position. */
+uint8_t seg_hash(int32_t lat, int32_t lon);
+
+/* Returns the distance of two positions in 1/10 m, kx is 1/10 m per 1e-5 degree longitude. */
+float seg_dist(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2, float kx);
+
+/* Stores a finished effort. */
+void seg_finish(seg_effort_t * e, uint32_t time);
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Loads the segment definitions and the best efforts.
+ * The SD card must be mounted and LOG_DIR must be the current directory.
+ * Returns	FR_OK or a FatFs error code
+ */
+uint8_t segments_load(void)
+{
+#ifndef SDCARD_OFF
+	static char line[SEG_LINELEN+1];
+	char chunk[32];
+	uint8_t len = 0;
+	UINT cnt, i;
+	BYTE b1;
+	seg_result_t res;
+
+	segCnt = 0;
+	segDropped = 0;
+	segSkip = false;
+	pointCnt = 0;
+	lastEffort = SEG_NONE;
+	lastResult.state = ssNone;
+	for(i=0; i<SEG_HASHLEN; i++) hash[i] = SEG_NONE;
+	for(i=0; i<SEG_MAXACTIVE; i++) efforts[i].seg = SEG_NONE;
+
+	/* read segment definitions line by line */
+	b1 = f_open(&segFile, SEG_FILENAME, FA_OPEN_EXISTING | FA_READ);
+	if ( !(b1==FR_OK) ) return b1;
+
+	do {
+		b1 = f_read(&segFile, chunk, sizeof(chunk), &cnt);
+		if(b1!=FR_OK) break;
+		for(i=0; i<cnt; i++)
+		{
+			if(chunk[i]=='\r' || chunk[i]=='\n')
+			{
+				line[len] = 0;
+				if(len>0) seg_processLine(line);
+				len = 0;
+			}
+			else if(len<SEG_LINELEN) line[len++] = chunk[i];
+		}
+	} while (cnt==sizeof(chunk));
+	line[len] = 0;
+	if(len>0) seg_processLine(line);
+
+	f_close(&segFile);
+	if ( !(b1==FR_OK) ) return b1;
+
+	/* determine best efforts from the results file */
+	b1 = f_open(&segFile, SEG_RESFILE, FA_OPEN_EXISTING | FA_READ);
+	if(b1==FR_NO_FILE) return FR_OK;
+	if ( !(b1==FR_OK) ) return b1;
+
+	do {
+		b1 = f_read(&segFile, &res, sizeof(res), &cnt);
+		if(b1!=FR_OK || cnt<sizeof(res)) break;
+		for(i=0; i<segCnt; i++)
+		{
+			if(segs[i].id==res.id && (segs[i].best==0 || res.time<segs[i].best))
+				segs[i].best = res.time;
+		}
+	} while (1);
+
+	f_close(&segFile);
+	return b1;
+#else
+	return FR_OK;
+#endif
+}
+
+/*
+ * Checks gates and times efforts. Must be called on every new fix.
+ * lat, lon		the current position
+ * time			the current time in 1/10 s
+ * date, tod	the current date and time of day, stored with a finished effort
+ */
+void segments_update(gps_coordinate_t lat, gps_coordinate_t lon, uint32_t time, date_t date, time_t tod)
+{
+	int32_t plat, plon;
+	float kx;
+	uint8_t i;
+	uint16_t s, k;
+	int8_t dy, dx;
+	seg_effort_t * e;
+	segment_t * sg;
+	seg_point_t * pt;
+
+	if(segCnt==0) return;
+	if(lat.NSEW=='-' || lon.NSEW=='-') return;	/* no valid position */
+
+	plat = gps_coordToInt(lat);
+	plon = gps_coordToInt(lon);
+	kx = SEG_DEG2DM * cosf((float)plat * SEG_RAD);
+
+	/* active efforts */
+	for(i=0; i<SEG_MAXACTIVE; i++)
+	{
+		e = &efforts[i];
+		if(e->seg==SEG_NONE) continue;
+		sg = &segs[e->seg];
+
+		if(e->inStart)
+		{
+			/* the effort starts when leaving the start gate */
+			if(seg_dist(plat, plon, sg->startLat, sg->startLon, kx) <= sg->radius)
+			{
+				e->start = time;
+				e->date = date;
+				e->tod = tod;
+				continue;
+			}
+			e->inStart = false;
+		}
+
+		/* polyline points must be passed in order */
+		while(e->nextPt<sg->numPts)
+		{
+			pt = &points[sg->firstPt + e->nextPt];
+			if(seg_dist(plat, plon, pt->lat, pt->lon, kx) > sg->radius) break;
+			e->progress = pt->dist;
+			e->nextPt++;
+		}
+
+		if(e->nextPt==sg->numPts && seg_dist(plat, plon, sg->endLat, sg->endLon, kx) <= sg->radius)
+		{
+			seg_finish(e, time);
+			e->seg = SEG_NONE;
+		}
+		else if(time - e->start > SEG_MAXTIME)
+		{
+			e->seg = SEG_NONE;		/* abort */
+		}
+	}
+
+	/* start gates in the surrounding grid cells */
+	for(dy=-1; dy<=1; dy++)
+	{
+		for(dx=-1; dx<=1; dx++)
+		{
+			for(s=hash[seg_hash(plat+dy*SEG_CELL, plon+dx*SEG_CELL)]; s!=SEG_NONE; s=segs[s].next)
+			{
+				sg = &segs[s];
+				if(seg_dist(plat, plon, sg->startLat, sg->startLon, kx) > sg->radius) continue;
+
+				/* start a new effort, if not already active */
+				k = SEG_NONE;
+				for(i=0; i<SEG_MAXACTIVE; i++)
+				{
+					if(efforts[i].seg==s) break;
+					if(efforts[i].seg==SEG_NONE && k==SEG_NONE) k = i;
+				}
+				if(i<SEG_MAXACTIVE || k==SEG_NONE) continue;
+
+				e = &efforts[k];
+				e->seg = s;
+				e->inStart = true;
+				e->nextPt = 0;
+				e->progress = 0;
+				e->start = time;
+				e->date = date;
+				e->tod = tod;
+				lastEffort = k;
+			}
+		}
+	}
+}
+
+/*
+ * Returns the status of the most recently started effort or of the last finished effort.
+ * time		the current time in 1/10 s
+ */
+seg_status_t segments_getStatus(uint32_t time)
+{
+	seg_status_t st;
+	seg_effort_t * e;
+	segment_t * sg;
+
+	if(lastEffort!=SEG_NONE && efforts[lastEffort].seg!=SEG_NONE)
+	{
+		e = &efforts[lastEffort];
+		sg = &segs[e->seg];
+
+		st.state = ssActive;
+		strcpy(st.name, sg->name);
+		st.elapsed = time - e->start;
+		st.best = sg->best;
+		st.progress = (sg->len>0) ? (uint8_t)((uint64_t)e->progress * 100 / sg->len) : 0;
+		if(sg->best>0 && sg->len>0)
+			st.delta = (int32_t)st.elapsed - (int32_t)((uint64_t)sg->best * e->progress / sg->len);
+		else
+			st.delta = 0;
+		return st;
+	}
+
+	if(lastResult.state==ssFinished && time - lastResultTime > SEG_SHOWTIME)
+		lastResult.state = ssNone;
+
+	return lastResult;
+}
+
+/*
+ * Returns the number of loaded segments.
+ */
+uint16_t segments_getCount(void)
+{
+	return segCnt;
+}
+
+/*
+ * Returns the number of segment and polyline point entries of the last load that were ignored,
+ * because SEG_MAXSEGS or SEG_MAXPOINTS was reached or the line could not be parsed.
+ * The P lines of an ignored S line are counted as well.
+ */
+uint16_t segments_getDropped(void)
+{
+	return segDropped;
+}
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Processes one line of the segment file.
+ * An S line that does not fit or can not be parsed is dropped together with its P lines.
+ * line		zero terminated line without line ending
+ */
+void seg_processLine(char * line)
+{
+	segment_t * sg;
+	seg_point_t * pt;
+	int32_t lat, lon, prevLat, prevLon, radius;
+	uint8_t i, h;
+	float kx;
+
+	if(line[0]=='S' && line[1]==',')
+	{
+		segSkip = true;
+		segDropped++;
+		if(segCnt>=SEG_MAXSEGS) return;
+
+		sg = &segs[segCnt];
+		line += 2;
+		sg->id = (uint16_t)strtoul(line, &line, 10);
+		if(*line++!=',') return;
+		if(!(line = seg_parseCoord(line, &sg->startLat))) return;
+		if(!(line = seg_parseCoord(line, &sg->startLon))) return;
+		if(!(line = seg_parseCoord(line, &sg->endLat))) return;
+		if(!(line = seg_parseCoord(line, &sg->endLon))) return;
+		radius = strtol(line, &line, 10) * 10;
+		if(radius<=0 || radius>SEG_MAXRADIUS) radius = SEG_MAXRADIUS;
+		sg->radius = (uint16_t)radius;
+		if(*line==',') line++;
+		for(i=0; i<SEG_NAMELEN && line[i]; i++) sg->name[i] = line[i];
+		sg->name[i] = 0;
+
+		sg->firstPt = pointCnt;
+		sg->numPts = 0;
+		sg->best = 0;
+		kx = SEG_DEG2DM * cosf((float)sg->startLat * SEG_RAD);
+		sg->len = (uint32_t)seg_dist(sg->startLat, sg->startLon, sg->endLat, sg->endLon, kx);
+
+		/* insert start gate into grid hash */
+		h = seg_hash(sg->startLat, sg->startLon);
+		sg->next = hash[h];
+		hash[h] = segCnt;
+
+		segCnt++;
+		segSkip = false;
+		segDropped--;
+	}
+	else if(line[0]=='P' && line[1]==',')
+	{
+		if(segSkip || segCnt==0 || pointCnt>=SEG_MAXPOINTS) { segDropped++; return; }
+
+		sg = &segs[segCnt-1];
+		line += 2;
+		if(!(line = seg_parseCoord(line, &lat)) || !seg_parseCoord(line, &lon))
+		{
+			segDropped++;
+			return;
+		}
+
+		if(sg->numPts==0) { prevLat = sg->startLat; prevLon = sg->startLon; }
+		else { prevLat = points[pointCnt-1].lat; prevLon = points[pointCnt-1].lon; }
+		kx = SEG_DEG2DM * cosf((float)lat * SEG_RAD);
+
+		pt = &points[pointCnt];
+		pt->lat = lat;
+		pt->lon = lon;
+		pt->dist = ((sg->numPts==0) ? 0 : points[pointCnt-1].dist) +
+				(uint32_t)seg_dist(prevLat, prevLon, lat, lon, kx);
+
+		/* segment length: start - points - end */
+		sg->len = pt->dist + (uint32_t)seg_dist(lat, lon, sg->endLat, sg->endLon, kx);
+
+		sg->numPts++;
+		pointCnt++;
+	}
+}
+
+/*
+ * Parses a signed decimal degree value to 1e-5 degree.
+ * Returns the position after the next ',' or the end of the string, NULL if no digit was found.
+ */
+char * seg_parseCoord(char * str, int32_t * val)
+{
+	bool neg = false, digit = false;
+	int8_t frac = -1;
+	int32_t v = 0;
+
+	while(*str==' ') str++;
+	if(*str=='-') { neg = true; str++; }
+	for( ; *str && *str!=','; str++)
+	{
+		if(*str=='.') frac = 0;
+		else if(*str>='0' && *str<='9')
+		{
+			digit = true;
+			if(frac<0) v = v*10 + (*str-'0');
+			else if(frac<5) { v = v*10 + (*str-'0'); frac++; }
+		}
+	}
+	if(!digit) return NULL;
+	if(frac<0) frac = 0;
+	while(frac<5) { v *= 10; frac++; }
+	*val = neg ? -v : v;
+
+	if(*str==',') str++;
+	return str;
+}
+
+/*
+ * Returns the grid hash bucket of a position.
+ */
+uint8_t seg_hash(int32_t lat, int32_t lon)
+{
+	uint32_t cy = (uint32_t)(lat + 9000000) / SEG_CELL;
+	uint32_t cx = (uint32_t)(lon + 18000000) / SEG_CELL;
+
+	return (uint8_t)((cy*31 + cx) & (SEG_HASHLEN-1));
+}
+
+/*
+ * Returns the distance of two positions in 1/10 m (equirectangular approximation).
+ * kx		1/10 m per 1e-5 degree longitude
+ */
+float seg_dist(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2, float kx)
+{
+	float dx = (float)(lon2 - lon1) * kx;
+	float dy = (float)(lat2 - lat1) * SEG_DEG2DM;
+
+	return sqrtf(dx*dx + dy*dy);
+}
+
+/*
+ * Stores a finished effort: appends it to the results file and updates the best effort.
+ */
+void seg_finish(seg_effort_t * e, uint32_t time)
+{
+	segment_t * sg = &segs[e->seg];
+	seg_result_t res;
+	UINT cnt;
+
+	lastResult.state = ssFinished;
+	strcpy(lastResult.name, sg->name);
+	lastResult.elapsed = time - e->start;
+	lastResult.best = sg->best;
+	lastResult.delta = (sg->best>0) ? (int32_t)lastResult.elapsed - (int32_t)sg->best : 0;
+	lastResult.progress = 100;
+	lastResultTime = time;
+
+	if(sg->best==0 || lastResult.elapsed<sg->best) sg->best = lastResult.elapsed;
+
+#ifndef SDCARD_OFF
+	res.id = sg->id;
+	res.y = e->date.y; res.m = e->date.m; res.d = e->date.d;
+	res.hr = e->tod.hr; res.min = e->tod.min; res.sec = e->tod.sec;
+	res.time = lastResult.elapsed;
+
+	if(f_open(&segFile, SEG_RESFILE, FA_WRITE | FA_OPEN_ALWAYS)==FR_OK)
+	{
+		if(f_lseek(&segFile, f_size(&segFile))==FR_OK)
+			f_write(&segFile, &res, sizeof(res), &cnt);
+		f_close(&segFile);
+	}
+#endif
+}
@@ -0,0 +1,82 @@
+/*
+ * segments.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: segments.h provides timing of predefined segments (e.g. climbs). Segments are read from
+ *       		SEG_FILENAME on the SD card, each consists of a start gate, intermediate polyline points
+ *       		and an end gate. Start gates are held in a grid hash, so each fix only tests the gates
+ *       		in the surrounding cells. Efforts are timed and compared live against the best effort,
+ *       		completed efforts are appended to the binary results file SEG_RESFILE.
+ *
+ *       		File format (one entry per line, coordinates in signed decimal degree, radius in m):
+ *       		S,<id>,<startLat>,<startLon>,<endLat>,<endLon>,<radius>,<name>
+ *       		P,<lat>,<lon>				polyline point of the preceding S line
+ *       		# comment
+ */
+
+#ifndef SEGMENTS_H_
+#define SEGMENTS_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gps.h"
+#include "time.h"
+
+#define SEG_FILENAME		"segments.txt"	/* segment definitions, located in LOG_DIR */
+#define SEG_RESFILE			"segres.bin"	/* effort results, located in LOG_DIR */
+
+#define SEG_MAXSEGS			512		/* max. number of segments (about 52 bytes of RAM each), must be less than SEG_NONE */
+#define SEG_MAXPOINTS		1024	/* max. number of polyline points of all segments (12 bytes of RAM each) */
+#define SEG_MAXACTIVE		4		/* max. number of concurrently timed efforts */
+#define SEG_NAMELEN			12		/* max. segment name length */
+#define SEG_LINELEN			96		/* max. line length in SEG_FILENAME */
+#define SEG_HASHLEN			256		/* grid hash buckets, power of 2, max. 256 */
+#define SEG_CELL			1000	/* 1e-5 degree, grid cell size, must be larger than the gate radius */
+#define SEG_MAXRADIUS		2000	/* 1/10 m, max. gate radius */
+#define SEG_MAXTIME			72000	/* 1/10 s, efforts are aborted after this time */
+#define SEG_NONE			0xFFFF
+
+typedef enum {
+	ssNone = 0,		/* no effort active and no recent result */
+	ssActive,		/* effort is being timed */
+	ssFinished		/* effort finished, result is shown */
+} seg_state_e;
+
+/* record as stored in SEG_RESFILE */
+typedef struct {
+	uint16_t	id;			/* segment id */
+	uint8_t		y, m, d;	/* date of the effort */
+	uint8_t		hr, min, sec;	/* start time of the effort */
+	uint32_t	time;		/* 1/10 s, elapsed time */
+} seg_result_t;
+
+typedef struct {
+	seg_state_e	state;
+	char		name[SEG_NAMELEN+1];
+	uint32_t	elapsed;	/* 1/10 s, elapsed or final time */
+	int32_t		delta;		/* 1/10 s, difference to the best effort scaled by progress, positive if slower */
+	uint32_t	best;		/* 1/10 s, best effort, 0 if none */
+	uint8_t		progress;	/* percent of the segment length */
+} seg_status_t;
+
+
+/* Loads the segment definitions and the best efforts. The SD card must be mounted and LOG_DIR must be the current directory. */
+uint8_t segments_load(void);
+
+/* Checks gates and times efforts. Must be called on every new fix, time in 1/10 s. */
+void segments_update(gps_coordinate_t lat, gps_coordinate_t lon, uint32_t time, date_t date, time_t tod);
+
+/* Returns the status of the most recently started effort or of the last finished effort. */
+seg_status_t segments_getStatus(uint32_t time);
+
+/* Returns the number of loaded segments. */
+uint16_t segments_getCount(void);
+
+/* Returns the number of segment and polyline point entries of the last load that did not fit or could not be parsed. */
+uint16_t segments_getDropped(void);
+
+#endif /* SEGMENTS_H_ */
@@ -0,0 +1,92 @@
+/*
+ * spi_dma.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "spi_dma.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ################### private function prototypes ################### */
+
+/* Arms the next chunk of the transfer. */
+void spidma_armNext(spi_dma_t *d);
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Initialises a DMA transfer engine.
+ * ops		hardware operations
+ * hwArg	argument passed to the hardware operations
+ */
+void spidma_init(spi_dma_t *d, const spi_dma_ops_t *ops, void *hwArg)
+{
+	d->ops = ops;
+	d->hwArg = hwArg;
+	d->tx = NULL;
+	d->rx = NULL;
+	d->left = 0;
+	d->busy = false;
+	d->transfers = 0;
+	d->chunks = 0;
+}
+
+/*
+ * Starts a transfer of cnt bytes with the first chunk.
+ * tx		the data to be sent, NULL sends the fill byte of the hardware operations
+ * rx		the destination of the received data, NULL discards it
+ */
+bool spidma_start(spi_dma_t *d, uint32_t cnt, const uint8_t *tx, uint8_t *rx)
+{
+	if(d->busy || cnt==0) return false;
+
+	d->tx = tx;
+	d->rx = rx;
+	d->left = cnt;
+	d->busy = true;
+	spidma_armNext(d);
+
+	return true;
+}
+
+/*
+ * Arms the next chunk, if the current one has completed. After the last chunk the peripheral's DMA
+ * requests are disabled and busy is cleared.
+ */
+bool spidma_service(spi_dma_t *d)
+{
+	if(!d->busy || !d->ops->done(d->hwArg)) return d->busy;
+
+	d->chunks++;
+	if(d->left)
+	{
+		spidma_armNext(d);
+		return true;
+	}
+
+	d->ops->stop(d->hwArg);
+	d->transfers++;
+	d->busy = false;
+	return false;
+}
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Arms the next chunk of at most SPI_DMAMAXXFER bytes and advances the buffers.
+ */
+void spidma_armNext(spi_dma_t *d)
+{
+	uint16_t len = d->left > SPI_DMAMAXXFER ? SPI_DMAMAXXFER : d->left;
+
+	d->ops->arm(d->hwArg, d->tx, d->rx, len);
+
+	if(d->tx) d->tx += len;
+	if(d->rx) d->rx += len;
+	d->left -= len;
+}
@@ -0,0 +1,52 @@
+/*
+ * spi_dma.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: spi_dma.h provides uDMA driven full duplex SPI block transfers. A transfer is split into
+ *       		chunks of at most SPI_DMAMAXXFER bytes; for each chunk the receive and the transmit channel
+ *       		are armed together, so the receive FIFO is emptied while it is filled. The hardware is
+ *       		accessed through a small set of operations only, so the splitting can also be run against
+ *       		a simulated DMA engine.
+ */
+
+#ifndef SPI_DMA_H_
+#define SPI_DMA_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SPI_DMAMAXXFER		1024	/* max. items of one uDMA transfer */
+
+/* hardware operations */
+typedef struct {
+	void (*arm)(void *arg, const uint8_t *tx, uint8_t *rx, uint16_t len);	/* arms both channels, tx==NULL sends a fill byte, rx==NULL discards */
+	bool (*done)(void *arg);												/* true, if both channels have completed */
+	void (*stop)(void *arg);												/* disables the peripheral's DMA requests */
+} spi_dma_ops_t;
+
+typedef struct {
+	const spi_dma_ops_t *ops;
+	void *hwArg;
+
+	const uint8_t *tx;				/* next chunk, NULL if not incremented */
+	uint8_t *rx;
+	uint32_t left;					/* bytes not yet armed */
+	volatile bool busy;				/* true from spidma_start() until the last chunk has completed */
+	uint32_t transfers;				/* completed transfers */
+	uint32_t chunks;				/* completed chunks */
+} spi_dma_t;
+
+
+/* Initialises a DMA transfer engine. */
+void spidma_init(spi_dma_t *d, const spi_dma_ops_t *ops, void *hwArg);
+
+/* Starts a transfer of cnt bytes. Returns false, if a transfer is in progress already. */
+bool spidma_start(spi_dma_t *d, uint32_t cnt, const uint8_t *tx, uint8_t *rx);
+
+/* Arms the next chunk when the current one has completed. Must be called on DMA completion. Returns true while busy. */
+bool spidma_service(spi_dma_t *d);
+
+#endif /* SPI_DMA_H_ */
@@ -0,0 +1,404 @@
+/*
+ * spi_trace.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "spi_trace.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/tm4c1294ncpdt.h"
+#include "driverlib/interrupt.h"
+
+#include "debug.h"
+#include "spi_wrapper.h"
+
+#if (SPITRACE_LEN & (SPITRACE_LEN-1)) != 0
+#error "SPITRACE_LEN must be a power of 2"
+#endif
+
+#define SPITRACE_LINELEN	(8+1+8+1+1+1+2+1+8+1+2*SPITRACE_BYTES+1+2*SPITRACE_BYTES+2)	/* longest dump line */
+
+/* ################### internal variables ################### */
+
+static spitrace_rec_t ring[SPITRACE_LEN];
+static uint16_t head = 0;				/* next record to write, free-running */
+static uint16_t count = 0;				/* valid records */
+static bool traceEnabled = true;
+static uint32_t traceClock = 0;
+
+static bool csOpen = false;				/* a chip select period is being recorded */
+static uint16_t csIdx;					/* its record, free-running */
+static bool xOpen = false;				/* the last record takes further SPI_xchg() bytes */
+static uint32_t opStart;				/* start of the current blocking transfer */
+
+static bool dumping = false;
+static bool dumpResume;					/* recording state before the dump */
+static int16_t dumpIdx;					/* record to dump next, -1 for the header */
+
+
+/* ################### private function prototypes ################### */
+
+/* Stores a new record and returns it */
+spitrace_rec_t * spitrace_new(uint8_t process, char type, uint32_t start);
+
+/* Returns the record of the open chip select period or NULL */
+spitrace_rec_t * spitrace_cs(void);
+
+/* Formats a record as dump line, returns the line length */
+uint8_t spitrace_formatRec(const spitrace_rec_t * rec, char * line);
+
+/* Appends a hex number with digits digits, returns the new length */
+uint8_t spitrace_appendHex(char * line, uint8_t i, uint32_t val, uint8_t digits);
+
+/* Appends a string, returns the new length */
+uint8_t spitrace_appendStr(char * line, uint8_t i, const char * str);
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Sets the timer clock the timestamps are counted in, it is reported in the dump header.
+ * clockHz		clock frequency of debug_timestamp()
+ */
+void spitrace_init(uint32_t clockHz)
+{
+	traceClock = clockHz;
+}
+
+/*
+ * Enables or disables recording. Records are written in the SSI interrupt as well.
+ */
+void spitrace_enable(bool enable)
+{
+	IntDisable(INT_SSI3);
+	if(dumping) dumpResume = enable;
+	else traceEnabled = enable;
+	csOpen = false;
+	xOpen = false;
+	IntEnable(INT_SSI3);
+}
+
+/*
+ * Returns true, if recording is enabled.
+ */
+bool spitrace_enabled(void)
+{
+	return dumping ? dumpResume : traceEnabled;
+}
+
+/*
+ * Discards all records.
+ */
+void spitrace_clear(void)
+{
+	if(dumping) return;
+
+	IntDisable(INT_SSI3);
+	count = 0;
+	csOpen = false;
+	xOpen = false;
+	IntEnable(INT_SSI3);
+}
+
+/*
+ * Opens the record of a chip select period, called when the chip select line is asserted.
+ * process		the SPI process
+ * type			'C' blocking access, 'Q' queued transaction, 'S' stream
+ */
+void spitrace_select(uint8_t process, char type)
+{
+	if(!traceEnabled) return;
+
+	spitrace_new(process, type, debug_timestamp());
+	csIdx = head-1;
+	csOpen = true;
+	xOpen = false;
+}
+
+/*
+ * Closes the record of the chip select period, called when the chip select line is deasserted.
+ */
+void spitrace_deselect(void)
+{
+	spitrace_rec_t * cs = spitrace_cs();
+
+	if(cs) cs->end = debug_timestamp();
+	csOpen = false;
+	xOpen = false;
+}
+
+/*
+ * Adds transmitted bytes to the chip select period.
+ * data		the bytes
+ * cnt		number of bytes
+ */
+void spitrace_tx(const uint8_t * data, uint32_t cnt)
+{
+	spitrace_rec_t * cs = spitrace_cs();
+	uint32_t i;
+
+	if(cs==NULL) return;
+
+	for(i=0; i<cnt && cs->n<SPITRACE_BYTES; i++)
+		cs->tx[cs->n++] = data[i];
+	cs->len += cnt;
+}
+
+/*
+ * Adds transmitted 16 bit frames of the same value to the chip select period.
+ * frame	the frame, sent MSB first
+ * cnt		number of frames
+ */
+void spitrace_frames(uint16_t frame, uint32_t cnt)
+{
+	spitrace_rec_t * cs = spitrace_cs();
+	uint32_t i;
+
+	if(cs==NULL) return;
+
+	/* byte by byte, n may be odd after spitrace_tx() */
+	for(i=0; i<2*cnt && cs->n<SPITRACE_BYTES; i++)
+		cs->tx[cs->n++] = (i & 1) ? frame : frame >> 8;
+	cs->len += 2*cnt;
+}
+
+/*
+ * Notes the start of a blocking transfer, the time is used by the next record.
+ */
+void spitrace_begin(void)
+{
+	opStart = debug_timestamp();
+}
+
+/*
+ * Records a byte exchanged by SPI_xchg(). The bytes are appended to the last record, if it is an
+ * exchange record of the same period with less than SPITRACE_BYTES bytes, or if they repeat its last
+ * exchange; otherwise a new record is started.
+ * process		the SPI process
+ * tx			the byte sent
+ * rx			the byte received
+ */
+void spitrace_xchg(uint8_t process, uint8_t tx, uint8_t rx)
+{
+	spitrace_rec_t * rec;
+	uint8_t tmp = tx;
+
+	if(!traceEnabled) return;
+	spitrace_tx(&tmp, 1);
+
+	rec = &ring[(uint16_t)(head-1) & (SPITRACE_LEN-1)];
+	if(xOpen && rec->len==rec->n && rec->n<SPITRACE_BYTES)
+	{
+		rec->tx[rec->n] = tx;
+		rec->rx[rec->n] = rx;
+		rec->n++;
+		rec->len++;
+	}
+	else if(xOpen && rec->tx[rec->n-1]==tx && rec->rx[rec->n-1]==rx)
+	{
+		rec->len++;
+	}
+	else
+	{
+		rec = spitrace_new(process, 'X', opStart);
+		rec->tx[0] = tx;
+		rec->rx[0] = rx;
+		rec->n = 1;
+		rec->len = 1;
+		xOpen = true;
+	}
+	rec->end = debug_timestamp();
+}
+
+/*
+ * Records a block transfer as 'T' (transmit only), 'R' (receive only) or 'F' (full duplex) record.
+ * process		the SPI process
+ * cnt			number of bytes
+ * tx			the bytes sent, NULL if SPI_FILL was sent
+ * rx			the bytes received, NULL if discarded
+ */
+void spitrace_block(uint8_t process, uint32_t cnt, const uint8_t * tx, const uint8_t * rx)
+{
+	spitrace_rec_t * rec;
+	spitrace_rec_t * cs;
+	uint8_t i;
+
+	if(!traceEnabled) return;
+
+	rec = spitrace_new(process, rx==NULL ? 'T' : (tx==NULL ? 'R' : 'F'), opStart);
+	rec->end = debug_timestamp();
+	rec->len = cnt;
+	for(i=0; i<cnt && i<SPITRACE_BYTES; i++)
+	{
+		rec->tx[i] = tx ? tx[i] : SPI_FILL;
+		rec->rx[i] = rx ? rx[i] : 0;
+	}
+	rec->n = i;
+	xOpen = false;
+
+	cs = spitrace_cs();
+	if(cs==NULL) return;
+	for(i=0; i<rec->n && cs->n<SPITRACE_BYTES; i++)
+		cs->tx[cs->n++] = rec->tx[i];
+	cs->len += cnt;
+}
+
+/*
+ * Starts dumping the ring over the debug UART, the lines are written by spitrace_poll().
+ */
+void spitrace_dump(void)
+{
+	if(dumping) return;
+
+	IntDisable(INT_SSI3);
+	dumpResume = traceEnabled;
+	traceEnabled = false;
+	csOpen = false;
+	xOpen = false;
+	IntEnable(INT_SSI3);
+	dumpIdx = -1;
+	dumping = true;
+}
+
+/*
+ * Writes pending dump lines as long as they fit into the transmit buffer.
+ * Returns true, if a line was written.
+ */
+bool spitrace_poll(void)
+{
+	char line[SPITRACE_LINELEN];
+	uint8_t len;
+	bool written = false;
+
+	while(dumping)
+	{
+		if(dumpIdx<0)
+		{
+			len = spitrace_appendStr(line, 0, "#SPITRACE,");
+			len = spitrace_appendHex(line, len, traceClock, 8);
+			line[len++] = ',';
+			len = spitrace_appendHex(line, len, count, 4);
+			line[len++] = '\r'; line[len++] = '\n';
+		}
+		else if(dumpIdx<count)
+		{
+			len = spitrace_formatRec(&ring[(uint16_t)(head - count + dumpIdx) & (SPITRACE_LEN-1)], line);
+		}
+		else
+		{
+			len = spitrace_appendStr(line, 0, "#SPIEND\r\n");
+		}
+
+		if(!debug_write(line, len)) return written;	/* continue with the next poll */
+		written = true;
+
+		if(dumpIdx++ >= (int16_t)count)
+		{
+			dumping = false;
+			traceEnabled = dumpResume;
+		}
+	}
+
+	return written;
+}
+
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Stores a new record, overwriting the oldest one if the ring is full.
+ * Returns the record, end is set to start and no bytes are stored.
+ */
+spitrace_rec_t * spitrace_new(uint8_t process, char type, uint32_t start)
+{
+	spitrace_rec_t * rec = &ring[head & (SPITRACE_LEN-1)];
+
+	rec->start = start;
+	rec->end = start;
+	rec->len = 0;
+	rec->process = process;
+	rec->type = type;
+	rec->n = 0;
+	head++;
+	if(count < SPITRACE_LEN) count++;
+
+	return rec;
+}
+
+/*
+ * Returns the record of the open chip select period, NULL if there is none or it has been overwritten
+ * by the records of a long period.
+ */
+spitrace_rec_t * spitrace_cs(void)
+{
+	if(!traceEnabled || !csOpen) return NULL;
+	if((uint16_t)(head - csIdx) > SPITRACE_LEN) return NULL;
+
+	return &ring[csIdx & (SPITRACE_LEN-1)];
+}
+
+/*
+ * Formats a record as dump line "<start>,<end>,<type>,<process>,<len>,<tx>,<rx>\r\n". The received
+ * bytes are written for 'X', 'R' and 'F' records only, the sent bytes for all but 'R' records.
+ * rec		the record
+ * line		destination, at least SPITRACE_LINELEN chars
+ * Returns the line length.
+ */
+uint8_t spitrace_formatRec(const spitrace_rec_t * rec, char * line)
+{
+	uint8_t i = 0;
+	uint8_t k;
+
+	i = spitrace_appendHex(line, i, rec->start, 8);
+	line[i++] = ',';
+	i = spitrace_appendHex(line, i, rec->end, 8);
+	line[i++] = ',';
+	line[i++] = rec->type;
+	line[i++] = ',';
+	i = spitrace_appendHex(line, i, rec->process, 2);
+	line[i++] = ',';
+	i = spitrace_appendHex(line, i, rec->len, 8);
+	line[i++] = ',';
+	if(rec->type != 'R')
+		for(k=0; k<rec->n; k++) i = spitrace_appendHex(line, i, rec->tx[k], 2);
+	line[i++] = ',';
+	if(rec->type == 'X' || rec->type == 'R' || rec->type == 'F')
+		for(k=0; k<rec->n; k++) i = spitrace_appendHex(line, i, rec->rx[k], 2);
+	line[i++] = '\r';
+	line[i++] = '\n';
+
+	return i;
+}
+
+/*
+ * Appends a hex number.
+ * line		destination
+ * i		current length
+ * val		the number
+ * digits	number of hex digits
+ * Returns the new length.
+ */
+uint8_t spitrace_appendHex(char * line, uint8_t i, uint32_t val, uint8_t digits)
+{
+	static const char hex[] = "0123456789abcdef";
+
+	while(digits--)
+		line[i++] = hex[(val >> (4*digits)) & 0x0F];
+
+	return i;
+}
+
+/*
+ * Appends a string without its terminating zero.
+ * Returns the new length.
+ */
+uint8_t spitrace_appendStr(char * line, uint8_t i, const char * str)
+{
+	while(*str) line[i++] = *str++;
+
+	return i;
+}
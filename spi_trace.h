@@ -0,0 +1,108 @@
+/*
+ * spi_trace.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: spi_trace.h provides a recorder of the transactions on the SPI bus (SSI3). Each period in
+ *       		which a process holds its chip select is stored as one record, the blocking transfers of a
+ *       		process in between (SPI_xchg(), SPI_xmit(), SPI_rcv(), SPI_xfer()) as further records. A
+ *       		record holds the process, the start and end timestamp (debug_timestamp()), the number of
+ *       		bytes and the first bytes sent and received. Consecutive SPI_xchg() calls are merged into
+ *       		one record of up to SPITRACE_BYTES exchanges, followed by any number of repetitions of the
+ *       		last one (e.g. polling for a busy card), so the exchanged bytes can be reconstructed.
+ *       		The records are kept in a RAM ring of SPITRACE_LEN records; the oldest are overwritten.
+ *       		The ring is dumped as text over the debug UART on demand and decoded by tools/spidecode.py
+ *       		(SSD1351 and SD commands, bus utilisation, idle gaps). The recorder is called by
+ *       		spi_wrapper.c only and is compiled in with SPI_TRACE.
+ *
+ *       		Dump (numbers in hex): "#SPITRACE,<clock Hz>,<records>", one line
+ *       		"<start>,<end>,<type>,<process>,<len>,<tx bytes>,<rx bytes>" per record, oldest first, then
+ *       		"#SPIEND". Types: 'C' chip select held by a blocking access, 'Q' by a queued transaction,
+ *       		'S' by a 16 bit stream; 'X' exchanged bytes, 'T' transmitted, 'R' received and 'F' full
+ *       		duplex block. Byte fields are empty, if not recorded for the type.
+ */
+
+#ifndef SPI_TRACE_H_
+#define SPI_TRACE_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+//#define SPI_TRACE					/* uncomment to record the SPI bus transactions */
+
+#define SPITRACE_LEN		256		/* records in the ring, power of 2 */
+#define SPITRACE_BYTES		6		/* first bytes stored per record, a SD command packet */
+
+/* trace record */
+typedef struct {
+	uint32_t	start;		/* debug_timestamp() */
+	uint32_t	end;
+	uint32_t	len;		/* bytes on the bus, a 16 bit frame counts 2 */
+	uint8_t		process;	/* the SPI process, i.e. its chip select */
+	char		type;		/* see above */
+	uint8_t		n;			/* bytes stored in tx and rx */
+	uint8_t		tx[SPITRACE_BYTES];
+	uint8_t		rx[SPITRACE_BYTES];
+} spitrace_rec_t;
+
+#ifdef SPI_TRACE
+#define SPITRACE_SELECT(process, type)	spitrace_select((process), (type))
+#define SPITRACE_DESELECT()				spitrace_deselect()
+#define SPITRACE_TX(data, cnt)			spitrace_tx((data), (cnt))
+#define SPITRACE_FRAMES(frame, cnt)		spitrace_frames((frame), (cnt))
+#define SPITRACE_BEGIN()				spitrace_begin()
+#define SPITRACE_XCHG(process, tx, rx)	spitrace_xchg((process), (tx), (rx))
+#define SPITRACE_BLOCK(process, cnt, tx, rx)	spitrace_block((process), (cnt), (tx), (rx))
+#else
+#define SPITRACE_SELECT(process, type)
+#define SPITRACE_DESELECT()
+#define SPITRACE_TX(data, cnt)
+#define SPITRACE_FRAMES(frame, cnt)
+#define SPITRACE_BEGIN()
+#define SPITRACE_XCHG(process, tx, rx)
+#define SPITRACE_BLOCK(process, cnt, tx, rx)
+#endif
+
+/* Sets the timer clock the timestamps are counted in. */
+void spitrace_init(uint32_t clockHz);
+
+/* Enables or disables recording. */
+void spitrace_enable(bool enable);
+
+/* Returns true, if recording is enabled. */
+bool spitrace_enabled(void);
+
+/* Discards all records. */
+void spitrace_clear(void);
+
+/* Opens the record of a chip select period. Use the SPITRACE_ macros for all recording functions. */
+void spitrace_select(uint8_t process, char type);
+
+/* Closes the record of the chip select period. */
+void spitrace_deselect(void);
+
+/* Adds cnt transmitted bytes to the chip select period. */
+void spitrace_tx(const uint8_t * data, uint32_t cnt);
+
+/* Adds cnt transmitted 16 bit frames of the same value to the chip select period. */
+void spitrace_frames(uint16_t frame, uint32_t cnt);
+
+/* Notes the start of a blocking transfer. */
+void spitrace_begin(void);
+
+/* Records a byte exchanged by SPI_xchg(). */
+void spitrace_xchg(uint8_t process, uint8_t tx, uint8_t rx);
+
+/* Records a block transfer, tx==NULL: SPI_FILL was sent, rx==NULL: the received data was discarded. */
+void spitrace_block(uint8_t process, uint32_t cnt, const uint8_t * tx, const uint8_t * rx);
+
+/* Starts dumping the ring over the debug UART. Recording is paused until the dump is complete. */
+void spitrace_dump(void);
+
+/* Writes pending dump lines as far as the transmit buffer allows. Must be called periodically.
+ * Returns true, if a line was written. */
+bool spitrace_poll(void);
+
+#endif /* SPI_TRACE_H_ */
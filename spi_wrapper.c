@@ -5,6 +5,7 @@
  *      Author: Christoph Ringl
  */
 
+#include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "inc/tm4c1294ncpdt.h"
@@ -13,11 +14,30 @@
 #include "inc/hw_types.h"
 #include "driverlib/ssi.h"
 #include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/pin_map.h"
+#include "driverlib/udma.h"
 
+#include "conversion.h"
+#include "debug.h"
+#include "dma.h"
+#include "spi_dma.h"
+#include "spi_trace.h"
 #include "spi_wrapper.h"
 
+/* SSI FIFO access, may be replaced by a FIFO model for testing on the host */
+#ifndef SSI_TXNOTFULL
+#define SSI_TXNOTFULL()		(HWREG(SSI3_BASE + SSI_O_SR) & SSI_SR_TNF)
+#define SSI_RXNOTEMPTY()	(HWREG(SSI3_BASE + SSI_O_SR) & SSI_SR_RNE)
+#define SSI_BUSY()			(HWREG(SSI3_BASE + SSI_O_SR) & SSI_SR_BSY)
+#define SSI_PUT(data)		(HWREG(SSI3_BASE + SSI_O_DR) = (data))
+#define SSI_GET()			(HWREG(SSI3_BASE + SSI_O_DR))
+#define SSI_SETDSS(bits)	(HWREG(SSI3_BASE + SSI_O_CR0) = (HWREG(SSI3_BASE + SSI_O_CR0) & ~SSI_CR0_DSS_M) | ((bits)-1))
+#define SSI_SETCLK(pre, scr)	do { HWREG(SSI3_BASE + SSI_O_CPSR) = (pre); \
+		HWREG(SSI3_BASE + SSI_O_CR0) = (HWREG(SSI3_BASE + SSI_O_CR0) & ~SSI_CR0_SCR_M) | ((uint32_t)(scr) << SSI_CR0_SCR_S); } while(0)
+#endif
+
 
 uint32_t spi_g_ui32SysClock;
 uint32_t spi_freq;
@@ -29,11 +49,62 @@ void SSI3IntHandler(void);
 
 inline void Deassert(void);
 inline void Assert(uint8_t process);
+void SPI_burst(uint32_t cnt, const uint8_t * buffXmit, uint8_t * buffRcv);
+void SPI_burstXmit(uint32_t cnt, const uint8_t * buffXmit);
+void SPI_waitBus(uint8_t process);
+void SPI_kick(void);
+void SPI_queueNext(void);
+void SPI_queueResume(void);
+bool SPI_preempt(void);
+void SPI_yield(void);
+void SPI_statsWait(uint8_t process, uint32_t cycles);
+void SPI_setDataLength(uint8_t bits);
+uint16_t SPI_divider(uint32_t freq, uint32_t * actual);
+void SPI_applyClock(uint8_t process);
+void SPI_applyDivider(uint16_t div);
+bool SPI_dma(uint32_t cnt, const uint8_t * buffXmit, uint8_t * buffRcv);
 
+/* uDMA operations of SSI3 (private) */
+void SPI_DmaArm(void *arg, const uint8_t *tx, uint8_t *rx, uint16_t len);
+bool SPI_DmaDone(void *arg);
+void SPI_DmaStop(void *arg);
+void SPI_queueRun(void);
+bool SPI_armEOT(void);
 void (* pfnCSHandler[SPI_MAXPROC*2])(void);	/* stores handler to functions to assert and deassert cs lines */
 uint8_t procCount = 0;						/* number of stored processes */
 volatile uint8_t trmProc = 0;				/* 0, if no transmission is in progress; otherwise the transmission (process) ID */
 
+spi_trans_t * queue[SPI_QUEUELEN];			/* queued transactions, written by the main loop at qHead */
+volatile uint8_t qHead = 0;
+volatile uint8_t qTail = 0;					/* read by the interrupt */
+spi_trans_t * volatile qCur = NULL;			/* the transaction in progress */
+uint8_t qBuf;								/* current buffer of qCur */
+uint16_t qPos;								/* next byte in the current buffer */
+uint16_t qRep;								/* repetitions of the current buffer already sent */
+bool qStarted;								/* true, if pfnStart of the current buffer has been called */
+spi_trans_t * volatile qPaused = NULL;		/* transaction paused for a process with higher priority */
+bool qYield;								/* qCur yields the bus at the end of transmission */
+uint32_t qGrant;							/* timestamp when qCur got the bus */
+
+uint8_t prio[SPI_MAXPROC+1];				/* arbitration policy per process, see SPI_setPolicy() */
+uint32_t maxHold[SPI_MAXPROC+1];			/* in us */
+volatile uint8_t waitProc = 0;				/* process waiting for the bus in a blocking function, 0 if none */
+spi_stats_t stats[SPI_MAXPROC+1];
+
+uint16_t procDiv[SPI_MAXPROC+1];			/* SSI clock divider per process, CPSDVSR | SCR<<8, 0: defDiv */
+uint16_t defDiv;							/* divider of processes without SPI_setClock() */
+uint16_t curDiv = 0;						/* divider in use, 0 if unknown */
+uint8_t curBits = 8;						/* frame size in use */
+
+#ifdef SPI_DMA
+static spi_dma_t spiDma;
+static const spi_dma_ops_t spiDmaOps = {
+	SPI_DmaArm, SPI_DmaDone, SPI_DmaStop
+};
+uint8_t dmaFill = SPI_FILL;					/* source of transfers without transmit data */
+uint8_t dmaDummy;							/* destination of transfers without receive buffer */
+#endif
+
 
 /* Initialise SPI (SSI3) with given clock frequency and data bit length. */
 void SPI_init(uint32_t g_ui32SysClock, uint32_t freq, uint8_t data_length)
@@ -41,6 +112,8 @@ void SPI_init(uint32_t g_ui32SysClock, uint32_t freq, uint8_t data_length)
 	spi_g_ui32SysClock = g_ui32SysClock;
 	spi_freq = freq;
 	spi_data_length = data_length;
+	curBits = data_length;
+	spitrace_init(g_ui32SysClock);
 
 	SysCtlPeripheralEnable(SYSCTL_PERIPH_SSI3);
 
@@ -55,29 +128,56 @@ void SPI_init(uint32_t g_ui32SysClock, uint32_t freq, uint8_t data_length)
 	//SSIIntClear(SSI3_BASE, SSI_TXEOT);
 
 	SSIConfigSetExpClk(SSI3_BASE, g_ui32SysClock, SSI_FRF_MOTO_MODE_0, SSI_MODE_MASTER, freq, data_length);
+	defDiv = SPI_divider(freq, NULL);
+	curDiv = 0;
 
-	/* Enable interrupts */
-	//SSIIntRegister(SSI3_BASE, SSI3IntHandler);
-	//SSIIntEnable(SSI3_BASE, SSI_TXEOT);
+	/* Enable interrupts, the sources are enabled while a queued transaction is sent */
+	SSIIntDisable(SSI3_BASE, SSI_TXFF|SSI_TXEOT);
+	SSIIntRegister(SSI3_BASE, SSI3IntHandler);
+
+#ifdef SPI_DMA
+	/* block transfers by uDMA, the receive channel has priority so that the receive FIFO can't overrun */
+	dma_init();
+	uDMAChannelAssign(UDMA_CH14_SSI3RX);
+	uDMAChannelAssign(UDMA_CH15_SSI3TX);
+	uDMAChannelAttributeDisable(UDMA_CH14_SSI3RX, UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST | UDMA_ATTR_REQMASK);
+	uDMAChannelAttributeEnable(UDMA_CH14_SSI3RX, UDMA_ATTR_HIGH_PRIORITY);
+	uDMAChannelAttributeDisable(UDMA_CH15_SSI3TX, UDMA_ATTR_ALTSELECT | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_USEBURST | UDMA_ATTR_REQMASK);
+	spidma_init(&spiDma, &spiDmaOps, NULL);
+#endif
 	
 	SSIEnable(SSI3_BASE);
 }
 
-/* Sets SPI bus speed to value set in SPI_init(). */
+/* Sets SPI bus speed of processes without SPI_setClock() to SPI_CLKSLOW. */
 void SPI_setSlow(void)
 {
-	while(SSIBusy(SSI3_BASE));
-	SSIDisable(SSI3_BASE);
-	SSIConfigSetExpClk(SSI3_BASE, spi_g_ui32SysClock, SSI_FRF_MOTO_MODE_0, SSI_MODE_MASTER, SPI_CLKSLOW, spi_data_length);
-	SSIEnable(SSI3_BASE);
+	defDiv = SPI_divider(SPI_CLKSLOW, NULL);
+	SPI_applyDivider(defDiv);
 }
-/* Sets SPI bus speed to value set in SPI_CLKSLOW. */
+/* Sets SPI bus speed of processes without SPI_setClock() to the value set in SPI_init(). */
 void SPI_setFast(void)
 {
-	while(SSIBusy(SSI3_BASE));
-	SSIDisable(SSI3_BASE);
-	SSIConfigSetExpClk(SSI3_BASE, spi_g_ui32SysClock, SSI_FRF_MOTO_MODE_0, SSI_MODE_MASTER, spi_freq, spi_data_length);
-	SSIEnable(SSI3_BASE);
+	defDiv = SPI_divider(spi_freq, NULL);
+	SPI_applyDivider(defDiv);
+}
+
+/*
+ * Sets the SSI clock used while process holds the bus, it is switched when the process gets the bus.
+ * freq		the clock in Hz, 0 restores the clock set in SPI_init()
+ * Returns the clock in Hz, the fastest one possible not above freq and SPI_CLKMAX.
+ */
+uint32_t SPI_setClock(uint8_t process, uint32_t freq)
+{
+	uint16_t div;
+
+	if(process==0 || process>procCount) return 0;
+
+	procDiv[process] = freq ? SPI_divider(freq, NULL) : 0;
+	if(process==trmProc) SPI_applyClock(process);
+
+	div = procDiv[process] ? procDiv[process] : defDiv;
+	return spi_g_ui32SysClock / ((div & 0xFF) * ((div >> 8) + 1));
 }
 
 /* Reserves SPI ressource so that access through this module is inhibitat for other processes. */
@@ -85,7 +185,9 @@ void SPI_reserve(uint8_t process)
 {
 	if(process>procCount) return;
 
+	SPI_waitBus(process);
 	trmProc = process;
+	SPI_applyClock(process);
 }
 
 /* Releases SPI ressource so that SPI can be used by other processes again. */
@@ -95,6 +197,7 @@ void SPI_release(uint8_t process)
 	//if(process!=trmProc) return;
 
 	trmProc = 0;
+	SPI_kick();
 }
 
 /* 
@@ -113,6 +216,58 @@ uint8_t SPI_registerProc(void (* pfnAssertCS)(void), void (* pfnDeAssertCS)(void
 	return procCount;
 }
 
+/* Sets the arbitration policy of a process: priority (higher wins, default 0) and the time in us its
+ * queued transactions may hold the bus while a process with higher priority waits. */
+void SPI_setPolicy(uint8_t process, uint8_t priority, uint32_t maxHoldUs)
+{
+	if(process==0 || process>procCount) return;
+
+	prio[process] = priority;
+	maxHold[process] = maxHoldUs;
+}
+
+/* Returns the bus arbitration statistics of a process. */
+spi_stats_t SPI_getStats(uint8_t process)
+{
+	spi_stats_t s = {0};
+
+	if(process==0 || process>procCount) return s;
+
+	IntDisable(INT_SSI3);
+	s = stats[process];
+	IntEnable(INT_SSI3);
+	return s;
+}
+
+/*
+ * Writes the bus arbitration statistics of a process as a text line.
+ * buffer	the destination, at least SPI_STATSTEXTLEN chars
+ * Returns buffer or NULL, if the process is not registered.
+ */
+char * SPI_statsToText(uint8_t process, char * buffer)
+{
+	spi_stats_t s;
+	uint32_t cyclesUs = spi_g_ui32SysClock/1000000;
+	uint16_t i = 0;
+
+	if(process==0 || process>procCount) return NULL;
+	s = SPI_getStats(process);
+	if(cyclesUs==0) cyclesUs = 1;
+
+	buffer[i++] = 'S'; buffer[i++] = 'P'; buffer[i++] = 'I';
+	i = ui32AppendA(buffer, i, process, ',');
+	i = ui32AppendA(buffer, i, prio[process], ',');
+	i = ui32AppendA(buffer, i, s.grants, ',');
+	i = ui32AppendA(buffer, i, s.waits, ',');
+	i = ui32AppendA(buffer, i, s.waitMax/cyclesUs, ',');
+	i = ui32AppendA(buffer, i, s.waits ? (uint32_t)(s.waitTotal/s.waits/cyclesUs) : 0, ',');
+	i = ui32AppendA(buffer, i, s.yields, '\r');
+	buffer[i++] = '\n';
+	buffer[i] = 0;
+
+	return buffer;
+}
+
 /* 
  * Put n bytes of data in the transmit buffer and start transmission.
  */
@@ -122,17 +277,19 @@ void SPI_Put(uint8_t process, uint8_t * data, uint8_t cnt)
 	
 	if(process>procCount) return;
 
-	while(trmProc);
+	SPI_waitBus(process);
 	
 	/* assert CS line */
 	Assert(process);
 
 	for(i=0; i<cnt; i++)
 	{SSIDataPut(SSI3_BASE, data[i]); }
+	SPITRACE_TX(data, cnt);
 	while(SSIBusy(SSI3_BASE));
 	
 	/* deassert CS line */
 	Deassert();
+	SPI_kick();
 }
 
 /* 
@@ -142,16 +299,18 @@ void SPI_Put8(uint8_t process, uint8_t data)
 {
 	if(process>procCount) return;
 
-	while(trmProc);
+	SPI_waitBus(process);
 	
 	/* assert CS line */
 	Assert(process);
 
 	SSIDataPut(SSI3_BASE, data);
+	SPITRACE_TX(&data, 1);
 	while(SSIBusy(SSI3_BASE));
 
 	/* deassert CS line */
 	Deassert();
+	SPI_kick();
 }
 
 /* 
@@ -161,17 +320,20 @@ void SPI_Put16(uint8_t process, uint8_t data1, uint8_t data2)
 {
 	if(process>procCount) return;
 
-	while(trmProc);
+	SPI_waitBus(process);
 	
 	/* assert CS line */
 	Assert(process);
 
 	SSIDataPut(SSI3_BASE, data1);
 	SSIDataPut(SSI3_BASE, data2);
+	SPITRACE_TX(&data1, 1);
+	SPITRACE_TX(&data2, 1);
 	while(SSIBusy(SSI3_BASE));
 
 	/* deassert CS line */
 	Deassert();
+	SPI_kick();
 }
 
 /* 
@@ -181,7 +343,7 @@ void SPI_Put24(uint8_t process, uint8_t data1, uint8_t data2, uint8_t data3)
 {
 	if(process>procCount) return;
 
-	while(trmProc);
+	SPI_waitBus(process);
 	
 	/* assert CS line */
 	Assert(process);
@@ -189,10 +351,14 @@ void SPI_Put24(uint8_t process, uint8_t data1, uint8_t data2, uint8_t data3)
 	SSIDataPut(SSI3_BASE, data1);
 	SSIDataPut(SSI3_BASE, data2);
 	SSIDataPut(SSI3_BASE, data3);
+	SPITRACE_TX(&data1, 1);
+	SPITRACE_TX(&data2, 1);
+	SPITRACE_TX(&data3, 1);
 	while(SSIBusy(SSI3_BASE));
 
 	/* deassert CS line */
 	Deassert();
+	SPI_kick();
 }
 
 /* Asserts the Chip Select line and reserves the SPI ressource. */
@@ -200,9 +366,9 @@ void SPI_SelectCS(uint8_t process)
 {
 	/* Check that process ID is valid and that CS wasn't selected already */
 	if(process>procCount) return;
-	if(process==trmProc) return;
+	if(process==trmProc && qCur==NULL) return;
 
-	while(trmProc);
+	SPI_waitBus(process);
 	
 	/* assert CS line */
 	Assert(process);
@@ -216,6 +382,7 @@ void SPI_DeselectCS(uint8_t process)
 
 	/* deassert CS line */
 	Deassert();
+	SPI_kick();
 }
 
 /* Transmits and receives 1 byte of data. */
@@ -229,45 +396,178 @@ uint8_t SPI_xchg(uint8_t process, uint8_t data)
 	for(i=0; i<8; i++)	/* read 8 times to clear Rcv FIFO */
 	{ SSIDataGetNonBlocking(SSI3_BASE, &ret); }
 	
+	SPITRACE_BEGIN();
 	SSIDataPut(SSI3_BASE, data);
 	while(SSIBusy(SSI3_BASE));
 	SSIDataGet(SSI3_BASE, &ret);
 	//SSIDataGetNonBlocking(SSI3_BASE, &ret);
+	SPITRACE_XCHG(process, data, ret);
 	
 	return ret;
 }
 
-/* Transmits an arbitrary amount of data bytes through SPI. */
+/* Transmits an arbitrary amount of data bytes through SPI, the received data is discarded. */
 void SPI_xmit(uint8_t process, uint32_t cnt, const uint8_t * buffXmit)
 {
 	if(process>procCount) return;
 	if(process!=trmProc) return;
-	uint32_t i;
-	uint32_t ret;
-	uint32_t tmp;
-	
-	for(i=0; i<cnt; i++)
-	{
-		tmp = *buffXmit++;
-		SSIDataPut(SSI3_BASE, tmp);
-		SSIDataGet(SSI3_BASE, &ret);
-	}
+
+	SPITRACE_BEGIN();
+	if(!SPI_dma(cnt, buffXmit, NULL)) SPI_burstXmit(cnt, buffXmit);
+	SPITRACE_BLOCK(process, cnt, buffXmit, NULL);
 }
 
-/* Receives an arbitrary amount of data bytes through SPI. */
+/* Receives an arbitrary amount of data bytes through SPI, SPI_FILL is sent. */
 void SPI_rcv(uint8_t process, uint32_t cnt, uint8_t * buffRcv)
 {
 	if(process>procCount) return;
 	if(process!=trmProc) return;
-	uint32_t i;
-	uint32_t tmp;
-	
-	for(i=0; i<cnt; i++)
+
+	SPITRACE_BEGIN();
+	if(!SPI_dma(cnt, NULL, buffRcv)) SPI_burst(cnt, NULL, buffRcv);
+	SPITRACE_BLOCK(process, cnt, NULL, buffRcv);
+}
+
+/*
+ * Transmits and receives an arbitrary amount of data bytes through SPI.
+ * buffXmit		the data to be sent, NULL sends SPI_FILL
+ * buffRcv		the destination of the received data, NULL discards it
+ */
+void SPI_xfer(uint8_t process, uint32_t cnt, const uint8_t * buffXmit, uint8_t * buffRcv)
+{
+	if(process>procCount) return;
+	if(process!=trmProc) return;
+
+	SPITRACE_BEGIN();
+	if(!SPI_dma(cnt, buffXmit, buffRcv))
 	{
-		SSIDataPut(SSI3_BASE, 0xFF);
-		SSIDataGet(SSI3_BASE, &tmp);
-		buffRcv[i] = tmp;
+		if(buffRcv) SPI_burst(cnt, buffXmit, buffRcv);
+		else SPI_burstXmit(cnt, buffXmit);
 	}
+	SPITRACE_BLOCK(process, cnt, buffXmit, buffRcv);
+}
+
+/*
+ * Queues a transmit-only transaction. It is started immediately if the bus is free, otherwise when
+ * the current transaction or the blocking access of another process has finished.
+ * trans		the transaction, must stay unchanged until trans->busy is false
+ * Returns false, if the process is invalid or the queue is full.
+ */
+bool SPI_queue(spi_trans_t * trans)
+{
+	uint8_t next;
+
+	if(trans->process==0 || trans->process>procCount) return false;
+
+	next = (qHead+1) % SPI_QUEUELEN;
+	if(next==qTail) return false;
+
+	trans->busy = true;
+	trans->queued = debug_timestamp();
+	trans->waited = trmProc!=0 || qCur!=NULL || qPaused!=NULL || qHead!=qTail;
+	queue[qHead] = trans;
+	qHead = next;
+
+	SPI_kick();
+	return true;
+}
+
+/* Returns true, if no queued transaction is pending or in progress. */
+bool SPI_queueIdle(void)
+{
+	return qCur==NULL && qPaused==NULL && qHead==qTail;
+}
+
+/*
+ * Waits until all queued transactions have been sent. The CPU sleeps while the interrupt sends them,
+ * interrupts are masked between the check and the sleep so that the completion can't be missed.
+ */
+void SPI_flush(void)
+{
+	SPI_kick();
+	while(1)
+	{
+		IntMasterDisable();
+		if(SPI_queueIdle()) break;
+		SysCtlSleep();
+		IntMasterEnable();
+	}
+	IntMasterEnable();
+}
+
+/*
+ * Waits until a queued transaction has been sent, the CPU sleeps meanwhile (see SPI_flush()).
+ * trans		the transaction passed to SPI_queue()
+ */
+void SPI_wait(spi_trans_t * trans)
+{
+	if(!trans->busy) return;
+
+	SPI_kick();
+	while(1)
+	{
+		IntMasterDisable();
+		if(!trans->busy) break;
+		SysCtlSleep();
+		IntMasterEnable();
+	}
+	IntMasterEnable();
+}
+
+/*
+ * Asserts the Chip Select line of process and switches to 16 bit frames. The frame size is changed
+ * while no Chip Select line is asserted.
+ */
+void SPI_streamStart(uint8_t process)
+{
+	if(process==0 || process>procCount) return;
+
+	SPI_waitBus(process);
+	SPI_setDataLength(16);
+	Assert(process);
+}
+
+/* Sends one 16 bit frame (MSB first) of a stream, waits only while the transmit FIFO is full. */
+void SPI_stream16(uint8_t process, uint16_t data)
+{
+	if(process!=trmProc) return;
+
+	while(!SSI_TXNOTFULL());
+	SSI_PUT(data);
+	SPITRACE_FRAMES(data, 1);
+}
+
+/* Sends the same 16 bit frame cnt times. */
+void SPI_streamFill16(uint8_t process, uint16_t data, uint32_t cnt)
+{
+	if(process!=trmProc) return;
+
+	SPITRACE_FRAMES(data, cnt);
+	while(cnt)
+	{
+		if(SSI_TXNOTFULL())
+		{
+			SSI_PUT(data);
+			cnt--;
+		}
+	}
+}
+
+/*
+ * Waits for the end of the stream, restores the frame size and deasserts the Chip Select line. The
+ * receive FIFO overruns during a stream and is emptied here.
+ */
+void SPI_streamStop(uint8_t process)
+{
+	if(process==0 || process!=trmProc) return;
+
+	while(SSI_BUSY());
+	while(SSI_RXNOTEMPTY()) SSI_GET();
+	SSIIntClear(SSI3_BASE, SSI_RXOR);
+
+	Deassert();
+	SPI_setDataLength(spi_data_length);
+	SPI_kick();
 }
 
 /* ---===  P R I V A T E  ===--- */
@@ -275,6 +575,7 @@ void SPI_rcv(uint8_t process, uint32_t cnt, uint8_t * buffRcv)
 /* Assert CS line */
 inline void Deassert(void)
 {
+	SPITRACE_DESELECT();
 	pfnCSHandler[trmProc*2+1]();
 	trmProc = 0;
 }
@@ -283,7 +584,372 @@ inline void Deassert(void)
 inline void Assert(uint8_t process)
 {
 	trmProc = process;
+	SPI_applyClock(process);
 	pfnCSHandler[trmProc*2]();
+	SPITRACE_SELECT(process, qCur!=NULL ? 'Q' : (curBits==16 ? 'S' : 'C'));
+}
+
+/*
+ * Full duplex burst transfer. The transmit FIFO is kept filled while the receive FIFO is drained, so
+ * the bus does not pause between bytes. At most SPI_FIFODEPTH bytes are in flight, so the receive
+ * FIFO can't overrun. (private)
+ */
+void SPI_burst(uint32_t cnt, const uint8_t * buffXmit, uint8_t * buffRcv)
+{
+	uint32_t sent = 0;
+	uint32_t rcvd = 0;
+	uint32_t tmp;
+
+	while(SSI_RXNOTEMPTY()) SSI_GET();		/* discard stale data of previous transmissions */
+
+	while(rcvd < cnt)
+	{
+		while(sent < cnt && sent - rcvd < SPI_FIFODEPTH && SSI_TXNOTFULL())
+		{
+			SSI_PUT(buffXmit ? buffXmit[sent] : SPI_FILL);
+			sent++;
+		}
+		while(rcvd < sent && SSI_RXNOTEMPTY())
+		{
+			tmp = SSI_GET();
+			if(buffRcv) buffRcv[rcvd] = tmp;
+			rcvd++;
+		}
+	}
+}
+
+/*
+ * Transmit only burst transfer. The transmit FIFO is kept filled and the receive FIFO is not read
+ * during the transfer; it overruns and is emptied once at the end. (private)
+ */
+void SPI_burstXmit(uint32_t cnt, const uint8_t * buffXmit)
+{
+	uint32_t sent = 0;
+
+	while(sent < cnt)
+	{
+		if(SSI_TXNOTFULL())
+		{
+			SSI_PUT(buffXmit ? buffXmit[sent] : SPI_FILL);
+			sent++;
+		}
+	}
+	while(SSI_BUSY());
+
+	while(SSI_RXNOTEMPTY()) SSI_GET();
+	SSIIntClear(SSI3_BASE, SSI_RXOR);
+}
+
+/*
+ * Transfers a block by uDMA and sleeps until it is complete. Returns false, if the block is shorter
+ * than SPI_DMAMIN or the transmit data is not in SRAM; it has to be sent by the CPU then. (private)
+ */
+bool SPI_dma(uint32_t cnt, const uint8_t * buffXmit, uint8_t * buffRcv)
+{
+#ifdef SPI_DMA
+	if(cnt < SPI_DMAMIN) return false;
+	if(buffXmit && (uint32_t)buffXmit < SRAM_BASE) return false;		/* e.g. constants in flash */
+
+	while(SSI_RXNOTEMPTY()) SSI_GET();		/* discard stale data of previous transmissions */
+	SSIIntClear(SSI3_BASE, SSI_RXOR|SSI_DMARX);
+	SSIIntEnable(SSI3_BASE, SSI_DMARX);
+
+	spidma_start(&spiDma, cnt, buffXmit, buffRcv);
+
+	/* sleep until the completion interrupt, interrupts are masked between the check and the sleep
+	 * so that the completion can't be missed */
+	while(1)
+	{
+		IntMasterDisable();
+		if(!spiDma.busy) break;
+		SysCtlSleep();
+		IntMasterEnable();
+	}
+	IntMasterEnable();
+
+	SSIIntDisable(SSI3_BASE, SSI_DMARX);
+	return true;
+#else
+	return false;
+#endif
+}
+
+/*
+ * Starts the next queued transaction if the bus is free. (private)
+ */
+void SPI_kick(void)
+{
+	if(qCur!=NULL || (qPaused==NULL && qHead==qTail)) return;
+
+	IntDisable(INT_SSI3);
+	if(qCur==NULL && trmProc==0)
+	{
+		if(qPaused!=NULL) SPI_queueResume();
+		else SPI_queueNext();
+	}
+	IntEnable(INT_SSI3);
+}
+
+/*
+ * Takes the next transaction from the queue, asserts its CS line and starts sending. Runs with the
+ * SSI interrupt disabled or in the interrupt. (private)
+ */
+void SPI_queueNext(void)
+{
+	/* a waiting blocking access with higher priority goes first */
+	if(qHead==qTail || (waitProc && prio[waitProc] > prio[queue[qTail]->process]))
+	{
+		qCur = NULL;
+		return;
+	}
+
+	qCur = queue[qTail];
+	qTail = (qTail+1) % SPI_QUEUELEN;
+	qBuf = 0;
+	qPos = 0;
+	qRep = 0;
+	qStarted = false;
+	qYield = false;
+
+	Assert(qCur->process);
+	qGrant = debug_timestamp();
+	stats[qCur->process].grants++;
+	if(qCur->waited) SPI_statsWait(qCur->process, qGrant - qCur->queued);
+	SPI_queueRun();
+}
+
+/*
+ * Continues the paused transaction where it stopped, pfnStart of the current buffer is called
+ * again. Runs with the SSI interrupt disabled. (private)
+ */
+void SPI_queueResume(void)
+{
+	qCur = qPaused;
+	qPaused = NULL;
+	qStarted = false;
+	qYield = false;
+
+	Assert(qCur->process);
+	qGrant = debug_timestamp();
+	SPI_queueRun();
+}
+
+/*
+ * Fills the transmit FIFO from the current transaction. Waits for the end of transmission by
+ * interrupt before a buffer with pfnStart and before the CS line is deasserted, so the last byte
+ * on the bus is complete. Completed transactions are finished and the next one is started. (private)
+ */
+void SPI_queueRun(void)
+{
+	const spi_buf_t * buf;
+	spi_trans_t * done;
+
+	while(qCur!=NULL)
+	{
+		if(qYield)						/* paused at a chunk boundary */
+		{
+			if(SPI_armEOT()) return;
+			SPI_yield();
+			break;
+		}
+		if(qBuf >= qCur->bufCnt)		/* all bytes in the FIFO */
+		{
+			if(SPI_armEOT()) return;
+			while(SSI_RXNOTEMPTY()) SSI_GET();
+			SSIIntClear(SSI3_BASE, SSI_RXOR);
+
+			done = qCur;
+			Deassert();
+			done->busy = false;
+			if(done->pfnDone) done->pfnDone(done);
+			SPI_queueNext();
+			continue;
+		}
+
+		buf = &qCur->bufs[qBuf];
+		if(buf->len==0)
+		{
+			qBuf++;
+			continue;
+		}
+		if(!qStarted && buf->pfnStart)
+		{
+			if(SPI_armEOT()) return;
+			buf->pfnStart();
+		}
+		qStarted = true;
+
+		while(SSI_TXNOTFULL())
+		{
+			SSI_PUT(buf->data[qPos]);
+			SPITRACE_TX(&buf->data[qPos], 1);
+			if(++qPos >= buf->len)
+			{
+				qPos = 0;
+				if(++qRep > buf->repeat) break;
+				if(buf->chunk && waitProc && qRep % buf->chunk == 0 && SPI_preempt())
+				{
+					qYield = true;
+					break;
+				}
+			}
+		}
+		if(qYield) continue;
+		if(qRep > buf->repeat)			/* buffer done, continue with the next one */
+		{
+			qBuf++;
+			qRep = 0;
+			qStarted = false;
+			/* the end of a buffer with chunks is a chunk boundary, e.g. a row of a rendered text */
+			if(buf->chunk && waitProc && qBuf < qCur->bufCnt && SPI_preempt()) qYield = true;
+			continue;
+		}
+
+		/* FIFO full, continue when it is half empty */
+		SSIIntDisable(SSI3_BASE, SSI_TXEOT);
+		SSIIntEnable(SSI3_BASE, SSI_TXFF);
+		return;
+	}
+
+	SSIIntDisable(SSI3_BASE, SSI_TXFF|SSI_TXEOT);
+}
+
+/*
+ * Waits until the bus is free for a blocking access of process and records the arbitration latency.
+ * A grant is counted only if the bus changes hands, not for every byte while process holds it.
+ * While waiting, a queued transaction with lower priority yields the bus at its next chunk boundary
+ * after its maximum hold time. (private)
+ */
+void SPI_waitBus(uint8_t process)
+{
+	uint32_t start;
+
+	if(trmProc && (trmProc!=process || qCur!=NULL))
+	{
+		start = debug_timestamp();
+		waitProc = process;
+		while(1)						/* sleep until the interrupt has released the bus, see SPI_flush() */
+		{
+			IntMasterDisable();
+			if(!trmProc || (trmProc==process && qCur==NULL)) break;
+			SysCtlSleep();
+			IntMasterEnable();
+		}
+		IntMasterEnable();
+		waitProc = 0;
+		SPI_statsWait(process, debug_timestamp() - start);
+	}
+	if(trmProc!=process) stats[process].grants++;
+}
+
+/*
+ * Returns true, if the current transaction has to yield the bus to the waiting process. (private)
+ */
+bool SPI_preempt(void)
+{
+	uint8_t p = qCur->process;
+
+	if(waitProc==0 || waitProc==p || prio[waitProc] <= prio[p]) return false;
+
+	return debug_timestamp() - qGrant >= maxHold[p] * (spi_g_ui32SysClock/1000000);
+}
+
+/*
+ * Pauses the current transaction and releases the bus, it is resumed by SPI_kick(). Runs after the
+ * end of transmission. (private)
+ */
+void SPI_yield(void)
+{
+	while(SSI_RXNOTEMPTY()) SSI_GET();
+	SSIIntClear(SSI3_BASE, SSI_RXOR);
+
+	stats[qCur->process].yields++;
+	qPaused = qCur;
+	qCur = NULL;
+	qYield = false;
+	Deassert();
+}
+
+/*
+ * Adds a wait for the bus to the statistics of process. (private)
+ */
+void SPI_statsWait(uint8_t process, uint32_t cycles)
+{
+	stats[process].waits++;
+	stats[process].waitTotal += cycles;
+	if(cycles > stats[process].waitMax) stats[process].waitMax = cycles;
+}
+
+/*
+ * Returns the SSI clock divider for the fastest clock not above freq and SPI_CLKMAX:
+ * SSIClk = SysClk / (CPSDVSR * (1 + SCR)), CPSDVSR is even 2..254, SCR is 0..255.
+ * actual	receives the resulting clock in Hz, may be NULL (private)
+ */
+uint16_t SPI_divider(uint32_t freq, uint32_t * actual)
+{
+	uint32_t div, pre, scr;
+
+	if(freq > SPI_CLKMAX) freq = SPI_CLKMAX;
+	if(freq == 0) freq = 1;
+
+	div = (spi_g_ui32SysClock + freq - 1) / freq;		/* smallest total divider */
+	for(pre=2; ; pre+=2)
+	{
+		scr = (div + pre - 1) / pre;
+		if(scr <= 256 || pre >= 254) break;
+	}
+	if(scr > 256) scr = 256;
+
+	if(actual) *actual = spi_g_ui32SysClock / (pre * scr);
+	return pre | (scr-1) << 8;
+}
+
+/*
+ * Switches to the clock of process, if it differs from the one in use. (private)
+ */
+void SPI_applyClock(uint8_t process)
+{
+	uint16_t div = procDiv[process] ? procDiv[process] : defDiv;
+
+	if(div != curDiv) SPI_applyDivider(div);
+}
+
+/*
+ * Writes a clock divider to the SSI, waits until the bus is idle. (private)
+ */
+void SPI_applyDivider(uint16_t div)
+{
+	while(SSI_BUSY());
+	SSIDisable(SSI3_BASE);
+	SSI_SETCLK(div & 0xFF, div >> 8);
+	SSIEnable(SSI3_BASE);
+	curDiv = div;
+}
+
+/*
+ * Changes the frame size of the SSI, the bus must be idle. (private)
+ */
+void SPI_setDataLength(uint8_t bits)
+{
+	while(SSI_BUSY());
+	SSIDisable(SSI3_BASE);
+	SSI_SETDSS(bits);
+	SSIEnable(SSI3_BASE);
+	curBits = bits;
+}
+
+/*
+ * Arms the end of transmission interrupt. Returns false, if the bus is idle already. (private)
+ */
+bool SPI_armEOT(void)
+{
+	SSIIntDisable(SSI3_BASE, SSI_TXFF);
+	SSIIntClear(SSI3_BASE, SSI_TXEOT);
+	SSIIntEnable(SSI3_BASE, SSI_TXEOT);
+	if(SSI_BUSY()) return true;
+
+	SSIIntDisable(SSI3_BASE, SSI_TXEOT);
+	return false;
 }
 
 /*
@@ -291,12 +957,17 @@ inline void Assert(uint8_t process)
  */
 void SSIIntHandler(uint32_t ui32Base, uint32_t ui32Status)
 {
-	if(ui32Status & SSI_TXEOT)
+#ifdef SPI_DMA
+	if(ui32Status & SSI_DMARX)
 	{
-		/* deassert CS line */
-		pfnCSHandler[trmProc*2+1]();
-
-		trmProc = 0;
+		/* next chunk of the block transfer */
+		spidma_service(&spiDma);
+	}
+#endif
+	if(ui32Status & (SSI_TXFF|SSI_TXEOT))
+	{
+		/* continue the queued transaction */
+		SPI_queueRun();
 	}
 }
 
@@ -317,4 +988,41 @@ void SSI3IntHandler(void)
 	SSIIntHandler(SSI3_BASE, ui32Status);
 }
 
+#ifdef SPI_DMA
+/*
+ * Arms the receive and the transmit channel for one chunk and enables the DMA requests of SSI3. (private)
+ */
+void SPI_DmaArm(void *arg, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+	uDMAChannelControlSet(UDMA_CH14_SSI3RX | UDMA_PRI_SELECT,
+			UDMA_SIZE_8 | UDMA_SRC_INC_NONE | (rx ? UDMA_DST_INC_8 : UDMA_DST_INC_NONE) | UDMA_ARB_4);
+	uDMAChannelTransferSet(UDMA_CH14_SSI3RX | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+			(void *)(SSI3_BASE + SSI_O_DR), rx ? rx : &dmaDummy, len);
+	uDMAChannelControlSet(UDMA_CH15_SSI3TX | UDMA_PRI_SELECT,
+			UDMA_SIZE_8 | (tx ? UDMA_SRC_INC_8 : UDMA_SRC_INC_NONE) | UDMA_DST_INC_NONE | UDMA_ARB_4);
+	uDMAChannelTransferSet(UDMA_CH15_SSI3TX | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+			tx ? (void *)tx : &dmaFill, (void *)(SSI3_BASE + SSI_O_DR), len);
+
+	uDMAChannelEnable(UDMA_CH14_SSI3RX);
+	uDMAChannelEnable(UDMA_CH15_SSI3TX);
+	SSIDMAEnable(SSI3_BASE, SSI_DMA_RX|SSI_DMA_TX);
+}
+
+/*
+ * Returns true, if both channels have completed. (private)
+ */
+bool SPI_DmaDone(void *arg)
+{
+	return !uDMAChannelIsEnabled(UDMA_CH14_SSI3RX) && !uDMAChannelIsEnabled(UDMA_CH15_SSI3TX);
+}
+
+/*
+ * Disables the DMA requests of SSI3. (private)
+ */
+void SPI_DmaStop(void *arg)
+{
+	SSIDMADisable(SSI3_BASE, SSI_DMA_RX|SSI_DMA_TX);
+}
+#endif
+
 
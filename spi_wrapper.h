@@ -7,6 +7,20 @@
  *       Brief: spi_wrapper.h provides wrapping and abstraction functionality for the TIVA SSI interface.
  *       		Processes can be registered in a way that each process asserts and deasserts its own chip
  *       		select lines so that multiple process can access multiple devices on the SPI bus.
+ *       		Transmit-only transactions can be queued with SPI_queue(); they are sent by the SSI
+ *       		interrupt while the main loop continues. A transaction holds the chip select of its
+ *       		process from the first to the last byte, queued transactions are sent in order and never
+ *       		interleave with each other or with the blocking functions.
+ *       		Each process has a priority and a maximum hold time (SPI_setPolicy()). A queued transaction
+ *       		is paused at the next chunk boundary of its buffers (e.g. a display row), if it has held the
+ *       		bus for its maximum hold time and a process with higher priority waits for the bus. It
+ *       		resumes when that process releases the bus. This bounds the latency of the higher priority
+ *       		process to the maximum hold time plus one chunk.
+ *       		A stream (SPI_streamStart() .. SPI_streamStop()) holds the chip select once and sends 16 bit
+ *       		frames back to back, e.g. pixels of a display.
+ *       		SPI_xmit(), SPI_rcv() and SPI_xfer() move blocks of at least SPI_DMAMIN bytes by uDMA (see
+ *       		spi_dma.h), the CPU sleeps until the block is complete.
+ *       		With SPI_TRACE (spi_trace.h) all transactions are recorded for tools/spidecode.py.
  */
 
 #ifndef SPI_WRAPPER_H_
@@ -22,15 +36,52 @@
 #define SPI_MAXPROC		10
 
 #define SPI_CLKSLOW		(2*1e5)
+#define SPI_CLKMAX		(25e6)	/* fastest clock set by SPI_setClock() */
+
+#define SPI_FIFODEPTH	8		/* depth of the SSI transmit and receive FIFOs */
+#define SPI_FILL		0xFF	/* byte sent by SPI_rcv() and SPI_xfer() without transmit data */
+#define SPI_QUEUELEN	8		/* max. number of queued transactions + 1 */
+#define SPI_DMA					/* comment out to transfer blocks without uDMA */
+#define SPI_DMAMIN		32		/* transfers of at least this many bytes use the uDMA */
+#define SPI_STATSTEXTLEN	(3+6*11+2+1)	/* max. length of the text produced by SPI_statsToText() */
+
+/* a buffer of a queued transaction */
+typedef struct {
+	const uint8_t *	data;			/* the bytes to be sent */
+	uint16_t		len;			/* number of bytes in data */
+	uint16_t		repeat;			/* data is sent repeat+1 times, e.g. to fill with a pattern */
+	uint16_t		chunk;			/* the transaction may be paused after every chunk repetitions and at the end of the buffer, 0=never */
+	void (* pfnStart)(void);		/* called with the bus idle before the first byte, e.g. to set a D/C line; or NULL */
+} spi_buf_t;
+
+/* a queued transmit-only transaction, must not be changed until busy is false */
+typedef struct spi_trans {
+	uint8_t				process;	/* the registered process, its CS is held during the transaction */
+	const spi_buf_t *	bufs;		/* the buffers, sent in order */
+	uint8_t				bufCnt;
+	void (* pfnDone)(struct spi_trans * trans);	/* called in interrupt context when all bytes have been sent; or NULL */
+	volatile bool		busy;		/* true from SPI_queue() until completion */
+	uint32_t			queued;		/* set by SPI_queue() for the latency statistics */
+	bool				waited;		/* set by SPI_queue(), if the bus was busy */
+} spi_trans_t;
+
+/* bus arbitration statistics of a process, times in cycles of debug_timestamp() */
+typedef struct {
+	uint32_t	grants;			/* bus accesses, counted when the bus changes hands */
+	uint32_t	waits;			/* blocking accesses and queued transactions that found the bus busy */
+	uint32_t	waitMax;		/* longest wait for the bus */
+	uint64_t	waitTotal;
+	uint32_t	yields;			/* queued transactions paused for a process with higher priority */
+} spi_stats_t;
 
 
 /* Initialise SPI (SSI3) with given clock frequency and data bit length. */
 void SPI_init(uint32_t g_ui32SysClock, uint32_t freq, uint8_t data_length);
 
-/* Sets SPI bus speed to value set in SPI_init(). */
+/* Sets SPI bus speed of processes without SPI_setClock() to SPI_CLKSLOW. */
 void SPI_setSlow(void);
 
-/* Sets SPI bus speed to value set in SPI_CLKSLOW. */
+/* Sets SPI bus speed of processes without SPI_setClock() to the value set in SPI_init(). */
 void SPI_setFast(void);
 
 /* Reserves SPI ressource so that access through this module is inhibitat for other processes. */
@@ -42,6 +93,22 @@ void SPI_release(uint8_t process);
 /* Registers a process with CS assert and deassert functions and returns the assigned process number. */
 uint8_t SPI_registerProc(void (* pfnAssertCS)(void), void (* pfnDeAssertCS)(void));
 
+/* Sets the SSI clock used while process holds the bus, 0 restores the clock set in SPI_init().
+ * Returns the clock in Hz, the fastest one possible not above freq and SPI_CLKMAX. */
+uint32_t SPI_setClock(uint8_t process, uint32_t freq);
+
+/* Sets the arbitration policy of a process: priority (higher wins, default 0) and the time in us its
+ * queued transactions may hold the bus while a process with higher priority waits. */
+void SPI_setPolicy(uint8_t process, uint8_t priority, uint32_t maxHoldUs);
+
+/* Returns the bus arbitration statistics of a process. */
+spi_stats_t SPI_getStats(uint8_t process);
+
+/* Writes the bus arbitration statistics of a process as a text line to buffer (at least SPI_STATSTEXTLEN
+ * chars): SPI<process>,priority,grants,waits,waitMax,waitMean,yields\r\n (times in us).
+ * Returns NULL, if the process is not registered. */
+char * SPI_statsToText(uint8_t process, char * buffer);
+
 /* Put n bytes of data in the transmit buffer and start transmission. */
 void SPI_Put(uint8_t process, uint8_t * data, uint8_t cnt);
 
@@ -69,4 +136,33 @@ void SPI_xmit(uint8_t process, uint32_t cnt, const uint8_t * buffXmit);
 /* Receives an arbitrary amount of data bytes through SPI. */
 void SPI_rcv(uint8_t process, uint32_t cnt, uint8_t * buffRcv);
 
+/* Transmits and receives an arbitrary amount of data bytes through SPI (buffXmit=NULL sends SPI_FILL,
+ * buffRcv=NULL discards the received data). */
+void SPI_xfer(uint8_t process, uint32_t cnt, const uint8_t * buffXmit, uint8_t * buffRcv);
+
+/* Queues a transmit-only transaction and returns immediately. Returns false, if the queue is full.
+ * Must be called from the main loop only. */
+bool SPI_queue(spi_trans_t * trans);
+
+/* Returns true, if no queued transaction is pending or in progress. */
+bool SPI_queueIdle(void);
+
+/* Waits until all queued transactions have been sent. */
+void SPI_flush(void);
+
+/* Waits until a queued transaction has been sent. */
+void SPI_wait(spi_trans_t * trans);
+
+/* Asserts the Chip Select line of process and switches to 16 bit frames for SPI_stream16(). */
+void SPI_streamStart(uint8_t process);
+
+/* Sends one 16 bit frame (MSB first) of a stream, waits only while the transmit FIFO is full. */
+void SPI_stream16(uint8_t process, uint16_t data);
+
+/* Sends the same 16 bit frame cnt times. */
+void SPI_streamFill16(uint8_t process, uint16_t data, uint32_t cnt);
+
+/* Waits for the end of the stream, restores the frame size and deasserts the Chip Select line. */
+void SPI_streamStop(uint8_t process);
+
 #endif /* SPI_WRAPPER_H_ */
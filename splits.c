@@ -0,0 +1,162 @@
+/*
+ * splits.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "splits.h"
+#include "conversion.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#if (SPLIT_RINGLEN & (SPLIT_RINGLEN-1)) != 0
+#error "SPLIT_RINGLEN must be a power of 2"
+#endif
+
+typedef struct {
+	uint32_t	dist;		/* 1/10 m */
+	uint32_t	time;		/* 1/10 s */
+} split_sample_t;
+
+/* ################### internal variables ################### */
+
+static split_sample_t	ring[SPLIT_RINGLEN];	/* sample ring, indexed by (sample number & (SPLIT_RINGLEN-1)) */
+static uint32_t			head;					/* sample number of the newest sample */
+static uint32_t			count;					/* number of samples added since reset */
+static uint32_t			tail[SPLIT_NUM];		/* sample number of the window start per split */
+static split_t			splits[SPLIT_NUM];
+
+static const uint32_t	splitDist[SPLIT_NUM] = SPLIT_DISTANCES;
+
+#define RING(n)			ring[(n) & (SPLIT_RINGLEN-1)]
+
+/* ################### function definitions ################### */
+
+/*
+ * Resets the sample ring and all best splits.
+ */
+void splits_reset(void)
+{
+	uint8_t i;
+
+	head = 0;
+	count = 0;
+	for(i=0; i<SPLIT_NUM; i++)
+	{
+		tail[i] = 0;
+		splits[i].dist = splitDist[i];
+		splits[i].best = 0;
+		splits[i].last = 0;
+	}
+}
+
+/*
+ * Adds a sample to the ring and updates all splits.
+ * Within the same distance bucket the newest sample replaces the previous one, so the ring holds
+ * the last SPLIT_RINGLEN*SPLIT_BUCKET of distance. Each window start only moves forward, the cost
+ * per call is amortised O(1) per split.
+ * dist		cumulative distance in 1/10 m
+ * time		time in 1/10 s
+ */
+void splits_update(uint32_t dist, uint32_t time)
+{
+	uint8_t i;
+	uint32_t start, oldest, t0, dt;
+	split_sample_t * a;
+	split_sample_t * b;
+
+	/* distance was reset, start over but keep the best splits */
+	if(count>0 && dist<RING(head).dist)
+	{
+		count = 0;
+		for(i=0; i<SPLIT_NUM; i++) splits[i].last = 0;
+	}
+
+	if(count>0 && dist/SPLIT_BUCKET == RING(head).dist/SPLIT_BUCKET)
+	{
+		/* same bucket as the newest sample, replace it */
+		RING(head).dist = dist;
+		RING(head).time = time;
+	}
+	else
+	{
+		if(count>0) head++;
+		else for(i=0; i<SPLIT_NUM; i++) tail[i] = head;
+		RING(head).dist = dist;
+		RING(head).time = time;
+		count++;
+	}
+
+	oldest = (count>SPLIT_RINGLEN) ? head-SPLIT_RINGLEN+1 : head-count+1;
+
+	for(i=0; i<SPLIT_NUM; i++)
+	{
+		if(dist<splitDist[i]) continue;
+		start = dist - splitDist[i];
+
+		if(tail[i]<oldest) tail[i] = oldest;	/* window start has been overwritten */
+
+		/* advance window start while the next sample is still before the start distance */
+		while(tail[i]<head && RING(tail[i]+1).dist<=start) tail[i]++;
+
+		a = &RING(tail[i]);
+		if(a->dist>start || tail[i]==head) continue;	/* split not covered by the ring */
+
+		/* interpolate the time at the start distance */
+		b = &RING(tail[i]+1);
+		t0 = a->time;
+		if(b->dist>a->dist)
+			t0 += (uint32_t)((uint64_t)(b->time - a->time) * (start - a->dist) / (b->dist - a->dist));
+
+		dt = time - t0;
+		splits[i].last = dt;
+		if(splits[i].best==0 || dt<splits[i].best) splits[i].best = dt;
+	}
+}
+
+/*
+ * Returns the split with index idx (0..SPLIT_NUM-1).
+ */
+split_t splits_get(uint8_t idx)
+{
+	if(idx>=SPLIT_NUM) idx = SPLIT_NUM-1;
+	return splits[idx];
+}
+
+/*
+ * Writes a summary line "SPLIT,<km>,<hh:mm:ss.s>" of split idx to buffer.
+ * idx		the split index (0..SPLIT_NUM-1)
+ * buffer	the destination, at least SPLIT_TEXTLEN chars
+ */
+char * splits_toText(uint8_t idx, char * buffer)
+{
+	split_t s = splits_get(idx);
+	uint8_t i = 0;
+
+	buffer[i++] = 'S'; buffer[i++] = 'P'; buffer[i++] = 'L'; buffer[i++] = 'I'; buffer[i++] = 'T';
+	buffer[i++] = ',';
+	ui16ToA(s.dist/10000, &buffer[i], 3, false);
+	i+=3;
+	buffer[i++] = 'k'; buffer[i++] = 'm';
+	buffer[i++] = ',';
+
+	ui8ToA(s.best/36000, &buffer[i], 2);
+	i+=2;
+	buffer[i++] = ':';
+	ui8ToA((s.best/600)%60, &buffer[i], 2);
+	i+=2;
+	buffer[i++] = ':';
+	ui8ToA((s.best/10)%60, &buffer[i], 2);
+	i+=2;
+	buffer[i++] = '.';
+	ui8ToA(s.best%10, &buffer[i], 1);
+	i+=1;
+	buffer[i++] = '\r';
+	buffer[i++] = '\n';
+	buffer[i] = 0;
+
+	return buffer;
+}
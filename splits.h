@@ -0,0 +1,45 @@
+/*
+ * splits.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: splits.h provides a personal best split detector. The fastest time over the distances
+ *       		in SPLIT_DISTANCES is determined with a two-pointer sliding window over the cumulative
+ *       		distance/time series. Samples are kept in a ring with one sample per distance bucket,
+ *       		so memory is bounded for trips of any length and each fix costs amortised O(1).
+ */
+
+#ifndef SPLITS_H_
+#define SPLITS_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SPLIT_DISTANCES		{10000, 50000, 100000}	/* 1/10 m, split distances (1 km, 5 km, 10 km) */
+#define SPLIT_NUM			3						/* number of entries in SPLIT_DISTANCES */
+#define SPLIT_BUCKET		100						/* 1/10 m, distance bucket, one sample is kept per bucket */
+#define SPLIT_RINGLEN		1024					/* samples, must cover the longest split (SPLIT_RINGLEN*SPLIT_BUCKET) */
+#define SPLIT_TEXTLEN		(6+5+1+10+2+1)			/* max. length of splits_toText() including the terminating zero */
+
+typedef struct {
+	uint32_t	dist;		/* 1/10 m, split distance */
+	uint32_t	best;		/* 1/10 s, fastest time, 0 if not yet covered */
+	uint32_t	last;		/* 1/10 s, time of the most recent window, 0 if not yet covered */
+} split_t;
+
+
+/* Resets the sample ring and all best splits. Must be called once before splits_update(). */
+void splits_reset(void);
+
+/* Adds a sample to the ring and updates all splits. dist in 1/10 m (cumulative), time in 1/10 s. */
+void splits_update(uint32_t dist, uint32_t time);
+
+/* Returns the split with index idx (0..SPLIT_NUM-1). */
+split_t splits_get(uint8_t idx);
+
+/* Writes a summary line "SPLIT,<km>,<hh:mm:ss.s>" of split idx to buffer (at least SPLIT_TEXTLEN chars). */
+char * splits_toText(uint8_t idx, char * buffer);
+
+#endif /* SPLITS_H_ */
@@ -0,0 +1,107 @@
+/*
+ * telem.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "telem.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "debug.h"
+#include "framing.h"
+
+/* ################### internal variables ################### */
+
+static bool telemEnabled = false;
+static uint16_t telemSeq = 0;
+static uint32_t telemDropped = 0;
+
+static uint8_t payload[TELEM_LEN + 4];
+static uint8_t frame[1 + FRAMING_MAXENC(TELEM_LEN + 4)];
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Enables or disables the stream.
+ */
+void telem_enable(bool enable)
+{
+	telemEnabled = enable;
+}
+
+/*
+ * Returns true, if the stream is enabled.
+ */
+bool telem_enabled(void)
+{
+	return telemEnabled;
+}
+
+/*
+ * Sends a frame for a GPS epoch. The frame is dropped if it does not fit into the transmit ring;
+ * the sequence number still advances, so the receiver sees the gap.
+ * nmea		raw GPS data of the epoch
+ * gps		computed GPS data of the epoch
+ * ticks	100ms ticks since system start
+ * meas		TELEM_MEASCNT runtime measurements (display, GPS, SD) in timer cycles
+ */
+void telem_send(const gps_nmea_data_t * nmea, const gps_data_t * gps, uint32_t ticks, const uint32_t * meas)
+{
+	uint8_t * p = payload;
+	int32_t val;
+	uint16_t len;
+	uint8_t i;
+
+	if(!telemEnabled) return;
+
+	*p++ = TELEM_TYPE;
+	*p++ = TELEM_VERSION;
+	memcpy(p, &telemSeq, 2);	p += 2;		/* Cortex-M is little endian */
+	memcpy(p, &ticks, 4);		p += 4;
+	*p++ = gps->time.h;
+	*p++ = gps->time.m;
+	*p++ = gps->time.s;
+	memcpy(p, &gps->time.ms, 2);	p += 2;
+	val = gps_coordToInt(gps->lat);
+	memcpy(p, &val, 4);			p += 4;
+	val = gps_coordToInt(gps->lon);
+	memcpy(p, &val, 4);			p += 4;
+	memcpy(p, &gps->alt, 4);	p += 4;
+	memcpy(p, &gps->spd, 2);	p += 2;
+	memcpy(p, &gps->dist, 4);	p += 4;
+	*p++ = nmea->GPSFixType;
+	*p++ = (uint8_t)nmea->GPSFixQuality;
+	*p++ = nmea->NumSatFix;
+	*p++ = nmea->NumSatView;
+	*p++ = nmea->PDOP;
+	*p++ = nmea->HDOP;
+	*p++ = nmea->VDOP;
+	for(i=0; i<TELEM_MEASCNT; i++)
+	{
+		memcpy(p, &meas[i], 4);	p += 4;
+	}
+	memcpy(p, &telemDropped, 4);	p += 4;
+
+	telemSeq++;
+
+	val = framing_crc32(0, payload, TELEM_LEN);
+	memcpy(p, &val, 4);
+	frame[0] = FRAMING_DELIM;			/* terminates text output written since the last frame */
+	len = 1 + framing_encode(payload, TELEM_LEN + 4, &frame[1]);
+
+	if(!debug_write((const char *)frame, len)) telemDropped++;
+}
+
+/*
+ * Returns the number of frames dropped because the transmit ring was full.
+ */
+uint32_t telem_getDropped(void)
+{
+	return telemDropped;
+}
@@ -0,0 +1,48 @@
+/*
+ * telem.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: telem.h provides a live binary telemetry stream over the debug UART for bench tests and
+ *       		tethered setups. One frame is sent per GPS epoch, framed like the log export (framing.h):
+ *       		COBS encoded payload with CRC-32, preceded by an extra delimiter, so text output on the
+ *       		same UART is skipped by the receiver. A frame is written completely into the transmit
+ *       		ring or dropped, sending never blocks. tools/telem_rx.py decodes, shows and records the
+ *       		stream.
+ *
+ *       		Payload (little endian, TELEM_VERSION 1, TELEM_LEN bytes):
+ *       			'T', version u8, seq u16, tick u32,
+ *       			hour u8, min u8, sec u8, ms u16,
+ *       			lat i32, lon i32 (1e-5 degree), alt i32, spd u16, dist u32 (as gps_data_t),
+ *       			fix type u8, fix quality u8, sats fix u8, sats view u8, PDOP u8, HDOP u8, VDOP u8,
+ *       			runtime display, GPS, SD u32 (timer cycles), frames dropped u32, CRC-32
+ */
+
+#ifndef TELEM_H_
+#define TELEM_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gps.h"
+
+#define TELEM_TYPE			'T'
+#define TELEM_VERSION		1
+#define TELEM_LEN			(1+1+2+4 + 3+2 + 4+4+4+2+4 + 7 + 3*4+4)		/* payload without CRC */
+#define TELEM_MEASCNT		3		/* runtime measurements per frame */
+
+/* Enables or disables the stream. */
+void telem_enable(bool enable);
+
+/* Returns true, if the stream is enabled. */
+bool telem_enabled(void);
+
+/* Sends a frame for a GPS epoch, does nothing if disabled. meas holds TELEM_MEASCNT runtimes. */
+void telem_send(const gps_nmea_data_t * nmea, const gps_data_t * gps, uint32_t ticks, const uint32_t * meas);
+
+/* Returns the number of frames dropped because the transmit ring was full. */
+uint32_t telem_getDropped(void);
+
+#endif /* TELEM_H_ */
@@ -0,0 +1,155 @@
+/*
+ * fatfs_posix.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host replacement of the FatFs read and directory calls and of sd_mount() on top of a
+ *       		host directory. sd_mount() changes into a directory below the root, names are opened
+ *       		relative to it. The FatFs DIR type is renamed here, as it collides with the POSIX one.
+ */
+
+#define DIR		FF_DIR
+#include "fatfs/ff.h"
+#undef DIR
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "fatfs_posix.h"
+
+#define MAXFILES	4
+
+typedef struct {
+	FIL *	fp;
+	int		fd;
+} posix_file_t;
+
+static char rootDir[256];
+static char curDir[512];
+static posix_file_t files[MAXFILES];
+static DIR * dir;				/* only one directory is read at a time */
+static bool firstRead;
+
+uint32_t fatfs_posix_firstRead;
+
+static posix_file_t * findFile(FIL * fp)
+{
+	int i;
+
+	for(i=0; i<MAXFILES; i++) if(files[i].fp == fp) return &files[i];
+	return NULL;
+}
+
+void fatfs_posix_init(const char * root)
+{
+	snprintf(rootDir, sizeof(rootDir), "%s", root);
+	snprintf(curDir, sizeof(curDir), "%s", root);
+}
+
+uint8_t sd_mount(const char * path)
+{
+	struct stat st;
+
+	snprintf(curDir, sizeof(curDir), "%s/%s", rootDir, path);
+	return (stat(curDir, &st)==0 && S_ISDIR(st.st_mode)) ? FR_OK : FR_NO_PATH;
+}
+
+FRESULT f_open(FIL* fp, const TCHAR* path, BYTE mode)
+{
+	char name[768];
+	posix_file_t * f = findFile(NULL);
+	struct stat st;
+
+	if(mode & ~(FA_READ | FA_OPEN_EXISTING)) return FR_DENIED;	/* read only */
+	if(f == NULL) return FR_TOO_MANY_OPEN_FILES;
+	snprintf(name, sizeof(name), "%s/%s", curDir, path);
+	f->fd = open(name, O_RDONLY);
+	if(f->fd < 0) return FR_NO_FILE;
+	fstat(f->fd, &st);
+	f->fp = fp;
+	fp->fptr = 0;
+	fp->fsize = st.st_size;
+	firstRead = true;
+	return FR_OK;
+}
+
+FRESULT f_close(FIL* fp)
+{
+	posix_file_t * f = findFile(fp);
+
+	if(f == NULL) return FR_INVALID_OBJECT;
+	close(f->fd);
+	f->fp = NULL;
+	return FR_OK;
+}
+
+FRESULT f_read(FIL* fp, void* buff, UINT btr, UINT* br)
+{
+	posix_file_t * f = findFile(fp);
+	ssize_t n;
+
+	*br = 0;
+	if(f == NULL) return FR_INVALID_OBJECT;
+	if(firstRead) fatfs_posix_firstRead = fp->fptr;
+	firstRead = false;
+	n = pread(f->fd, buff, btr, fp->fptr);
+	if(n < 0) return FR_DISK_ERR;
+	fp->fptr += n;
+	*br = n;
+	return FR_OK;
+}
+
+FRESULT f_lseek(FIL* fp, DWORD ofs)
+{
+	if(findFile(fp) == NULL) return FR_INVALID_OBJECT;
+	fp->fptr = (ofs < fp->fsize) ? ofs : fp->fsize;
+	return FR_OK;
+}
+
+FRESULT f_opendir(FF_DIR* dp, const TCHAR* path)
+{
+	char name[768];
+
+	if(dir) closedir(dir);
+	snprintf(name, sizeof(name), "%s/%s", curDir, path);
+	dir = opendir(name);
+	return dir ? FR_OK : FR_NO_PATH;
+}
+
+FRESULT f_closedir(FF_DIR* dp)
+{
+	if(dir == NULL) return FR_INVALID_OBJECT;
+	closedir(dir);
+	dir = NULL;
+	return FR_OK;
+}
+
+/* returns the entries except . and .., the end of the directory with an empty fname */
+FRESULT f_readdir(FF_DIR* dp, FILINFO* fno)
+{
+	char name[768];
+	struct dirent * de;
+	struct stat st;
+
+	if(dir == NULL) return FR_INVALID_OBJECT;
+	do {
+		de = readdir(dir);
+	} while(de && (strcmp(de->d_name, ".")==0 || strcmp(de->d_name, "..")==0));
+
+	memset(fno->fname, 0, sizeof(fno->fname));
+	if(fno->lfname) fno->lfname[0] = 0;
+	if(de == NULL) return FR_OK;
+
+	snprintf(name, sizeof(name), "%s/%s", curDir, de->d_name);
+	if(stat(name, &st) != 0) return FR_DISK_ERR;
+	fno->fsize = st.st_size;
+	fno->fattrib = S_ISDIR(st.st_mode) ? AM_DIR : AM_ARC;
+	snprintf(fno->fname, sizeof(fno->fname), "%.12s", de->d_name);
+	if(fno->lfname) snprintf(fno->lfname, fno->lfsize, "%s", de->d_name);
+	return FR_OK;
+}
@@ -0,0 +1,23 @@
+/*
+ * fatfs_posix.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: fatfs_posix.h maps the FatFs calls used for reading files and directories, and
+ *       		sd_mount(), onto a directory of the host file system, so modules reading the SD card
+ *       		can be tested against real files.
+ */
+
+#ifndef FATFS_POSIX_H_
+#define FATFS_POSIX_H_
+
+#include <stdint.h>
+
+/* file position of the first f_read() after the last f_open() */
+extern uint32_t fatfs_posix_firstRead;
+
+/* Sets the host directory that stands for the root of the card. */
+void fatfs_posix_init(const char * root);
+
+#endif /* FATFS_POSIX_H_ */
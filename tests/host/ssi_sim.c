@@ -0,0 +1,396 @@
+/*
+ * ssi_sim.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "ssi_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stubs/tivaware.h"
+
+#define FIFODEPTH		8
+#define SLEEPMAX		100000000	/* cycles SysCtlSleep() waits for an interrupt before the test is aborted */
+
+typedef struct {
+	bool		enabled;
+	bool		inc;			/* memory address increments */
+	uint8_t *	mem;
+	uint32_t	left;
+} dma_ch_t;
+
+/* ################### internal variables ################### */
+
+uint8_t ssisim_log[SSISIM_LOGLEN];
+uint8_t ssisim_logCS[SSISIM_LOGLEN];
+uint8_t ssisim_logDC[SSISIM_LOGLEN];
+uint32_t ssisim_logLen;
+
+bool ssisim_cs[SSISIM_MAXCS];
+bool ssisim_dc = true;
+uint8_t (*ssisim_peer)(uint8_t tx) = NULL;
+
+static uint32_t now;
+static uint16_t txf[FIFODEPTH], rxf[FIFODEPTH];
+static int txn, rxn;
+static bool shifting;
+static uint32_t shiftEnd;
+static uint16_t shiftVal;
+static uint8_t width = 8;
+static uint32_t bitCycles = 12;
+static uint32_t lastEnd;			/* end of the last frame */
+static bool measuring, measured;	/* gap counting on, a frame has been shifted since */
+static ssisim_stats_t stats;
+
+static uint32_t intMask, intRaw;	/* SSI interrupt mask and latched sources */
+static bool nvicEnabled = true, masterEnabled = true, inIsr = false;
+
+static bool dmaReqTx, dmaReqRx;		/* DMA requests of the SSI enabled */
+static dma_ch_t dmaTx, dmaRx;
+
+/* the interrupt handler of spi_wrapper.c */
+void SSI3IntHandler(void);
+
+/* ################### private function prototypes ################### */
+
+static void advance(uint32_t cnt);
+static uint32_t status(void);
+static void interrupt(void);
+static void shiftDone(void);
+
+/* ################### function definitions ################### */
+
+void ssisim_reset(void)
+{
+	now = 0;
+	txn = rxn = 0;
+	shifting = false;
+	lastEnd = 0;
+	measuring = measured = false;
+	memset(&stats, 0, sizeof(stats));
+	ssisim_logLen = 0;
+	intRaw = 0;
+}
+
+void ssisim_step(uint32_t cnt)
+{
+	advance(cnt);
+}
+
+void ssisim_measure(bool on)
+{
+	measuring = on;
+	measured = false;
+}
+
+ssisim_stats_t ssisim_stats(void)
+{
+	return stats;
+}
+
+uint32_t ssisim_time(void)
+{
+	return now;
+}
+
+bool ssisim_txNotFull(void)
+{
+	advance(2);
+	return txn < FIFODEPTH;
+}
+
+bool ssisim_rxNotEmpty(void)
+{
+	advance(2);
+	return rxn > 0;
+}
+
+bool ssisim_busy(void)
+{
+	advance(2);
+	return shifting || txn;
+}
+
+void ssisim_put(uint32_t data)
+{
+	advance(2);
+	if(txn >= FIFODEPTH) { printf("ssi_sim: transmit FIFO overflow\n"); exit(2); }
+	txf[txn++] = data;
+	intRaw &= ~SSI_TXEOT;
+}
+
+uint32_t ssisim_get(void)
+{
+	uint32_t v = 0;
+
+	advance(2);
+	if(rxn)
+	{
+		v = rxf[0];
+		memmove(rxf, rxf+1, (--rxn)*sizeof(rxf[0]));
+	}
+	return v;
+}
+
+void ssisim_setDss(uint8_t bits)
+{
+	int i;
+
+	advance(2);
+	for(i=0; i<SSISIM_MAXCS; i++)
+		if(ssisim_cs[i]) stats.dssViolations++;
+	if(shifting || txn) stats.dssViolations++;
+	width = bits;
+}
+
+void ssisim_setClk(uint32_t pre, uint32_t scr)
+{
+	advance(2);
+	bitCycles = pre * (scr + 1);
+}
+
+uint32_t debug_timestamp(void)
+{
+	advance(1);
+	return now;
+}
+
+/* driverlib functions of the SSI, the interrupt controller and the uDMA ---------------- */
+
+void SSIConfigSetExpClk(uint32_t base, uint32_t clock, uint32_t protocol, uint32_t mode, uint32_t rate, uint32_t bits)
+{
+	bitCycles = clock / rate;
+	width = bits;
+}
+
+bool SSIBusy(uint32_t base)
+{
+	return ssisim_busy();
+}
+
+void SSIDataPut(uint32_t base, uint32_t data)
+{
+	while(!ssisim_txNotFull());
+	ssisim_put(data);
+}
+
+void SSIDataGet(uint32_t base, uint32_t * data)
+{
+	while(!ssisim_rxNotEmpty());
+	*data = ssisim_get();
+}
+
+int32_t SSIDataGetNonBlocking(uint32_t base, uint32_t * data)
+{
+	if(!ssisim_rxNotEmpty()) return 0;
+	*data = ssisim_get();
+	return 1;
+}
+
+uint32_t SSIIntStatus(uint32_t base, bool masked)
+{
+	return masked ? status() & intMask : status();
+}
+
+void SSIIntClear(uint32_t base, uint32_t flags)
+{
+	intRaw &= ~flags;
+}
+
+void SSIIntEnable(uint32_t base, uint32_t flags)
+{
+	intMask |= flags;
+	interrupt();
+}
+
+void SSIIntDisable(uint32_t base, uint32_t flags)
+{
+	intMask &= ~flags;
+}
+
+void SSIDMAEnable(uint32_t base, uint32_t flags)
+{
+	if(flags & SSI_DMA_TX) dmaReqTx = true;
+	if(flags & SSI_DMA_RX) dmaReqRx = true;
+}
+
+void SSIDMADisable(uint32_t base, uint32_t flags)
+{
+	if(flags & SSI_DMA_TX) dmaReqTx = false;
+	if(flags & SSI_DMA_RX) dmaReqRx = false;
+}
+
+void IntEnable(uint32_t n)
+{
+	if(n == INT_SSI3) nvicEnabled = true;
+	interrupt();
+}
+
+void IntDisable(uint32_t n)
+{
+	if(n == INT_SSI3) nvicEnabled = false;
+}
+
+void IntMasterEnable(void)
+{
+	masterEnabled = true;
+	interrupt();
+}
+
+void IntMasterDisable(void)
+{
+	masterEnabled = false;
+}
+
+void SysCtlSleep(void)
+{
+	uint32_t i;
+
+	for(i=0; i<SLEEPMAX; i++)
+	{
+		if(nvicEnabled && (status() & intMask)) return;
+		advance(1);
+	}
+	printf("ssi_sim: sleeping without pending interrupt\n");
+	exit(2);
+}
+
+void uDMAChannelControlSet(uint32_t channel, uint32_t control)
+{
+	if((channel & 0x1F) == (UDMA_CH15_SSI3TX & 0x1F))
+		dmaTx.inc = (control & UDMA_SRC_INC_NONE) != UDMA_SRC_INC_NONE;
+	else
+		dmaRx.inc = (control & UDMA_DST_INC_NONE) != UDMA_DST_INC_NONE;
+}
+
+void uDMAChannelTransferSet(uint32_t channel, uint32_t mode, void * src, void * dst, uint32_t len)
+{
+	if((channel & 0x1F) == (UDMA_CH15_SSI3TX & 0x1F)) { dmaTx.mem = src; dmaTx.left = len; }
+	else { dmaRx.mem = dst; dmaRx.left = len; }
+}
+
+void uDMAChannelEnable(uint32_t channel)
+{
+	if((channel & 0x1F) == (UDMA_CH15_SSI3TX & 0x1F)) dmaTx.enabled = true;
+	else dmaRx.enabled = true;
+}
+
+void uDMAChannelDisable(uint32_t channel)
+{
+	if((channel & 0x1F) == (UDMA_CH15_SSI3TX & 0x1F)) dmaTx.enabled = false;
+	else dmaRx.enabled = false;
+}
+
+bool uDMAChannelIsEnabled(uint32_t channel)
+{
+	return ((channel & 0x1F) == (UDMA_CH15_SSI3TX & 0x1F)) ? dmaTx.enabled : dmaRx.enabled;
+}
+
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Lets cnt cycles pass: frames are shifted, the uDMA serves the FIFOs and a pending interrupt is
+ * taken afterwards.
+ */
+static void advance(uint32_t cnt)
+{
+	while(cnt--)
+	{
+		now++;
+		if(shifting) stats.busyCycles++;
+		if(shifting && now >= shiftEnd) shiftDone();
+
+		if(dmaReqRx && dmaRx.enabled && rxn)
+		{
+			*dmaRx.mem = rxf[0];
+			memmove(rxf, rxf+1, (--rxn)*sizeof(rxf[0]));
+			if(dmaRx.inc) dmaRx.mem++;
+			if(--dmaRx.left == 0) { dmaRx.enabled = false; intRaw |= SSI_DMARX; }
+		}
+		if(dmaReqTx && dmaTx.enabled && txn < FIFODEPTH)
+		{
+			txf[txn++] = *dmaTx.mem;
+			intRaw &= ~SSI_TXEOT;
+			if(dmaTx.inc) dmaTx.mem++;
+			if(--dmaTx.left == 0) dmaTx.enabled = false;
+		}
+
+		if(!shifting && txn)
+		{
+			if(measuring && measured && now > lastEnd)
+			{
+				stats.gaps++;
+				stats.gapCycles += now - lastEnd;
+			}
+			measured = true;
+			shiftVal = txf[0];
+			memmove(txf, txf+1, (--txn)*sizeof(txf[0]));
+			shifting = true;
+			shiftEnd = now + bitCycles * width;
+		}
+	}
+	interrupt();
+}
+
+/*
+ * Completes the frame in the shift register: logs it and stores the answer in the receive FIFO.
+ */
+static void shiftDone(void)
+{
+	int i, n = 0, cs = 0;
+
+	shifting = false;
+	lastEnd = now;
+	stats.frames++;
+
+	for(i=0; i<SSISIM_MAXCS; i++)
+		if(ssisim_cs[i]) { n++; cs = i; }
+	if(n != 1) stats.csViolations++;
+
+	if(ssisim_logLen+2 <= SSISIM_LOGLEN)
+	{
+		if(width > 8)
+		{
+			ssisim_log[ssisim_logLen] = shiftVal >> 8;
+			ssisim_logCS[ssisim_logLen] = cs;
+			ssisim_logDC[ssisim_logLen] = ssisim_dc;
+			ssisim_logLen++;
+		}
+		ssisim_log[ssisim_logLen] = shiftVal;
+		ssisim_logCS[ssisim_logLen] = cs;
+		ssisim_logDC[ssisim_logLen] = ssisim_dc;
+		ssisim_logLen++;
+	}
+
+	if(rxn < FIFODEPTH) rxf[rxn++] = ssisim_peer ? ssisim_peer(shiftVal) : 0xFF;
+	else stats.overruns++;
+
+	if(!txn) intRaw |= SSI_TXEOT;
+}
+
+/*
+ * Returns the raw interrupt status: TXFF while the transmit FIFO is at most half full, TXEOT and
+ * DMARX latched.
+ */
+static uint32_t status(void)
+{
+	return (txn <= FIFODEPTH/2 ? SSI_TXFF : 0) | (intRaw & (SSI_TXEOT | SSI_DMARX));
+}
+
+/*
+ * Calls the interrupt handler, if an enabled interrupt is pending.
+ */
+static void interrupt(void)
+{
+	if(inIsr || !nvicEnabled || !masterEnabled) return;
+	if(status() & intMask)
+	{
+		inIsr = true;
+		SSI3IntHandler();
+		inIsr = false;
+	}
+}
@@ -0,0 +1,79 @@
+/*
+ * ssi_sim.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: ssi_sim.h provides a cycle counting model of SSI3 for the host tests of spi_wrapper.c. It
+ *       		models the 8 frame transmit and receive FIFOs, the shift register, the frame size and
+ *       		clock, the TXFF, TXEOT and DMARX interrupts and the two uDMA channels of SSI3. Every
+ *       		register access costs a few cycles and debug_timestamp() returns the simulated time, so
+ *       		busy loops of the code under test let the bus run. Each frame on the bus is logged with
+ *       		the asserted chip select and the D/C line, and the idle gaps between frames are counted.
+ *
+ *       		The header is included before spi_wrapper.c (-include) and replaces its register access
+ *       		macros. The chip select and D/C functions of a test set ssisim_cs[] and ssisim_dc.
+ */
+
+#ifndef SSI_SIM_H_
+#define SSI_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SSISIM_LOGLEN		200000		/* frames in the bus log */
+#define SSISIM_MAXCS		4
+
+typedef struct {
+	uint32_t	frames;			/* frames shifted out */
+	uint32_t	busyCycles;		/* cycles the shift register was busy */
+	uint32_t	gaps;			/* pauses between frames while measuring */
+	uint32_t	gapCycles;		/* their length */
+	uint32_t	overruns;		/* frames lost, receive FIFO full */
+	uint32_t	csViolations;	/* frames shifted with none or several chip selects asserted */
+	uint32_t	dssViolations;	/* frame size changed while a frame was pending or a CS was asserted */
+} ssisim_stats_t;
+
+/* bus log, one entry per byte, a 16 bit frame is logged as two bytes MSB first */
+extern uint8_t ssisim_log[SSISIM_LOGLEN];
+extern uint8_t ssisim_logCS[SSISIM_LOGLEN];		/* chip select asserted during the byte */
+extern uint8_t ssisim_logDC[SSISIM_LOGLEN];		/* D/C line during the byte */
+extern uint32_t ssisim_logLen;
+
+extern bool ssisim_cs[SSISIM_MAXCS];			/* chip select lines, true: asserted */
+extern bool ssisim_dc;							/* D/C line */
+extern uint8_t (*ssisim_peer)(uint8_t tx);		/* answers a byte, NULL: 0xFF */
+
+/* Resets time, FIFOs, log and statistics. */
+void ssisim_reset(void);
+
+/* Lets cnt cycles pass. */
+void ssisim_step(uint32_t cnt);
+
+/* Starts or stops counting the gaps between frames. The first frame after the start is no gap. */
+void ssisim_measure(bool on);
+
+/* Returns the statistics. */
+ssisim_stats_t ssisim_stats(void);
+
+/* Returns the simulated time in cycles. */
+uint32_t ssisim_time(void);
+
+/* register access */
+bool ssisim_txNotFull(void);
+bool ssisim_rxNotEmpty(void);
+bool ssisim_busy(void);
+void ssisim_put(uint32_t data);
+uint32_t ssisim_get(void);
+void ssisim_setDss(uint8_t bits);
+void ssisim_setClk(uint32_t pre, uint32_t scr);
+
+#define SSI_TXNOTFULL()			ssisim_txNotFull()
+#define SSI_RXNOTEMPTY()		ssisim_rxNotEmpty()
+#define SSI_BUSY()				ssisim_busy()
+#define SSI_PUT(data)			ssisim_put(data)
+#define SSI_GET()				ssisim_get()
+#define SSI_SETDSS(bits)		ssisim_setDss(bits)
+#define SSI_SETCLK(pre, scr)	ssisim_setClk((pre), (scr))
+
+#endif /* SSI_SIM_H_ */
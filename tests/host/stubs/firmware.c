@@ -0,0 +1,31 @@
+/*
+ * firmware.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: firmware.c provides weak replacements of firmware functions that a module under test
+ *       		calls, but whose module is not part of the test. A test may define its own version.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gps.h"
+
+#define STUB	__attribute__((weak))
+
+/* debug.c: output is discarded */
+STUB bool debug_write(const char * data, uint16_t len) { return true; }
+STUB void debug_print(char * str) { }
+
+/* gps.c */
+STUB int32_t gps_coordToInt(gps_coordinate_t coo)
+{
+	int32_t val;
+
+	val = (int32_t)coo.coord_int * 100000 + (int32_t)coo.coord_fract;
+	if(coo.NSEW=='S' || coo.NSEW=='W') val = -val;
+	return val;
+}
@@ -0,0 +1,97 @@
+/*
+ * tivaware.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: tivaware.c provides the driverlib functions declared in tivaware.h as functions without
+ *       		effect that return 0; peripherals are always ready. They are weak, a test models a
+ *       		peripheral by defining its functions.
+ */
+
+#include "tivaware.h"
+
+#define STUB	__attribute__((weak))
+
+STUB void GPIOPinWrite(uint32_t a0, uint8_t a1, uint8_t a2) { }
+STUB int32_t GPIOPinRead(uint32_t a0, uint8_t a1) { return 0; }
+STUB void GPIOPinTypeGPIOOutput(uint32_t a0, uint8_t a1) { }
+STUB void GPIOPinTypeGPIOInput(uint32_t a0, uint8_t a1) { }
+STUB void GPIOPadConfigSet(uint32_t a0, uint8_t a1, uint32_t a2, uint32_t a3) { }
+STUB void GPIOPinConfigure(uint32_t a0) { }
+STUB void GPIOPinTypeUART(uint32_t a0, uint8_t a1) { }
+STUB void GPIOPinTypeSSI(uint32_t a0, uint8_t a1) { }
+STUB void SysCtlPeripheralEnable(uint32_t a0) { }
+STUB void SysCtlPeripheralReset(uint32_t a0) { }
+STUB void SysCtlDelay(uint32_t a0) { }
+STUB uint32_t SysCtlClockFreqSet(uint32_t a0, uint32_t a1) { return 0; }
+STUB void SysCtlSleep(void) { }
+STUB void IntMasterDisable(void) { }
+STUB void IntMasterEnable(void) { }
+STUB void IntEnable(uint32_t a0) { }
+STUB void IntDisable(uint32_t a0) { }
+STUB void IntPrioritySet(uint32_t a0, uint8_t a1) { }
+STUB void IntPendSet(uint32_t a0) { }
+STUB void TimerConfigure(uint32_t a0, uint32_t a1) { }
+STUB void TimerLoadSet(uint32_t a0, uint32_t a1, uint32_t a2) { }
+STUB void TimerIntEnable(uint32_t a0, uint32_t a1) { }
+STUB void TimerEnable(uint32_t a0, uint32_t a1) { }
+STUB void TimerIntClear(uint32_t a0, uint32_t a1) { }
+STUB void UARTIntUnregister(uint32_t a0) { }
+STUB void UARTFIFOEnable(uint32_t a0) { }
+STUB void UARTFIFOLevelSet(uint32_t a0, uint32_t a1, uint32_t a2) { }
+STUB void UARTTxIntModeSet(uint32_t a0, uint32_t a1) { }
+STUB void UARTConfigSetExpClk(uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3) { }
+STUB void UARTIntEnable(uint32_t a0, uint32_t a1) { }
+STUB void UARTIntDisable(uint32_t a0, uint32_t a1) { }
+STUB bool UARTCharPutNonBlocking(uint32_t a0, unsigned char a1) { return 0; }
+STUB bool UARTCharsAvail(uint32_t a0) { return 0; }
+STUB int32_t UARTCharGetNonBlocking(uint32_t a0) { return 0; }
+STUB uint32_t UARTIntStatus(uint32_t a0, bool a1) { return 0; }
+STUB void UARTIntClear(uint32_t a0, uint32_t a1) { }
+STUB bool UARTSpaceAvail(uint32_t a0) { return 0; }
+STUB uint32_t UARTRxErrorGet(uint32_t a0) { return 0; }
+STUB void UARTRxErrorClear(uint32_t a0) { }
+STUB void UARTDMAEnable(uint32_t a0, uint32_t a1) { }
+STUB void UARTDMADisable(uint32_t a0, uint32_t a1) { }
+STUB bool UARTBusy(uint32_t a0) { return 0; }
+STUB void SSIConfigSetExpClk(uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a5) { }
+STUB void SSIEnable(uint32_t a0) { }
+STUB void SSIDisable(uint32_t a0) { }
+STUB bool SSIBusy(uint32_t a0) { return 0; }
+STUB void SSIDataPut(uint32_t a0, uint32_t a1) { }
+STUB int32_t SSIDataPutNonBlocking(uint32_t a0, uint32_t a1) { return 0; }
+STUB void SSIDataGet(uint32_t a0, uint32_t* a1) { }
+STUB int32_t SSIDataGetNonBlocking(uint32_t a0, uint32_t* a1) { return 0; }
+STUB uint32_t SSIIntStatus(uint32_t a0, bool a1) { return 0; }
+STUB void SSIIntClear(uint32_t a0, uint32_t a1) { }
+STUB void SSIIntEnable(uint32_t a0, uint32_t a1) { }
+STUB void SSIIntDisable(uint32_t a0, uint32_t a1) { }
+STUB void SSIDMAEnable(uint32_t a0, uint32_t a1) { }
+STUB void SSIDMADisable(uint32_t a0, uint32_t a1) { }
+STUB void uDMAEnable(void) { }
+STUB void uDMAControlBaseSet(void* a0) { }
+STUB void uDMAChannelAssign(uint32_t a0) { }
+STUB void uDMAChannelAttributeDisable(uint32_t a0, uint32_t a1) { }
+STUB void uDMAChannelAttributeEnable(uint32_t a0, uint32_t a1) { }
+STUB void uDMAChannelControlSet(uint32_t a0, uint32_t a1) { }
+STUB void uDMAChannelTransferSet(uint32_t a0, uint32_t a1, void* a2, void* a3, uint32_t a4) { }
+STUB void uDMAChannelEnable(uint32_t a0) { }
+STUB void uDMAChannelDisable(uint32_t a0) { }
+STUB bool uDMAChannelIsEnabled(uint32_t a0) { return 0; }
+STUB uint32_t uDMAChannelSizeGet(uint32_t a0) { return 0; }
+STUB uint32_t uDMAChannelModeGet(uint32_t a0) { return 0; }
+STUB void uDMAErrorStatusClear(void) { }
+STUB uint32_t uDMAErrorStatusGet(void) { return 0; }
+STUB uint32_t EEPROMInit(void) { return 0; }
+STUB uint32_t EEPROMRead(uint32_t* a0, uint32_t a1, uint32_t a2) { return 0; }
+STUB uint32_t EEPROMProgram(uint32_t* a0, uint32_t a1, uint32_t a2) { return 0; }
+STUB uint32_t EEPROMProgramNonBlocking(uint32_t a0, uint32_t a1) { return 0; }
+STUB uint32_t EEPROMStatusGet(void) { return 0; }
+STUB uint32_t EEPROMSizeGet(void) { return 0; }
+STUB bool SysCtlPeripheralReady(uint32_t a0) { return true; }
+STUB void UARTConfigGetExpClk(uint32_t a0, uint32_t a1, uint32_t* a2, uint32_t* a3) { }
+STUB void TimerIntRegister(uint32_t a0, uint32_t a1, void (*a2)(void)) { }
+STUB void UARTIntRegister(uint32_t a0, void (*a1)(void)) { }
+STUB void SSIIntRegister(uint32_t a0, void (*a1)(void)) { }
+STUB void uDMAIntRegister(uint32_t a0, void (*a1)(void)) { }
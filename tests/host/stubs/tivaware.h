@@ -0,0 +1,227 @@
+/*
+ * tivaware.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: tivaware.h replaces the TivaWare and register headers for the host tests. It defines the
+ *       		constants used by the firmware and declares the driverlib functions; a test defines the
+ *       		functions the code under test calls. Every stub header in inc/ and driverlib/ includes it.
+ */
+
+#ifndef TIVAWARE_H_
+#define TIVAWARE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HWREG(x) (*((volatile uint32_t *)(x)))
+#define ASSERT(x)
+#define GPIO_PORTK_BASE 0x40061000
+#define GPIO_PORTN_BASE 0x40064000
+#define GPIO_PORTL_BASE 0x40062000
+#define GPIO_PORTA_BASE 0
+#define GPIO_PORTP_BASE 0
+#define GPIO_PORTQ_BASE 0
+#define GPIO_PIN_0 1
+#define GPIO_PIN_1 2
+#define GPIO_PIN_2 4
+#define GPIO_PIN_3 8
+#define GPIO_PIN_4 16
+#define GPIO_PIN_5 32
+#define GPIO_PIN_6 64
+#define GPIO_PIN_7 128
+#define GPIO_STRENGTH_4MA 0
+#define GPIO_STRENGTH_2MA 0
+#define GPIO_PIN_TYPE_STD 0
+#define GPIO_PIN_TYPE_STD_WPU 0
+#define UART0_BASE 0x4000C000
+#define UART1_BASE 0x4000D000
+#define UART6_BASE 0x40012000
+#define TIMER0_BASE 0x40030000
+#define TIMER1_BASE 0x40031000
+#define TIMER_O_TAR 0x48
+#define TIMER_A 0xff
+#define TIMER_CFG_PERIODIC 0
+#define TIMER_TIMA_TIMEOUT 1
+#define SSI3_BASE 0x4000B000
+#define SSI_O_DR 0x8
+#define SSI_O_SR 0xC
+#define SSI_SR_TNF 2
+#define SSI_SR_RNE 4
+#define SSI_SR_BSY 0x10
+#define SSI_TXEOT 0x40
+#define SSI_TXFF 8
+#define SSI_RXOR 1
+#define SSI_DMATX 0x20
+#define SSI_DMARX 0x10
+#define SSI_FRF_MOTO_MODE_0 0
+#define SSI_MODE_MASTER 0
+#define SSI_DMA_TX 2
+#define SSI_DMA_RX 1
+#define UART_CONFIG_WLEN_8 0x60
+#define UART_CONFIG_STOP_ONE 0
+#define UART_CONFIG_PAR_NONE 0
+#define UART_INT_RX 0x10
+#define UART_INT_RT 0x40
+#define UART_INT_TX 0x20
+#define UART_INT_OE 0x400
+#define UART_INT_FE 0x80
+#define UART_INT_DMARX 0x10000
+#define UART_FIFO_TX1_8 0
+#define UART_FIFO_RX1_8 0
+#define UART_FIFO_RX4_8 0x10
+#define UART_TXINT_MODE_EOT 0x10
+#define UART_DMA_RX 1
+#define UART_DR_OE 0x800
+#define UART_DR_BE 0x400
+#define UART_DR_PE 0x200
+#define UART_DR_FE 0x100
+#define UART_O_DR 0
+#define UART_O_FR 0x18
+#define UART_FR_RXFE 0x10
+#define INT_UART0 21
+#define INT_UART1 22
+#define INT_UART6 75
+#define INT_TIMER0A 35
+#define INT_SSI3 88
+#define INT_UDMAERR 63
+#define SYSCTL_PERIPH_UART0 0
+#define SYSCTL_PERIPH_UART6 0
+#define SYSCTL_PERIPH_GPIOA 0
+#define SYSCTL_PERIPH_GPIOP 0
+#define SYSCTL_PERIPH_GPIOQ 0
+#define SYSCTL_PERIPH_GPIOK 0
+#define SYSCTL_PERIPH_GPION 0
+#define SYSCTL_PERIPH_GPIOL 0
+#define SYSCTL_PERIPH_SSI3 0
+#define SYSCTL_PERIPH_TIMER0 0
+#define SYSCTL_PERIPH_TIMER1 0
+#define SYSCTL_PERIPH_UDMA 0
+#define SYSCTL_PERIPH_EEPROM0 0
+#define SYSCTL_XTAL_25MHZ 0
+#define SYSCTL_OSC_MAIN 0
+#define SYSCTL_USE_PLL 0
+#define SYSCTL_CFG_VCO_480 0
+#define GPIO_PA0_U0RX 0
+#define GPIO_PA1_U0TX 0
+#define GPIO_PP0_U6RX 0
+#define GPIO_PP1_U6TX 0
+#define GPIO_PQ0_SSI3CLK 0
+#define GPIO_PQ2_SSI3XDAT0 0
+#define GPIO_PQ3_SSI3XDAT1 0
+#define UDMA_CH10_UART6RX 0x2000a
+#define UDMA_CH14_SSI3RX 0x2000e
+#define UDMA_CH15_SSI3TX 0x2000f
+#define UDMA_PRI_SELECT 0
+#define UDMA_ALT_SELECT 0x20
+#define UDMA_SIZE_8 0
+#define UDMA_SRC_INC_8 0
+#define UDMA_SRC_INC_NONE 0xc000000
+#define UDMA_DST_INC_8 0
+#define UDMA_DST_INC_NONE 0xc0000000
+#define UDMA_ARB_4 0
+#define UDMA_ARB_8 0
+#define UDMA_MODE_PINGPONG 3
+#define UDMA_MODE_BASIC 1
+#define UDMA_MODE_STOP 0
+#define UDMA_ATTR_USEBURST 1
+#define UDMA_ATTR_ALTSELECT 2
+#define UDMA_ATTR_HIGH_PRIORITY 4
+#define UDMA_ATTR_REQMASK 8
+#define UDMA_ATTR_ALL 15
+#define EEPROM_INIT_OK 0
+#define EEPROM_RC_WORKING 1
+void GPIOPinWrite(uint32_t,uint8_t,uint8_t);
+int32_t GPIOPinRead(uint32_t,uint8_t);
+void GPIOPinTypeGPIOOutput(uint32_t,uint8_t);
+void GPIOPinTypeGPIOInput(uint32_t,uint8_t);
+void GPIOPadConfigSet(uint32_t,uint8_t,uint32_t,uint32_t);
+void GPIOPinConfigure(uint32_t);
+void GPIOPinTypeUART(uint32_t,uint8_t);
+void GPIOPinTypeSSI(uint32_t,uint8_t);
+void SysCtlPeripheralEnable(uint32_t);
+void SysCtlPeripheralReset(uint32_t);
+void SysCtlDelay(uint32_t);
+uint32_t SysCtlClockFreqSet(uint32_t,uint32_t);
+void SysCtlSleep(void);
+void IntMasterDisable(void);
+void IntMasterEnable(void);
+void IntEnable(uint32_t);
+void IntDisable(uint32_t);
+void IntPrioritySet(uint32_t,uint8_t);
+void IntPendSet(uint32_t);
+void TimerConfigure(uint32_t,uint32_t);
+void TimerLoadSet(uint32_t,uint32_t,uint32_t);
+void TimerIntRegister(uint32_t,uint32_t,void(*)(void));
+void TimerIntEnable(uint32_t,uint32_t);
+void TimerEnable(uint32_t,uint32_t);
+void TimerIntClear(uint32_t,uint32_t);
+void UARTIntUnregister(uint32_t);
+void UARTIntRegister(uint32_t,void(*)(void));
+void UARTFIFOEnable(uint32_t);
+void UARTFIFOLevelSet(uint32_t,uint32_t,uint32_t);
+void UARTTxIntModeSet(uint32_t,uint32_t);
+void UARTConfigSetExpClk(uint32_t,uint32_t,uint32_t,uint32_t);
+void UARTIntEnable(uint32_t,uint32_t);
+void UARTIntDisable(uint32_t,uint32_t);
+bool UARTCharPutNonBlocking(uint32_t,unsigned char);
+bool UARTCharsAvail(uint32_t);
+int32_t UARTCharGetNonBlocking(uint32_t);
+uint32_t UARTIntStatus(uint32_t,bool);
+void UARTIntClear(uint32_t,uint32_t);
+bool UARTSpaceAvail(uint32_t);
+uint32_t UARTRxErrorGet(uint32_t);
+void UARTRxErrorClear(uint32_t);
+void UARTDMAEnable(uint32_t,uint32_t);
+void UARTDMADisable(uint32_t,uint32_t);
+bool UARTBusy(uint32_t);
+void SSIConfigSetExpClk(uint32_t,uint32_t,uint32_t,uint32_t,uint32_t,uint32_t);
+void SSIEnable(uint32_t);
+void SSIDisable(uint32_t);
+bool SSIBusy(uint32_t);
+void SSIDataPut(uint32_t,uint32_t);
+int32_t SSIDataPutNonBlocking(uint32_t,uint32_t);
+void SSIDataGet(uint32_t,uint32_t*);
+int32_t SSIDataGetNonBlocking(uint32_t,uint32_t*);
+uint32_t SSIIntStatus(uint32_t,bool);
+void SSIIntClear(uint32_t,uint32_t);
+void SSIIntEnable(uint32_t,uint32_t);
+void SSIIntDisable(uint32_t,uint32_t);
+void SSIIntRegister(uint32_t,void(*)(void));
+void SSIDMAEnable(uint32_t,uint32_t);
+void SSIDMADisable(uint32_t,uint32_t);
+void uDMAEnable(void);
+void uDMAControlBaseSet(void*);
+void uDMAChannelAssign(uint32_t);
+void uDMAChannelAttributeDisable(uint32_t,uint32_t);
+void uDMAChannelAttributeEnable(uint32_t,uint32_t);
+void uDMAChannelControlSet(uint32_t,uint32_t);
+void uDMAChannelTransferSet(uint32_t,uint32_t,void*,void*,uint32_t);
+void uDMAChannelEnable(uint32_t);
+void uDMAChannelDisable(uint32_t);
+bool uDMAChannelIsEnabled(uint32_t);
+uint32_t uDMAChannelSizeGet(uint32_t);
+uint32_t uDMAChannelModeGet(uint32_t);
+void uDMAErrorStatusClear(void);
+uint32_t uDMAErrorStatusGet(void);
+void uDMAIntRegister(uint32_t,void(*)(void));
+uint32_t EEPROMInit(void);
+uint32_t EEPROMRead(uint32_t*,uint32_t,uint32_t);
+uint32_t EEPROMProgram(uint32_t*,uint32_t,uint32_t);
+uint32_t EEPROMProgramNonBlocking(uint32_t,uint32_t);
+uint32_t EEPROMStatusGet(void);
+uint32_t EEPROMSizeGet(void);
+bool SysCtlPeripheralReady(uint32_t);
+#define UART_RXERROR_OVERRUN 1
+#define UART_RXERROR_FRAMING 1
+#define UDMA_INT_ERR 1
+void UARTConfigGetExpClk(uint32_t,uint32_t,uint32_t*,uint32_t*);
+#define SSI_O_CR0 0x0
+#define SSI_CR0_DSS_M 0xF
+#define SRAM_BASE 0					/* all host memory is RAM */
+#define SSI_O_CPSR 0x10
+#define SSI_CR0_SCR_M 0xFF00
+#define SSI_CR0_SCR_S 8
+
+#endif /* TIVAWARE_H_ */
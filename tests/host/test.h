@@ -0,0 +1,25 @@
+/*
+ * test.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: test.h provides the check macros of the host tests. A failed check prints the file, line
+ *       		and condition and is counted; TEST_END() prints the result and returns the exit code of the
+ *       		test program.
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+
+static int testFailed = 0;
+
+#define CHECK(cond)		do { if(!(cond)) { testFailed++; printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); } } while(0)
+
+#define CHECK_MSG(cond, ...)	do { if(!(cond)) { testFailed++; printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); printf(__VA_ARGS__); printf("\n"); } } while(0)
+
+#define TEST_END()		do { printf("%s: %s\n", __FILE__, testFailed ? "FAILED" : "ok"); return testFailed != 0; } while(0)
+
+#endif /* TEST_H_ */
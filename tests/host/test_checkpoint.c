@@ -0,0 +1,162 @@
+/*
+ * test_checkpoint.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of the trip checkpoint recovery. checkpoint.c runs against a simulated EEPROM
+ *       		that loses power after a given number of programmed words; the word being programmed at
+ *       		that moment is left with garbage. For every point of interruption of a save and of a
+ *       		clear, loading after the restart must return the previous or the new state, never a mix.
+ *       		The age limit of chkpt_expired() is checked as well.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "checkpoint.h"
+#include "test.h"
+
+#define MEMWORDS	(CHKPT_SLOTS*CHKPT_SLOTWORDS)
+
+/* simulated EEPROM */
+static uint32_t mem[MEMWORDS];
+static int budget;				/* words programmed until the power fails, <0: no failure */
+static bool powerLost;
+static uint32_t garbage = 0x12345678;
+
+static bool eeInit(void *arg)
+{
+	return true;
+}
+
+static void eeRead(void *arg, uint32_t *data, uint32_t addr, uint32_t len)
+{
+	memcpy(data, &mem[addr/4], len);
+}
+
+static void eeProgram(void *arg, uint32_t data, uint32_t addr)
+{
+	CHECK(addr/4 < MEMWORDS && (addr & 3) == 0);
+	if(powerLost) return;
+	if(budget == 0)
+	{
+		garbage = garbage*1103515245 + 12345;
+		mem[addr/4] = garbage;			/* torn word */
+		powerLost = true;
+		return;
+	}
+	if(budget > 0) budget--;
+	mem[addr/4] = data;
+}
+
+static bool eeReady(void *arg)
+{
+	return true;
+}
+
+static const chkpt_ops_t ops = {eeInit, eeRead, eeProgram, eeReady};
+
+static chkpt_data_t make(uint32_t n)
+{
+	chkpt_data_t d;
+
+	memset(&d, 0, sizeof(d));
+	d.dist = n*1000;
+	d.stpw = n*7;
+	d.rec = 1;
+	d.saveTime = n;
+	snprintf(d.logName, CHKPT_NAMELEN, "LOG_%u.TXT", n);
+	return d;
+}
+
+static void runSave(const chkpt_data_t * d, bool clear)
+{
+	int guard;
+
+	if(clear) chkpt_clear();
+	else chkpt_save(d);
+	for(guard=0; chkpt_busy() && guard<1000; guard++) chkpt_poll();
+	CHECK(!chkpt_busy());
+}
+
+/* restarts after a power loss and returns the loaded checkpoint number, 0 if none */
+static uint32_t restart(void)
+{
+	chkpt_data_t d, e;
+
+	powerLost = false;
+	budget = -1;
+	chkpt_initOps(&ops, NULL);
+	if(!chkpt_load(&d)) return 0;
+	e = make(d.saveTime);
+	CHECK_MSG(memcmp(&d, &e, sizeof(d)) == 0, "checkpoint %u corrupted", d.saveTime);
+	return d.saveTime;
+}
+
+int main(void)
+{
+	chkpt_data_t d;
+	uint32_t n, got;
+	int cut, i;
+
+	/* erased EEPROM */
+	memset(mem, 0xFF, sizeof(mem));
+	CHECK(restart() == 0);
+
+	/* a chain of saves over several rounds of the slots, each interrupted at every word */
+	for(n=1; n<=3*CHKPT_SLOTS; n++)
+	{
+		d = make(n);
+		for(cut=0; cut<=CHKPT_SLOTWORDS; cut++)
+		{
+			restart();
+			budget = cut;
+			runSave(&d, false);
+			got = restart();
+			if(cut < CHKPT_SLOTWORDS)
+				CHECK_MSG(got == n-1 || (n == 1 && got == 0), "save %u cut at %d: loaded %u", n, cut, got);
+			else
+				CHECK_MSG(got == n, "save %u: loaded %u", n, got);
+		}
+	}
+
+	/* a save restarted with new data while pending */
+	restart();
+	d = make(100);
+	chkpt_save(&d);
+	for(i=0; i<5; i++) chkpt_poll();
+	d = make(101);
+	runSave(&d, false);
+	CHECK(restart() == 101);
+
+	/* clearing: interrupted, the previous checkpoint stays; completed, none is loaded */
+	for(cut=0; cut<=CHKPT_SLOTWORDS; cut++)
+	{
+		restart();
+		budget = cut;
+		runSave(NULL, true);
+		got = restart();
+		CHECK_MSG(got == (cut < CHKPT_SLOTWORDS ? 101 : 0), "clear cut at %d: loaded %u", cut, got);
+		d = make(101);
+		runSave(&d, false);
+	}
+	restart();
+	runSave(NULL, true);
+	CHECK(restart() == 0);
+	d = make(102);
+	runSave(&d, false);			/* a later save is loaded again */
+	CHECK(restart() == 102);
+
+	/* age */
+	d = make(0);
+	d.saveTime = chkpt_timestamp((gps_date_t){31, 12, 26}, (gps_time_t){23, 30, 0, 0, 0});
+	CHECK(!chkpt_expired(&d, d.saveTime));
+	CHECK(!chkpt_expired(&d, chkpt_timestamp((gps_date_t){1, 1, 27}, (gps_time_t){1, 30, 0, 0, 0})));
+	CHECK(chkpt_expired(&d, chkpt_timestamp((gps_date_t){1, 1, 27}, (gps_time_t){1, 30, 1, 0, 0})));
+	CHECK(chkpt_expired(&d, chkpt_timestamp((gps_date_t){31, 12, 26}, (gps_time_t){23, 29, 59, 0, 0})));
+	CHECK(chkpt_timestamp((gps_date_t){1, 3, 24}, (gps_time_t){0, 0, 0, 0, 0}) -
+			chkpt_timestamp((gps_date_t){28, 2, 24}, (gps_time_t){0, 0, 0, 0, 0}) == 2*86400);
+	CHECK(chkpt_timestamp((gps_date_t){1, 1, 1}, (gps_time_t){0, 0, 0, 0, 0}) == 366*86400);
+
+	TEST_END();
+}
@@ -0,0 +1,111 @@
+/*
+ * test_console.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of console.c: argument splitting, line assembly with backspace and overlong
+ *       		lines, command dispatch and the number output of console_printValue() and
+ *       		console_printUValue() at the limits of the value range.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "console.h"
+#include "test.h"
+
+static char out[4096];				/* console output */
+static int outLen = 0;
+
+static int calls = 0;				/* executed commands */
+static uint8_t lastArgc;
+static char lastArgv[CONSOLE_MAXARGS][CONSOLE_LINELEN+1];
+
+void debug_print(char * str)
+{
+	size_t n = strlen(str);
+
+	if(outLen+n < sizeof(out)) { memcpy(&out[outLen], str, n+1); outLen += n; }
+}
+
+static void cmd_set(uint8_t argc, char * argv[])
+{
+	uint8_t i;
+
+	calls++;
+	lastArgc = argc;
+	for(i=0; i<argc; i++) strcpy(lastArgv[i], argv[i]);
+}
+
+static const console_cmd_t commands[] = {
+	{"set", "set a value", cmd_set},
+};
+
+static void input(const char * s)
+{
+	while(*s) console_input(*s++);
+}
+
+static void clearOut(void)
+{
+	outLen = 0;
+	out[0] = 0;
+}
+
+int main(void)
+{
+	char line[CONSOLE_LINELEN+1];
+	char * argv[CONSOLE_MAXARGS+1];
+	char longLine[CONSOLE_LINELEN+8];
+
+	/* splitting */
+	strcpy(line, "  a\tbb  c ");
+	CHECK(console_parse(line, argv, CONSOLE_MAXARGS) == 3);
+	CHECK(strcmp(argv[0], "a")==0 && strcmp(argv[1], "bb")==0 && strcmp(argv[2], "c")==0);
+	CHECK(argv[3] == NULL);
+	strcpy(line, "1 2 3 4 5 6");
+	CHECK(console_parse(line, argv, CONSOLE_MAXARGS) == CONSOLE_MAXARGS);
+	strcpy(line, " \t ");
+	CHECK(console_parse(line, argv, CONSOLE_MAXARGS) == 0);
+
+	/* line assembly and dispatch */
+	console_init(commands, 1);
+	input("  set  a\tb\r\n");
+	CHECK(calls == 1 && lastArgc == 3);
+	CHECK(strcmp(lastArgv[0], "set")==0 && strcmp(lastArgv[1], "a")==0 && strcmp(lastArgv[2], "b")==0);
+	input("sex\bt 1\n");				/* backspace */
+	CHECK(calls == 2 && lastArgc == 2 && strcmp(lastArgv[1], "1")==0);
+	clearOut();
+	input("foo\r\n\r\n");				/* unknown, empty line and CR LF */
+	CHECK(calls == 2);
+	CHECK(strstr(out, "unknown command") != NULL);
+
+	memset(longLine, 'a', sizeof(longLine)-2);
+	longLine[sizeof(longLine)-2] = '\r';
+	longLine[sizeof(longLine)-1] = 0;
+	clearOut();
+	input(longLine);
+	CHECK(strstr(out, "line too long") != NULL);
+	input("set x\r");					/* the console recovers */
+	CHECK(calls == 3 && strcmp(lastArgv[1], "x")==0);
+
+	clearOut();
+	input("help\r");
+	CHECK(strstr(out, "set\tset a value") != NULL);
+
+	/* numbers */
+	clearOut();
+	console_printValue("a", 0);
+	console_printValue("b", -1);
+	console_printValue("c", INT32_MAX);
+	console_printValue("d", INT32_MIN);
+	console_printValue("e", -1000000000);
+	CHECK_MSG(strcmp(out, "a=0\r\nb=-1\r\nc=2147483647\r\nd=-2147483648\r\ne=-1000000000\r\n")==0, "%s", out);
+	clearOut();
+	console_printUValue("f", 0);
+	console_printUValue("g", UINT32_MAX);
+	console_printUValue("h", 3000000000U);
+	CHECK_MSG(strcmp(out, "f=0\r\ng=4294967295\r\nh=3000000000\r\n")==0, "%s", out);
+
+	TEST_END();
+}
@@ -0,0 +1,71 @@
+/*
+ * test_cpuload.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of cpuload.c: a main loop with flagged passes, passes in which a poller finds
+ *       		work and idle passes runs over several windows and a wrap of the timer; the load and the
+ *       		longest pass must match the simulated times.
+ */
+
+#include <stdio.h>
+#include "cpuload.h"
+#include "test.h"
+
+#define CLOCK		120000000
+
+static uint32_t now = 0xFFF00000;		/* the timer wraps during the test */
+
+uint32_t debug_timestamp(void)
+{
+	return now;
+}
+
+int main(void)
+{
+	cpuload_t load;
+	uint32_t t;
+	int s, k;
+
+	cpuload_init(CLOCK);
+	for(s=0; s<12; s++)
+	{
+		t = 0;
+		/* 10 flagged passes of 3 ms, one of 13 ms in second 5 */
+		for(k=0; k<10; k++)
+		{
+			cpuload_loop(true);
+			now += 360000 + (s==5 && k==0 ? 1200000 : 0);
+			t += 360000 + (s==5 && k==0 ? 1200000 : 0);
+		}
+		/* 100 passes of 1 ms in which a poller finds work */
+		for(k=0; k<100; k++)
+		{
+			cpuload_loop(false);
+			now += 60000;
+			cpuload_work(true);
+			now += 60000;
+			t += 120000;
+		}
+		/* idle passes of 10 us */
+		while(t < CLOCK)
+		{
+			cpuload_loop(false);
+			cpuload_work(false);
+			now += 1200;
+			t += 1200;
+		}
+	}
+	cpuload_loop(false);
+
+	/* 3 % flagged + 10 % polling work */
+	load = cpuload_get();
+	CHECK_MSG(load.load1 >= 129 && load.load1 <= 131, "load1 %u", load.load1);
+	CHECK_MSG(load.load10 >= 129 && load.load10 <= 141, "load10 %u", load.load10);
+	CHECK_MSG(load.passMaxAll == 13000, "passMaxAll %u", load.passMaxAll);
+	CHECK_MSG(load.passMax == 3000, "passMax %u", load.passMax);
+	CHECK(load.windows >= 11);
+
+	TEST_END();
+}
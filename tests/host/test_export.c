@@ -0,0 +1,322 @@
+/*
+ * test_export.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of the log export against the host client. export.c and framing.c run on one
+ *       		side of a pseudo-terminal pair, reading the files of a host directory through the FatFs
+ *       		shim fatfs_posix.c; tools/logxfer.py runs on the other side. The debug UART is modelled
+ *       		by a transmit ring that is drained into the pty. Listing, a ranged read, resuming a
+ *       		partial output file at its size and a transfer with lost and corrupted data frames and
+ *       		lost acknowledgements (go-back-N) must deliver the files unchanged.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pty.h>
+#include <termios.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "debug.h"
+#include "export.h"
+#include "framing.h"
+#include "fatfs/ff.h"
+#include "fatfs_posix.h"
+#include "test.h"
+
+#define TXRING		2048		/* UART0 transmit ring */
+#define TRACKLEN	70000
+#define RUNTIME		60			/* s, max. run time of a client call */
+
+/* a file of the simulated card */
+typedef struct {
+	const char *	name;
+	uint32_t		size;
+	uint8_t *		data;
+} card_file_t;
+
+static card_file_t cardFiles[] = {
+	{"track001.csv", TRACKLEN, NULL},
+	{"events001.csv", 1234, NULL},
+	{"a long file name 2026.txt", 300, NULL},
+	{"empty.txt", 0, NULL}
+};
+#define NFILES		(sizeof(cardFiles)/sizeof(cardFiles[0]))
+
+static char root[64];
+static int master, slave;
+static char slaveName[64];
+
+/* debug UART model */
+static uint8_t txRing[TXRING];
+static uint16_t txLen;
+static uint32_t baud = DEBUG_BAUD;
+
+/* link errors */
+static bool lossy;
+static int dataFrames, dataDropped, dataCorrupted, acks, acksDropped;
+
+/* ---=== debug UART replacement ===--- */
+
+bool debug_write(const char * data, uint16_t len)
+{
+	if(len > TXRING - txLen) return false;
+	if(lossy && len >= XFER_BLOCK)
+	{
+		/* a data frame, the only long frames */
+		dataFrames++;
+		if(dataFrames % 7 == 0) { dataDropped++; return true; }
+		memcpy(&txRing[txLen], data, len);
+		if(dataFrames % 11 == 0) { txRing[txLen + len/2] ^= 0x20; dataCorrupted++; }
+		txLen += len;
+		return true;
+	}
+	memcpy(&txRing[txLen], data, len);
+	txLen += len;
+	return true;
+}
+
+uint16_t debug_space(void)
+{
+	return TXRING - txLen;
+}
+
+bool debug_setBaud(uint32_t b)
+{
+	if(txLen) return false;
+	baud = b;
+	return true;
+}
+
+/* ---=== link ===--- */
+
+static uint32_t ticks(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec*10 + tv.tv_usec/100000;
+}
+
+/* drains the transmit ring into the pty */
+static void flushTx(void)
+{
+	ssize_t n;
+
+	if(txLen == 0) return;
+	n = write(master, txRing, txLen);
+	if(n <= 0) return;
+	memmove(txRing, &txRing[n], txLen - n);
+	txLen -= n;
+}
+
+/* passes received frames to the export, drops every 4th acknowledgement on a lossy link */
+static void receive(void)
+{
+	static uint8_t frame[256];
+	static uint16_t len;
+	uint8_t c, dec[256];
+	uint16_t i, n;
+
+	while(read(master, &c, 1) == 1)
+	{
+		if(c != FRAMING_DELIM)
+		{
+			if(len < sizeof(frame)) frame[len++] = c;
+			continue;
+		}
+		n = framing_decode(frame, len, dec);
+		if(lossy && n > 0 && dec[0] == 'A' && ++acks % 4 == 0)
+			acksDropped++;
+		else
+		{
+			for(i=0; i<len; i++) export_input(frame[i]);
+			export_input(FRAMING_DELIM);
+		}
+		len = 0;
+	}
+}
+
+/* runs the device beside a logxfer.py call, returns the exit code of the client */
+static int run(const char * const * args)
+{
+	const char * argv[16];
+	char out[128];
+	uint32_t start;
+	int n = 0, status = -1, fd;
+	pid_t pid;
+
+	export_start(0);
+	export_poll(ticks());
+	CHECK(export_active() && baud == XFER_BAUD);
+
+	argv[n++] = "python3";
+	argv[n++] = LOGXFER;
+	argv[n++] = "--port";
+	argv[n++] = slaveName;
+	argv[n++] = "--no-enter";
+	while(*args) argv[n++] = *args++;
+	argv[n] = NULL;
+
+	fflush(stdout);
+	pid = fork();
+	if(pid == 0)
+	{
+		snprintf(out, sizeof(out), "%s/stdout.txt", root);
+		fd = open(out, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		dup2(fd, 1);
+		snprintf(out, sizeof(out), "%s/stderr.txt", root);
+		fd = open(out, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		dup2(fd, 2);
+		execvp("python3", (char * const *)argv);
+		_exit(127);
+	}
+
+	/* main loop of the device until the client has quit and the console is back */
+	start = ticks();
+	while(export_active() || waitpid(pid, &status, WNOHANG) == 0)
+	{
+		receive();
+		export_poll(ticks());
+		flushTx();
+		usleep(200);
+		if(ticks() - start > RUNTIME*10)
+		{
+			CHECK_MSG(false, "%s: no end after %d s", argv[5], RUNTIME);
+			kill(pid, SIGKILL);
+			waitpid(pid, &status, 0);
+			break;
+		}
+	}
+	if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+	{
+		snprintf(out, sizeof(out), "cat %s/stderr.txt", root);
+		system(out);
+	}
+	CHECK(baud == DEBUG_BAUD);
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/* ---=== files ===--- */
+
+static void writeFile(const char * path, const uint8_t * data, uint32_t len)
+{
+	FILE * f = fopen(path, "wb");
+
+	fwrite(data, 1, len, f);
+	fclose(f);
+}
+
+/* true, if the file at path holds len bytes equal to data from offset on */
+static bool sameData(const char * path, uint32_t offset, const uint8_t * data, uint32_t len, uint32_t size)
+{
+	static uint8_t buf[TRACKLEN];
+	FILE * f = fopen(path, "rb");
+	size_t n;
+
+	if(f == NULL) return false;
+	n = fread(buf, 1, sizeof(buf), f);
+	fclose(f);
+	return n == size && memcmp(&buf[offset], data, len) == 0;
+}
+
+static void makeCard(void)
+{
+	char path[192];
+	uint32_t i, k, x = 1;
+
+	snprintf(root, sizeof(root), "/tmp/test_export.XXXXXX");
+	CHECK(mkdtemp(root) != NULL);
+	snprintf(path, sizeof(path), "%s/logs", root);
+	mkdir(path, 0755);
+	snprintf(path, sizeof(path), "%s/logs/sub", root);
+	mkdir(path, 0755);							/* directories are not listed */
+	snprintf(path, sizeof(path), "%s/out", root);
+	mkdir(path, 0755);
+
+	for(k=0; k<NFILES; k++)
+	{
+		cardFiles[k].data = malloc(cardFiles[k].size + 1);
+		for(i=0; i<cardFiles[k].size; i++)
+		{
+			x = x*1103515245 + 12345;
+			cardFiles[k].data[i] = (i % 97 == 0) ? 0 : (uint8_t)(x >> 16);	/* zeros exercise the COBS encoding */
+		}
+		snprintf(path, sizeof(path), "%s/logs/%s", root, cardFiles[k].name);
+		writeFile(path, cardFiles[k].data, cardFiles[k].size);
+	}
+	fatfs_posix_init(root);
+}
+
+int main(void)
+{
+	struct termios tio;
+	char path[192], line[160], name[128];
+	FILE * f;
+	uint32_t size, resent;
+	int k, found, lines;
+
+	if(system("python3 -c 'import serial' 2>/dev/null") != 0)
+	{
+		printf("%s: skipped, python3 with pyserial is needed\n", __FILE__);
+		return 0;
+	}
+
+	makeCard();
+	CHECK(openpty(&master, &slave, slaveName, NULL, NULL) == 0);
+	tcgetattr(slave, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(slave, TCSANOW, &tio);
+	fcntl(master, F_SETFL, O_NONBLOCK);
+
+	/* list */
+	CHECK(run((const char * const []){"list", NULL}) == 0);
+	snprintf(path, sizeof(path), "%s/stdout.txt", root);
+	f = fopen(path, "r");
+	for(lines=0, found=0; f && fgets(line, sizeof(line), f); lines++)
+	{
+		if(sscanf(line, "%u %127[^\n]", &size, name) != 2) continue;
+		for(k=0; k<NFILES; k++)
+			if(strcmp(name, cardFiles[k].name) == 0 && size == cardFiles[k].size) found++;
+	}
+	if(f) fclose(f);
+	CHECK_MSG(lines == NFILES && found == NFILES, "%d lines, %d files found", lines, found);
+
+	/* a range of a file */
+	snprintf(path, sizeof(path), "%s/out/range.csv", root);
+	CHECK(run((const char * const []){"get", "track001.csv", "-o", path, "--offset", "1000", "--length", "5000", NULL}) == 0);
+	CHECK(sameData(path, 1000, &cardFiles[0].data[1000], 5000, 6000));
+	CHECK(fatfs_posix_firstRead == 1000);
+
+	/* resuming a partial output file at its size */
+	snprintf(path, sizeof(path), "%s/out/resume.csv", root);
+	writeFile(path, cardFiles[0].data, 30000);
+	CHECK(run((const char * const []){"get", "track001.csv", "-o", path, NULL}) == 0);
+	CHECK(sameData(path, 0, cardFiles[0].data, TRACKLEN, TRACKLEN));
+	CHECK(fatfs_posix_firstRead == 30000);
+	CHECK(export_getResent() == 0);
+
+	/* all files over a lossy link */
+	lossy = true;
+	snprintf(path, sizeof(path), "%s/out", root);
+	CHECK(run((const char * const []){"get", "--all", "-d", path, NULL}) == 0);
+	lossy = false;
+	for(k=0; k<NFILES; k++)
+	{
+		snprintf(path, sizeof(path), "%s/out/%s", root, cardFiles[k].name);
+		CHECK_MSG(sameData(path, 0, cardFiles[k].data, cardFiles[k].size, cardFiles[k].size), "%s", cardFiles[k].name);
+	}
+	resent = export_getResent();
+	CHECK_MSG(dataDropped > 0 && dataCorrupted > 0 && acksDropped > 0 && resent >= dataDropped + dataCorrupted,
+			"%d frames dropped, %d corrupted, %d acks dropped, %u blocks resent", dataDropped, dataCorrupted, acksDropped, resent);
+
+	snprintf(path, sizeof(path), "rm -rf %s", root);
+	system(path);
+	TEST_END();
+}
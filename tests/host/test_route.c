@@ -0,0 +1,286 @@
+/*
+ * test_route.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of the route following. A synthetic GPX route longer than ROUTE_MAXVERTEX
+ *       		points is loaded through an in-memory replacement of the FatFs calls and followed
+ *       		segment by segment; the matched segment, cross track error, distance to go and next turn
+ *       		must fit the route and the vertex file must be read a bounded number of times per fix.
+ *       		Re-acquiring the route far ahead, read errors of the vertex file at every point of an
+ *       		update and the error paths of route_load() must leave no file open.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "route.h"
+#include "fatfs/ff.h"
+#include "test.h"
+
+#define NPTS		(ROUTE_BLOCKLEN*ROUTE_MAXBLOCKS + 100)	/* more points than a route can hold */
+#define MAXVTX		(ROUTE_BLOCKLEN*ROUTE_MAXBLOCKS)
+#define RUNE		20			/* segments east per step of the staircase */
+#define RUNN		5			/* segments north per step */
+#define STEPLON		50			/* 1e-5 degree */
+#define STEPLAT		40
+#define LAT0		4800000
+#define LON0		1600000
+#define OFFSET		100			/* 1/10 m, position right of the route */
+
+/* in-memory files */
+typedef struct {
+	const char *	name;
+	char *			data;
+	UINT			size;
+	UINT			cap;
+} memfile_t;
+
+typedef struct {
+	FIL *		fp;
+	memfile_t *	f;
+	UINT		pos;
+} handle_t;
+
+static char gpxData[NPTS*64];
+static char binData[MAXVTX*sizeof(route_vertex_t)];
+static memfile_t files[2] = {
+	{ROUTE_GPXFILE, gpxData, 0, sizeof(gpxData)},
+	{ROUTE_BINFILE, binData, 0, sizeof(binData)}
+};
+static handle_t handles[4];
+static int openCnt;
+static int binReads;			/* reads of the vertex file */
+static int readBudget = -1;		/* vertex file reads until a read error, <0: no errors */
+static bool writeFail;
+
+static int32_t vlat[NPTS], vlon[NPTS];
+
+/* ---=== FatFs replacement ===--- */
+
+static handle_t * findHandle(FIL * fp)
+{
+	int i;
+
+	for(i=0; i<4; i++) if(handles[i].fp == fp) return &handles[i];
+	return NULL;
+}
+
+FRESULT f_open(FIL* fp, const TCHAR* path, BYTE mode)
+{
+	handle_t * h;
+	int i;
+
+	CHECK_MSG(findHandle(fp) == NULL, "%s opened twice", path);
+	for(i=0; i<2; i++) if(strcmp(files[i].name, path) == 0) break;
+	if(i == 2) return FR_NO_FILE;
+	h = findHandle(NULL);
+	h->fp = fp;
+	h->f = &files[i];
+	h->pos = 0;
+	if(mode & FA_CREATE_ALWAYS) files[i].size = 0;
+	openCnt++;
+	return FR_OK;
+}
+
+FRESULT f_close(FIL* fp)
+{
+	handle_t * h = findHandle(fp);
+
+	CHECK_MSG(h != NULL, "closing a file that is not open");
+	if(!h) return FR_INVALID_OBJECT;
+	h->fp = NULL;
+	openCnt--;
+	return FR_OK;
+}
+
+FRESULT f_read(FIL* fp, void* buff, UINT btr, UINT* br)
+{
+	handle_t * h = findHandle(fp);
+
+	*br = 0;
+	if(!h) return FR_INVALID_OBJECT;
+	if(h->f == &files[1])
+	{
+		binReads++;
+		if(readBudget == 0) return FR_DISK_ERR;
+		if(readBudget > 0) readBudget--;
+	}
+	if(btr > h->f->size - h->pos) btr = h->f->size - h->pos;
+	memcpy(buff, &h->f->data[h->pos], btr);
+	h->pos += btr;
+	*br = btr;
+	return FR_OK;
+}
+
+FRESULT f_write(FIL* fp, const void* buff, UINT btw, UINT* bw)
+{
+	handle_t * h = findHandle(fp);
+
+	*bw = 0;
+	if(!h) return FR_INVALID_OBJECT;
+	if(writeFail || h->pos + btw > h->f->cap) return FR_DISK_ERR;
+	memcpy(&h->f->data[h->pos], buff, btw);
+	h->pos += btw;
+	if(h->pos > h->f->size) h->f->size = h->pos;
+	*bw = btw;
+	return FR_OK;
+}
+
+FRESULT f_lseek(FIL* fp, DWORD ofs)
+{
+	handle_t * h = findHandle(fp);
+
+	if(!h) return FR_INVALID_OBJECT;
+	h->pos = (ofs < h->f->size) ? ofs : h->f->size;
+	return FR_OK;
+}
+
+/* ---=== route ===--- */
+
+static gps_coordinate_t coord(int32_t v, char nsew)
+{
+	gps_coordinate_t c;
+
+	c.NSEW = nsew;
+	c.coord_int = v / 100000;
+	c.coord_fract = v % 100000;
+	return c;
+}
+
+/* writes a staircase route of n points to the GPX file, east runs of RUNE and north runs of RUNN segments */
+static void makeGpx(int n)
+{
+	int i, len;
+	int32_t lat = LAT0, lon = LON0;
+
+	len = sprintf(gpxData, "<?xml version=\"1.0\"?>\n<gpx version=\"1.1\">\n<rte><name>long route</name>\n");
+	for(i=0; i<n; i++)
+	{
+		vlat[i] = lat;
+		vlon[i] = lon;
+		len += sprintf(&gpxData[len], "<rtept lat=\"%d.%05d\" lon=\"%d.%05d\"><ele>%d</ele></rtept>\n",
+				lat/100000, lat%100000, lon/100000, lon%100000, i%300);
+		if(i % (RUNE+RUNN) < RUNE) lon += STEPLON;
+		else lat += STEPLAT;
+	}
+	len += sprintf(&gpxData[len], "</rte>\n</gpx>\n");
+	files[0].size = len;
+}
+
+/* true, if segment s of the staircase runs east */
+static bool isEast(int s)
+{
+	return s % (RUNE+RUNN) < RUNE;
+}
+
+/* updates with a position OFFSET right of the middle of segment s */
+static void updateAt(int s)
+{
+	int32_t lat, lon;
+	float kx = 11.1195f * cosf((float)vlat[s] * (3.14159265f/180.0f/100000.0f));
+
+	lat = (vlat[s] + vlat[s+1]) / 2;
+	lon = (vlon[s] + vlon[s+1]) / 2;
+	if(isEast(s)) lat -= (int32_t)(OFFSET / 11.1195f + 0.5f);
+	else lon += (int32_t)(OFFSET / kx + 0.5f);
+	route_update(coord(lat, 'N'), coord(lon, 'E'));
+}
+
+/* the route must be unloaded with no file open */
+static void checkUnloaded(const char * what)
+{
+	route_data_t d = route_getData();
+
+	CHECK_MSG(d.state == rsNone && openCnt == 0, "%s: state %d, %d files open", what, d.state, openCnt);
+	CHECK_MSG(d.segment == 0 && d.distToGo == 0 && route_getVertexCount() == 0, "%s: route data left", what);
+}
+
+int main(void)
+{
+	route_data_t d;
+	uint32_t total, prevToGo = 0;
+	double len;
+	int s, reads, maxReads = 0, n, budget, bad;
+
+	makeGpx(NPTS);
+
+	/* loading, the points beyond ROUTE_MAXVERTEX are ignored */
+	CHECK(route_load(ROUTE_GPXFILE) == FR_OK);
+	CHECK(openCnt == 1);
+	CHECK(route_getVertexCount() == MAXVTX);
+	CHECK(files[1].size == MAXVTX*sizeof(route_vertex_t));
+	d = route_getData();
+	CHECK(d.state == rsAcquire);
+	total = d.distToGo;
+	for(len=0, s=0; s<MAXVTX-1; s++)
+		len += hypot((vlon[s+1]-vlon[s]) * cos(vlat[s] * M_PI/180.0/100000.0), vlat[s+1]-vlat[s]) * 11.1195;
+	CHECK_MSG(fabs(total - len) < 0.0005*len, "route length %u, expected %.0f", total, len);
+
+	/* following the whole route */
+	for(bad=0, s=0; s<MAXVTX-1; s++)
+	{
+		binReads = 0;
+		updateAt(s);
+		reads = binReads;
+		if(reads > maxReads) maxReads = reads;
+		d = route_getData();
+		if(d.state != rsOnRoute || d.segment != s || d.xte < OFFSET-5 || d.xte > OFFSET+5)
+		{
+			if(bad++ < 5) CHECK_MSG(false, "segment %d: state %d, segment %u, xte %d", s, d.state, d.segment, d.xte);
+			continue;
+		}
+		if(s > 0) CHECK_MSG(prevToGo - d.distToGo >= 360 && prevToGo - d.distToGo <= 455, "segment %d: distToGo %u", s, d.distToGo);
+		prevToGo = d.distToGo;
+		/* the turn at the end of the run lies within the window */
+		if(isEast(s) && RUNE - s%(RUNE+RUNN) <= ROUTE_WINDOW && s+ROUTE_WINDOW < MAXVTX-2)
+			CHECK_MSG(d.turnBrg <= 1 || d.turnBrg >= 359, "segment %d: turn %u", s, d.turnBrg);
+		if(!isEast(s) && s+ROUTE_WINDOW < MAXVTX-2)
+			CHECK_MSG(d.turnBrg >= 89 && d.turnBrg <= 91, "segment %d: turn %u", s, d.turnBrg);
+	}
+	CHECK(bad == 0);
+	CHECK_MSG(d.distToGo < 250, "distToGo at the end %u", d.distToGo);
+	CHECK_MSG(maxReads <= 2, "%d reads per fix", maxReads);
+
+	/* off route and re-acquired far ahead */
+	route_update(coord(LAT0 - 100000, 'N'), coord(LON0, 'E'));
+	CHECK(route_getData().state == rsOffRoute);
+	for(n=0; n<ROUTE_MAXBLOCKS/ROUTE_REACQBLOCKS+2 && route_getData().state != rsOnRoute; n++)
+		updateAt(6000);
+	d = route_getData();
+	CHECK_MSG(d.state == rsOnRoute && d.segment == 6000, "re-acquired after %d fixes: state %d segment %u", n, d.state, d.segment);
+
+	/* a read error at every point of an update gives up the route and closes the vertex file */
+	for(budget=0; budget<4; budget++)
+	{
+		CHECK(route_load(ROUTE_GPXFILE) == FR_OK);
+		updateAt(0);
+		updateAt(1);
+		readBudget = budget;
+		for(s=2; s<200 && route_getData().state != rsNone; s += 20) updateAt(s);
+		readBudget = -1;
+		checkUnloaded("read error");
+		updateAt(s);							/* ignored without a route */
+		route_unload();
+		checkUnloaded("unload after read error");
+	}
+
+	/* error paths of route_load() */
+	CHECK(route_load("none.gpx") == FR_NO_FILE);
+	checkUnloaded("missing GPX file");
+	makeGpx(1);
+	CHECK(route_load(ROUTE_GPXFILE) == FR_INVALID_OBJECT);
+	checkUnloaded("single point");
+	makeGpx(NPTS);
+	writeFail = true;
+	CHECK(route_load(ROUTE_GPXFILE) == FR_DISK_ERR);
+	writeFail = false;
+	checkUnloaded("write error");
+	CHECK(route_load(ROUTE_GPXFILE) == FR_OK);
+	route_unload();
+	route_unload();
+	checkUnloaded("unloaded twice");
+
+	TEST_END();
+}
@@ -0,0 +1,92 @@
+/*
+ * test_sdlink.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of sdlink.c: CRC7 and CRC16 against known packets, TRAN_SPEED decoding of CSD
+ *       		dumps read from cards and the clock back-off.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sdlink.h"
+#include "test.h"
+
+/* CSD registers as read by CMD9, the last byte is CRC7 and end bit */
+static const char * csdDump[] = {
+	"002600325f5a83aefefbcfff928040df",		/* SDSC 1 GB (CSD v1), 25 MHz */
+	"400e00325b590000edc87f800a4040c3",		/* SDHC 16 GB (CSD v2), 25 MHz */
+	"400e005a5b590000edc87f800a404015",		/* SDHC high speed (CSD v2), 50 MHz */
+};
+static const uint32_t csdHz[] = {25000000, 25000000, 50000000};
+
+
+/* Converts a hex string, returns the number of bytes */
+static int hexToBytes(const char * s, uint8_t * out)
+{
+	int n = 0;
+	unsigned v;
+
+	while(*s && sscanf(s, "%2x", &v)==1) { out[n++] = v; s += 2; }
+	return n;
+}
+
+int main(void)
+{
+	uint8_t b[512];
+	uint8_t cmd0[5] = {0x40, 0, 0, 0, 0};
+	uint8_t cmd8[5] = {0x48, 0, 0, 0x01, 0xAA};
+	uint8_t cmd17[5] = {0x51, 0, 0, 0, 0};
+	sdlink_t link;
+	uint32_t clk, prev;
+	int i, steps;
+
+	/* command CRC7 with end bit as sent on the bus */
+	CHECK(((sdlink_crc7(cmd0, 5) << 1) | 1) == 0x95);
+	CHECK(((sdlink_crc7(cmd8, 5) << 1) | 1) == 0x87);
+	CHECK(((sdlink_crc7(cmd17, 5) << 1) | 1) == 0x55);
+
+	/* data block CRC16 */
+	memset(b, 0xFF, 512);
+	CHECK(sdlink_crc16(b, 512) == 0x7FA1);
+
+	/* CSD dumps: the CRC must match, the clock is decoded from TRAN_SPEED */
+	for(i=0; i<3; i++)
+	{
+		CHECK(hexToBytes(csdDump[i], b) == 16);
+		CHECK_MSG(((sdlink_crc7(b, 15) << 1) | 1) == b[15], "CSD %d", i);
+		CHECK_MSG(sdlink_tranSpeed(b) == csdHz[i], "CSD %d: %u Hz", i, sdlink_tranSpeed(b));
+	}
+
+	/* reserved TRAN_SPEED codes */
+	b[3] = 0x32 | 0x80;
+	CHECK(sdlink_tranSpeed(b) == 0);
+	b[3] = 0x04;						/* unit reserved */
+	CHECK(sdlink_tranSpeed(b) == 0);
+	b[3] = 0x02;						/* time value 0 reserved */
+	CHECK(sdlink_tranSpeed(b) == 0);
+
+	/* clock limit: the slower of card and host, the safe clock if the card is unknown */
+	CHECK(sdlink_init(&link, 50000000, 25000000) == 25000000);
+	CHECK(sdlink_init(&link, 0, 25000000) == SDLINK_CLKSAFE);
+
+	/* back-off: every error lowers the clock until the minimum is reached */
+	sdlink_init(&link, 25000000, 60000000);
+	prev = link.clock;
+	steps = 0;
+	while(steps < 100)
+	{
+		clk = sdlink_error(&link);
+		if(clk >= prev) break;
+		CHECK(clk >= prev*SDLINK_BACKOFF/100 - 1);
+		prev = clk;
+		steps++;
+	}
+	CHECK_MSG(clk == SDLINK_CLKMIN, "%u Hz", clk);
+	CHECK(steps == 12);
+	CHECK(link.backoffs == (uint32_t)steps);
+	CHECK(link.errors == (uint32_t)steps+1);
+
+	TEST_END();
+}
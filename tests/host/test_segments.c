@@ -0,0 +1,189 @@
+/*
+ * test_segments.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of the segment timing with more segments than SEG_MAXSEGS. The segment file
+ *       		and the results file are held in memory behind a replacement of the FatFs calls. The
+ *       		entries beyond the limit and a malformed segment must be dropped and counted, their
+ *       		polyline points must not be attached to a loaded segment, and segments with an index
+ *       		above 255 must be timed and get their best effort from the results file.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "segments.h"
+#include "fatfs/ff.h"
+#include "test.h"
+
+#define NSEGS		(SEG_MAXSEGS + 88)
+#define COLS		30
+#define SPACING		5000		/* 1e-5 degree between segments */
+#define LAT0		4700000
+#define LON0		1500000
+#define BADSEG		5			/* a malformed S line follows this segment */
+
+/* in-memory files */
+typedef struct {
+	const char *	name;
+	char *			data;
+	UINT			size;
+	UINT			cap;
+} memfile_t;
+
+static char segData[NSEGS*80];
+static char resData[64*sizeof(seg_result_t)];
+static memfile_t files[2] = {
+	{SEG_FILENAME, segData, 0, sizeof(segData)},
+	{SEG_RESFILE, resData, 0, sizeof(resData)}
+};
+static memfile_t * openFile;
+
+/* ---=== FatFs replacement, one file open at a time ===--- */
+
+FRESULT f_open(FIL* fp, const TCHAR* path, BYTE mode)
+{
+	int i;
+
+	CHECK(openFile == NULL);
+	for(i=0; i<2; i++) if(strcmp(files[i].name, path) == 0) break;
+	if(i == 2) return FR_NO_FILE;
+	if(files[i].size == 0 && !(mode & FA_OPEN_ALWAYS)) return FR_NO_FILE;
+	openFile = &files[i];
+	fp->fptr = 0;
+	fp->fsize = openFile->size;
+	return FR_OK;
+}
+
+FRESULT f_close(FIL* fp)
+{
+	CHECK(openFile != NULL);
+	openFile = NULL;
+	return FR_OK;
+}
+
+FRESULT f_read(FIL* fp, void* buff, UINT btr, UINT* br)
+{
+	if(btr > openFile->size - fp->fptr) btr = openFile->size - fp->fptr;
+	memcpy(buff, &openFile->data[fp->fptr], btr);
+	fp->fptr += btr;
+	*br = btr;
+	return FR_OK;
+}
+
+FRESULT f_write(FIL* fp, const void* buff, UINT btw, UINT* bw)
+{
+	*bw = 0;
+	if(fp->fptr + btw > openFile->cap) return FR_DISK_ERR;
+	memcpy(&openFile->data[fp->fptr], buff, btw);
+	fp->fptr += btw;
+	if(fp->fptr > openFile->size) openFile->size = fp->fsize = fp->fptr;
+	*bw = btw;
+	return FR_OK;
+}
+
+FRESULT f_lseek(FIL* fp, DWORD ofs)
+{
+	fp->fptr = (ofs < openFile->size) ? ofs : openFile->size;
+	return FR_OK;
+}
+
+/* ---=== segments ===--- */
+
+static const date_t today = {18, 10, 26};
+static const time_t noon = {12, 0, 0, 0};
+
+static int32_t segLat(int j) { return LAT0 + (j / COLS) * SPACING; }
+static int32_t segLon(int j) { return LON0 + (j % COLS) * SPACING; }
+
+static int fmt(char * buf, int32_t v)
+{
+	return sprintf(buf, "%d.%05d", v/100000, v%100000);
+}
+
+/* writes NSEGS segments with one polyline point each: start, point 200 m east, end 400 m east */
+static void makeFile(void)
+{
+	char * p = segData;
+	int j;
+
+	p += sprintf(p, "# %d segments\r\n", NSEGS);
+	for(j=0; j<NSEGS; j++)
+	{
+		p += sprintf(p, "S,%d,", 1000+j);
+		p += fmt(p, segLat(j)); *p++ = ',';
+		p += fmt(p, segLon(j)); *p++ = ',';
+		p += fmt(p, segLat(j)); *p++ = ',';
+		p += fmt(p, segLon(j) + 540); *p++ = ',';
+		p += sprintf(p, "20,S%d\r\nP,", j);
+		p += fmt(p, segLat(j)); *p++ = ',';
+		p += fmt(p, segLon(j) + 270);
+		p += sprintf(p, "\r\n");
+		if(j == BADSEG)
+			p += sprintf(p, "S,999,47.1,x\r\nP,47.5,15.5\r\n");		/* malformed, its point lies far away */
+	}
+	files[0].size = p - segData;
+}
+
+static void at(int32_t lat, int32_t lon, uint32_t t)
+{
+	gps_coordinate_t a = {'N', lat / 100000, lat % 100000};
+	gps_coordinate_t b = {'E', lon / 100000, lon % 100000};
+
+	segments_update(a, b, t, today, noon);
+}
+
+/* rides segment j in the time dt from t, returns the status after the finish */
+static seg_status_t ride(int j, uint32_t t, uint32_t dt)
+{
+	at(segLat(j), segLon(j), t);
+	at(segLat(j), segLon(j) + 270, t + dt/2);
+	at(segLat(j), segLon(j) + 540, t + dt);
+	return segments_getStatus(t + dt);
+}
+
+int main(void)
+{
+	seg_status_t st;
+	seg_result_t res;
+	char name[8];
+	int k, j;
+	static const int rideSegs[] = {0, BADSEG-1, BADSEG, 300, SEG_MAXSEGS-1};
+
+	makeFile();
+	CHECK(segments_load() == FR_OK);
+	CHECK_MSG(segments_getCount() == SEG_MAXSEGS, "%u segments", segments_getCount());
+	CHECK_MSG(segments_getDropped() == 2 + 2*(NSEGS-SEG_MAXSEGS), "%u dropped", segments_getDropped());
+	CHECK(openFile == NULL);
+
+	/* segments around the malformed entry and above index 255 are timed */
+	for(k=0; k<sizeof(rideSegs)/sizeof(rideSegs[0]); k++)
+	{
+		j = rideSegs[k];
+		st = ride(j, 1000*(k+1), 300);
+		sprintf(name, "S%d", j);
+		CHECK_MSG(st.state == ssFinished && strcmp(st.name, name) == 0 && st.elapsed == 300 && st.best == 0,
+				"segment %d: state %d, name %s, elapsed %u", j, st.state, st.name, st.elapsed);
+		CHECK(files[1].size == (k+1)*sizeof(res));
+		memcpy(&res, &resData[k*sizeof(res)], sizeof(res));
+		CHECK(res.id == 1000+j && res.time == 300 && res.d == 18 && res.hr == 12);
+	}
+
+	/* a segment beyond SEG_MAXSEGS is not loaded */
+	st = ride(SEG_MAXSEGS, 10000, 300);
+	CHECK(st.state == ssNone);
+	CHECK(files[1].size == k*sizeof(res));
+
+	/* the best effort of segment 300 is read back from the results file */
+	CHECK(segments_load() == FR_OK);
+	at(segLat(300), segLon(300), 20000);
+	at(segLat(300), segLon(300) + 270, 20100);
+	st = segments_getStatus(20100);
+	CHECK_MSG(st.state == ssActive && st.best == 300 && st.progress >= 49 && st.progress <= 50, "state %d best %u progress %u", st.state, st.best, st.progress);
+	at(segLat(300), segLon(300) + 540, 20200);
+	st = segments_getStatus(20200);
+	CHECK(st.state == ssFinished && st.elapsed == 200 && st.delta == -100);
+
+	TEST_END();
+}
@@ -0,0 +1,118 @@
+/*
+ * test_spi_burst.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of the CPU block transfers of spi_wrapper.c against the SSI FIFO model. A
+ *       		lock-step loop (put one byte, wait for its answer) leaves the bus idle between all
+ *       		frames; SPI_burst() and SPI_burstXmit() must keep the shift register busy without idle
+ *       		gaps, receive every answer in order and leave the receive FIFO empty.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "driverlib/ssi.h"
+#include "ssi_sim.h"
+#include "spi_wrapper.h"
+#include "test.h"
+
+#define LEN		512
+
+/* private functions of spi_wrapper.c */
+void SPI_burst(uint32_t cnt, const uint8_t * buffXmit, uint8_t * buffRcv);
+void SPI_burstXmit(uint32_t cnt, const uint8_t * buffXmit);
+
+static uint8_t answer(uint8_t tx)
+{
+	return tx ^ 0x5A;
+}
+
+/* the receive loop before the FIFO was used */
+static void lockStep(uint32_t cnt, uint8_t * rx)
+{
+	uint32_t i;
+
+	for(i=0; i<cnt; i++)
+	{
+		while(!ssisim_txNotFull());
+		ssisim_put(SPI_FILL);
+		while(!ssisim_rxNotEmpty());
+		rx[i] = ssisim_get();
+	}
+}
+
+static void begin(void)
+{
+	ssisim_reset();
+	ssisim_cs[1] = true;
+	ssisim_measure(true);
+}
+
+static void report(const char * name, uint32_t cnt)
+{
+	ssisim_stats_t s = ssisim_stats();
+
+	printf("%-12s %4u bytes: %6u cycles, bus %5.1f %% busy, %3u idle gaps, %3u overruns\n", name, cnt,
+			ssisim_time(), 100.0*s.busyCycles/ssisim_time(), s.gaps, s.overruns);
+}
+
+int main(void)
+{
+	static uint8_t tx[LEN], rx[LEN];
+	ssisim_stats_t s;
+	uint32_t tLockStep;
+	int i;
+
+	ssisim_peer = answer;
+	SSIConfigSetExpClk(SSI3_BASE, 120000000, SSI_FRF_MOTO_MODE_0, SSI_MODE_MASTER, 10000000, 8);
+	for(i=0; i<LEN; i++) tx[i] = i*7;
+
+	begin();
+	lockStep(LEN, rx);
+	tLockStep = ssisim_time();
+	report("lock-step", LEN);
+	CHECK(ssisim_stats().gaps == LEN-1);
+
+	/* receive: SPI_FILL is sent */
+	begin();
+	memset(rx, 0, LEN);
+	SPI_burst(LEN, NULL, rx);
+	report("burst rcv", LEN);
+	s = ssisim_stats();
+	CHECK(s.gaps == 0 && s.overruns == 0 && s.frames == LEN);
+	CHECK(ssisim_time() < tLockStep);
+	for(i=0; i<LEN; i++) if(rx[i] != answer(SPI_FILL)) break;
+	CHECK_MSG(i == LEN, "byte %d", i);
+	for(i=0; i<LEN; i++) if(ssisim_log[i] != SPI_FILL) break;
+	CHECK(i == LEN);
+
+	/* full duplex */
+	begin();
+	SPI_burst(LEN, tx, rx);
+	report("burst xfer", LEN);
+	s = ssisim_stats();
+	CHECK(s.gaps == 0 && s.overruns == 0);
+	for(i=0; i<LEN; i++) if(rx[i] != answer(tx[i]) || ssisim_log[i] != tx[i]) break;
+	CHECK_MSG(i == LEN, "byte %d", i);
+
+	/* transmit only: the receive FIFO overruns and is emptied at the end */
+	begin();
+	SPI_burstXmit(LEN, tx);
+	report("burst xmit", LEN);
+	s = ssisim_stats();
+	CHECK(s.gaps == 0 && s.frames == LEN);
+	CHECK(!ssisim_rxNotEmpty());
+	CHECK(memcmp(ssisim_log, tx, LEN) == 0);
+
+	/* short blocks and stale data in the receive FIFO */
+	begin();
+	SPI_burstXmit(3, tx);
+	ssisim_put(0x11);
+	while(ssisim_busy());
+	SPI_burst(3, tx, rx);
+	CHECK(rx[0] == answer(tx[0]) && rx[1] == answer(tx[1]) && rx[2] == answer(tx[2]));
+	CHECK(!ssisim_rxNotEmpty());
+
+	TEST_END();
+}
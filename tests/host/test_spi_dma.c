@@ -0,0 +1,138 @@
+/*
+ * test_spi_dma.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of the uDMA block transfers. spi_dma.c is first run against a simulated DMA
+ *       		engine and card for all block lengths up to 4 chunks and every combination of transmit
+ *       		and receive buffer: the chunks must cover the block exactly once and in order. Then
+ *       		SPI_xfer(), SPI_xmit() and SPI_rcv() of spi_wrapper.c move blocks through the uDMA
+ *       		channels of the SSI model, the card answers each byte.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "driverlib/ssi.h"
+#include "ssi_sim.h"
+#include "spi_dma.h"
+#include "spi_wrapper.h"
+#include "test.h"
+
+#define LEN		(4*SPI_DMAMAXXFER + 4)
+
+/* simulated DMA engine and card: the card logs the bytes sent and answers with (index*7) */
+static uint8_t cardIn[LEN];
+static int cardLen, polls, arms, maxChunk, stops;
+static bool active;
+
+static void arm(void *arg, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+	int i;
+
+	CHECK(!active);
+	CHECK(len <= SPI_DMAMAXXFER);
+	for(i=0; i<len; i++)
+	{
+		cardIn[cardLen] = tx ? tx[i] : SPI_FILL;
+		if(rx) rx[i] = (uint8_t)(cardLen*7);
+		cardLen++;
+	}
+	arms++;
+	if(len > maxChunk) maxChunk = len;
+	polls = 3;							/* the chunk completes after 3 polls */
+	active = true;
+}
+
+static bool done(void *arg)
+{
+	if(polls) { polls--; return false; }
+	active = false;
+	return true;
+}
+
+static void stop(void *arg)
+{
+	stops++;
+}
+
+static const spi_dma_ops_t ops = {arm, done, stop};
+
+/* chip select of the process on the SSI model */
+static void assertCS(void) { ssisim_cs[1] = true; }
+static void deassertCS(void) { ssisim_cs[1] = false; }
+
+static uint8_t answer(uint8_t tx)
+{
+	return ~tx;
+}
+
+int main(void)
+{
+	static uint8_t tx[LEN], rx[LEN];
+	spi_dma_t d;
+	const uint8_t * t;
+	uint8_t * r;
+	uint8_t p;
+	int len, mode, i, guard, bad;
+
+	for(i=0; i<LEN; i++) tx[i] = i*13;
+
+	/* chunking against the simulated engine */
+	spidma_init(&d, &ops, NULL);
+	for(len=1; len<LEN; len += (len<40 ? 1 : 37))
+	{
+		for(mode=0; mode<3; mode++)
+		{
+			cardLen = arms = stops = 0;
+			memset(rx, 0xAA, sizeof(rx));
+			t = (mode==1) ? NULL : tx;
+			r = (mode==2) ? NULL : rx;
+
+			CHECK(spidma_start(&d, len, t, r));
+			CHECK(!spidma_start(&d, len, t, r));			/* rejected while busy */
+			for(guard=0; spidma_service(&d) && guard<100000; guard++);
+
+			CHECK_MSG(cardLen == len && !d.busy, "len %d mode %d: %d bytes", len, mode, cardLen);
+			CHECK_MSG(arms == (len+SPI_DMAMAXXFER-1)/SPI_DMAMAXXFER && stops == 1, "len %d mode %d: %d chunks", len, mode, arms);
+			for(bad=0, i=0; i<len; i++)
+			{
+				if(cardIn[i] != (t ? tx[i] : SPI_FILL)) bad++;
+				if(r && rx[i] != (uint8_t)(i*7)) bad++;
+			}
+			CHECK_MSG(bad == 0, "len %d mode %d", len, mode);
+			if(r) CHECK(rx[len] == 0xAA);
+		}
+	}
+	CHECK(maxChunk == SPI_DMAMAXXFER);
+
+	/* block transfers of spi_wrapper.c through the uDMA channels of the SSI model */
+	ssisim_reset();
+	ssisim_peer = answer;
+	SPI_init(120000000, 10000000, 8);
+	p = SPI_registerProc(assertCS, deassertCS);
+
+	SPI_SelectCS(p);
+	SPI_xfer(p, 2*SPI_DMAMAXXFER+100, tx, rx);
+	SPI_DeselectCS(p);
+	CHECK(ssisim_logLen == 2*SPI_DMAMAXXFER+100);
+	CHECK(memcmp(ssisim_log, tx, ssisim_logLen) == 0);
+	for(i=0; i<2*SPI_DMAMAXXFER+100; i++) if(rx[i] != answer(tx[i])) break;
+	CHECK_MSG(i == 2*SPI_DMAMAXXFER+100, "byte %d", i);
+
+	ssisim_reset();
+	SPI_SelectCS(p);
+	SPI_rcv(p, 512, rx);
+	SPI_xmit(p, 512, tx);
+	CHECK(ssisim_stats().overruns == 0);
+	SPI_xmit(p, SPI_DMAMIN-1, tx);		/* sent by the CPU */
+	SPI_DeselectCS(p);
+	CHECK(ssisim_logLen == 1024+SPI_DMAMIN-1);
+	for(i=0; i<512; i++) if(rx[i] != answer(SPI_FILL) || ssisim_log[i] != SPI_FILL) break;
+	CHECK_MSG(i == 512, "byte %d", i);
+	CHECK(memcmp(&ssisim_log[512], tx, 512) == 0);
+	CHECK(ssisim_stats().csViolations == 0);
+	CHECK(!ssisim_rxNotEmpty());
+
+	TEST_END();
+}
@@ -0,0 +1,324 @@
+/*
+ * test_spi_queue.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of the SPI transaction queue against the SSI model. Queued transactions of two
+ *       		processes and blocking accesses in between must appear on the bus in call order, each
+ *       		byte with exactly the chip select of its process and the D/C level of its buffer. Then
+ *       		oled_ssd1351.c draws a page through the queue while the SD card process sends blocks in
+ *       		between; a model of the SSD1351 RAM decodes the bus and the picture must equal the one
+ *       		drawn by the blocking functions. Finally a synthetic workload redraws a full page through
+ *       		the queue while the SD card process, with a higher priority, accesses the bus between
+ *       		slices of main loop work: its wait must stay below OLED_MAXHOLD plus one display row, the
+ *       		picture must stay intact. Without the priority the SD card waits for whole transactions.
+ *       		Grants are counted per bus hand-over and waits only when the bus was busy.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "driverlib/gpio.h"
+#include "driverlib/ssi.h"
+#include "ssi_sim.h"
+#include "spi_wrapper.h"
+#include "oled_ssd1351.h"
+#include "test.h"
+
+#define CS_A		0				/* chip selects of the processes on the SSI model */
+#define CS_OLED		1
+#define CS_SD		2
+#define CS_B		3
+
+#define TRANS		6
+#define CLOCK		120000000
+#define ROWCYCLES	(SSD1351WIDTH*2*8*(CLOCK/10000000))		/* a display row at 10 MHz */
+
+extern uint8_t oledSPIProcess;		/* oled_ssd1351.c */
+
+/* the OLED and SD card lines on port K, active low chip selects */
+void GPIOPinWrite(uint32_t port, uint8_t pins, uint8_t val)
+{
+	if(port != GPIO_PORTK_BASE) return;
+	if(pins & GPIO_PIN_4) ssisim_cs[CS_OLED] = !(val & GPIO_PIN_4);
+	if(pins & GPIO_PIN_5) ssisim_cs[CS_SD] = !(val & GPIO_PIN_5);
+	if(pins & GPIO_PIN_7) ssisim_dc = (val & GPIO_PIN_7) != 0;
+}
+
+static void assertA(void) { ssisim_cs[CS_A] = true; }
+static void deassertA(void) { ssisim_cs[CS_A] = false; }
+static void assertB(void) { ssisim_cs[CS_B] = true; }
+static void deassertB(void) { ssisim_cs[CS_B] = false; }
+static void assertSD(void) { GPIOPinWrite(GPIO_PORTK_BASE, GPIO_PIN_5, 0); }
+static void deassertSD(void) { GPIOPinWrite(GPIO_PORTK_BASE, GPIO_PIN_5, GPIO_PIN_5); }
+static void dcLow(void) { ssisim_dc = false; }
+static void dcHigh(void) { ssisim_dc = true; }
+
+static int doneOrder[TRANS], doneCnt;
+
+static void onDone(spi_trans_t * trans)
+{
+	doneOrder[doneCnt++] = trans->bufs[0].data[0];
+}
+
+/* SSD1351 model: RAM, window and write pointer */
+static uint16_t ram[SSD1351HEIGHT][SSD1351WIDTH];
+static uint8_t x1, x2, y1, y2, cx, cy;
+
+/* decodes the OLED bytes of the bus log into ram[] */
+static void decode(void)
+{
+	uint8_t cmd = 0, args[2];
+	int nargs = 0, hi = -1;
+	uint32_t i;
+
+	for(i=0; i<ssisim_logLen; i++)
+	{
+		if(ssisim_logCS[i] != CS_OLED) continue;
+		if(!ssisim_logDC[i])
+		{
+			cmd = ssisim_log[i];
+			nargs = 0;
+			hi = -1;
+			if(cmd == SSD1351_CMD_WRITERAM) { cx = x1; cy = y1; }
+			continue;
+		}
+		if(cmd == SSD1351_CMD_WRITERAM)
+		{
+			if(hi < 0) { hi = ssisim_log[i]; continue; }
+			ram[cy][cx] = hi<<8 | ssisim_log[i];
+			hi = -1;
+			if(++cx > x2) { cx = x1; if(++cy > y2) cy = y1; }
+			continue;
+		}
+		if(nargs < 2) args[nargs++] = ssisim_log[i];
+		if(nargs == 2 && cmd == SSD1351_CMD_SETCOLUMN) { x1 = args[0]; x2 = args[1]; }
+		if(nargs == 2 && cmd == SSD1351_CMD_SETROW) { y1 = args[0]; y2 = args[1]; }
+	}
+}
+
+/* a page like display_drawStaticText() draws it */
+static void drawPage(bool async, uint8_t sd)
+{
+	static uint8_t block[512];
+	int i;
+
+	for(i=0; i<512; i++) block[i] = i;
+	if(async)
+	{
+		oled_fillRectAsync(0, 13, SSD1351WIDTH, SSD1351HEIGHT-13, 0x0000);
+		oled_drawtextAsync("Stopwatch", 0x8410, 0x0000, 4, 15);
+		oled_drawtextAsync_big("12:34", 0xFFFF, 0x0000, 4, 24);
+		SPI_SelectCS(sd);
+		SPI_xmit(sd, 512, block);
+		SPI_DeselectCS(sd);
+		oled_fillRectAsync(10, 50, 100, 1, 0xF800);
+		oled_fillRectAsync(10, 50, 1, 40, 0x07E0);
+		oled_drawtextAsync("Vw/Fx PDOP/HDOP/VDOP", 0x8410, 0x0000, 2, 100);
+		oled_drawtextAsync("cut off at the right edge", 0xFFFF, 0x001F, 90, 112);
+		SPI_Put8(sd, 0x55);
+		SPI_flush();
+	}
+	else
+	{
+		oled_fillRect(0, 13, SSD1351WIDTH, SSD1351HEIGHT-13, 0x0000);
+		oled_drawtext("Stopwatch", 0x8410, 0x0000, 4, 15);
+		oled_drawtext_big("12:34", 0xFFFF, 0x0000, 4, 24);
+		oled_drawHLine(10, 50, 100, 0xF800);
+		oled_drawVLine(10, 50, 40, 0x07E0);
+		oled_drawtext("Vw/Fx PDOP/HDOP/VDOP", 0x8410, 0x0000, 2, 100);
+		oled_drawtext("cut of", 0xFFFF, 0x001F, 90, 112);
+	}
+}
+
+/* labels of a full page */
+static const struct {
+	char *		text;
+	uint8_t		x, y;
+	bool		big;
+} labels[] = {
+	{"Stopwatch", 4, 15, false}, {"12:34.5", 4, 24, true}, {"Altitude", 4, 42, false},
+	{"Up", 59, 48, false}, {"Dwn", 59, 57, false}, {"Speed", 4, 68, false}, {"km/h", 102, 74, false},
+	{"Avg", 59, 74, false}, {"Max", 59, 83, false}, {"Distance", 4, 94, false}, {"12345", 4, 103, true},
+	{"Vw/Fx PDOP/HDOP/VDOP", 2, 119, false},
+};
+
+/* redraws the full page; async: through the queue */
+static void redraw(bool async)
+{
+	int k, n = sizeof(labels)/sizeof(labels[0]);
+
+	if(async) oled_fillRectAsync(0, 0, SSD1351WIDTH, SSD1351HEIGHT, 0x0000);
+	else oled_fillRect(0, 0, SSD1351WIDTH, SSD1351HEIGHT, 0x0000);
+	for(k=0; k<n; k++)
+	{
+		if(async && labels[k].big) oled_drawtextAsync_big(labels[k].text, 0xFFFF, 0x0000, labels[k].x, labels[k].y);
+		else if(async) oled_drawtextAsync(labels[k].text, 0x8410, 0x0000, labels[k].x, labels[k].y);
+		else if(labels[k].big) oled_drawtext_big(labels[k].text, 0xFFFF, 0x0000, labels[k].x, labels[k].y);
+		else oled_drawtext(labels[k].text, 0x8410, 0x0000, labels[k].x, labels[k].y);
+	}
+	if(async) oled_fillRectAsync(0, 13, SSD1351WIDTH, 1, 0x8410);
+	else oled_drawHLine(0, 13, SSD1351WIDTH, 0x8410);
+}
+
+/* redraws the page through the queue, the SD card sends a block after each slice of main loop work */
+static void workload(uint8_t sd, uint32_t slice)
+{
+	static uint8_t block[512];
+	int k;
+
+	memset(ram, 0xAA, sizeof(ram));
+	ssisim_reset();
+	for(k=0; k<2; k++)
+	{
+		redraw(true);
+		while(!SPI_queueIdle())
+		{
+			ssisim_step(slice);
+			SPI_SelectCS(sd);
+			SPI_xmit(sd, sizeof(block), block);
+			SPI_DeselectCS(sd);
+		}
+	}
+	decode();
+}
+
+int main(void)
+{
+	static uint8_t data[TRANS][300];
+	static spi_buf_t bufs[TRANS][3];
+	static spi_trans_t trans[TRANS];
+	static uint16_t ref[SSD1351HEIGHT][SSD1351WIDTH];
+	static const int order[] = {0, 1, 2, -1, 3, 4, 5, -2};
+	uint8_t pa, pb, sd, x[4] = {0xC0, 0xC1, 0xC2, 0xC3};
+	uint32_t pos, n, i, j, sdBytes, waitMax;
+	spi_stats_t st;
+	int k, o;
+
+	SPI_init(CLOCK, 10000000, 8);
+	pa = SPI_registerProc(assertA, deassertA);
+	pb = SPI_registerProc(assertB, deassertB);
+
+	/* transactions: a command byte (D/C low), 2 arguments and a repeated pattern (D/C high) */
+	for(k=0; k<TRANS; k++)
+	{
+		for(i=0; i<300; i++) data[k][i] = k*40 + i%40;
+		bufs[k][0] = (spi_buf_t){data[k], 1, 0, 0, dcLow};
+		bufs[k][1] = (spi_buf_t){data[k]+1, 2, 0, 0, dcHigh};
+		bufs[k][2] = (spi_buf_t){data[k]+3, 3, k*20, 0, NULL};
+		trans[k] = (spi_trans_t){(k&1) ? pb : pa, bufs[k], 3, onDone, false, 0};
+	}
+
+	ssisim_reset();
+	for(k=0; k<3; k++) CHECK(SPI_queue(&trans[k]));
+	SPI_Put16(pa, 0xAA, 0xBB);					/* blocking access in between */
+	for(k=3; k<TRANS; k++) CHECK(SPI_queue(&trans[k]));
+	SPI_SelectCS(pb);
+	SPI_xmit(pb, 4, x);
+	SPI_DeselectCS(pb);
+	SPI_flush();
+
+	pos = 0;
+	for(o=0; o<8; o++)
+	{
+		k = order[o];
+		if(k == -1)
+		{
+			CHECK(ssisim_log[pos] == 0xAA && ssisim_log[pos+1] == 0xBB && ssisim_logCS[pos] == CS_A);
+			pos += 2;
+			continue;
+		}
+		if(k == -2)
+		{
+			for(i=0; i<4; i++, pos++) CHECK(ssisim_log[pos] == 0xC0+i && ssisim_logCS[pos] == CS_B);
+			continue;
+		}
+		n = 1 + 2 + 3*(k*20+1);
+		for(i=0; i<n; i++, pos++)
+		{
+			j = i<3 ? i : 3 + (i-3)%3;
+			if(ssisim_log[pos] != data[k][j] || ssisim_logCS[pos] != ((k&1) ? CS_B : CS_A) || ssisim_logDC[pos] != (i != 0))
+				break;
+		}
+		CHECK_MSG(i == n, "transaction %d byte %u", k, i);
+		pos += n - i;
+	}
+	CHECK_MSG(pos == ssisim_logLen, "%u of %u bytes", pos, ssisim_logLen);
+	CHECK(doneCnt == TRANS);
+	for(k=0; k<TRANS; k++) CHECK(doneOrder[k] == data[k][0] && !trans[k].busy);
+	CHECK(ssisim_stats().csViolations == 0);
+
+	/* on an idle bus: one grant per selection, not per byte, and no waits */
+	st = SPI_getStats(pa);
+	SPI_SelectCS(pa);
+	for(i=0; i<10; i++)
+	{
+		SPI_reserve(pa);						/* as xchg_spi() of the SD card driver */
+		SPI_xchg(pa, i);
+	}
+	SPI_DeselectCS(pa);
+	trans[0].pfnDone = NULL;
+	CHECK(SPI_queue(&trans[0]));
+	SPI_flush();
+	CHECK_MSG(SPI_getStats(pa).grants == st.grants + 2 && SPI_getStats(pa).waits == st.waits, "%u grants, %u waits",
+			SPI_getStats(pa).grants - st.grants, SPI_getStats(pa).waits - st.waits);
+
+	/* a display page through the queue, SD card blocks in between */
+	oled_init(CLOCK);
+	sd = SPI_registerProc(assertSD, deassertSD);
+	SPI_setPolicy(sd, 1, 0);
+
+	memset(ram, 0xAA, sizeof(ram));
+	ssisim_reset();
+	drawPage(false, sd);
+	decode();
+	memcpy(ref, ram, sizeof(ram));
+	memset(ram, 0xAA, sizeof(ram));
+
+	ssisim_reset();
+	drawPage(true, sd);
+	decode();
+	for(i=0; i<SSD1351HEIGHT; i++)
+		if(memcmp(ref[i], ram[i], sizeof(ram[i])) != 0) break;
+	CHECK_MSG(i == SSD1351HEIGHT, "row %u differs", i);
+	CHECK(ssisim_stats().csViolations == 0 && ssisim_stats().dssViolations == 0);
+
+	for(sdBytes=0, i=0; i<ssisim_logLen; i++)
+	{
+		if(ssisim_logCS[i] != CS_SD) continue;
+		CHECK(ssisim_log[i] == (sdBytes < 512 ? (uint8_t)sdBytes : 0x55));
+		sdBytes++;
+	}
+	CHECK(sdBytes == 513);
+
+	/* synthetic workload: SD card accesses while the page is redrawn */
+	memset(ram, 0xAA, sizeof(ram));
+	ssisim_reset();
+	redraw(false);
+	decode();
+	memcpy(ref, ram, sizeof(ram));
+
+	for(j=1; j<=3; j++)
+	{
+		workload(sd, j*j*CLOCK/10000);				/* 100, 400 and 900 us */
+		for(i=0; i<SSD1351HEIGHT; i++)
+			if(memcmp(ref[i], ram[i], sizeof(ram[i])) != 0) break;
+		CHECK_MSG(i == SSD1351HEIGHT, "workload %u: row %u differs", j, i);
+		CHECK(ssisim_stats().csViolations == 0 && ssisim_stats().dssViolations == 0);
+	}
+	st = SPI_getStats(sd);
+	waitMax = st.waitMax;
+	printf("SD card, priority 1: %u waits, max. %u us, mean %u us, %u yields of the display\n", st.waits,
+			waitMax/(CLOCK/1000000), (uint32_t)(st.waitTotal/st.waits/(CLOCK/1000000)), SPI_getStats(oledSPIProcess).yields);
+	CHECK(st.waits > 50);
+	CHECK_MSG(waitMax <= OLED_MAXHOLD*(CLOCK/1000000) + ROWCYCLES + 2000, "max. wait %u cycles", waitMax);
+
+	/* the same priority: the SD card waits for whole transactions, e.g. the page clear */
+	SPI_setPolicy(sd, OLED_SPIPRIO, 0);
+	workload(sd, CLOCK/10000);
+	st = SPI_getStats(sd);
+	printf("SD card, same priority: max. %u us\n", st.waitMax/(CLOCK/1000000));
+	CHECK(st.waitMax > 2*waitMax);
+
+	TEST_END();
+}
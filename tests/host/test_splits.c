@@ -0,0 +1,89 @@
+/*
+ * test_splits.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of splits.c: the best and last splits of a random trip with stops are compared
+ *       		to a brute force search over all raw samples. The ring keeps one sample per distance bucket,
+ *       		so the result may deviate by the time needed for one bucket.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "splits.h"
+#include "test.h"
+
+#define SAMPLES		60000
+
+static uint32_t D[SAMPLES];			/* 1/10 m */
+static uint32_t T[SAMPLES];			/* 1/10 s */
+
+/* Returns the time of the window of length len ending at sample j, interpolated on the raw samples, <0 if not covered */
+static double window(int j, uint32_t len)
+{
+	double s, t0;
+	int i;
+
+	if(D[j] < len) return -1;
+	s = D[j] - len;
+	for(i=j; i>0 && D[i]>s; i--);
+	while(i+1<j && D[i+1]<=s) i++;
+	t0 = T[i];
+	if(D[i+1] > D[i]) t0 += (double)(T[i+1]-T[i]) * (s-D[i]) / (D[i+1]-D[i]);
+
+	return T[j] - t0;
+}
+
+int main(void)
+{
+	const uint32_t dist[SPLIT_NUM] = SPLIT_DISTANCES;
+	char text[SPLIT_TEXTLEN+1];
+	double best, dt, tol;
+	split_t sp;
+	int j, k;
+
+	srand(3);
+	splits_reset();
+	D[0] = 0; T[0] = 0;
+	splits_update(0, 0);
+	for(j=1; j<SAMPLES; j++)
+	{
+		T[j] = T[j-1] + 10;
+		D[j] = D[j-1] + ((rand()%4==0) ? 0 : rand()%150);		/* 1 s fixes, stops and varying speed */
+		splits_update(D[j], T[j]);
+	}
+
+	for(k=0; k<SPLIT_NUM; k++)
+	{
+		best = 1e18;
+		for(j=1; j<SAMPLES; j++)
+		{
+			dt = window(j, dist[k]);
+			if(dt >= 0 && dt < best) best = dt;
+		}
+		sp = splits_get(k);
+		tol = best * SPLIT_BUCKET / dist[k] + 1;
+		CHECK(sp.dist == dist[k]);
+		CHECK_MSG(fabs(sp.best - best) <= tol, "split %d: best %u, brute force %.1f", k, sp.best, best);
+		dt = window(SAMPLES-1, dist[k]);
+		CHECK_MSG(fabs(sp.last - dt) <= 2*tol, "split %d: last %u, brute force %.1f", k, sp.last, dt);
+	}
+
+	/* a distance reset keeps the best splits, the last ones start over */
+	sp = splits_get(0);
+	splits_update(0, T[SAMPLES-1]+10);
+	CHECK(splits_get(0).best == sp.best);
+	CHECK(splits_get(0).last == 0);
+
+	/* text line */
+	memset(text, 0x55, sizeof(text));
+	splits_toText(2, text);
+	CHECK(strlen(text) == SPLIT_TEXTLEN-1);
+	CHECK(text[SPLIT_TEXTLEN] == 0x55);
+	CHECK(strncmp(text, "SPLIT,010km,", 12) == 0);
+
+	TEST_END();
+}
@@ -0,0 +1,147 @@
+/*
+ * test_uart_dma.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of the ping-pong reception of uart_dma.c against a simulated uDMA and UART. The
+ *       		UART receives bursts of random length into its 16 byte FIFO, the uDMA moves 8 bytes per
+ *       		request into the armed halves and switches to the other half when one completes. The
+ *       		completion interrupt is served with a random latency of up to 3 bursts while the next
+ *       		half fills, and the receive timeout flushes the bytes below the burst level. All bytes
+ *       		must arrive in order without loss.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uart_dma.h"
+#include "test.h"
+
+#define STEPS		200000
+#define FIFOLEN		16
+#define BURST		8				/* bytes per uDMA request (UART_FIFO_RX4_8) */
+
+/* simulated uDMA channel and UART FIFO */
+static struct {
+	uint8_t *	dst[2];
+	uint16_t	len[2];
+	uint16_t	pos[2];
+	bool		enabled[2];
+	bool		alt;				/* half the uDMA writes to */
+	bool		paused;
+	bool		irq;				/* completion interrupt pending */
+	char		fifo[FIFOLEN];
+	int			fifoLen;
+	int			lost;				/* bytes lost, FIFO full */
+} sim;
+
+static char out[1 << 22];			/* received data */
+static int outLen = 0;
+
+static void arm(void *arg, bool alt, uint8_t *dst, uint16_t len)
+{
+	sim.dst[alt] = dst;
+	sim.len[alt] = len;
+	sim.pos[alt] = 0;
+	sim.enabled[alt] = true;
+}
+
+static bool done(void *arg, bool alt)
+{
+	return !sim.enabled[alt];
+}
+
+static uint16_t remaining(void *arg, bool alt)
+{
+	return sim.enabled[alt] ? sim.len[alt] - sim.pos[alt] : 0;
+}
+
+static void pause(void *arg, bool p)
+{
+	sim.paused = p;
+}
+
+static uint16_t drain(void *arg, char *buffer, uint16_t len)
+{
+	uint16_t n = 0;
+
+	while(n < len && sim.fifoLen)
+	{
+		buffer[n++] = sim.fifo[0];
+		memmove(sim.fifo, sim.fifo+1, --sim.fifoLen);
+	}
+	return n;
+}
+
+static uint16_t sink(void *arg, const char *data, uint16_t len)
+{
+	memcpy(&out[outLen], data, len);
+	outLen += len;
+	return len;
+}
+
+static const uart_dma_ops_t ops = {arm, done, remaining, pause, drain};
+
+/* serves the uDMA requests: bursts of BURST bytes while the FIFO holds at least BURST bytes */
+static void dmaStep(void)
+{
+	int k;
+
+	if(sim.paused) return;
+	while(sim.fifoLen >= BURST && sim.enabled[sim.alt])
+	{
+		for(k=0; k<BURST; k++)
+		{
+			sim.dst[sim.alt][sim.pos[sim.alt]++] = sim.fifo[0];
+			memmove(sim.fifo, sim.fifo+1, --sim.fifoLen);
+		}
+		if(sim.pos[sim.alt] == sim.len[sim.alt])
+		{
+			sim.enabled[sim.alt] = false;
+			sim.alt = !sim.alt;
+			sim.irq = true;
+		}
+	}
+}
+
+int main(void)
+{
+	uart_dma_t d;
+	int sent = 0;
+	int i, k, burst;
+	int latency = 0;
+
+	srand(1);
+	uartdma_init(&d, &ops, NULL, sink, NULL);
+	uartdma_start(&d);
+
+	for(i=0; i<STEPS; i++)
+	{
+		burst = rand() % 20;
+		for(k=0; k<burst; k++)
+		{
+			if(sim.fifoLen < FIFOLEN) sim.fifo[sim.fifoLen++] = (char)sent++;
+			else sim.lost++;
+			dmaStep();
+		}
+		if(sim.irq && (rand()%3==0 || ++latency>=3))		/* completion interrupt with latency */
+		{
+			sim.irq = false;
+			latency = 0;
+			uartdma_service(&d, false);
+		}
+		if(rand()%7==0 && sim.fifoLen>0 && sim.fifoLen<BURST)	/* receive timeout */
+			uartdma_service(&d, true);
+	}
+	uartdma_service(&d, true);
+
+	CHECK(sim.lost == 0);
+	CHECK_MSG(outLen == sent, "%d of %d bytes received", outLen, sent);
+	for(i=0; i<outLen; i++)
+		if(out[i] != (char)i) { CHECK_MSG(out[i] == (char)i, "byte %d", i); break; }
+	CHECK(d.blocks > 0 && d.flushes > 0);
+	CHECK(!sim.paused);
+
+	TEST_END();
+}
@@ -0,0 +1,90 @@
+/*
+ * test_uart_ring.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: Host test of the single producer / single consumer rings of uart.c. A producer thread
+ *       		(the main loop writing debug output) and the consumer (the ISR) run concurrently, so a
+ *       		wrong index order or missing barriers show up as corrupted or lost bytes. The 16 bit
+ *       		indices wrap many times for every buffer length.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "uart.h"
+#include "test.h"
+
+#define BYTES		5000000
+
+/* private functions of uart.c */
+uint16_t UARTRingWrite(uart_ring_t *ring, const char *data, uint16_t len);
+uint16_t UARTRingRead(uart_ring_t *ring, char *buffer, uint16_t len);
+
+static char buffer[32768];
+static uart_ring_t ring;
+static uint32_t attempted;			/* bytes offered to UARTRingWrite() */
+
+/* writes the sequence 0, 1, 2, ... in chunks of varying length, retrying what was dropped */
+static void * producer(void * arg)
+{
+	uint32_t i = 0;
+	uint16_t n, k;
+	char chunk[37];
+
+	while(i < BYTES)
+	{
+		n = (i % 37) + 1;
+		if(n > BYTES-i) n = BYTES-i;
+		for(k=0; k<n; k++) chunk[k] = (char)(i + k);
+		attempted += n;
+		k = UARTRingWrite(&ring, chunk, n);
+		if(k==0) sched_yield();			/* ring full, let the consumer run on a single core */
+		i += k;
+	}
+
+	return NULL;
+}
+
+/* runs producer and consumer on a ring of len bytes, returns the number of corrupted bytes */
+static int run(uint16_t len)
+{
+	pthread_t thread;
+	uint32_t i = 0;
+	uint16_t n, k;
+	char chunk[53];
+	int bad = 0;
+
+	memset(&ring, 0, sizeof(ring));
+	ring.buffer = buffer;
+	ring.mask = len - 1;
+	attempted = 0;
+
+	pthread_create(&thread, NULL, producer, NULL);
+	while(i < BYTES)
+	{
+		n = UARTRingRead(&ring, chunk, (i % 53) + 1);
+		for(k=0; k<n; k++)
+			if(chunk[k] != (char)(i + k)) bad++;
+		if(n==0) sched_yield();
+		i += n;
+	}
+	pthread_join(thread, NULL);
+
+	CHECK_MSG(ring.head == ring.tail, "ring of %u bytes not empty", len);
+	CHECK_MSG(attempted == BYTES + ring.dropped, "ring of %u bytes: %u offered, %u dropped", len, attempted, ring.dropped);
+	CHECK(ring.high <= len);
+
+	return bad;
+}
+
+int main(void)
+{
+	CHECK(run(64) == 0);
+	CHECK(run(512) == 0);
+	CHECK(run(32768) == 0);
+
+	TEST_END();
+}
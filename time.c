@@ -12,7 +12,7 @@
 
 uint8_t hr=0, min=0, sec=0, ms=0;					/* clock */
 uint8_t da=1, mo=1, ye=0;							/* date, year=ye+2000 */		
-uint8_t stpwHr=0, stpwMin=0, stpwSec=0, stpwMsec=0;	/* Stopwatch variables */
+volatile uint32_t stpwMs=0;							/* Stopwatch in milliseconds */
 bool stpwRun=false;
 
 bool sync = false;
@@ -41,7 +41,7 @@ inline void tick_day()
 }
 
 /*
- * 100ms tick function must be called every 100ms to ensure correct time and stopwatch function.
+ * 100ms tick function must be called every 100ms to ensure correct time function.
  */
 void time_tick100Ms(void)
 {
@@ -69,30 +69,18 @@ void time_tick100Ms(void)
 			}
 		}
 	}
+}
 
+/*
+ * 1ms tick function must be called every 1ms to ensure correct stopwatch function.
+ */
+void time_tick1Ms(void)
+{
 	// STOPWATCH
 	if(stpwRun)
 	{
-		stpwMsec++;
-		if(stpwMsec==10)
-		{
-			stpwMsec=0;
-			stpwSec++;
-			if(stpwSec==60)
-			{
-				stpwSec=0;
-				stpwMin++;
-				if(stpwMin==60)
-				{
-					stpwMin=0;
-					stpwHr++;
-					if(stpwHr==99)
-					{
-						stpwHr=0;
-					}
-				}
-			}
-		}
+		stpwMs++;
+		if(stpwMs==99UL*3600000UL) stpwMs=0;	/* wrap at 99 hours */
 	}
 }
 
@@ -145,23 +133,28 @@ void time_sync(uint8_t Ye, uint8_t Mo, uint8_t Da, uint8_t Hr, uint8_t Min, uint
 }
 
 /*
- * Returns the current stopwatch value.
+ * Returns the current stopwatch value (ms = tenth of seconds).
  */
 time_t stpw(void)
 {
-	do
-	{
-		sync = false;
+	uint32_t t = stpwMs;	/* single 32 bit read, no syncronisation required */
 
-		tempStpw.hr = stpwHr;
-		tempStpw.min = stpwMin;
-		tempStpw.sec = stpwSec;
-		tempStpw.ms = stpwMsec;
-	} while(sync==true); /* copy values again when interrupted by a 100ms tick event */
+	tempStpw.hr = t / 3600000UL;
+	tempStpw.min = (t / 60000UL) % 60;
+	tempStpw.sec = (t / 1000UL) % 60;
+	tempStpw.ms = (t / 100UL) % 10;
 
 	return tempStpw;
 }
 
+/*
+ * Returns the current stopwatch value in milliseconds.
+ */
+uint32_t stpw_ms(void)
+{
+	return stpwMs;
+}
+
 /*
  * Starts or resumes the stopwatch.
  */
@@ -181,15 +174,21 @@ void stpw_stop(void)
  */
 void stpw_reset(void)
 {
-	do
-	{
-		sync = false;
+	stpwMs = 0;
+}
 
-		stpwHr = 0;
-		stpwMin = 0;
-		stpwSec = 0;
-		stpwMsec = 0;
-	} while(sync==true); /* copy values again when interrupted by a 100ms tick event */
+/*
+ * Sets the stopwatch to a value in milliseconds.
+ */
+void stpw_set(uint32_t ms)
+{
+	stpwMs = ms;
+}
 
-	sync = false;
+/*
+ * Returns true, if the stopwatch is running.
+ */
+bool stpw_running(void)
+{
+	return stpwRun;
 }
@@ -6,7 +6,7 @@
  *
  *       Brief: time.h provides function for managing a time consisting of hours, minutes and
  *       		seconds and date. Additionally, a stopwatch function is provided with a resolution 
- *				of tenth of seconds.
+ *				of milliseconds.
  */
 
 #ifndef TIME_H_
@@ -26,9 +26,12 @@ typedef struct strDate
 	uint8_t d, m, y;		/* year = YY+2000 */
 } date_t;
 
-/* 100ms tick function must be called every 100ms to ensure correct time and stopwatch function. */
+/* 100ms tick function must be called every 100ms to ensure correct time function. */
 void time_tick100Ms(void);
 
+/* 1ms tick function must be called every 1ms to ensure correct stopwatch function. */
+void time_tick1Ms(void);
+
  /* Returns the current time. Must be called prior to date() if date should also be retreived. */
 time_t time(void);
 
@@ -38,9 +41,12 @@ date_t date(void);
 /* Syncronises the time with a specific value (e.g. GPS time). */
 void time_sync(uint8_t Ye, uint8_t Mo, uint8_t Da, uint8_t Hr, uint8_t Min, uint8_t Sec);
 
-/* Returns the current stopwatch value. */
+/* Returns the current stopwatch value (ms = tenth of seconds). */
 time_t stpw(void);
 
+/* Returns the current stopwatch value in milliseconds. */
+uint32_t stpw_ms(void);
+
 /* Starts or resumes the stopwatch. */
 void stpw_start(void);
 
@@ -50,4 +56,10 @@ void stpw_stop(void);
 /* Resets the stopwatch to zero. */
 void stpw_reset(void);
 
+/* Sets the stopwatch to a value in milliseconds, e.g. when resuming from a checkpoint. */
+void stpw_set(uint32_t ms);
+
+/* Returns true, if the stopwatch is running. */
+bool stpw_running(void);
+
 #endif /* TIME_H_ */
@@ -38,8 +38,9 @@ SECTIONS
     .vtable :   > 0x20000000
     .data   :   > SRAM
     .bss    :   > SRAM
+    .uartbuf :  > SRAM
     .sysmem :   > SRAM
     .stack  :   > SRAM
 }
 
-__STACK_TOP = __stack + 512;
+__STACK_TOP = __STACK_END;
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""
+dlog_decode.py -- expands deferred binary log records of the GPS logger into text.
+
+The debug UART carries normal text output mixed with binary records:
+    0xA5, ID, number of arguments, arguments (uint32, little endian)
+The ID table is read from dlog_ids.h, IDs are numbered by their position.
+Text output is passed through unchanged.
+
+Usage:
+    dlog_decode.py capture.bin                  decode a captured byte stream
+    dlog_decode.py --port /dev/ttyACM0          decode live from the serial port (needs pyserial)
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+MAXARGS = 3
+
+ID_RE = re.compile(r'^\s*DLOG_ID\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)', re.M)
+CONV_RE = re.compile(r'%[-+ #0]*\d*([diuxXc%])')
+
+
+def load_ids(path):
+    """Returns a list of (name, format) tuples in ID order."""
+    with open(path, encoding='utf-8', errors='replace') as f:
+        text = f.read()
+    return [(m.group(1), bytes(m.group(2), 'utf-8').decode('unicode_escape'))
+            for m in ID_RE.finditer(text)]
+
+
+def expand(fmt, args):
+    """Expands a C style format with 32 bit raw arguments."""
+    values = []
+    convs = [c for c in CONV_RE.findall(fmt) if c != '%']
+    for conv, raw in zip(convs, args):
+        if conv in 'di':
+            raw = raw - (1 << 32) if raw & 0x80000000 else raw
+        elif conv == 'c':
+            raw = chr(raw & 0xFF)
+        values.append(raw)
+    if len(values) != len(convs):
+        return fmt + ' <argument mismatch: ' + ' '.join(str(a) for a in args) + '>'
+    return CONV_RE.sub(lambda m: m.group(0).replace('u', 'd'), fmt) % tuple(values)
+
+
+class Decoder:
+    """Splits a byte stream into text and records."""
+
+    def __init__(self, ids, out):
+        self.ids = ids
+        self.out = out
+        self.buf = bytearray()
+
+    def feed(self, data):
+        self.buf += data
+        while self.buf:
+            pos = self.buf.find(SYNC)
+            if pos < 0:
+                self.text(self.buf)
+                self.buf.clear()
+                break
+            if pos > 0:
+                self.text(self.buf[:pos])
+                del self.buf[:pos]
+            if len(self.buf) < 3:
+                break
+            rid, nargs = self.buf[1], self.buf[2]
+            if rid >= len(self.ids) or nargs > MAXARGS:
+                self.text(self.buf[:1])         # not a record, pass the byte through
+                del self.buf[:1]
+                continue
+            size = 3 + 4 * nargs
+            if len(self.buf) < size:
+                break
+            args = struct.unpack('<%dI' % nargs, bytes(self.buf[3:size]))
+            del self.buf[:size]
+            self.record(rid, args)
+
+    def text(self, data):
+        self.out.write(bytes(data).decode('latin-1'))
+
+    def record(self, rid, args):
+        name, fmt = self.ids[rid]
+        self.out.write('\n[%s] %s\n' % (name, expand(fmt, args)))
+        self.out.flush()
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', nargs='?', help='captured byte stream, default: stdin')
+    parser.add_argument('--port', help='serial port to read from')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--ids', default=os.path.join(here, '..', 'dlog_ids.h'), help='path to dlog_ids.h')
+    args = parser.parse_args()
+
+    dec = Decoder(load_ids(args.ids), sys.stdout)
+
+    if args.port:
+        import serial
+        with serial.Serial(args.port, args.baud, timeout=0.1) as ser:
+            try:
+                while True:
+                    dec.feed(ser.read(256))
+            except KeyboardInterrupt:
+                pass
+    else:
+        src = open(args.capture, 'rb') if args.capture else sys.stdin.buffer
+        with src:
+            while True:
+                data = src.read(4096)
+                if not data:
+                    break
+                dec.feed(data)
+
+
+if __name__ == '__main__':
+    main()
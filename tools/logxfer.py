@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+"""
+logxfer.py -- fetches log files from the GPS logger over the debug UART.
+
+The console command "xfer [baud]" puts the device into transfer mode and switches the debug UART
+to the given baud rate (default 921600). Frames are COBS encoded and end with a zero byte, the payload
+is: type, body, CRC-32 (little endian) of type and body. See export.h for the frame types.
+
+File data arrives in blocks tagged with their offset. The client acknowledges the contiguous data
+received so far; the device resends everything behind the last acknowledgement when blocks are lost.
+An existing partial output file is continued at its current size, so an interrupted transfer is
+resumed with the same command.
+
+Usage:
+    logxfer.py --port /dev/ttyACM0 list
+    logxfer.py --port /dev/ttyACM0 get track001.csv [-o out.csv] [--offset N] [--length N]
+    logxfer.py --port /dev/ttyACM0 get --all [-d dir]
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+import zlib
+
+DEBUG_BAUD = 115200
+XFER_BAUD = 921600
+
+FR_TEXT = {0: 'ok', 1: 'disk error', 3: 'not ready', 4: 'no file', 5: 'no path', 6: 'invalid name'}
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for b in data:
+        if b == 0:
+            out.append(len(block) + 1)
+            out += block
+            block.clear()
+        else:
+            block.append(b)
+            if len(block) == 254:
+                out.append(255)
+                out += block
+                block.clear()
+    out.append(len(block) + 1)
+    out += block
+    out.append(0)
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 255 and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class XferError(Exception):
+    pass
+
+
+class Link:
+    """Frame level access to the device."""
+
+    def __init__(self, ser):
+        self.ser = ser
+        self.buf = bytearray()
+        self.bad = 0
+
+    def send(self, ftype, body=b''):
+        payload = ftype.encode() + body
+        self.ser.write(cobs_encode(payload + struct.pack('<I', zlib.crc32(payload))))
+
+    def recv(self, timeout):
+        """Returns (type, body) of the next valid frame or None on timeout."""
+        end = time.monotonic() + timeout
+        while True:
+            pos = self.buf.find(0)
+            while pos >= 0:
+                raw = bytes(self.buf[:pos])
+                del self.buf[:pos + 1]
+                frame = cobs_decode(raw) if raw else None
+                if frame and len(frame) >= 5 and zlib.crc32(frame[:-4]) == struct.unpack('<I', frame[-4:])[0]:
+                    return chr(frame[0]), frame[1:-4]
+                if raw:
+                    self.bad += 1       # text output or a corrupted frame
+                pos = self.buf.find(0)
+            left = end - time.monotonic()
+            if left <= 0:
+                return None
+            self.ser.timeout = min(left, 0.05)
+            self.buf += self.ser.read(max(1, self.ser.in_waiting))
+
+    def expect(self, ftypes, timeout=2.0, match=None):
+        while True:
+            frame = self.recv(timeout)
+            if frame is None:
+                raise XferError('no reply from the device')
+            if frame[0] in ftypes and (match is None or match(frame[1])):
+                return frame
+
+    def request(self, ftype, body, ftypes, timeout=1.0, tries=3, match=None):
+        """Sends a request and returns the first reply frame, the request is repeated if the reply is lost."""
+        for _ in range(tries - 1):
+            self.send(ftype, body)
+            try:
+                return self.expect(ftypes, timeout, match)
+            except XferError:
+                pass
+        self.send(ftype, body)
+        return self.expect(ftypes, timeout, match)
+
+
+def enter(ser, baud):
+    """Starts transfer mode with the console command and switches the baud rate."""
+    ser.baudrate = DEBUG_BAUD
+    ser.reset_input_buffer()
+    ser.write(b'\rxfer %d\r' % baud)
+    time.sleep(0.2)                     # device waits for its output to drain before switching
+    ser.baudrate = baud
+    ser.reset_input_buffer()
+
+
+def leave(link):
+    link.send('Q')
+    try:
+        link.expect('q', 1.0)
+    except XferError:
+        pass
+    link.ser.baudrate = DEBUG_BAUD
+
+
+def list_files(link, tries=3):
+    """Returns a list of (name, size) tuples, the list is requested again if its end is lost."""
+    for attempt in range(tries):
+        files = []
+        ftype, body = link.request('L', b'', 'lE')
+        try:
+            while ftype != 'E':
+                size = struct.unpack('<I', body[:4])[0]
+                files.append((body[4:].decode('latin-1'), size))
+                ftype, body = link.expect('lE', 1.0)
+        except XferError:
+            if attempt == tries - 1:
+                raise
+            continue
+        if body[0]:
+            raise XferError('list failed: ' + FR_TEXT.get(body[0], str(body[0])))
+        return files
+
+
+def get_file(link, name, out, offset=0, length=0, progress=True):
+    """Reads name from offset into the file object out (positioned at offset). Returns the bytes received."""
+    bname = name.encode('latin-1')
+    ftype, body = link.request('R', bname + b'\0' + struct.pack('<II', offset, length), 'r',
+                               match=lambda b: b[5:] == bname)
+    status, size = struct.unpack('<BI', body[:5])
+    if status:
+        raise XferError('%s: %s' % (name, FR_TEXT.get(status, str(status))))
+    end = size if not length else min(size, offset + length)
+    pos = min(offset, size)
+    start = time.monotonic()
+    unacked = 0
+    while pos < end:
+        frame = link.recv(0.5)
+        if frame is None:
+            link.send('A', struct.pack('<I', pos))   # ack lost or all frames lost, repeat
+            continue
+        ftype, body = frame
+        if ftype == 'E' and body[0]:
+            raise XferError('%s: read failed at %d: %s' % (name, pos, FR_TEXT.get(body[0], str(body[0]))))
+        if ftype != 'D':
+            continue
+        boff = struct.unpack('<I', body[:4])[0]
+        data = body[4:]
+        if boff == pos:
+            out.write(data)
+            pos += len(data)
+            unacked += 1
+            if unacked >= 2 or pos >= end:
+                link.send('A', struct.pack('<I', pos))
+                unacked = 0
+        elif boff > pos:
+            link.send('A', struct.pack('<I', pos))   # gap, ask for the missing block
+        if progress:
+            rate = (pos - offset) / max(time.monotonic() - start, 1e-3)
+            sys.stderr.write('\r%s: %d/%d bytes, %.1f kB/s ' % (name, pos, end, rate / 1000))
+    if progress:
+        sys.stderr.write('\n')
+    return pos - offset
+
+
+def fetch(link, name, path, offset, length):
+    """Writes name to path, continues a partial file if no offset is given."""
+    if offset is None:
+        offset = os.path.getsize(path) if os.path.exists(path) else 0
+    with open(path, 'r+b' if os.path.exists(path) else 'wb') as out:
+        out.seek(offset)
+        get_file(link, name, out, offset, length)
+        out.truncate()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--port', required=True, help='serial port of the debug UART')
+    parser.add_argument('--baud', type=int, default=XFER_BAUD, help='baud rate during the transfer')
+    parser.add_argument('--no-enter', action='store_true', help='device is already in transfer mode')
+    sub = parser.add_subparsers(dest='cmd', required=True)
+    sub.add_parser('list', help='lists the files in the logs directory')
+    get = sub.add_parser('get', help='fetches files, partial output files are resumed')
+    get.add_argument('names', nargs='*')
+    get.add_argument('--all', action='store_true', help='fetch all files')
+    get.add_argument('-o', '--output', help='output file (single name only)')
+    get.add_argument('-d', '--dir', default='.', help='output directory')
+    get.add_argument('--offset', type=int, help='first byte, default: size of the existing output file')
+    get.add_argument('--length', type=int, default=0, help='number of bytes, default: to the end')
+    args = parser.parse_args()
+
+    import serial
+    with serial.Serial(args.port, DEBUG_BAUD, timeout=0.05) as ser:
+        if args.no_enter:
+            ser.baudrate = args.baud
+        else:
+            enter(ser, args.baud)
+        link = Link(ser)
+        try:
+            if args.cmd == 'list':
+                for name, size in list_files(link):
+                    print('%10d  %s' % (size, name))
+            else:
+                names = [n for n, _ in list_files(link)] if args.all else args.names
+                if args.output and len(names) != 1:
+                    parser.error('--output needs exactly one file')
+                for name in names:
+                    fetch(link, name, args.output or os.path.join(args.dir, name), args.offset, args.length)
+        except XferError as e:
+            sys.stderr.write('error: %s\n' % e)
+            return 1
+        finally:
+            leave(link)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+memreport.py -- reports the static RAM footprint of the GPS logger per module from the linker map file.
+
+The TI linker writes the map file (GPS_Speedo_Logger.map in the build directory) with a section
+allocation map: output sections with origin and length, followed by the input sections they hold:
+    .bss       0    20000470    00001a3c     UNINITIALIZED
+                      20000470    00000800     gps.obj (.bss:sats1)
+The input sections of all output sections in SRAM (.data, .bss, .uartbuf, .vtable, .sysmem, .stack)
+are summed up per object file; the largest variables are listed with --top. Run time stack usage is
+shown by the console command "mem".
+
+Usage:
+    memreport.py Debug/GPS_Speedo_Logger.map [--top 20]
+    memreport.py new.map --diff old.map           changes per module
+"""
+
+import argparse
+import re
+import sys
+
+SRAM_BASE = 0x20000000
+SRAM_SIZE = 0x40000
+
+OUT_RE = re.compile(r'^(\.\w+|\S+)\s+\d+\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})')
+IN_RE = re.compile(r'^\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})\s+(.+?)\s+\(([^)]+)\)\s*$')
+HOLE_RE = re.compile(r'^\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})\s+--HOLE--')
+
+
+def parse_map(path):
+    """Returns a list of (output section, module, input section, address, size) in SRAM."""
+    entries = []
+    section = None
+    inside = False
+    with open(path, encoding='latin-1') as f:
+        for line in f:
+            if line.startswith('SECTION ALLOCATION MAP'):
+                inside = True
+                continue
+            if not inside:
+                continue
+            if line.startswith('MODULE SUMMARY') or line.startswith('GLOBAL SYMBOLS') or \
+               line.startswith('LINKER GENERATED'):
+                break
+            m = OUT_RE.match(line)
+            if m:
+                origin = int(m.group(2), 16)
+                section = m.group(1) if SRAM_BASE <= origin < SRAM_BASE + SRAM_SIZE else None
+                continue
+            if section is None:
+                continue
+            m = HOLE_RE.match(line)
+            if m:
+                owner = {'.stack': '(stack)', '.sysmem': '(heap)'}.get(section, '(padding)')
+                entries.append((section, owner, '--HOLE--', int(m.group(1), 16), int(m.group(2), 16)))
+                continue
+            m = IN_RE.match(line)
+            if m:
+                module = m.group(3).split(' : ')[-1]        # "lib : member.obj" -> member.obj
+                module = re.sub(r'(\.c)?\.obj$', '', module)
+                entries.append((section, module, m.group(4), int(m.group(1), 16), int(m.group(2), 16)))
+    return entries
+
+
+def per_module(entries):
+    """Returns {module: {output section: bytes}}."""
+    modules = {}
+    for section, module, _, _, size in entries:
+        sizes = modules.setdefault(module, {})
+        sizes[section] = sizes.get(section, 0) + size
+    return modules
+
+
+def print_table(modules, sections):
+    print('%-24s' % 'module' + ''.join('%10s' % s for s in sections) + '%10s' % 'total')
+    totals = dict.fromkeys(sections, 0)
+    for module, sizes in sorted(modules.items(), key=lambda m: -sum(m[1].values())):
+        for s in sections:
+            totals[s] += sizes.get(s, 0)
+        print('%-24s' % module[:24] + ''.join('%10d' % sizes.get(s, 0) for s in sections)
+              + '%10d' % sum(sizes.values()))
+    total = sum(totals.values())
+    print('%-24s' % 'total' + ''.join('%10d' % totals[s] for s in sections) + '%10d' % total)
+    print('SRAM used %d of %d bytes (%.1f %%)' % (total, SRAM_SIZE, 100.0 * total / SRAM_SIZE))
+
+
+def print_top(entries, count):
+    print('\n%-10s %8s  %-24s %s' % ('address', 'size', 'module', 'section'))
+    for section, module, insec, addr, size in sorted(entries, key=lambda e: -e[4])[:count]:
+        print('%08x   %8d  %-24s %s' % (addr, size, module[:24], insec))
+
+
+def print_diff(new, old):
+    print('%-24s %10s %10s %10s' % ('module', 'old', 'new', 'change'))
+    for module in sorted(set(new) | set(old)):
+        a = sum(old.get(module, {}).values())
+        b = sum(new.get(module, {}).values())
+        if a != b:
+            print('%-24s %10d %10d %+10d' % (module[:24], a, b, b - a))
+    a = sum(sum(v.values()) for v in old.values())
+    b = sum(sum(v.values()) for v in new.values())
+    print('%-24s %10d %10d %+10d' % ('total', a, b, b - a))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('map', help='linker map file')
+    parser.add_argument('--top', type=int, default=15, help='number of largest input sections to list')
+    parser.add_argument('--diff', metavar='OLDMAP', help='compare with an older map file')
+    args = parser.parse_args()
+
+    entries = parse_map(args.map)
+    if not entries:
+        sys.stderr.write('error: no SRAM sections found in %s\n' % args.map)
+        return 1
+    modules = per_module(entries)
+
+    if args.diff:
+        print_diff(modules, per_module(parse_map(args.diff)))
+        return 0
+
+    sections = []
+    for e in entries:
+        if e[0] not in sections:
+            sections.append(e[0])
+    print_table(modules, sections)
+    if args.top:
+        print_top([e for e in entries if e[2] != '--HOLE--'], args.top)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
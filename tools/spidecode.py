@@ -0,0 +1,498 @@
+#!/usr/bin/env python3
+"""
+spidecode.py -- decodes a SPI bus recorder dump of the GPS logger.
+
+The recorder is compiled in with SPI_TRACE (spi_trace.h). "spitrace dump" on the console prints the
+record ring as text (numbers in hex):
+    #SPITRACE,<clock Hz>,<records>
+    <start>,<end>,<type>,<process>,<len>,<tx bytes>,<rx bytes>      one line per record, oldest first
+    #SPIEND
+Types: C, Q, S chip select held by a blocking access, a queued transaction or a 16 bit stream;
+X exchanged bytes (SPI_xchg()), T, R, F transmitted, received, full duplex block. Other output around
+the dump is ignored.
+
+The records of the display are decoded as SSD1351 commands (names from oled_ssd1351.h), those of the
+SD card as SD commands, responses, tokens and busy times. The summary shows the bus utilisation per
+process and the idle gaps between the chip select periods. The processes are numbered in the order
+they register with the SPI wrapper: SD card 1, display 2.
+
+Usage:
+    spidecode.py capture.txt [--summary] [--gaps 10]
+    spidecode.py --port /dev/ttyACM0                 sends "spitrace dump" and reads the reply
+"""
+
+import argparse
+import collections
+import os
+import re
+import sys
+
+Rec = collections.namedtuple('Rec', 'start end type proc len tx rx')
+
+CS_TYPES = 'CQS'
+CMD_RE = re.compile(r'^\s*#define\s+SSD1351_CMD_(\w+)\s+0x([0-9A-Fa-f]+)', re.M)
+
+# argument bytes of the SSD1351 commands
+SSD1351_ARGS = {0x15: 2, 0x75: 2, 0xA0: 1, 0xA1: 1, 0xA2: 1, 0xAB: 1, 0xB1: 1, 0xB2: 3, 0xB3: 1, 0xB4: 3,
+                0xB5: 1, 0xB6: 1, 0xB8: 63, 0xBB: 1, 0xBE: 1, 0xC1: 3, 0xC7: 1, 0xCA: 1, 0xFD: 1, 0x96: 5}
+SSD1351_WRITERAM = 0x5C
+
+SD_NAMES = {0: 'GO_IDLE_STATE', 1: 'SEND_OP_COND', 8: 'SEND_IF_COND', 9: 'SEND_CSD', 10: 'SEND_CID',
+            12: 'STOP_TRANSMISSION', 13: 'SEND_STATUS', 16: 'SET_BLOCKLEN', 17: 'READ_SINGLE_BLOCK',
+            18: 'READ_MULTIPLE_BLOCK', 23: 'SET_BLOCK_COUNT', 24: 'WRITE_BLOCK', 25: 'WRITE_MULTIPLE_BLOCK',
+            32: 'ERASE_WR_BLK_START', 33: 'ERASE_WR_BLK_END', 38: 'ERASE', 55: 'APP_CMD', 58: 'READ_OCR',
+            59: 'CRC_ON_OFF'}
+SD_ACMD_NAMES = {13: 'SD_STATUS', 23: 'SET_WR_BLK_ERASE_COUNT', 41: 'SD_SEND_OP_COND', 51: 'SEND_SCR'}
+SD_READS = {9, 10, 17, 18}
+SD_ACMD_READS = {13, 51}
+SD_WRITES = {24, 25}
+R1_FLAGS = ('idle', 'erase reset', 'illegal command', 'CRC error', 'erase sequence error', 'address error',
+            'parameter error')
+
+
+def load_cmds(path):
+    """Returns a dict of SSD1351 command names by value, empty if the header is not found."""
+    try:
+        with open(path, encoding='utf-8', errors='replace') as f:
+            return {int(m.group(2), 16): m.group(1) for m in CMD_RE.finditer(f.read())}
+    except OSError:
+        return {}
+
+
+def parse_dump(lines):
+    """Returns (clock, records) of the last complete dump, timestamps are unwrapped."""
+    result = None
+    dump = None
+    clock = 0
+    for line in lines:
+        line = line.strip()
+        if line.startswith('#SPITRACE,'):
+            clock, dump = int(line.split(',')[1], 16), []
+        elif line == '#SPIEND' and dump is not None:
+            result = (clock, dump)
+            dump = None
+        elif dump is not None:
+            parts = line.split(',')
+            if len(parts) == 7 and len(parts[2]) == 1:
+                dump.append(Rec(int(parts[0], 16), int(parts[1], 16), parts[2], int(parts[3], 16),
+                                int(parts[4], 16), bytes.fromhex(parts[5]), bytes.fromhex(parts[6])))
+    if result is None:
+        raise ValueError('no complete SPI trace dump found')
+    clock, records = result
+    return clock, unwrap(records)
+
+
+def unwrap(records):
+    """Timestamps wrap after 2^32 cycles; records are in order of their start, gaps must be shorter."""
+    out = []
+    prev = None
+    base = 0
+    for r in records:
+        if prev is not None:
+            delta = (r.start - prev) & 0xFFFFFFFF
+            base += delta - (1 << 32 if delta >= 1 << 31 else 0)
+        else:
+            base = r.start
+        prev = r.start
+        out.append(r._replace(start=base, end=base + ((r.end - r.start) & 0xFFFFFFFF)))
+    t0 = min((r.start for r in out), default=0)
+    return [r._replace(start=r.start - t0, end=r.end - t0) for r in out]
+
+
+def crc7(data):
+    crc = 0
+    for b in data:
+        for i in range(8):
+            crc <<= 1
+            if ((b << i) ^ crc) & 0x80:
+                crc ^= 0x09
+    return crc & 0x7F
+
+
+class Listing:
+    """Collects decoded lines: (start, end, process, text)."""
+
+    def __init__(self):
+        self.lines = []
+
+    def add(self, start, end, proc, text):
+        self.lines.append((start, end, proc, text))
+
+
+class OledDecoder:
+    """Decodes the chip select periods of the display as SSD1351 commands. Command and data bytes are
+    told apart by the number of arguments of each command; after WRITERAM, periods of two bytes and
+    streams are pixel data."""
+
+    def __init__(self, out, proc, names):
+        self.out = out
+        self.proc = proc
+        self.names = names
+        self.cmd = None             # (start, code, args) of the command waiting for arguments
+        self.need = 0
+        self.ram = False            # WRITERAM seen
+
+    def name(self, code):
+        return self.names.get(code, 'cmd %02x' % code)
+
+    def record(self, r):
+        if r.type == 'S':
+            self.out.add(r.start, r.end, self.proc, 'pixel stream %d px' % (r.len // 2))
+            return
+        if r.type == 'Q':
+            b = r.tx
+            if len(b) == 6 and b[0] == 0x15 and b[3] == 0x75 and r.len >= 7:
+                self.out.add(r.start, r.end, self.proc, 'fill column %d..%d row %d..%d, %d px (queued)'
+                             % (b[1], b[2], b[4], b[5], (r.len - 7) // 2))
+                self.ram = True
+            else:
+                self.out.add(r.start, r.end, self.proc, 'queued %d bytes %s' % (r.len, b.hex(' ')))
+            return
+        if self.need == 0 and self.ram and r.len == 2:
+            self.out.add(r.start, r.end, self.proc, 'pixel %s' % r.tx.hex())
+            return
+        for i, b in enumerate(r.tx):
+            if self.need:
+                self.cmd[2].append(b)
+                self.need -= 1
+                if self.need == 0:
+                    self.flush(r.end)
+            elif b in self.names or b in SSD1351_ARGS:
+                self.cmd = (r.start, b, [])
+                self.need = SSD1351_ARGS.get(b, 0)
+                self.ram = b == SSD1351_WRITERAM
+                if self.need == 0:
+                    self.flush(r.end)
+            else:
+                self.out.add(r.start, r.end, self.proc, 'data %s' % r.tx[i:].hex(' '))
+                break
+
+    def flush(self, end):
+        start, code, args = self.cmd
+        self.out.add(start, end, self.proc, ' '.join([self.name(code)] + ['%02x' % a for a in args]))
+        self.cmd = None
+
+
+class SdDecoder:
+    """Decodes the records of the SD card. The exchanged bytes are reassembled from the 'X' records and
+    parsed as command packets, R1/R3/R7 responses, data tokens, data responses and busy periods."""
+
+    def __init__(self, out, proc):
+        self.out = out
+        self.proc = proc
+        self.stats = collections.Counter()
+        self.busy = []              # durations of busy periods in cycles
+        self.reset()
+
+    def reset(self):
+        self.phase = 'idle'
+        self.buf = []
+        self.t = None               # start of the element being collected
+        self.app = False            # CMD55 seen
+        self.last = None            # (cmd, acmd) of the last command
+        self.read = False           # data blocks from the card follow
+        self.write = False          # data blocks to the card follow
+        self.run = None             # [kind, count, start, end] of repeated bytes
+
+    def emit(self, start, end, text):
+        self.out.add(start, end, self.proc, text)
+
+    def flush_run(self):
+        if self.run:
+            kind, n, start, end = self.run
+            if kind == 'busy':
+                self.busy.append(end - start)
+                self.emit(start, end, 'busy %d bytes' % n)
+            elif n > 1:
+                self.emit(start, end, 'wait %d bytes' % n)
+            self.run = None
+
+    def count_run(self, kind, start, end):
+        if self.run and self.run[0] == kind:
+            self.run[1] += 1
+            self.run[3] = end
+        else:
+            self.flush_run()
+            self.run = [kind, 1, start, end]
+
+    def select(self, r):
+        """A new chip select period, commands and responses never span two periods."""
+        self.flush_run()
+        self.phase, self.buf = 'idle', []
+
+    def record(self, r):
+        if r.type in 'TRF':
+            self.block(r)
+        elif r.type == 'X':
+            # the stored exchanges, then len-n repetitions of the last one; the time of each byte is
+            # interpolated over the record
+            dur = r.end - r.start
+            n = len(r.tx)
+            for i, (tx, rx) in enumerate(zip(r.tx, r.rx)):
+                self.byte(tx, rx, r.start + dur * i // r.len, r.start + dur * (i + 1) // r.len)
+            rep = r.len - n
+            if rep and self.phase == 'idle' and self.run and (r.tx[-1], r.rx[-1]) in ((0xFF, 0xFF), (0xFF, 0x00)):
+                self.run[1] += rep          # polling, counted without decoding every byte
+                self.run[3] = r.end
+            else:
+                for i in range(n, r.len):
+                    self.byte(r.tx[-1], r.rx[-1], r.start + dur * i // r.len, r.start + dur * (i + 1) // r.len)
+
+    def block(self, r):
+        self.flush_run()
+        what = 'data block' if self.phase in ('rblock', 'wblock') else 'block'
+        self.emit(r.start, r.end, '%s %d bytes (%s)' % (what, r.len, {'T': 'tx', 'R': 'rx', 'F': 'tx/rx'}[r.type]))
+        self.stats['block bytes'] += r.len
+        if self.phase == 'rblock':
+            self.phase, self.buf, self.t = 'rcrc', [], None
+        elif self.phase == 'wblock':
+            self.phase, self.buf, self.t = 'wcrc', [], None
+
+    def byte(self, tx, rx, start, end):
+        if self.phase == 'cmd':
+            self.buf.append(tx)
+            if len(self.buf) == 6:
+                self.command(end)
+            return
+        if self.phase == 'resp':
+            if rx & 0x80:
+                self.buf.append(rx)
+                if len(self.buf) > 9:
+                    self.emit(self.t, end, 'no response')
+                    self.stats['no response'] += 1
+                    self.phase = 'idle'
+                return
+            self.response(rx, start, end)
+            return
+        if self.phase == 'rext':
+            self.buf.append(rx)
+            if self.t is None:
+                self.t = start
+            if len(self.buf) == 4:
+                self.emit(self.t, end, '  %s %s' % ('OCR' if self.last[0] == 58 else 'R7', bytes(self.buf).hex()))
+                self.phase = 'idle'
+            return
+        if self.phase in ('rcrc', 'wcrc'):
+            self.buf.append(rx if self.phase == 'rcrc' else tx)
+            if self.t is None:
+                self.t = start
+            if len(self.buf) == 2:
+                self.emit(self.t, end, '  CRC16 %02x%02x' % tuple(self.buf))
+                if self.phase == 'wcrc':
+                    self.phase = 'wresp'
+                else:
+                    self.phase = 'idle'
+                    self.read = self.last[0] == 18 and not self.last[1]
+            return
+        if self.phase == 'wresp':
+            code = rx & 0x1F
+            text = {0x05: 'accepted', 0x0B: 'CRC error', 0x0D: 'write error'}.get(code, 'invalid')
+            self.emit(start, end, '  data response %02x %s' % (rx, text))
+            if code != 0x05:
+                self.stats['data response ' + text] += 1
+            self.phase = 'idle'
+            self.write = self.last[0] == 25 and code == 0x05
+            return
+
+        # idle
+        if tx & 0xC0 == 0x40 and rx == 0xFF:
+            self.flush_run()
+            self.phase, self.buf, self.t = 'cmd', [tx], start
+        elif self.write and tx in (0xFC, 0xFE):
+            self.flush_run()
+            self.emit(start, end, 'data token %02x (write)' % tx)
+            self.phase = 'wblock'
+        elif self.write and tx == 0xFD:
+            self.flush_run()
+            self.emit(start, end, 'stop token')
+            self.write = False
+        elif self.read and tx == 0xFF and rx == 0xFE:
+            self.flush_run()
+            self.emit(start, end, 'data token fe (read)')
+            self.phase = 'rblock'
+        elif self.read and tx == 0xFF and 0 < rx < 0x20:
+            self.flush_run()
+            self.emit(start, end, 'error token %02x' % rx)
+            self.stats['error token'] += 1
+            self.read = False
+        elif tx == 0xFF and rx == 0xFF:
+            self.count_run('wait', start, end)
+        elif tx == 0xFF and rx == 0x00:
+            self.count_run('busy', start, end)
+        else:
+            self.flush_run()
+            self.emit(start, end, 'byte %02x/%02x' % (tx, rx))
+
+    def command(self, end):
+        pkt = bytes(self.buf)
+        cmd = pkt[0] & 0x3F
+        acmd = self.app and cmd != 55
+        arg = int.from_bytes(pkt[1:5], 'big')
+        name = (SD_ACMD_NAMES if acmd else SD_NAMES).get(cmd, '')
+        crc_ok = (pkt[5] >> 1) == crc7(pkt[:5]) and pkt[5] & 1
+        self.emit(self.t, end, '%sCMD%d %s arg=%08x crc %02x%s'
+                  % ('A' if acmd else '', cmd, name, arg, pkt[5], '' if crc_ok else ' BAD'))
+        self.stats[('ACMD%d' if acmd else 'CMD%d') % cmd] += 1
+        self.app = cmd == 55
+        self.last = (cmd, acmd)
+        if cmd == 12:
+            self.read = False
+        self.phase, self.buf, self.t = 'resp', [], None
+
+    def response(self, rx, start, end):
+        cmd, acmd = self.last
+        flags = [f for i, f in enumerate(R1_FLAGS) if rx & (1 << i)]
+        self.emit(start, end, '  R1 %02x%s%s' % (rx, ' ' if flags else '', ', '.join(flags)))
+        if rx & 0x7E:
+            self.stats['R1 error'] += 1
+        self.phase, self.buf, self.t = 'idle', [], None
+        if rx & 0x7E:
+            return
+        if cmd in (8, 58) and not acmd:
+            self.phase = 'rext'
+        self.read = (cmd in SD_ACMD_READS) if acmd else (cmd in SD_READS)
+        self.write = cmd in SD_WRITES and not acmd
+
+
+def intervals(records):
+    """Returns the merged busy intervals of the bus: chip select periods and transfers outside of them,
+    e.g. the clocks sent to the SD card before its initialisation."""
+    spans = sorted((r.start, r.end) for r in records)
+    merged = []
+    for s, e in spans:
+        if merged and s <= merged[-1][1]:
+            merged[-1][1] = max(merged[-1][1], e)
+        else:
+            merged.append([s, e])
+    return merged
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(p * len(values)))] if values else 0
+
+
+def summary(records, clock, names, sd, gaps_n, out):
+    us = 1e6 / clock
+    window = max(r.end for r in records) - min(r.start for r in records)
+    busy = intervals(records)
+    held = sum(e - s for s, e in busy)
+    out.write('\nwindow %.1f ms, %d records, bus held %.1f ms (%.1f %%)\n'
+              % (window * us / 1000, len(records), held * us / 1000, 100.0 * held / max(window, 1)))
+
+    out.write('\nprocess      periods    held ms      %    bytes  Mbit/s held\n')
+    for p in sorted({r.proc for r in records}):
+        cs = [r for r in records if r.proc == p and r.type in CS_TYPES]
+        t = sum(r.end - r.start for r in cs)
+        n = sum(r.len for r in cs)
+        out.write('%-10s %9d %10.2f %6.1f %8d %8.2f\n'
+                  % (names.get(p, 'SPI%d' % p), len(cs), t * us / 1000, 100.0 * t / max(window, 1), n,
+                     n * 8 / (t * us) if t else 0))
+
+    gaps = [(busy[i + 1][0] - busy[i][1], busy[i][1]) for i in range(len(busy) - 1)]
+    if gaps:
+        g = [d for d, _ in gaps]
+        out.write('\nidle gaps %d: min %.1f, median %.1f, p90 %.1f, max %.1f us\n'
+                  % (len(g), min(g) * us, percentile(g, 0.5) * us, percentile(g, 0.9) * us, max(g) * us))
+        hist = collections.Counter()
+        for d in g:
+            b = 1
+            while b < d * us:
+                b *= 2
+            hist[b] += 1
+        for b in sorted(hist):
+            out.write('  <= %6d us %6d\n' % (b, hist[b]))
+        out.write('\nlongest gaps (us, at ms, before -> after):\n')
+        for d, at in sorted(gaps, reverse=True)[:gaps_n]:
+            before = max((r for r in records if r.end <= at), key=lambda r: r.end, default=None)
+            after = min((r for r in records if r.start >= at + d), key=lambda r: r.start, default=None)
+            out.write('  %8.1f %10.3f  %s -> %s\n' % (d * us, at * us / 1000,
+                      names.get(before.proc, '?') if before else '-', names.get(after.proc, '?') if after else '-'))
+
+    if sd is not None:
+        out.write('\nSD card:\n')
+        for k in sorted(sd.stats):
+            out.write('  %-22s %d\n' % (k, sd.stats[k]))
+        if sd.busy:
+            out.write('  busy periods %d: mean %.1f, max %.1f us\n'
+                      % (len(sd.busy), sum(sd.busy) / len(sd.busy) * us, max(sd.busy) * us))
+
+
+def read_port(port, baud, timeout):
+    import serial
+    lines = []
+    with serial.Serial(port, baud, timeout=timeout) as ser:
+        ser.reset_input_buffer()
+        ser.write(b'\rspitrace dump\r')
+        while True:
+            line = ser.readline()
+            if not line:
+                break
+            line = line.decode('latin-1')
+            lines.append(line)
+            if line.strip() == '#SPIEND':
+                break
+    return lines
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', nargs='?', help='captured console output, default: stdin')
+    parser.add_argument('--port', help='serial port of the debug UART')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--header', default=os.path.join(here, '..', 'oled_ssd1351.h'),
+                        help='path to oled_ssd1351.h')
+    parser.add_argument('--sd', type=int, default=1, help='process number of the SD card')
+    parser.add_argument('--oled', type=int, default=2, help='process number of the display')
+    parser.add_argument('--summary', action='store_true', help='no listing, summary only')
+    parser.add_argument('--gaps', type=int, default=10, help='number of longest idle gaps shown')
+    args = parser.parse_args()
+
+    if args.port:
+        lines = read_port(args.port, args.baud, 2.0)
+    else:
+        src = open(args.capture, encoding='latin-1') if args.capture else sys.stdin
+        with src:
+            lines = src.readlines()
+
+    try:
+        clock, records = parse_dump(lines)
+    except ValueError as e:
+        sys.stderr.write('error: %s\n' % e)
+        return 1
+    if not records or not clock:
+        sys.stderr.write('error: the dump is empty (SPI_TRACE not compiled in?)\n')
+        return 1
+
+    names = {args.sd: 'sd', args.oled: 'oled'}
+    listing = Listing()
+    oled = OledDecoder(listing, 'oled', load_cmds(args.header))
+    sd = SdDecoder(listing, 'sd')
+    for r in records:
+        if r.proc == args.oled:
+            if r.type in CS_TYPES:
+                oled.record(r)
+        elif r.proc == args.sd:
+            if r.type in CS_TYPES:
+                listing.add(r.start, r.end, 'sd', 'select, %d bytes' % r.len)
+                sd.select(r)
+            else:
+                sd.record(r)
+        else:
+            listing.add(r.start, r.end, names.get(r.proc, 'SPI%d' % r.proc),
+                        '%s %d bytes %s' % (r.type, r.len, r.tx.hex(' ')))
+    sd.flush_run()
+
+    us = 1e6 / clock
+    if not args.summary:
+        sys.stdout.write('      time us    dur us  proc  decoded\n')
+        for start, end, proc, text in sorted(listing.lines, key=lambda l: l[0]):
+            sys.stdout.write('%13.2f %9.2f  %-5s %s\n' % (start * us, (end - start) * us, proc, text))
+    summary(records, clock, names, sd if any(r.proc == args.sd for r in records) else None, args.gaps,
+            sys.stdout)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
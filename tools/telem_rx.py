@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""
+telem_rx.py -- receives the binary telemetry stream of the GPS logger.
+
+Enable the stream with the console command "telem on". One frame is sent per GPS epoch, framed like
+the log export (see logxfer.py and telem.h); text output on the same UART is skipped. Frames are
+shown as a live status line and can be recorded to a CSV file. Gaps in the sequence number count
+frames lost on the link or dropped by the device.
+
+Usage:
+    telem_rx.py --port /dev/ttyACM0 [--csv out.csv] [--quiet]
+    telem_rx.py capture.bin --csv out.csv           decode a captured byte stream
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+from logxfer import cobs_decode
+
+TELEM_TYPE = ord('T')
+TELEM_VERSION = 1
+
+FRAME = struct.Struct('<BBHI BBBH iiiHI BBBBBBB IIII I')
+FIELDS = ('seq', 'tick', 'hour', 'min', 'sec', 'ms', 'lat', 'lon', 'alt', 'spd', 'dist',
+          'fixType', 'fixQuality', 'satsFix', 'satsView', 'pdop', 'hdop', 'vdop',
+          'rtDisp', 'rtGps', 'rtSd', 'dropped')
+
+
+class Receiver:
+    """Splits a byte stream into telemetry frames."""
+
+    def __init__(self, sink):
+        self.sink = sink
+        self.rest = b''
+        self.frames = 0
+        self.bad = 0
+        self.lost = 0
+        self.seq = None
+
+    def feed(self, data):
+        parts = (self.rest + data).split(b'\0')
+        self.rest = parts.pop()[-2 * FRAME.size:]      # text without frames must not pile up
+        for raw in parts:
+            frame = cobs_decode(raw) if raw else None
+            if not frame or len(frame) != FRAME.size or frame[0] != TELEM_TYPE:
+                self.bad += bool(raw)
+                continue
+            values = FRAME.unpack(frame)
+            if values[1] != TELEM_VERSION or zlib.crc32(frame[:-4]) != values[-1]:
+                self.bad += 1
+                continue
+            rec = dict(zip(FIELDS, values[2:-1]))
+            if self.seq is not None:
+                self.lost += (rec['seq'] - self.seq - 1) & 0xFFFF
+            self.seq = rec['seq']
+            self.frames += 1
+            self.sink(rec)
+
+
+class Dashboard:
+    """Shows the last frame as a status line, at most a few times per second."""
+
+    def __init__(self, rx, interval=0.2):
+        self.rx = rx
+        self.interval = interval
+        self.last = 0.0
+
+    def __call__(self, r):
+        now = time.monotonic()
+        if now - self.last < self.interval:
+            return
+        self.last = now
+        sys.stderr.write('\r%02d:%02d:%02d.%d  %9.5f %10.5f  alt %6.1f  spd %5.1f  dist %8.1f  '
+                         'fix %d/%d  sats %2d/%2d  pdop %4.1f  gps %6d  frames %d lost %d drop %d  '
+                         % (r['hour'], r['min'], r['sec'], r['ms'] // 100, r['lat'] / 1e5, r['lon'] / 1e5,
+                            r['alt'] / 10, r['spd'] / 10, r['dist'] / 10, r['fixType'], r['fixQuality'],
+                            r['satsFix'], r['satsView'], r['pdop'] / 10, r['rtGps'],
+                            self.rx.frames, self.rx.lost, r['dropped']))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', nargs='?', help='captured byte stream instead of a port')
+    parser.add_argument('--port', help='serial port of the debug UART')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--csv', help='record all frames to this file')
+    parser.add_argument('--quiet', action='store_true', help='no status line')
+    args = parser.parse_args()
+    if not args.port and not args.capture:
+        parser.error('give a port or a capture file')
+
+    csv = open(args.csv, 'w') if args.csv else None
+    if csv:
+        csv.write(','.join(FIELDS) + '\n')
+    sinks = []
+    rx = Receiver(lambda rec: [s(rec) for s in sinks])
+    if csv:
+        sinks.append(lambda rec: csv.write(','.join(str(rec[f]) for f in FIELDS) + '\n'))
+    if not args.quiet:
+        sinks.append(Dashboard(rx))
+
+    try:
+        if args.port:
+            import serial
+            with serial.Serial(args.port, args.baud, timeout=0.1) as ser:
+                while True:
+                    rx.feed(ser.read(max(1, ser.in_waiting)))   # blocks until data, no busy polling
+        else:
+            with open(args.capture, 'rb') as src:
+                while True:
+                    data = src.read(65536)
+                    if not data:
+                        break
+                    rx.feed(data)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if csv:
+            csv.close()
+    sys.stderr.write('\nframes %d, lost %d, other data %d\n' % (rx.frames, rx.lost, rx.bad))
+
+
+if __name__ == '__main__':
+    main()
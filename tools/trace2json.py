@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+trace2json.py -- converts an event trace dump of the GPS logger into Chrome trace JSON.
+
+"trace dump" on the console prints the trace ring as text (numbers in hex):
+    #TRACE,<clock Hz>,<records>
+    <timestamp>,<B|E|I>,<id>,<arg>          one line per record, oldest first
+    #END
+Other output around the dump is ignored. Event names are read from trace_ids.h, IDs are numbered by
+their position. The result opens in chrome://tracing or https://ui.perfetto.dev.
+
+Usage:
+    trace2json.py capture.txt -o trace.json
+    trace2json.py --port /dev/ttyACM0 -o trace.json         sends "trace dump" and reads the reply
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+ID_RE = re.compile(r'^\s*TRACE_ID\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)', re.M)
+
+
+def load_ids(path):
+    """Returns a list of event names in ID order."""
+    with open(path, encoding='utf-8', errors='replace') as f:
+        return [m.group(2) for m in ID_RE.finditer(f.read())]
+
+
+def parse_dump(lines):
+    """Returns (clock, records) of the last complete dump, records are (timestamp, type, id, arg)."""
+    result = None
+    dump = None
+    clock = 0
+    for line in lines:
+        line = line.strip()
+        if line.startswith('#TRACE,'):
+            clock, dump = int(line.split(',')[1], 16), []
+        elif line == '#END' and dump is not None:
+            result = (clock, dump)
+            dump = None
+        elif dump is not None:
+            parts = line.split(',')
+            if len(parts) == 4 and parts[1] in ('B', 'E', 'I'):
+                dump.append((int(parts[0], 16), parts[1], int(parts[2], 16), int(parts[3], 16)))
+    if result is None:
+        raise ValueError('no complete trace dump found')
+    return result
+
+
+def to_chrome(clock, records, names):
+    """Converts records into trace events. Timestamps wrap after 2^32 cycles, gaps must be shorter."""
+    events = []
+    open_ids = {}
+    base = 0
+    prev = None
+    t0 = records[0][0] if records else 0
+    for ts, kind, rid, arg in records:
+        if prev is not None and ts < prev:
+            base += 1 << 32
+        prev = ts
+        us = (base + ts - t0) * 1e6 / clock
+        name = names[rid] if rid < len(names) else 'id %d' % rid
+        if kind == 'B':
+            open_ids[rid] = open_ids.get(rid, 0) + 1
+            events.append({'name': name, 'ph': 'B', 'ts': us, 'pid': 1, 'tid': 1})
+        elif kind == 'E':
+            if not open_ids.get(rid):
+                continue                # begin was overwritten in the ring
+            open_ids[rid] -= 1
+            events.append({'name': name, 'ph': 'E', 'ts': us, 'pid': 1, 'tid': 1})
+        else:
+            events.append({'name': name, 'ph': 'i', 's': 't', 'ts': us, 'pid': 1, 'tid': 1,
+                           'args': {'arg': arg}})
+    return {'traceEvents': events, 'displayTimeUnit': 'ms'}
+
+
+def read_port(port, baud, timeout):
+    import serial
+    lines = []
+    with serial.Serial(port, baud, timeout=timeout) as ser:
+        ser.reset_input_buffer()
+        ser.write(b'\rtrace dump\r')
+        while True:
+            line = ser.readline()
+            if not line:
+                break
+            line = line.decode('latin-1')
+            lines.append(line)
+            if line.strip() == '#END':
+                break
+    return lines
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', nargs='?', help='captured console output, default: stdin')
+    parser.add_argument('--port', help='serial port of the debug UART')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--ids', default=os.path.join(here, '..', 'trace_ids.h'), help='path to trace_ids.h')
+    parser.add_argument('-o', '--output', help='output file, default: stdout')
+    args = parser.parse_args()
+
+    if args.port:
+        lines = read_port(args.port, args.baud, 2.0)
+    else:
+        src = open(args.capture, encoding='latin-1') if args.capture else sys.stdin
+        with src:
+            lines = src.readlines()
+
+    try:
+        clock, records = parse_dump(lines)
+    except ValueError as e:
+        sys.stderr.write('error: %s\n' % e)
+        return 1
+    trace = to_chrome(clock, records, load_ids(args.ids))
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    with out:
+        json.dump(trace, out)
+    sys.stderr.write('%d records, %.1f ms\n' % (len(records),
+                     trace['traceEvents'][-1]['ts'] / 1000 if trace['traceEvents'] else 0))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,203 @@
+/*
+ * trace.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "trace.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "debug.h"
+
+#if (TRACE_LEN & (TRACE_LEN-1)) != 0
+#error "TRACE_LEN must be a power of 2"
+#endif
+
+#define TRACE_LINELEN		24		/* longest dump line */
+
+/* ################### internal variables ################### */
+
+static trace_rec_t ring[TRACE_LEN];
+static uint16_t head = 0;				/* next record to write, free-running */
+static uint16_t count = 0;				/* valid records */
+static bool traceEnabled = true;
+static uint32_t traceClock = 0;
+
+static bool dumping = false;
+static bool dumpResume;					/* recording state before the dump */
+static int16_t dumpIdx;					/* record to dump next, -1 for the header */
+
+
+/* ################### private function prototypes ################### */
+
+/* Formats a record as dump line, returns the line length */
+uint8_t trace_formatRec(const trace_rec_t * rec, char * line);
+
+/* Appends a hex number with digits digits, returns the new length */
+uint8_t trace_appendHex(char * line, uint8_t i, uint32_t val, uint8_t digits);
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Sets the timer clock the timestamps are counted in, it is reported in the dump header.
+ * clockHz		clock frequency of debug_timestamp()
+ */
+void trace_init(uint32_t clockHz)
+{
+	traceClock = clockHz;
+}
+
+/*
+ * Enables or disables recording.
+ */
+void trace_enable(bool enable)
+{
+	if(dumping) dumpResume = enable;
+	else traceEnabled = enable;
+}
+
+/*
+ * Returns true, if recording is enabled.
+ */
+bool trace_enabled(void)
+{
+	return dumping ? dumpResume : traceEnabled;
+}
+
+/*
+ * Discards all records.
+ */
+void trace_clear(void)
+{
+	if(dumping) return;
+	count = 0;
+}
+
+/*
+ * Stores a record, overwriting the oldest one if the ring is full.
+ * id			event ID
+ * type		'B', 'E' or 'I'
+ * arg		free argument
+ */
+void trace_record(trace_id_e id, char type, uint16_t arg)
+{
+	trace_rec_t * rec;
+
+	if(!traceEnabled) return;
+
+	rec = &ring[head & (TRACE_LEN-1)];
+	rec->ts = debug_timestamp();
+	rec->id = (uint8_t)id;
+	rec->type = type;
+	rec->arg = arg;
+	head++;
+	if(count < TRACE_LEN) count++;
+}
+
+/*
+ * Starts dumping the ring over the debug UART, the lines are written by trace_poll().
+ */
+void trace_dump(void)
+{
+	if(dumping) return;
+	dumpResume = traceEnabled;
+	traceEnabled = false;
+	dumpIdx = -1;
+	dumping = true;
+}
+
+/*
+ * Writes pending dump lines as long as they fit into the transmit buffer.
+ * Returns true, if a line was written.
+ */
+bool trace_poll(void)
+{
+	char line[TRACE_LINELEN];
+	uint8_t len;
+	bool written = false;
+
+	while(dumping)
+	{
+		if(dumpIdx<0)
+		{
+			/* header */
+			len = 0;
+			line[len++] = '#'; line[len++] = 'T'; line[len++] = 'R'; line[len++] = 'A';
+			line[len++] = 'C'; line[len++] = 'E'; line[len++] = ',';
+			len = trace_appendHex(line, len, traceClock, 8);
+			line[len++] = ',';
+			len = trace_appendHex(line, len, count, 4);
+			line[len++] = '\r'; line[len++] = '\n';
+		}
+		else if(dumpIdx<count)
+		{
+			len = trace_formatRec(&ring[(uint16_t)(head - count + dumpIdx) & (TRACE_LEN-1)], line);
+		}
+		else
+		{
+			len = 0;
+			line[len++] = '#'; line[len++] = 'E'; line[len++] = 'N'; line[len++] = 'D';
+			line[len++] = '\r'; line[len++] = '\n';
+		}
+
+		if(!debug_write(line, len)) return written;	/* continue with the next poll */
+		written = true;
+
+		if(dumpIdx++ >= (int16_t)count)
+		{
+			dumping = false;
+			traceEnabled = dumpResume;
+		}
+	}
+
+	return written;
+}
+
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Formats a record as dump line "<timestamp hex>,<type>,<id>,<arg>\r\n".
+ * rec		the record
+ * line		destination, at least TRACE_LINELEN chars
+ * Returns the line length.
+ */
+uint8_t trace_formatRec(const trace_rec_t * rec, char * line)
+{
+	uint8_t i = 0;
+
+	i = trace_appendHex(line, i, rec->ts, 8);
+	line[i++] = ',';
+	line[i++] = rec->type;
+	line[i++] = ',';
+	i = trace_appendHex(line, i, rec->id, 2);
+	line[i++] = ',';
+	i = trace_appendHex(line, i, rec->arg, 4);
+	line[i++] = '\r';
+	line[i++] = '\n';
+
+	return i;
+}
+
+/*
+ * Appends a hex number.
+ * line		destination
+ * i		current length
+ * val		the number
+ * digits	number of hex digits
+ * Returns the new length.
+ */
+uint8_t trace_appendHex(char * line, uint8_t i, uint32_t val, uint8_t digits)
+{
+	static const char hex[] = "0123456789abcdef";
+
+	while(digits--)
+		line[i++] = hex[(val >> (4*digits)) & 0x0F];
+
+	return i;
+}
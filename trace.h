@@ -0,0 +1,77 @@
+/*
+ * trace.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: trace.h provides an event trace of the main loop. Begin, end and instant events are stored
+ *       		with a timestamp of the free-running debug timer (debug_timestamp()) in a RAM ring of
+ *       		TRACE_LEN records; the oldest records are overwritten. Unlike debug_startMeas(), regions can
+ *       		nest. The ring is dumped as text over the debug UART on demand and converted into Chrome
+ *       		trace JSON (chrome://tracing, Perfetto) by tools/trace2json.py, which reads the event names
+ *       		from trace_ids.h. Events may only be recorded from the main loop.
+ *
+ *       		Dump (numbers in hex): "#TRACE,<clock Hz>,<records>", one line "<timestamp>,<B|E|I>,<id>,<arg>"
+ *       		per record, oldest first, then "#END".
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+//#define TRACE_OFF				/* uncomment to remove all trace events at compile time */
+
+#define TRACE_LEN			512		/* records in the ring, power of 2 */
+
+/* event IDs, generated from trace_ids.h */
+typedef enum {
+#define TRACE_ID(id, name)	id,
+#include "trace_ids.h"
+#undef TRACE_ID
+	TRACE_IDCOUNT
+} trace_id_e;
+
+/* trace record */
+typedef struct {
+	uint32_t	ts;			/* debug_timestamp() */
+	uint8_t		id;			/* trace_id_e */
+	char		type;		/* 'B' begin, 'E' end, 'I' instant */
+	uint16_t	arg;		/* free argument */
+} trace_rec_t;
+
+#ifndef TRACE_OFF
+#define TRACE_BEGIN(id)			trace_record((id), 'B', 0)
+#define TRACE_END(id)			trace_record((id), 'E', 0)
+#define TRACE_INSTANT(id, arg)	trace_record((id), 'I', (uint16_t)(arg))
+#else
+#define TRACE_BEGIN(id)
+#define TRACE_END(id)
+#define TRACE_INSTANT(id, arg)
+#endif
+
+/* Sets the timer clock the timestamps are counted in. */
+void trace_init(uint32_t clockHz);
+
+/* Enables or disables recording. */
+void trace_enable(bool enable);
+
+/* Returns true, if recording is enabled. */
+bool trace_enabled(void);
+
+/* Discards all records. */
+void trace_clear(void);
+
+/* Stores a record. Use the TRACE_ macros instead of calling this function directly. */
+void trace_record(trace_id_e id, char type, uint16_t arg);
+
+/* Starts dumping the ring over the debug UART. Recording is paused until the dump is complete. */
+void trace_dump(void);
+
+/* Writes pending dump lines as far as the transmit buffer allows. Must be called periodically.
+ * Returns true, if a line was written. */
+bool trace_poll(void);
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,22 @@
+/*
+ * trace_ids.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: trace_ids.h is the table of trace event IDs. Each entry defines an ID and the name shown in
+ *       		the trace viewer. tools/trace2json.py reads this file, so IDs are numbered by their position:
+ *       		append new entries, do not reorder or remove them while old dumps need to be converted.
+ *       		No include guard, the file is included repeatedly.
+ */
+
+TRACE_ID(TR_TICK,			"tick 100ms")
+TRACE_ID(TR_GPS_PARSE,		"GPS parse")
+TRACE_ID(TR_GPS_COMPUTE,	"GPS compute")
+TRACE_ID(TR_GPS_MATCH,		"route/splits/segments")
+TRACE_ID(TR_DISPLAY,		"display update")
+TRACE_ID(TR_SD,				"SD block")
+TRACE_ID(TR_SD_WRITE,		"SD log write")
+TRACE_ID(TR_GHOST,			"ghost read ahead")
+TRACE_ID(TR_EXPORT,			"log export")
+TRACE_ID(TR_LOG_START,		"log start incl. mount")
@@ -6,16 +6,47 @@
  */
 #include "inc/hw_types.h"
 
+#include <string.h>
+
+#include "inc/hw_uart.h"
+#include "driverlib/debug.h"
+#include "driverlib/udma.h"
+
+#include "conversion.h"
+#include "dma.h"
+
 #include "uart.h"
 
-/* Put Data into Read Buffer (private) */
-void UARTPutRead(uint8_t UART_handler, const char *pui8Buffer);
+/* Orders the ring buffer accesses against the index updates of the other side */
+#if defined(__TI_COMPILER_VERSION__)
+#define UART_BARRIER()		__asm(" dmb")
+#else
+#define UART_BARRIER()		__sync_synchronize()
+#endif
+
+/* Writes data into a ring and returns the number of bytes written (private, producer side) */
+uint16_t UARTRingWrite(uart_ring_t *ring, const char *data, uint16_t len);
+
+/* Reads data from a ring and returns the number of bytes read (private, consumer side) */
+uint16_t UARTRingRead(uart_ring_t *ring, char *buffer, uint16_t len);
 
-/* Check internal, if unread data are available in the RX buffer (private) */
-void CheckUARTData(uint8_t UART_handler);
+/* Fills the TX FIFO from the TX ring (private, called by the ISR only) */
+void UARTFillTxFifo(uint8_t UART_handler);
 
 /* Common Interrupt handler, processes incoming UART interrupts (private) */
-void UARTIntHandler(uint8_t UARTNo, uint32_t intFlags, bool NoIsHandler);
+void UARTIntHandler(uint8_t UARTNo, uint32_t intFlags);
+
+/* Passes data received by uDMA to the RX ring (private) */
+uint16_t UARTDmaSink(void *arg, const char *data, uint16_t len);
+
+#ifdef UART6_RXDMA
+/* uDMA operations of UART6 RX (private) */
+void UART6DmaArm(void *arg, bool alt, uint8_t *dst, uint16_t len);
+bool UART6DmaDone(void *arg, bool alt);
+uint16_t UART6DmaRemaining(void *arg, bool alt);
+void UART6DmaPause(void *arg, bool pause);
+uint16_t UART6DmaDrain(void *arg, char *buffer, uint16_t len);
+#endif
 
  /* ISR for UART0 */
 void UART0IntHandler(void);
@@ -26,36 +57,63 @@ void UART6IntHandler(void);
 static uint32_t g_ui32SysClock;
 static uart_t uarts[8];
 
+/* statically allocated ring buffers, sized per UART */
+#pragma DATA_SECTION(uart0TxBuf, ".uartbuf")
+static char uart0TxBuf[UART0_TXLEN];
+#pragma DATA_SECTION(uart0RxBuf, ".uartbuf")
+static char uart0RxBuf[UART0_RXLEN];
+#pragma DATA_SECTION(uart6TxBuf, ".uartbuf")
+static char uart6TxBuf[UART6_TXLEN];
+#pragma DATA_SECTION(uart6RxBuf, ".uartbuf")
+static char uart6RxBuf[UART6_RXLEN];
+
+#ifdef UART6_RXDMA
+#pragma DATA_SECTION(uart6Dma, ".uartbuf")
+static uart_dma_t uart6Dma;
+static const uart_dma_ops_t uart6DmaOps = {
+	UART6DmaArm, UART6DmaDone, UART6DmaRemaining, UART6DmaPause, UART6DmaDrain
+};
+#endif
+
 /* Initialises a specified UART Module including GPIO and interrupt init */
 uint8_t UART_init(uint8_t UARTNo, uint32_t _g_ui32SysClock, uint32_t _ui32Baud, uint32_t _ui32Config)
 {
 	g_ui32SysClock = _g_ui32SysClock;
 	uint8_t i = 0;
 	while (uarts[i].initialized) {
+		ASSERT(uarts[i].UARTNo != UARTNo);	/* UART initialised twice */
+		if (uarts[i].UARTNo == UARTNo) return 255;
 		i++;
 	}
-
-	char * pBuff;
+	ASSERT(i <= UART_MAX);
+	if (i > UART_MAX) return 255;
 
 	uarts[i].UARTNo = UARTNo;
 	uint32_t offset = (UARTNo<<12);
 	uarts[i].ui32Base = UART0_BASE + offset;
 	
-	pBuff = (char*) calloc(UART_BUFF_LEN, sizeof(char));
-	if (pBuff==NULL) return 255;
-	uarts[i].w_start = 0;
-	uarts[i].w_end = 0;
-	uarts[i].w_buffer = pBuff;
-
-	pBuff = (char*) calloc(UART_BUFF_LEN, sizeof(char));
-	if (pBuff==NULL) return 255;
-	uarts[i].r_start = 0;
-	uarts[i].r_end = 0;
-	uarts[i].r_buffer = pBuff;
+	uarts[i].w.head = 0;
+	uarts[i].w.tail = 0;
+	uarts[i].r.head = 0;
+	uarts[i].r.tail = 0;
+	uarts[i].w.high = 0;
+	uarts[i].w.dropped = 0;
+	uarts[i].r.high = 0;
+	uarts[i].r.dropped = 0;
+	uarts[i].rxBytes = 0;
+	uarts[i].txBytes = 0;
+	uarts[i].overruns = 0;
+	uarts[i].framingErr = 0;
+	uarts[i].rxDma = NULL;
 
 	// UART specific part
 	if(UARTNo==0) 
 	{
+		uarts[i].w.buffer = uart0TxBuf;
+		uarts[i].w.mask = UART0_TXLEN-1;
+		uarts[i].r.buffer = uart0RxBuf;
+		uarts[i].r.mask = UART0_RXLEN-1;
+
 		//Pins A0 & A1
 		SysCtlPeripheralEnable(SYSCTL_PERIPH_UART0);
 		SysCtlPeripheralReset(SYSCTL_PERIPH_UART0);
@@ -68,10 +126,16 @@ uint8_t UART_init(uint8_t UARTNo, uint32_t _g_ui32SysClock, uint32_t _ui32Baud,
 
 		UARTIntUnregister(uarts[i].ui32Base);
 		UARTIntRegister(uarts[i].ui32Base, UART0IntHandler);
+		uarts[i].ui32Int = INT_UART0;
 		IntEnable(INT_UART0);
 	}
 	else if(UARTNo==6)
 	{
+		uarts[i].w.buffer = uart6TxBuf;
+		uarts[i].w.mask = UART6_TXLEN-1;
+		uarts[i].r.buffer = uart6RxBuf;
+		uarts[i].r.mask = UART6_RXLEN-1;
+
 		//Pins AP & P1
 		SysCtlPeripheralEnable(SYSCTL_PERIPH_UART6);
 		SysCtlPeripheralReset(SYSCTL_PERIPH_UART6);
@@ -84,8 +148,13 @@ uint8_t UART_init(uint8_t UARTNo, uint32_t _g_ui32SysClock, uint32_t _ui32Baud,
 
 		UARTIntUnregister(uarts[i].ui32Base);
 		UARTIntRegister(uarts[i].ui32Base, UART6IntHandler);
+		uarts[i].ui32Int = INT_UART6;
 		IntEnable(INT_UART6);
 	}
+	else
+	{
+		return 255;		/* no buffers for this UART */
+	}
 
 	//UARTFIFODisable(uarts[i].ui32Base);
 	UARTFIFOEnable(uarts[i].ui32Base);
@@ -93,161 +162,269 @@ uint8_t UART_init(uint8_t UARTNo, uint32_t _g_ui32SysClock, uint32_t _ui32Baud,
 	UARTTxIntModeSet(uarts[i].ui32Base, UART_TXINT_MODE_EOT); //UART_TXINT_MODE_FIFO, UART_TXINT_MODE_EOT
 	UARTConfigSetExpClk(uarts[i].ui32Base, g_ui32SysClock, _ui32Baud, _ui32Config);
 
-    UARTIntEnable(uarts[i].ui32Base, UART_INT_RX | UART_INT_RT | UART_INT_TX);
+#ifdef UART6_RXDMA
+	if(UARTNo==6)
+	{
+		/* RX by uDMA ping-pong, bursts of 8 bytes at FIFO level 4/8, the receive timeout flushes the rest */
+		dma_init();
+		uDMAChannelAssign(UDMA_CH10_UART6RX);
+		uDMAChannelAttributeDisable(UDMA_CH10_UART6RX, UDMA_ATTR_ALTSELECT | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+		uDMAChannelAttributeEnable(UDMA_CH10_UART6RX, UDMA_ATTR_USEBURST);
+		uDMAChannelControlSet(UDMA_CH10_UART6RX | UDMA_PRI_SELECT, UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_8);
+		uDMAChannelControlSet(UDMA_CH10_UART6RX | UDMA_ALT_SELECT, UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_8);
+		UARTFIFOLevelSet(uarts[i].ui32Base, UART_FIFO_TX1_8, UART_FIFO_RX4_8);
+
+		uarts[i].rxDma = &uart6Dma;
+		uartdma_init(&uart6Dma, &uart6DmaOps, &uarts[i], UARTDmaSink, &uarts[i]);
+		uartdma_start(&uart6Dma);
+		UARTDMAEnable(uarts[i].ui32Base, UART_DMA_RX);
+	}
+#endif
+
+	if(uarts[i].rxDma)
+		UARTIntEnable(uarts[i].ui32Base, UART_INT_DMARX | UART_INT_RT | UART_INT_TX);
+	else
+		UARTIntEnable(uarts[i].ui32Base, UART_INT_RX | UART_INT_RT | UART_INT_TX);
 
 	uarts[i].initialized = true;
     return i;
 }
 
+/* Puts chars into the UART transmit buffer */
 void UARTPut(uint8_t UART_handler, const char *pui8Buffer)
 {
-	if (uarts[UART_handler].initialized)
-	{
-		IntMasterDisable();
-		while(*pui8Buffer)
-		{
-			uarts[UART_handler].w_buffer[uarts[UART_handler].w_end] = *pui8Buffer++;
-			uarts[UART_handler].w_end++;
-			if (uarts[UART_handler].w_end == UART_BUFF_LEN) uarts[UART_handler].w_end = 0;
-		}
-		IntMasterEnable();
+	UARTWrite(UART_handler, pui8Buffer, strlen(pui8Buffer));
+}
 
-		UARTSend(UART_handler);
-	}
+/*
+ * Puts len bytes into the UART transmit buffer and starts sending.
+ * Bytes that do not fit into the buffer are dropped.
+ * Returns the number of bytes written.
+ */
+uint16_t UARTWrite(uint8_t UART_handler, const char *data, uint16_t len)
+{
+	uint16_t cnt;
+
+	if (!uarts[UART_handler].initialized) return 0;
+
+	cnt = UARTRingWrite(&uarts[UART_handler].w, data, len);
+	UARTSend(UART_handler);
+
+	return cnt;
 }
 
-bool UARTSend(uint8_t UART_handler)
+/* Returns the free space in the UART transmit buffer */
+uint16_t UARTSpace(uint8_t UART_handler)
 {
+	if (!uarts[UART_handler].initialized) return 0;
+
+	return uarts[UART_handler].w.mask + 1 - (uint16_t)(uarts[UART_handler].w.head - uarts[UART_handler].w.tail);
+}
 
-	bool success = true;
+/*
+ * Starts sending data from the UART buffer.
+ * The TX FIFO is filled by the ISR only, which is triggered by software here. Thus the ISR remains the
+ * single consumer of the TX ring.
+ * Returns true, if the transmit buffer is empty.
+ */
+bool UARTSend(uint8_t UART_handler)
+{
 	if (!uarts[UART_handler].initialized)
 	{
 		return true;
 	}
 
-	while(uarts[UART_handler].w_start != uarts[UART_handler].w_end)
-	{
+	if (uarts[UART_handler].w.head == uarts[UART_handler].w.tail) return true;
 
-		success = UARTCharPutNonBlocking(uarts[UART_handler].ui32Base, uarts[UART_handler].w_buffer[uarts[UART_handler].w_start]);
+	IntPendSet(uarts[UART_handler].ui32Int);
+	return false;
+}
 
-		if (!success) break;
 
-		/*if (!success) {
-			while(UARTBusy(uarts[UART_handler].ui32Base));
-			success = UARTCharPutNonBlocking(uarts[UART_handler].ui32Base, uarts[UART_handler].buffer[uarts[UART_handler].start]);
-			if (!success) break;
-		}*/
-		uarts[UART_handler].w_start++;
-		if (uarts[UART_handler].w_start >= UART_BUFF_LEN) uarts[UART_handler].w_start = 0;
-	}
+/*
+ * Changes the baud rate of a UART, keeping the frame format.
+ * The baud rate is only changed once all pending data is sent, so no byte is garbled.
+ * Returns false, if data is still being sent; call again later.
+ */
+bool UART_setBaud(uint8_t UART_handler, uint32_t baud)
+{
+	uint32_t oldBaud, config;
+
+	if (!uarts[UART_handler].initialized) return false;
+	if (!UARTSend(UART_handler) || UARTBusy(uarts[UART_handler].ui32Base)) return false;
 
-	return success;
+	UARTConfigGetExpClk(uarts[UART_handler].ui32Base, g_ui32SysClock, &oldBaud, &config);
+	UARTConfigSetExpClk(uarts[UART_handler].ui32Base, g_ui32SysClock, baud, config);
+	return true;
 }
 
 
 /* UART Read functions ------------------------------------------------------ */
 
 
-/* Put Data into Read Buffer (private) */
-void UARTPutRead(uint8_t UART_handler, const char *pui8Buffer)
-{
-	if (uarts[UART_handler].initialized)
-	{
-		/*IntMasterDisable(); */
-		while(*pui8Buffer)
-		{
-			uarts[UART_handler].r_buffer[uarts[UART_handler].r_end] = *pui8Buffer++;
-			uarts[UART_handler].r_end++;
-			if (uarts[UART_handler].r_end == UART_BUFF_LEN) uarts[UART_handler].r_end = 0;
-		}
-		/*IntMasterEnable(); */
-
-		/*UARTSend(UART_handler); */
-	}
-}
-
-
 /* Check, if unread data are have been received */
 bool UARTDataAvailable(uint8_t UART_handler)
 {
-	CheckUARTData(UART_handler);
-
-	return uarts[UART_handler].r_start != uarts[UART_handler].r_end;
+	return uarts[UART_handler].r.head != uarts[UART_handler].r.tail;
 }
 
 /* returns number of read bytes */
 uint8_t UARTGet(uint8_t UART_handler, char * buffer, uint8_t numToRead)
 {
-	uint16_t cnt = 0;
+	return (uint8_t)UARTRead(UART_handler, buffer, numToRead);
+}
 
-	if (!uarts[UART_handler].initialized || numToRead==0)
+/* Reads up to len bytes from the UART receive buffer and returns the number of bytes read */
+uint16_t UARTRead(uint8_t UART_handler, char *buffer, uint16_t len)
+{
+	if (!uarts[UART_handler].initialized || len==0)
 	{
 		return 0;
 	}
 
-	while( (uarts[UART_handler].r_start != uarts[UART_handler].r_end)  && (cnt<numToRead))
+	return UARTRingRead(&uarts[UART_handler].r, buffer, len);
+}
+
+/* Ring buffer functions ---------------------------------------------------- */
+
+/*
+ * Writes data into a ring (producer side). The data is copied before the head is published.
+ * Returns the number of bytes written, bytes that do not fit are dropped.
+ */
+uint16_t UARTRingWrite(uart_ring_t *ring, const char *data, uint16_t len)
+{
+	uint16_t head = ring->head;
+	uint16_t space = ring->mask + 1 - (uint16_t)(head - ring->tail);
+	uint16_t idx, first;
+
+	if (len > space)
 	{
-		IntMasterDisable();
-		buffer[cnt] = uarts[UART_handler].r_buffer[uarts[UART_handler].r_start];
-		uarts[UART_handler].r_start++;
-		if (uarts[UART_handler].r_start >= UART_BUFF_LEN) uarts[UART_handler].r_start = 0;
-		IntMasterEnable();
-		cnt++;
+		ring->dropped += len - space;
+		len = space;
 	}
+	if (len == 0) return 0;
 
-	return cnt;
+	idx = head & ring->mask;
+	first = ring->mask + 1 - idx;
+	if (first > len) first = len;
+
+	memcpy(&ring->buffer[idx], data, first);
+	memcpy(&ring->buffer[0], data + first, len - first);
+
+	UART_BARRIER();						/* data must be visible before the head moves */
+	ring->head = head + len;
+
+	if (ring->mask + 1 - space + len > ring->high) ring->high = ring->mask + 1 - space + len;
+
+	return len;
+}
+
+/*
+ * Reads data from a ring (consumer side). The data is copied before the tail is released.
+ * Returns the number of bytes read.
+ */
+uint16_t UARTRingRead(uart_ring_t *ring, char *buffer, uint16_t len)
+{
+	uint16_t tail = ring->tail;
+	uint16_t avail = (uint16_t)(ring->head - tail);
+	uint16_t idx, first;
+
+	UART_BARRIER();						/* read head before the data */
+
+	if (len > avail) len = avail;
+	if (len == 0) return 0;
+
+	idx = tail & ring->mask;
+	first = ring->mask + 1 - idx;
+	if (first > len) first = len;
+
+	memcpy(buffer, &ring->buffer[idx], first);
+	memcpy(buffer + first, &ring->buffer[0], len - first);
+
+	UART_BARRIER();						/* data must be read before the tail moves */
+	ring->tail = tail + len;
+
+	return len;
 }
 
 /* Common Interrupt handler ----------------------------------------------- */
-/* Common Interrupt handler, processes incoming UART interrupts (private) */
-void UARTIntHandler(uint8_t UARTNo, uint32_t intFlags, bool NoIsHandler)
+
+/* Fills the TX FIFO from the TX ring (private, called by the ISR only) */
+void UARTFillTxFifo(uint8_t UART_handler)
 {
+	uart_ring_t *ring = &uarts[UART_handler].w;
+	uint16_t tail = ring->tail;
+	uint16_t head = ring->head;
 
+	UART_BARRIER();
+
+	while(tail != head)
+	{
+		if (!UARTCharPutNonBlocking(uarts[UART_handler].ui32Base, ring->buffer[tail & ring->mask])) break;
+		tail++;
+	}
+
+	UART_BARRIER();
+	uarts[UART_handler].txBytes += (uint16_t)(tail - ring->tail);
+	ring->tail = tail;
+}
+
+/* Common Interrupt handler, processes incoming UART interrupts (private) */
+void UARTIntHandler(uint8_t UARTNo, uint32_t intFlags)
+{
 	uint8_t UART_handler = 255;
-	if(NoIsHandler)
+
+	/* Get the UART_handler from the UART Number */
+	int i;
+	for(i=0; i<=UART_MAX; i++)
 	{
-		UART_handler = UARTNo;
+		if(uarts[i].initialized && uarts[i].UARTNo == UARTNo)
+		{
+			UART_handler = i;
+			break;
+		}
 	}
-	else
+	if (UART_handler == 255) return;
+
+	if(uarts[UART_handler].rxDma)
 	{
-		/* Get the UART_handler from the UART Number */
-		int i;
-		for(i=0; i<=UART_MAX; i++)
+		if(intFlags & (UART_INT_DMARX | UART_INT_RT))
 		{
-			if(uarts[i].UARTNo == UARTNo)
+			uint32_t err = UARTRxErrorGet(uarts[UART_handler].ui32Base);
+			if(err)
 			{
-				UART_handler = i;
-				break;
+				if(err & UART_RXERROR_OVERRUN) uarts[UART_handler].overruns++;
+				if(err & UART_RXERROR_FRAMING) uarts[UART_handler].framingErr++;
+				UARTRxErrorClear(uarts[UART_handler].ui32Base);
 			}
+
+			uartdma_service(uarts[UART_handler].rxDma, (intFlags & UART_INT_RT) != 0);
 		}
-		if (UART_handler == 255) return;
 	}
-
-	
-	if(intFlags & UART_INT_RX)
+	else if(intFlags & (UART_INT_RX | UART_INT_RT))
 	{
-		char rchar[2];
-		rchar[1] = 0;
+		char rchars[16];		/* size of the RX FIFO */
+		uint8_t cnt = 0;
+		int32_t c;
 
 		/* Loop while there are characters in the receive FIFO. */
-		while(UARTCharsAvail(uarts[UART_handler].ui32Base))
+		while(UARTCharsAvail(uarts[UART_handler].ui32Base) && cnt<sizeof(rchars))
 		{
-			rchar[0] = UARTCharGetNonBlocking(uarts[UART_handler].ui32Base);
-
-			UARTPutRead(UART_handler, rchar);
+			c = UARTCharGetNonBlocking(uarts[UART_handler].ui32Base);
+			if(c & (UART_DR_OE | UART_DR_FE))		/* error flags of the received character */
+			{
+				if(c & UART_DR_OE) uarts[UART_handler].overruns++;
+				if(c & UART_DR_FE) uarts[UART_handler].framingErr++;
+			}
+			rchars[cnt++] = (char)c;
 		}
+
+		uarts[UART_handler].rxBytes += cnt;
+		UARTRingWrite(&uarts[UART_handler].r, rchars, cnt);
 	}
-	/* Send if TX Data available */
-	if(intFlags & UART_INT_TX)
-	{
-		UARTSend(UART_handler);
-	}
-}
 
-/* Check internal, if unread data are available in the RX buffer (private) */
-void CheckUARTData(uint8_t UART_handler)
-{
-	UARTIntHandler(UART_handler, UART_INT_RX, true);
+	/* Send if TX Data available. Also called without UART_INT_TX when triggered by UARTSend() */
+	UARTFillTxFifo(UART_handler);
 }
 
 
@@ -265,7 +442,7 @@ void UART0IntHandler(void)
 	/* Clear the asserted interrupts. */
 	UARTIntClear(UART0_BASE, ui32Status);
 
-	UARTIntHandler(0, ui32Status, false);
+	UARTIntHandler(0, ui32Status);
 }
 
 void UART1IntHandler(void)
@@ -278,7 +455,7 @@ void UART1IntHandler(void)
 	/* Clear the asserted interrupts. */
 	UARTIntClear(UART1_BASE, ui32Status);
 
-	UARTIntHandler(1, ui32Status, false);
+	UARTIntHandler(1, ui32Status);
 }
 
 void UART6IntHandler(void)
@@ -291,7 +468,119 @@ void UART6IntHandler(void)
 	/* Clear the asserted interrupts. */
 	UARTIntClear(UART6_BASE, ui32Status);
 
-	UARTIntHandler(6, ui32Status, false);
+	UARTIntHandler(6, ui32Status);
+}
+
+/* uDMA reception ----------------------------------------------------------- */
+
+/* Passes data received by uDMA to the RX ring (private) */
+uint16_t UARTDmaSink(void *arg, const char *data, uint16_t len)
+{
+	uart_t *u = (uart_t *)arg;
+
+	u->rxBytes += len;
+	return UARTRingWrite(&u->r, data, len);
+}
+
+#ifdef UART6_RXDMA
+/* Arms the primary or alternate ping-pong transfer from the UART6 data register (private) */
+void UART6DmaArm(void *arg, bool alt, uint8_t *dst, uint16_t len)
+{
+	uDMAChannelTransferSet(UDMA_CH10_UART6RX | (alt ? UDMA_ALT_SELECT : UDMA_PRI_SELECT), UDMA_MODE_PINGPONG,
+			(void *)(UART6_BASE + UART_O_DR), dst, len);
+	uDMAChannelEnable(UDMA_CH10_UART6RX);
+}
+
+/* Returns true, if the primary or alternate transfer has completed (private) */
+bool UART6DmaDone(void *arg, bool alt)
+{
+	return uDMAChannelModeGet(UDMA_CH10_UART6RX | (alt ? UDMA_ALT_SELECT : UDMA_PRI_SELECT)) == UDMA_MODE_STOP;
+}
+
+/* Returns the bytes not yet transferred by the primary or alternate transfer (private) */
+uint16_t UART6DmaRemaining(void *arg, bool alt)
+{
+	return uDMAChannelSizeGet(UDMA_CH10_UART6RX | (alt ? UDMA_ALT_SELECT : UDMA_PRI_SELECT));
+}
+
+/* Stops or resumes the RX DMA requests of UART6 (private) */
+void UART6DmaPause(void *arg, bool pause)
+{
+	if(pause) UARTDMADisable(UART6_BASE, UART_DMA_RX);
+	else UARTDMAEnable(UART6_BASE, UART_DMA_RX);
+}
+
+/* Reads the bytes left in the UART6 RX FIFO (private) */
+uint16_t UART6DmaDrain(void *arg, char *buffer, uint16_t len)
+{
+	uint16_t cnt = 0;
+
+	while(cnt<len && UARTCharsAvail(UART6_BASE))
+		buffer[cnt++] = (char)UARTCharGetNonBlocking(UART6_BASE);
+
+	return cnt;
+}
+#endif
+
+/* UART statistics ---------------------------------------------------------- */
+
+/*
+ * Returns the health counters of a UART.
+ * Each counter is modified by one side only, so it can be read without masking interrupts.
+ */
+uart_stats_t UART_getStats(uint8_t UART_handler)
+{
+	uart_stats_t s;
+
+	memset(&s, 0, sizeof(s));
+	if (UART_handler>UART_MAX || !uarts[UART_handler].initialized) return s;
+
+	s.rxBytes = uarts[UART_handler].rxBytes;
+	s.txBytes = uarts[UART_handler].txBytes;
+	s.rxDropped = uarts[UART_handler].r.dropped;
+	s.txDropped = uarts[UART_handler].w.dropped;
+	s.overruns = uarts[UART_handler].overruns;
+	s.framingErr = uarts[UART_handler].framingErr;
+	s.rxHigh = uarts[UART_handler].r.high;
+	s.txHigh = uarts[UART_handler].w.high;
+	s.rxLen = uarts[UART_handler].r.mask + 1;
+	s.txLen = uarts[UART_handler].w.mask + 1;
+
+	return s;
+}
+
+/*
+ * Writes the health counters of a UART as a text line to buffer:
+ * UARTn,RX,bytes,high/len,dropped,overruns,framing errors,TX,bytes,high/len,dropped
+ * buffer	must hold at least UART_STATSTEXTLEN chars
+ * Returns	buffer, or NULL if the UART is not initialised
+ */
+char * UART_statsToText(uint8_t UART_handler, char * buffer)
+{
+	uart_stats_t s;
+	uint8_t i = 0;
+
+	if (UART_handler>UART_MAX || !uarts[UART_handler].initialized) return NULL;
+	s = UART_getStats(UART_handler);
+
+	buffer[i++] = 'U'; buffer[i++] = 'A'; buffer[i++] = 'R'; buffer[i++] = 'T';
+	i = ui32AppendA(buffer, i, uarts[UART_handler].UARTNo, ',');
+	buffer[i++] = 'R'; buffer[i++] = 'X'; buffer[i++] = ',';
+	i = ui32AppendA(buffer, i, s.rxBytes, ',');
+	i = ui32AppendA(buffer, i, s.rxHigh, '/');
+	i = ui32AppendA(buffer, i, s.rxLen, ',');
+	i = ui32AppendA(buffer, i, s.rxDropped, ',');
+	i = ui32AppendA(buffer, i, s.overruns, ',');
+	i = ui32AppendA(buffer, i, s.framingErr, ',');
+	buffer[i++] = 'T'; buffer[i++] = 'X'; buffer[i++] = ',';
+	i = ui32AppendA(buffer, i, s.txBytes, ',');
+	i = ui32AppendA(buffer, i, s.txHigh, '/');
+	i = ui32AppendA(buffer, i, s.txLen, ',');
+	i = ui32AppendA(buffer, i, s.txDropped, '\r');
+	buffer[i++] = '\n';
+	buffer[i] = 0;
+
+	return buffer;
 }
 
 /* Convert a 16 bit unsigned integer to an ascii character array (string) */
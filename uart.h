@@ -6,6 +6,9 @@
  *
  *  	 Brief: uart.h provides basic interrupt driven buffered UART functions. This include reading from
  *  			and writing to multiple UART modules.
+ *  			The TX and RX buffers are single producer / single consumer ring buffers: the main loop only
+ *  			moves the head of the TX ring and the tail of the RX ring, the ISR only the other ones. Thus
+ *  			neither side masks interrupts. Data not fitting into a ring is dropped.
  */
 
 #ifndef UART_H_
@@ -22,22 +25,62 @@
 #include "driverlib/interrupt.h"
 #include "driverlib/uart.h"
 
+#include "uart_dma.h"
 
-#define UART_BUFF_LEN 	512		/* Buffer length for UART TX and RX */
+
+/* Buffer lengths for UART TX and RX per UART module, must be powers of two not larger than 32768.
+ * The buffers are allocated statically in section .uartbuf and listed in the linker map file. */
+#define UART0_TXLEN		2048	/* debug output and log export frames */
+#define UART0_RXLEN		128		/* debug input, typed commands and export acknowledgements */
+#define UART6_TXLEN		64		/* GPS configuration messages */
+#define UART6_RXLEN		1024	/* GPS NMEA stream */
 #define UART_MAX		7		/* maximum number of UARTs that can be initialized */
+#define UART_STATSTEXTLEN	112	/* max. length of the text produced by UART_statsToText() */
+#define UART6_RXDMA				/* comment out to receive the GPS stream without uDMA */
+
+#define UART_ISPOW2(len)	(((len) & ((len)-1))==0 && (len)<=32768)
+#if !UART_ISPOW2(UART0_TXLEN) || !UART_ISPOW2(UART0_RXLEN) || !UART_ISPOW2(UART6_TXLEN) || !UART_ISPOW2(UART6_RXLEN)
+#error "UART buffer lengths must be powers of two not larger than 32768"
+#endif
+
+/* single producer / single consumer ring, indices are free running and masked on access */
+typedef struct uart_ring_str{
+	char *buffer;
+	uint16_t mask;				/* buffer length - 1 */
+	volatile uint16_t head;		/* write index, only modified by the producer */
+	volatile uint16_t tail;		/* read index, only modified by the consumer */
+	uint16_t high;				/* high-water mark, only modified by the producer */
+	uint32_t dropped;			/* bytes dropped because the ring was full, only modified by the producer */
+} uart_ring_t;
+
+/* UART health counters, used to size buffers and choose baud rates */
+typedef struct {
+	uint32_t rxBytes;			/* bytes received */
+	uint32_t txBytes;			/* bytes transmitted */
+	uint32_t rxDropped;			/* received bytes dropped, RX ring full */
+	uint32_t txDropped;			/* bytes to transmit dropped, TX ring full */
+	uint32_t overruns;			/* hardware RX FIFO overruns */
+	uint32_t framingErr;		/* framing errors */
+	uint16_t rxHigh;			/* RX ring high-water mark */
+	uint16_t txHigh;			/* TX ring high-water mark */
+	uint16_t rxLen;				/* RX ring length */
+	uint16_t txLen;				/* TX ring length */
+} uart_stats_t;
 
 typedef struct uart_str{
 	uint8_t UARTNo;
 	uint32_t ui32Base;
+	uint32_t ui32Int;
 	bool initialized;
 
-	char *w_buffer;
-	uint16_t w_start;
-	uint16_t w_end;
+	uart_ring_t w;				/* TX ring, producer: main loop, consumer: ISR */
+	uart_ring_t r;				/* RX ring, producer: ISR, consumer: main loop */
+	uart_dma_t *rxDma;			/* uDMA ping-pong receiver, NULL if RX is interrupt driven */
 
-	char *r_buffer;
-	uint16_t r_start;
-	uint16_t r_end;
+	uint32_t rxBytes;			/* health counters, only modified by the ISR */
+	uint32_t txBytes;
+	uint32_t overruns;
+	uint32_t framingErr;
 } uart_t;
 
  /* Initialises a specified UART Module including GPIO and interrupt init. 
@@ -47,15 +90,34 @@ uint8_t UART_init(uint8_t UARTNo, uint32_t _g_ui32SysClock, uint32_t _ui32Baud,
 /* Puts chars into the UART transmit buffer */
 void UARTPut(uint8_t UART_handler, const char *pui8Buffer);
 
-/* Sends data from the UART buffer */
+/* Puts len bytes into the UART transmit buffer and returns the number of bytes written, the rest is dropped */
+uint16_t UARTWrite(uint8_t UART_handler, const char *data, uint16_t len);
+
+/* Returns the free space in the UART transmit buffer */
+uint16_t UARTSpace(uint8_t UART_handler);
+
+/* Starts sending data from the UART buffer, returns true if the buffer is empty */
 bool UARTSend(uint8_t UART_handler);
 
+/* Changes the baud rate once all pending data is sent, returns false if still sending */
+bool UART_setBaud(uint8_t UART_handler, uint32_t baud);
+
 /* Returns wheter unread data are in the UART receive buffer  */
 bool UARTDataAvailable(uint8_t UART_handler);
 
 /* Reads data from the UART receive buffer to buffer and returns the number of successfully read data */
 uint8_t UARTGet(uint8_t UART_handler, char * buffer, uint8_t numToRead);
 
+/* Reads up to len bytes from the UART receive buffer and returns the number of bytes read */
+uint16_t UARTRead(uint8_t UART_handler, char *buffer, uint16_t len);
+
+/* Returns the health counters of a UART */
+uart_stats_t UART_getStats(uint8_t UART_handler);
+
+/* Writes the health counters of a UART as a text line to buffer (at least UART_STATSTEXTLEN chars).
+ * Returns NULL, if the UART is not initialised. */
+char * UART_statsToText(uint8_t UART_handler, char * buffer);
+
 /* Convert a 16 bit unsigned integer to an ascii character array (string) */
 char * int16ToA(uint16_t int16, char * buffer);
 /* Convert a 8 bit unsigned integer to an ascii character array (string) */
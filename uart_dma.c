@@ -0,0 +1,102 @@
+/*
+ * uart_dma.c
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ */
+
+#include "uart_dma.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ################### private function prototypes ################### */
+
+/* Passes the bytes of the active half up to upto to the sink. */
+void uartdma_flush(uart_dma_t *d, uint16_t upto);
+
+
+/* ################### function definitions ################### */
+
+/*
+ * Initialises a ping-pong receiver.
+ * ops		hardware operations
+ * hwArg	argument passed to the hardware operations
+ * sink		function receiving the data
+ * sinkArg	argument passed to the sink
+ */
+void uartdma_init(uart_dma_t *d, const uart_dma_ops_t *ops, void *hwArg, uart_dma_sink_t sink, void *sinkArg)
+{
+	d->ops = ops;
+	d->hwArg = hwArg;
+	d->sink = sink;
+	d->sinkArg = sinkArg;
+	d->active = false;
+	d->consumed = 0;
+	d->blocks = 0;
+	d->flushes = 0;
+}
+
+/*
+ * Arms both halves and starts reception with the primary half.
+ */
+void uartdma_start(uart_dma_t *d)
+{
+	d->active = false;
+	d->consumed = 0;
+	d->ops->arm(d->hwArg, false, d->buffer[0], UART_DMABLOCK);
+	d->ops->arm(d->hwArg, true, d->buffer[1], UART_DMABLOCK);
+}
+
+/*
+ * Passes received data to the sink, keeping the order of the bytes.
+ * Completed halves are passed on and re-armed. On receive timeout the peripheral's DMA requests are
+ * paused, so the partially filled half and then the bytes left in the FIFO can be passed on without
+ * the uDMA writing in between.
+ * timeout	true, if called on receive timeout
+ */
+void uartdma_service(uart_dma_t *d, bool timeout)
+{
+	uint8_t i;
+
+	if(timeout) d->ops->pause(d->hwArg, true);
+
+	/* completed halves, at most both */
+	for(i=0; i<2 && d->ops->done(d->hwArg, d->active); i++)
+	{
+		uartdma_flush(d, UART_DMABLOCK);
+		d->ops->arm(d->hwArg, d->active, d->buffer[d->active], UART_DMABLOCK);
+		d->active = !d->active;
+		d->consumed = 0;
+		d->blocks++;
+	}
+
+	if(timeout)
+	{
+		char fifo[UART_DMAFIFO];
+		uint16_t cnt;
+
+		uartdma_flush(d, UART_DMABLOCK - d->ops->remaining(d->hwArg, d->active));
+
+		cnt = d->ops->drain(d->hwArg, fifo, UART_DMAFIFO);
+		if(cnt) d->sink(d->sinkArg, fifo, cnt);
+
+		d->flushes++;
+		d->ops->pause(d->hwArg, false);
+	}
+}
+
+/* ---=== PRIVATE ===--- */
+
+/*
+ * Passes the bytes of the active half from the last flush up to upto to the sink.
+ */
+void uartdma_flush(uart_dma_t *d, uint16_t upto)
+{
+	if(upto > d->consumed)
+	{
+		d->sink(d->sinkArg, (const char *)&d->buffer[d->active][d->consumed], upto - d->consumed);
+		d->consumed = upto;
+	}
+}
@@ -0,0 +1,58 @@
+/*
+ * uart_dma.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: Christoph Ringl
+ *
+ *       Brief: uart_dma.h provides uDMA driven UART reception with ping-pong buffers. The uDMA fills one
+ *       		half of a buffer while the other half is passed on, and the receive timeout flushes
+ *       		partially filled halves. The hardware is accessed through a small set of operations only,
+ *       		so the buffer switching can also be run against a simulated DMA engine.
+ */
+
+#ifndef UART_DMA_H_
+#define UART_DMA_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define UART_DMABLOCK		64		/* bytes per ping-pong half */
+#define UART_DMAFIFO		16		/* bytes read from the peripheral FIFO on receive timeout */
+
+/* hardware operations, alt selects the primary (false) or alternate (true) transfer */
+typedef struct {
+	void (*arm)(void *arg, bool alt, uint8_t *dst, uint16_t len);	/* (re-)arms a transfer into dst */
+	bool (*done)(void *arg, bool alt);								/* true, if the transfer has completed */
+	uint16_t (*remaining)(void *arg, bool alt);						/* bytes not yet transferred */
+	void (*pause)(void *arg, bool pause);							/* stops or resumes the peripheral's DMA requests */
+	uint16_t (*drain)(void *arg, char *buffer, uint16_t len);		/* reads bytes left in the peripheral FIFO */
+} uart_dma_ops_t;
+
+/* receives the data in order, returns the number of bytes accepted */
+typedef uint16_t (*uart_dma_sink_t)(void *arg, const char *data, uint16_t len);
+
+typedef struct {
+	const uart_dma_ops_t *ops;
+	void *hwArg;
+	uart_dma_sink_t sink;
+	void *sinkArg;
+
+	uint8_t buffer[2][UART_DMABLOCK];	/* ping-pong halves */
+	bool active;						/* half being filled, false: primary, true: alternate */
+	uint16_t consumed;					/* bytes of the active half already passed to the sink */
+	uint32_t blocks;					/* completed halves */
+	uint32_t flushes;					/* receive timeout flushes */
+} uart_dma_t;
+
+
+/* Initialises a ping-pong receiver. */
+void uartdma_init(uart_dma_t *d, const uart_dma_ops_t *ops, void *hwArg, uart_dma_sink_t sink, void *sinkArg);
+
+/* Arms both halves and starts reception. */
+void uartdma_start(uart_dma_t *d);
+
+/* Passes received data to the sink. Must be called on DMA completion and on receive timeout. */
+void uartdma_service(uart_dma_t *d, bool timeout);
+
+#endif /* UART_DMA_H_ */